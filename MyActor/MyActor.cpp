@@ -1,10 +1,18 @@
 #include <iostream>
 #include "./actor/my_actor.h"
 #include "./actor/actor_socket.h"
+#include "./actor/async_file.h"
 #include "./actor/async_timer.h"
+#include "./actor/huge_page.h"
 #include "./actor/msg_queue.h"
 #include "./actor/generator.h"
 #include "./actor/channel.h"
+#include "./actor/actor_group.h"
+#include "./actor/parallel.h"
+#include "./actor/strand_balancer.h"
+#include "./actor/stack_sampler.h"
+#include "./actor/shm_link.h"
+#include "./actor/remote_actor.h"
 #include "./actor/trace.h"
 
 void wait_multi_msg()
@@ -105,6 +113,59 @@ void wait_multi_msg()
 	trace_line("end wait_multi_msg");
 }
 
+void select_wake_test()
+{
+	trace_line("begin select_wake_test");
+	io_engine ios;
+	ios.run();
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [](my_actor* self)
+	{
+		msg_handle<int> amh1;
+		msg_handle<int> amh2;
+		const int count = 6;
+		int recv1 = 0, recv2 = 0, recv3 = 0;
+		child_handle ch = self->create_child([&](my_actor* self)
+		{
+			//消息都在select挂起期间送达
+			self->select_msg_blocks_many(select_block_msg<int>(amh1, [&](int msg)
+			{
+				trace_comma(self->self_id(), "msg1", msg);
+				recv1++;
+				return recv1 + recv2 + recv3 == 3 * count;
+			}), select_block_msg<int>(amh2, [&](int msg)
+			{
+				trace_comma(self->self_id(), "msg2", msg);
+				recv2++;
+				return recv1 + recv2 + recv3 == 3 * count;
+			}), select_block_pump<int>(self, [&](int msg)
+			{
+				trace_comma(self->self_id(), "pump", msg);
+				recv3++;
+				return recv1 + recv2 + recv3 == 3 * count;
+			}));
+		});
+		auto ntf1 = self->make_msg_notifer_to(ch, amh1);
+		auto ntf2 = self->make_msg_notifer_to(ch, amh2);
+		auto ntf3 = self->connect_msg_notifer_to<int>(ch);
+		self->child_run(ch);
+		for (int i = 0; i < count; i++)
+		{
+			self->sleep(50);
+			ntf1(i);
+			self->sleep(50);
+			ntf3(i);
+			ntf2(i);
+		}
+		self->child_wait_quit(ch);
+		assert(count == recv1 && count == recv2 && count == recv3);
+		trace_line("select_wake_test received ", recv1, " ", recv2, " ", recv3);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end select_wake_test");
+}
+
 void sync_msg_test()
 {
 	trace_line("begin sync_msg_test");
@@ -814,182 +875,1845 @@ void perfor_test()
 	trace_line("end perfor_test");
 }
 
-void async_timer_test()
+void async_file_perfor_test()
 {
-	trace_line("begin async_timer_test");
+	trace_line("begin async_file_perfor_test");
 	io_engine ios;
-	ios.run();
+	ios.run(run_thread::cpu_thread_number());
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [](my_actor* self)
 	{
-		shared_strand strand = boost_strand::create(ios);
-		async_timer timer1 = strand->make_timer();
-		async_timer timer2 = strand->make_timer();
-		async_timer timer3 = strand->make_timer();
-		strand->post([=]
+		const char* path = "./async_file_perfor.tmp";
+		const size_t fileSize = 32 * 1024 * 1024;//每次运行都要写一遍，不宜过大
+		const size_t maxBlock = 4 * 1024 * 1024;
+		std::vector<char> buff(maxBlock, 'a');
+		async_file file(self->self_io_engine());
+		if (!file.open(path, async_file::read_write | async_file::create | async_file::truncate | async_file::sequential).ok)
 		{
-			const shared_strand& lockStrand = strand;
-			timer1->timeout(500, [timer1]
+			trace_line("open file failed");
+			return;
+		}
+		trace_line(file.is_uring() ? "io_uring" : "thread pool", ", file size ", fileSize / (1024 * 1024), "MB");
+		for (size_t pos = 0; pos < fileSize; pos += maxBlock)
+		{
+			if (!file.write_at(self, pos, &buff[0], maxBlock).ok)
 			{
-				info_trace_line("timer1 ", 1);
-				timer1->timeout(1000, [timer1]
+				trace_line("write file failed");
+				file.close();
+				remove(path);
+				return;
+			}
+		}
+		file.fsync(self);
+		for (size_t blockSize = 64 * 1024; blockSize <= maxBlock; blockSize *= 4)
+		{
+			size_t asyncBytes = 0;
+			long long tk = get_tick_us();
+			for (size_t pos = 0; pos < fileSize; pos += blockSize)
+			{
+				async_file::result res = file.read_at(self, pos, &buff[0], blockSize);
+				if (!res.ok || !res.s)
 				{
-					info_trace_line("timer1 ", 2);
-					timer1->timeout(1000, []
-					{
-						info_trace_line("timer1 ", 3);
-					});
-				});
-			});
-			timer2->timeout(1000, [timer2]
+					break;
+				}
+				asyncBytes += res.s;
+			}
+			const long long asyncTm = get_tick_us() - tk;
+			size_t syncBytes = 0;
+			FILE* syncFile = fopen(path, "rb");
+			tk = get_tick_us();
+			while (syncFile)
 			{
-				info_trace_line("timer2 ", 1);
-				timer2->timeout(1000, [timer2]
+				size_t s = self->run_in_thread_stack<size_t>([&]()->size_t
 				{
-					info_trace_line("timer2 ", 2);
-					timer2->timeout(1000, []
-					{
-						info_trace_line("timer2 ", 3);
-					});
+					return fread(&buff[0], 1, blockSize, syncFile);
 				});
-			});
-			timer3->timeout(1500, [timer3]
+				if (!s)
+				{
+					break;
+				}
+				syncBytes += s;
+			}
+			const long long syncTm = get_tick_us() - tk;
+			if (syncFile)
 			{
-				info_trace_line("timer3 ", 1);
-				timer3->timeout(1000, [timer3]
+				fclose(syncFile);
+			}
+			trace_line("block ", blockSize / 1024, "kB, async_file ", (size_t)((double)asyncBytes / (double)(asyncTm + 1)), "MB/s, run_in_thread_stack ",
+				(size_t)((double)syncBytes / (double)(syncTm + 1)), "MB/s");
+		}
+		file.close();
+		remove(path);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end async_file_perfor_test");
+}
+
+void handoff_perfor_test()
+{
+	trace_line("begin handoff_perfor_test");
+	io_engine ios;
+	ios.run(1);
+	const int rounds = 1000000;
+	for (int sameStrand = 1; sameStrand >= 0; sameStrand--)
+	{
+		shared_strand strand = boost_strand::create(ios);
+		actor_handle ah = my_actor::create(strand, [&](my_actor* self)
+		{
+			msg_handle<int> pingHandle, pongHandle;
+			msg_notifer<int> pongNtf = self->make_msg_notifer_to_self(pongHandle);
+			child_handle ch = self->create_child(sameStrand ? strand : boost_strand::create(ios), [&](my_actor* self)
+			{
+				for (int i = 0; i < rounds; i++)
 				{
-					info_trace_line("timer3 ", 2);
-					timer3->timeout(1000, []
-					{
-						info_trace_line("timer3 ", 3);
-					});
-				});
+					pongNtf(self->wait_msg(pingHandle));
+				}
 			});
+			msg_notifer<int> pingNtf = self->make_msg_notifer_to(ch, pingHandle);
+			self->child_run(ch);
+			long long tk = get_tick_us();
+			for (int i = 0; i < rounds; i++)
+			{
+				pingNtf(i);
+				self->wait_msg(pongHandle);
+			}
+			tk = get_tick_us() - tk;
+			self->child_wait_quit(ch);
+			self->close_msg_notifer(pongHandle);
+			trace_line(sameStrand ? "actor same strand" : "actor cross strand", ", round trip ", (int)((double)tk * 1000 / rounds), "ns");
 		});
+		ah->run();
+		ah->outside_wait_quit();
+	}
+	for (int sameStrand = 1; sameStrand >= 0; sameStrand--)
+	{
+		shared_strand strand = boost_strand::create(ios);
+		std::shared_ptr<co_channel<int>> pingChan = std::make_shared<co_channel<int>>(strand, 1);
+		std::shared_ptr<co_channel<int>> pongChan = std::make_shared<co_channel<int>>(strand, 1);
+		std::mutex mutex;
+		std::condition_variable conVar;
+		int doneCount = 0;
+		auto doneNtf = [&]
+		{
+			std::lock_guard<std::mutex> lg(mutex);
+			if (2 == ++doneCount)
+			{
+				conVar.notify_one();
+			}
+		};
+		long long tk = get_tick_us();
+		co_go(sameStrand ? strand : boost_strand::create(ios), doneNtf)[&](co_generator)
+		{
+			co_begin_context;
+			int i;
+			int res;
+			co_use_state;
+			co_end_context(ctx);
+
+			co_begin;
+			for (ctx.i = 0; ctx.i < rounds; ctx.i++)
+			{
+				co_chan_io(*pingChan) >> ctx.res;
+				co_chan_io(*pongChan) << ctx.res;
+			}
+			co_end;
+		};
+		co_go(strand, doneNtf)[&](co_generator)
+		{
+			co_begin_context;
+			int i;
+			int res;
+			co_use_state;
+			co_end_context(ctx);
+
+			co_begin;
+			for (ctx.i = 0; ctx.i < rounds; ctx.i++)
+			{
+				co_chan_io(*pingChan) << ctx.i;
+				co_chan_io(*pongChan) >> ctx.res;
+			}
+			co_end;
+		};
+		{
+			std::unique_lock<std::mutex> ul(mutex);
+			while (2 != doneCount)
+			{
+				conVar.wait(ul);
+			}
+		}
+		tk = get_tick_us() - tk;
+		trace_line(sameStrand ? "generator same strand" : "generator cross strand", ", round trip ", (int)((double)tk * 1000 / rounds), "ns");
 	}
 	ios.stop();
-	trace_line("end async_timer_test");
+	trace_line("end handoff_perfor_test");
 }
 
-void create_child_test()
+#ifdef ENABLE_ACTOR_PROFILE
+void actor_profile_test()
 {
-	trace_line("begin create_child_test");
+	trace_line("begin actor_profile_test");
 	io_engine ios;
-	ios.run();
-	int count = 0;
-	actor_recursive(createActor, self)
+	ios.run(2);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [](my_actor* self)
 	{
-		if (++count < 100)
+		child_handle yieldChild = self->create_child([](my_actor* self)
 		{
-			info_trace_line("create_child ", count);
-			child_handle child1 = self->create_child([&](my_actor* self)
+			for (int i = 0; i < 100000; i++)
 			{
-				self->sleep(1000);
-				createActor(self);
-			});
-			child_handle child2 = self->create_child([&](my_actor* self)
+				self->yield();
+			}
+		});
+		child_handle sleepChild = self->create_child([](my_actor* self)
+		{
+			for (int i = 0; i < 100; i++)
 			{
-				self->sleep(1000);
-				createActor(self);
-			});
-			self->child_run(child1, child2);
-			self->child_wait_quit(child1, child2);
+				self->sleep(10);
+			}
+		});
+		self->child_run(yieldChild);
+		self->child_run(sleepChild);
+		self->child_wait_quit(yieldChild);
+		//sleepChild还在运行，它的统计也应该已经提交
+		bool liveFound = false;
+		for (auto& ele : my_actor::profile_table())
+		{
+			liveFound |= ele.first == sleepChild.get_actor()->self_key();
 		}
-		self->after_exit_clean_stack();
-	};
-	my_actor::create(boost_strand::create(ios), wrap_ref_handler(createActor))->run();
+		assert(liveFound);
+		trace_line("live actor in profile table: ", liveFound ? "yes" : "no");
+		self->child_wait_quit(sleepChild);
+		trace_line("yield actor key=", yieldChild.get_actor()->self_key(), ", sleep actor key=", sleepChild.get_actor()->self_key());
+	});
+	ah->run();
+	ah->outside_wait_quit();
 	ios.stop();
-	trace_line("end create_child_test");
+	trace(my_actor::profile_csv());
+	trace(my_actor::profile_folded());
+	trace_line("end actor_profile_test");
 }
+#endif
 
-void suspend_test()
+struct ping_pong_state
 {
-	trace_line("begin suspend_test");
-	io_engine ios;
-	ios.run();
-	go(ios)[](my_actor* self)
+	void ping(size_t side)
 	{
-		child_handle child = self->create_child([](my_actor* self)
+		strands[side]->post([this, side]
 		{
-			child_handle child = self->create_child([](my_actor* self)
+			if (++count == rounds)
 			{
-				int i = 0;
-				self->sleep(300);
-				info_trace_comma("---child2", i++);
-				info_trace_line("---lock_suspend");
-				self->lock_suspend();
-				for (int j = 0; j < 10; j++)
+				std::lock_guard<std::mutex> lg(*mutex);
+				if (0 == --*remain)
 				{
-					self->sleep(100);
-					info_trace_comma("---child2", i++);
+					conVar->notify_one();
 				}
-				info_trace_line("---begin_unlock_suspend");
-				self->unlock_suspend();
-				info_trace_line("---end_unlock_suspend");
-				info_trace_comma("---child2", i++);
-				self->sleep(100);
-			});
-			self->child_run(child);
-			int i = 0;
-			self->sleep(100);
-			info_trace_comma("--child1", i++);
-			self->sleep(300);
-			info_trace_comma("--child1", i++);
-			self->sleep(300);
-			info_trace_comma("--child1", i++);
-			self->child_wait_quit(child);
+			}
+			else
+			{
+				ping(1 - side);
+			}
 		});
-		self->child_run(child);
-		self->sleep(500);
-		info_trace_line("-begin suspend");
-		self->child_suspend(child);
-		info_trace_line("-end suspend");
-		self->sleep(1500);
-		info_trace_line("-begin resume");
-		self->child_resume(child);
-		info_trace_line("-end resume");
-		self->child_wait_quit(child);
-	};
-	ios.stop();
-	trace_line("end suspend_test");
-}
+	}
 
-void auto_stack_test()
+	shared_strand strands[2];
+	size_t count = 0;
+	size_t rounds = 0;
+	size_t* remain = NULL;
+	std::mutex* mutex = NULL;
+	std::condition_variable* conVar = NULL;
+};
+
+void shard_perfor_test()
 {
-	trace_line("begin auto_stack_test");
-	io_engine ios;
-	ios.run();
-	for (int i = 0; i < 3; i++)
+	trace_line("begin shard_perfor_test");
+	const size_t threads = run_thread::cpu_thread_number();
+	const size_t pairs = threads * 4;
+	const size_t rounds = 200000;
+	const char* names[] = { "run", "runShard same shard", "runShard cross shard" };
+	for (int mode = 0; mode < 3; mode++)
 	{
-		actor_handle ah = my_actor::create(boost_strand::create(ios), auto_stack_[i](my_actor* self)
+		io_engine ios;
+		if (0 == mode)
 		{
-			int count = 0;
-			HEARTBEAT_EXEC(self, 300, trace_space("heartbeat", i, count++));
-			self->sleep(1000);
-		});
-		ah->run();
-		ah->outside_wait_quit();
-		trace_line("stack size:", ah->stack_size(), ", using size:", ah->using_stack_size());
+			ios.run(threads);
+		}
+		else
+		{
+			ios.runShard(threads);
+		}
+		std::mutex mutex;
+		std::condition_variable conVar;
+		size_t remain = pairs;
+		std::vector<ping_pong_state> states(pairs);
+		for (size_t i = 0; i < pairs; i++)
+		{
+			ping_pong_state& st = states[i];
+			st.rounds = rounds;
+			st.remain = &remain;
+			st.mutex = &mutex;
+			st.conVar = &conVar;
+			st.strands[0] = 0 == mode ? boost_strand::create(ios) : boost_strand::create(ios, i % threads);
+			st.strands[1] = 0 == mode ? boost_strand::create(ios) : boost_strand::create(ios, (2 == mode ? i + 1 : i) % threads);
+		}
+		long long tk = get_tick_us();
+		for (size_t i = 0; i < pairs; i++)
+		{
+			states[i].ping(0);
+		}
+		{
+			std::unique_lock<std::mutex> ul(mutex);
+			while (remain)
+			{
+				conVar.wait(ul);
+			}
+		}
+		tk = get_tick_us() - tk;
+		trace_line(names[mode], ", threads=", threads, ", msgs/s=", (size_t)((double)pairs * rounds * 1000000 / (double)(tk + 1)));
+		states.clear();
+		ios.stop();
 	}
-	ios.stop();
-	trace_line("end auto_stack_test");
+	trace_line("end shard_perfor_test");
 }
 
-void co_perfor_test()
+void reuse_port_accept_perfor_test()
 {
-	trace_line("begin co_perfor_test");
-	io_engine ios;
-	ios.run(run_thread::cpu_thread_number());
-	std::vector<size_t> count(ios.ioThreads());
-	std::vector<shared_strand> strands = boost_strand::create_multi(ios.ioThreads(), ios);
-	std::list<generator_handle> gens;
-	size_t num = 1000;
-	for (size_t i = 0; i < ios.ioThreads(); i++)
+	trace_line("begin reuse_port_accept_perfor_test");
+	const size_t threads = run_thread::cpu_thread_number();
+	const size_t clients = threads * 4;
+	const size_t connects = 1000;
+	const unsigned short port = 1236;
+	const char* names[] = { "tcp_acceptor accept", "tcp_shard_acceptor accept_many" };
+	for (int mode = 0; mode < 2; mode++)
 	{
-		for (size_t j = 0; j < num; j++)
+		io_engine ios;
+		ios.runShard(threads);
+		std::atomic<size_t> accepted(0);
+		actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
 		{
-			generator_handle gen = co_go(strands[i])[&count, i](co_generator)
+			tcp_acceptor acc(self->self_io_engine());
+			tcp_shard_acceptor shardAcc(self->self_io_engine());
+			child_handle srv;
+			if (0 == mode)
 			{
-				co_no_context;
-
+				if (!acc.open_v4(port).ok)
+				{
+					trace_line("server port conflict");
+					return;
+				}
+				srv = self->create_child([&](my_actor* self)
+				{
+					while (true)
+					{
+						tcp_socket sck(self->self_io_engine());
+						if (!acc.accept(self, sck).ok)
+						{
+							break;
+						}
+						accepted++;
+						sck.close();
+					}
+				});
+				self->child_run(srv);
+			}
+			else
+			{
+				if (!shardAcc.open_v4(port).ok)
+				{
+					trace_line("server port conflict");
+					return;
+				}
+				shardAcc.start([&](const shared_strand&, tcp_socket::native_handle sck, bool)
+				{
+					accepted++;
+					tcp_socket::close_native(sck);
+				});
+			}
+			std::list<child_handle> clis;
+			for (size_t i = 0; i < clients; i++)
+			{
+				clis.push_back(self->create_child(boost_strand::create(self->self_io_engine(), i % threads), [&](my_actor* self)
+				{
+					for (size_t j = 0; j < connects; j++)
+					{
+						tcp_socket sck(self->self_io_engine());
+						sck.connect(self, "127.0.0.1", port);
+						sck.close();
+					}
+				}));
+			}
+			long long tk = get_tick_us();
+			self->children_run(clis);
+			self->children_wait_quit(clis);
+			while (accepted < clients * connects)
+			{
+				self->sleep(1);
+				if (get_tick_us() - tk > 10000000)
+				{
+					break;
+				}
+			}
+			tk = get_tick_us() - tk;
+			trace_line(names[mode], ", threads=", threads, ", accepted=", (size_t)accepted, ", connects/s=", (size_t)((double)accepted * 1000000 / (double)(tk + 1)));
+			if (0 == mode)
+			{
+				acc.close();
+				self->child_wait_quit(srv);
+			}
+			else
+			{
+				shardAcc.close(self);
+			}
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		ios.stop();
+	}
+	trace_line("end reuse_port_accept_perfor_test");
+}
+
+void udp_gso_perfor_test()
+{
+	trace_line("begin udp_gso_perfor_test");
+	const size_t segSize = 1200;
+	const size_t segs = 40;
+	const size_t rounds = 20000;
+	const char* names[] = { "send per datagram", "send_segments(GSO)" };
+	for (int mode = 0; mode < 2; mode++)
+	{
+		io_engine ios;
+		ios.run(2);
+		actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+		{
+			udp_socket receiver(self->self_io_engine());
+			if (!receiver.open_bind_v4(1237).ok)
+			{
+				trace_line("udp port conflict");
+				return;
+			}
+			const bool gro = receiver.enable_gro().ok;
+			size_t recvBytes = 0;
+			child_handle recv = self->create_child([&](my_actor* self)
+			{
+				std::vector<char> buff(65536);
+				size_t segmentSize = 0;
+				while (true)
+				{
+					udp_socket::result res = receiver.receive_segments(self, &buff.front(), buff.size(), segmentSize);
+					if (!res.ok)
+					{
+						break;
+					}
+					recvBytes += res.s;
+				}
+			});
+			self->child_run(recv);
+			udp_socket sender(self->self_io_engine());
+			sender.open_v4();
+			sender.connect("127.0.0.1", 1237);
+			std::vector<char> data(segSize * segs);
+			long long tk = get_tick_us();
+			for (size_t i = 0; i < rounds; i++)
+			{
+				if (0 == mode)
+				{
+					for (size_t j = 0; j < segs; j++)
+					{
+						sender.send(self, &data[j * segSize], segSize);
+					}
+				}
+				else
+				{
+					sender.send_segments(self, &data.front(), data.size(), segSize);
+				}
+			}
+			tk = get_tick_us() - tk;
+			trace_line(names[mode], ", gro=", gro, ", datagrams/s=", (size_t)((double)rounds * segs * 1000000 / (double)(tk + 1)), ", received bytes=", recvBytes);
+			self->sleep(100);
+			sender.close();
+			receiver.close();
+			self->child_wait_quit(recv);
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		ios.stop();
+	}
+	trace_line("end udp_gso_perfor_test");
+}
+
+void udp_batch_perfor_test()
+{
+	trace_line("begin udp_batch_perfor_test");
+	const size_t packets = 500000;
+	const char* names[] = { "receive_from", "receive_batch" };
+	for (int mode = 0; mode < 2; mode++)
+	{
+		io_engine ios;
+		ios.run(2);
+		actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+		{
+			udp_socket receiver(self->self_io_engine());
+			if (!receiver.open_bind_v4(1238).ok)
+			{
+				trace_line("udp port conflict");
+				return;
+			}
+			child_handle sender = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+			{
+				udp_socket sck(self->self_io_engine());
+				sck.open_v4();
+				sck.connect("127.0.0.1", 1238);
+				char buf[256] = { 0 };
+				const void* buffs[32];
+				size_t lengths[32];
+				for (size_t i = 0; i < 32; i++)
+				{
+					buffs[i] = buf;
+					lengths[i] = sizeof(buf);
+				}
+				for (size_t i = 0; i < packets; i += 32)
+				{
+					if (!sck.try_msend(buffs, lengths, 32).ok)
+					{
+						self->yield();
+					}
+				}
+				sck.close();
+			});
+			size_t count = 0;
+			long long tk = get_tick_us();
+			long long lastTk = tk;
+			self->child_run(sender);
+			if (0 == mode)
+			{
+				char buf[2048];
+				while (receiver.timed_receive_from(self, 300, buf, sizeof(buf)).ok)
+				{
+					count++;
+					lastTk = get_tick_us();
+				}
+			}
+			else
+			{
+				udp_socket::datagram dgs[64];
+				while (true)
+				{
+					udp_socket::result res = receiver.timed_receive_batch(self, 300, fixed_array_length(dgs), dgs);
+					if (!res.ok)
+					{
+						break;
+					}
+					count += res.s;
+					lastTk = get_tick_us();
+				}
+			}
+			self->child_wait_quit(sender);
+			trace_line(names[mode], ", received=", count, ", datagrams/s=", (size_t)((double)count * 1000000 / (double)(lastTk - tk + 1)));
+			receiver.close();
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		ios.stop();
+	}
+	trace_line("end udp_batch_perfor_test");
+}
+
+void tcp_cork_perfor_test()
+{
+	trace_line("begin tcp_cork_perfor_test");
+	const size_t rounds = 100000;
+	const char header[] = "HTTP/1.1 200 OK\r\nContent-Length: 64\r\n\r\n";
+	const char body[64] = { 0 };
+	const char trailer[] = "\r\n";
+	const size_t total = rounds * (sizeof(header) - 1 + sizeof(body) + sizeof(trailer) - 1);
+	//0: 不合并，每段依次write；1: 合并，两段async_write加一次write；2: 合并，每段依次write(拷贝排队后立即返回)
+	const char* names[] = { "write", "cork async_write", "cork write" };
+	for (int mode = 0; mode < 3; mode++)
+	{
+		io_engine ios;
+		ios.run(2);
+		actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+		{
+			tcp_acceptor acc(self->self_io_engine());
+			if (!acc.open("127.0.0.1", 1239).ok)
+			{
+				trace_line("server port conflict");
+				return;
+			}
+			child_handle srv = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+			{
+				tcp_socket sck(self->self_io_engine());
+				if (acc.accept(self, sck).ok)
+				{
+					std::vector<char> buf(64 * 1024);
+					size_t recvBytes = 0;
+					while (recvBytes < total)
+					{
+						tcp_socket::result res = sck.read_some(self, &buf.front(), buf.size());
+						if (!res.ok)
+						{
+							break;
+						}
+						recvBytes += res.s;
+					}
+				}
+				sck.close();
+			});
+			self->child_run(srv);
+			tcp_socket sck(self->self_io_engine());
+			if (sck.connect(self, "127.0.0.1", 1239).ok)
+			{
+				sck.no_delay();
+				if (0 != mode)
+				{
+					sck.cork(self->self_strand());
+				}
+				long long tk = get_tick_us();
+				for (size_t i = 0; i < rounds; i++)
+				{
+					if (1 == mode)
+					{
+						sck.async_write(header, sizeof(header) - 1, [](const tcp_socket::result&) {});
+						sck.async_write(body, sizeof(body), [](const tcp_socket::result&) {});
+					}
+					else if (!sck.write(self, header, sizeof(header) - 1).ok || !sck.write(self, body, sizeof(body)).ok)
+					{
+						break;
+					}
+					if (!sck.write(self, trailer, sizeof(trailer) - 1).ok)
+					{
+						break;
+					}
+				}
+				sck.flush(self);
+				self->child_wait_quit(srv);
+				tk = get_tick_us() - tk;
+				trace_line(names[mode], ", responses/s=", (size_t)((double)rounds * 1000000 / (double)(tk + 1)));
+			}
+			sck.close();
+			acc.close();
+			self->child_wait_quit(srv);
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		ios.stop();
+	}
+	trace_line("end tcp_cork_perfor_test");
+}
+
+void relay_perfor_test()
+{
+	trace_line("begin relay_perfor_test");
+	const size_t total = 1024 * 1024 * 1024;
+	const char* names[] = { "read/write relay", "splice relay" };
+	for (int mode = 0; mode < 2; mode++)
+	{
+		io_engine ios;
+		ios.run(3);
+		actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+		{
+			tcp_acceptor proxyAcc(self->self_io_engine());
+			tcp_acceptor sinkAcc(self->self_io_engine());
+			if (!proxyAcc.open("127.0.0.1", 1240).ok || !sinkAcc.open("127.0.0.1", 1241).ok)
+			{
+				trace_line("server port conflict");
+				return;
+			}
+			child_handle sink = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+			{
+				tcp_socket sck(self->self_io_engine());
+				if (sinkAcc.accept(self, sck).ok)
+				{
+					std::vector<char> buf(256 * 1024);
+					while (sck.read_some(self, &buf.front(), buf.size()).ok) {}
+				}
+				sck.close();
+			});
+			child_handle proxy = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+			{
+				tcp_socket src(self->self_io_engine());
+				tcp_socket dst(self->self_io_engine());
+				if (proxyAcc.accept(self, src).ok && dst.connect(self, "127.0.0.1", 1241).ok)
+				{
+					if (0 == mode)
+					{
+						std::vector<char> buf(64 * 1024);
+						while (true)
+						{
+							tcp_socket::result res = src.read_some(self, &buf.front(), buf.size());
+							if (!res.ok || !dst.write(self, &buf.front(), res.s).ok)
+							{
+								break;
+							}
+						}
+					}
+					else
+					{
+						src.relay(self, dst);
+					}
+				}
+				src.close();
+				dst.close();
+			});
+			self->child_run(sink, proxy);
+			tcp_socket sck(self->self_io_engine());
+			if (sck.connect(self, "127.0.0.1", 1240).ok)
+			{
+				std::vector<char> buf(256 * 1024);
+				long long tk = get_tick_us();
+				for (size_t sendBytes = 0; sendBytes < total; sendBytes += buf.size())
+				{
+					if (!sck.write(self, &buf.front(), buf.size()).ok)
+					{
+						break;
+					}
+				}
+				sck.close();
+				self->child_wait_quit(proxy, sink);
+				tk = get_tick_us() - tk;
+				trace_line(names[mode], ", MB/s=", (size_t)((double)total * 1000000 / (1024 * 1024) / (double)(tk + 1)));
+			}
+			sck.close();
+			proxyAcc.close();
+			sinkAcc.close();
+			self->child_wait_quit(proxy, sink);
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		ios.stop();
+	}
+	trace_line("end relay_perfor_test");
+}
+
+void huge_page_perfor_test()
+{
+	trace_line("begin huge_page_perfor_test");
+	//ENABLE_HUGE_PAGE下每个栈独占一个大页，Actor数量不宜太多
+	const int actorCount = 256;
+	const int rounds = 10000;
+	io_engine ios;
+	ios.run(4);
+	std::vector<shared_strand> strands;
+	for (int i = 0; i < 64; i++)
+	{
+		strands.push_back(boost_strand::create(ios));
+	}
+	std::vector<actor_handle> actors;
+	actors.reserve(actorCount);
+	for (int i = 0; i < actorCount; i++)
+	{
+		actors.push_back(my_actor::create(strands[i % strands.size()], [&](my_actor* self)
+		{
+#ifdef ENABLE_HUGE_PAGE
+			assert(0 == self->stack_total_size() % HUGE_PAGE_SIZE);//栈在大页中
+#endif
+			for (int j = 0; j < rounds; j++)
+			{
+				self->yield();
+			}
+		}));
+	}
+	long long tk = get_tick_us();
+	for (actor_handle& ah : actors)
+	{
+		ah->run();
+	}
+	for (actor_handle& ah : actors)
+	{
+		ah->outside_wait_quit();
+	}
+	tk = get_tick_us() - tk;
+	trace_line("actors ", actorCount, ", switches/s=", (size_t)((double)actorCount * rounds * 1000000 / (double)(tk + 1)));
+#ifdef ENABLE_HUGE_PAGE
+	huge_page::stats_info st = huge_page::stats();
+	trace_line("stack slabs ", st.stackSlabs, ", huge stacks ", st.stackCount, ", 4K stacks ", st.fallbackStacks,
+		", pool slabs ", st.poolSlabs, ", hugetlb ", st.hugetlbBytes / 1024, "KB, thp ", st.thpBytes / 1024, "KB, resident thp ", st.anonHugeBytes / 1024, "KB");
+	assert(0 == st.fallbackStacks);//没有栈退回4K页
+#endif
+	actors.clear();
+	ios.stop();
+	trace_line("end huge_page_perfor_test");
+}
+
+void actor_layout_perfor_test()
+{
+	trace_line("begin actor_layout_perfor_test");
+	trace_line("sizeof(my_actor)=", sizeof(my_actor));
+	const int actorCount = 100000;
+	io_engine ios;
+	ios.run(1);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		long long tk = get_tick_us();
+		for (int i = 0; i < actorCount; i++)
+		{
+			child_handle ch = self->create_child([&](my_actor* self)
+			{
+				self->yield();
+			});
+			self->child_run(ch);
+			self->child_wait_quit(ch);
+		}
+		tk = get_tick_us() - tk;
+		trace_line("child create/run/quit ", (int)((double)tk * 1000 / actorCount), "ns");
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end actor_layout_perfor_test");
+}
+
+void stack_budget_perfor_test()
+{
+	trace_line("begin stack_budget_perfor_test");
+	const int actorCount = 2000;
+	io_engine ios;
+	ios.run(4);
+	shared_strand strand = boost_strand::create(ios);
+	auto printStats = [](const char* title)
+	{
+		ContextPool_::stack_stats st = my_actor::stack_pool_stats();
+		trace_line(title, ": stacks ", st.stackCount, ", idle ", st.idleCount, ", decommit ", st.decommitCount,
+			", idle resident ", st.idleResidentSize / 1024, "KB, rss ", st.processResidentSize / 1024,
+			"KB, budget decommit ", st.budgetDecommitCount, ", budget delete ", st.budgetDeleteCount);
+	};
+	auto runBatch = [&]()->long long
+	{
+		long long tk = get_tick_us();
+		actor_handle ah = my_actor::create(strand, [&](my_actor* self)
+		{
+			std::vector<child_handle> childs;
+			childs.reserve(actorCount);
+			for (int i = 0; i < actorCount; i++)
+			{
+				childs.push_back(self->create_child([](my_actor* self)
+				{
+					volatile char buf[48 * 1024];
+					for (size_t j = 0; j < sizeof(buf); j += 1024)
+					{
+						buf[j] = (char)j;
+					}
+					self->yield();
+				}, 128 * 1024));
+				self->child_run(childs.back());
+			}
+			for (child_handle& ch : childs)
+			{
+				self->child_wait_quit(ch);
+			}
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		return get_tick_us() - tk;
+	};
+	trace_line("cold batch ", runBatch(), "us");
+	printStats("after cold batch");
+	trace_line("warm batch ", runBatch(), "us");
+	my_actor::set_stack_clear_cycle(2, 4);
+	run_thread::sleep(3000);
+	printStats("after lazy free");
+	trace_line("lazy freed batch ", runBatch(), "us");
+	ContextPool_::stack_stats st = my_actor::stack_pool_stats();
+	my_actor::set_stack_rss_budget(st.processResidentSize - st.idleResidentSize / 2);
+	run_thread::sleep(500);
+	printStats("after budget");
+	trace_line("budget reclaimed batch ", runBatch(), "us");
+	my_actor::set_stack_rss_budget(0);
+	my_actor::set_stack_clear_cycle(30, 300);
+	ios.stop();
+	trace_line("end stack_budget_perfor_test");
+}
+
+void elastic_io_perfor_test()
+{
+	trace_line("begin elastic_io_perfor_test");
+	const int bursts = 20;
+	const int burstTasks = 2000;
+	const int taskUs = 50;
+	const int maxThreads = (int)run_thread::cpu_thread_number();
+	const char* names[] = { "fixed 1", "fixed max", "elastic" };
+	for (int mode = 0; mode < 3; mode++)
+	{
+		io_engine ios;
+		if (0 == mode)
+		{
+			ios.run(1);
+		}
+		else if (1 == mode)
+		{
+			ios.run(maxThreads);
+		}
+		else
+		{
+			ios.runElastic(1, maxThreads, 500, 200);
+		}
+		//突发负载：每轮瞬间投递一批计算任务，然后空闲一段时间
+		std::vector<long long> latencys;
+		latencys.reserve(bursts * burstTasks);
+		std::mutex latencyMutex;
+		long long tk = get_tick_us();
+		for (int i = 0; i < bursts; i++)
+		{
+			std::atomic<int> remain(burstTasks);
+			for (int j = 0; j < burstTasks; j++)
+			{
+				const long long postTick = get_tick_us();
+				((boost::asio::io_service&)ios).post([&, postTick]
+				{
+					const long long beginTick = get_tick_us();
+					while (get_tick_us() - beginTick < taskUs) {}
+					{
+						std::lock_guard<std::mutex> lg(latencyMutex);
+						latencys.push_back(beginTick - postTick);
+					}
+					remain--;
+				});
+			}
+			while (remain)
+			{
+				run_thread::sleep(1);
+			}
+			run_thread::sleep(100);
+		}
+		tk = get_tick_us() - tk;
+		std::sort(latencys.begin(), latencys.end());
+		long long total = 0;
+		for (long long ele : latencys)
+		{
+			total += ele;
+		}
+		size_t threads = ios.ioThreads();
+		io_engine::elastic_stats st = ios.elasticStats();
+		trace_line(names[mode], ": tasks/s=", (size_t)((double)latencys.size() * 1000000 / (double)(tk + 1)),
+			", avg latency=", total / (long long)latencys.size(), "us, p99 latency=", latencys[latencys.size() * 99 / 100],
+			"us, threads=", threads, ", spawn=", st.spawnCount, ", retire=", st.retireCount);
+		ios.stop();
+	}
+	trace_line("end elastic_io_perfor_test");
+}
+
+void strand_urgent_perfor_test()
+{
+	trace_line("begin strand_urgent_perfor_test");
+	const int backlog = 100000;
+	io_engine ios;
+	ios.run(2);
+	shared_strand strand = boost_strand::create(ios);
+	for (int mode = 0; mode < 2; mode++)
+	{
+		//先堆积大量普通任务，再投递一个控制任务，测量控制任务的等待时间
+		std::atomic<int> done(0);
+		for (int i = 0; i < backlog; i++)
+		{
+			strand->post([&]
+			{
+				const long long tk = get_tick_us();
+				while (get_tick_us() == tk) {}
+				done++;
+			});
+		}
+		std::atomic<long long> latency(0);
+		const long long postTick = get_tick_us();
+		auto ctrl = [&, postTick]
+		{
+			latency = get_tick_us() - postTick;
+		};
+		if (0 == mode)
+		{
+			strand->post(ctrl);
+		}
+		else
+		{
+			strand->post_urgent(ctrl);
+		}
+		while (backlog != done || !latency)
+		{
+			run_thread::sleep(1);
+		}
+		trace_line(0 == mode ? "post" : "post_urgent", " behind ", backlog, " handlers, latency=", (long long)latency, "us");
+	}
+	ios.stop();
+	trace_line("end strand_urgent_perfor_test");
+}
+
+void time_source_perfor_test()
+{
+	trace_line("begin time_source_perfor_test");
+	const int count = 10000000;
+	io_engine ios;
+	ios.run(1);
+	shared_strand strand = boost_strand::create(ios);
+	std::atomic<bool> finished(false);
+	strand->post([&]
+	{
+		run_thread::sleep(20);
+		trace_line("invariant tsc=", time_source::tsc_invariant(), ", tsc/us=", time_source::tsc_per_us());
+		long long sum = 0;
+		long long tk = get_tick_us();
+		for (int i = 0; i < count; i++)
+		{
+			sum += get_tick_us();
+		}
+		trace_line("get_tick_us ", (get_tick_us() - tk) * 1000 / count, "ns/call");
+		tk = get_tick_us();
+		for (int i = 0; i < count; i++)
+		{
+			sum += time_source::tsc_us();
+		}
+		trace_line("tsc_us ", (get_tick_us() - tk) * 1000 / count, "ns/call");
+		tk = get_tick_us();
+		for (int i = 0; i < count; i++)
+		{
+			sum += time_source::coarse_us();
+		}
+		trace_line("coarse_us ", (get_tick_us() - tk) * 1000 / count, "ns/call");
+		trace_line("tsc_us - get_tick_us=", time_source::tsc_us() - get_tick_us(), "us", sum ? "" : " ");
+		finished = true;
+	});
+	while (!finished)
+	{
+		run_thread::sleep(1);
+	}
+	ios.stop();
+	trace_line("end time_source_perfor_test");
+}
+
+void actor_group_perfor_test()
+{
+	trace_line("begin actor_group_perfor_test");
+	const int msgCount = 1000000;
+	const int batchSize = 64;
+	io_engine ios;
+	ios.run(4);
+	std::atomic<long long> received(0);
+	actor_group<int, int> group(ios, [&](my_actor* self, size_t index)
+	{
+		msg_pump_handle<int> pump = self->connect_msg_pump<int>();
+		msg_pump_handle<actor_group_rebalance> rbPump = self->connect_msg_pump<actor_group_rebalance>();
+		while (true)
+		{
+			if (self->pump_msg(pump) < 0)
+			{
+				//-1 表示随后有一次扩缩容
+				actor_group_rebalance rb = self->pump_msg(rbPump);
+				if (index >= rb.newSize)
+				{
+					break;
+				}
+				continue;
+			}
+			received++;
+		}
+	});
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		auto waitReceived = [&](long long total)
+		{
+			while (received < total)
+			{
+				self->sleep(1);
+			}
+		};
+		group.resize(self, 4);
+		long long tk = get_tick_us();
+		for (int i = 0; i < msgCount; i++)
+		{
+			group.post(i, i);
+		}
+		waitReceived(msgCount);
+		trace_line("post ", msgCount, " msgs to ", group.size(), " members: ", get_tick_us() - tk, "us");
+		tk = get_tick_us();
+		for (int i = 0; i < msgCount; i += batchSize)
+		{
+			std::vector<std::pair<int, std::tuple<int>>> batch;
+			batch.reserve(batchSize);
+			for (int j = i; j < i + batchSize && j < msgCount; j++)
+			{
+				batch.push_back(std::make_pair(j, std::make_tuple(j)));
+			}
+			group.post_batch(std::move(batch));
+		}
+		waitReceived(2 * (long long)msgCount);
+		trace_line("post_batch(", batchSize, ") ", msgCount, " msgs: ", get_tick_us() - tk, "us");
+		//扩容后统计key迁移比例
+		std::vector<size_t> before(10000);
+		for (int i = 0; i < (int)before.size(); i++)
+		{
+			before[i] = group.route(i);
+		}
+		group.broadcast(-1);
+		group.resize(self, 5);
+		size_t moved = 0;
+		for (int i = 0; i < (int)before.size(); i++)
+		{
+			moved += before[i] != group.route(i) ? 1 : 0;
+		}
+		trace_line("resize 4->5 moved ", moved * 100 / before.size(), "% keys");
+		group.broadcast(-1);
+		group.stop(self);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end actor_group_perfor_test");
+}
+
+void parallel_perfor_test()
+{
+	trace_line("begin parallel_perfor_test");
+	const int objCount = 10000;
+	const int objSize = 16 * 1024;
+	io_engine ios;
+	ios.run(4);
+	std::vector<std::vector<unsigned char>> objs(objCount, std::vector<unsigned char>(objSize));
+	for (int i = 0; i < objCount; i++)
+	{
+		for (int j = 0; j < objSize; j++)
+		{
+			objs[i][j] = (unsigned char)(i * 31 + j);
+		}
+	}
+	auto checksum = [&](int i)->unsigned long long
+	{
+		unsigned long long h = 14695981039346656037ULL;
+		for (unsigned char c : objs[i])
+		{
+			h = (h ^ c) * 1099511628211ULL;
+		}
+		return h;
+	};
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		long long tk = get_tick_us();
+		unsigned long long serial = 0;
+		for (int i = 0; i < objCount; i++)
+		{
+			serial ^= checksum(i);
+		}
+		trace_line("serial checksum ", get_tick_us() - tk, "us");
+		tk = get_tick_us();
+		std::vector<unsigned long long> sums(objCount);
+		parallel_for(self, 0, objCount, 64, [&](int i)
+		{
+			sums[i] = checksum(i);
+		});
+		trace_line("parallel_for checksum ", get_tick_us() - tk, "us");
+		tk = get_tick_us();
+		unsigned long long reduced = map_reduce(self, 0, objCount, 64, 0ULL, checksum, [](unsigned long long a, unsigned long long b)
+		{
+			return a ^ b;
+		});
+		trace_line("map_reduce checksum ", get_tick_us() - tk, "us, ", serial == reduced ? "match" : "mismatch");
+		//结果类型不需要默认构造，init只参与一次归约
+		struct sum_value
+		{
+			explicit sum_value(unsigned long long v) :value(v) {}
+			unsigned long long value;
+		};
+		unsigned long long serialSum = 1;
+		for (int i = 0; i < objCount; i++)
+		{
+			serialSum += checksum(i) & 0xFF;
+		}
+		sum_value summed = map_reduce(self, 0, objCount, 64, sum_value(1), [&](int i)
+		{
+			return sum_value(checksum(i) & 0xFF);
+		}, [](const sum_value& a, const sum_value& b)
+		{
+			return sum_value(a.value + b.value);
+		});
+		assert(serialSum == summed.value);
+		trace_line("map_reduce sum with init ", serialSum == summed.value ? "match" : "mismatch");
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end parallel_perfor_test");
+}
+
+void chan_pipeline_perfor_test()
+{
+	trace_line("begin chan_pipeline_perfor_test");
+	const int msgCount = 200000;
+	io_engine ios;
+	ios.run(2);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		auto runChain = [&](channel<int>& src, channel<int>& dst)->long long
+		{
+			long long tk = get_tick_us();
+			child_handle producer = self->create_child([&](my_actor* self)
+			{
+				for (int i = 0; i < msgCount; i++)
+				{
+					src.send(self, i);
+				}
+			});
+			self->child_run(producer);
+			for (int i = 0; i < msgCount; i++)
+			{
+				int msg;
+				dst.take(self, msg);
+			}
+			self->child_wait_quit(producer);
+			return get_tick_us() - tk;
+		};
+		{
+			//三个chan_connector串联
+			channel<int> c1(boost_strand::create(ios), 64), c2(boost_strand::create(ios), 64);
+			channel<int> c3(boost_strand::create(ios), 64), c4(boost_strand::create(ios), 64);
+			chan_connector<channel<int>, channel<int>> conn1(c1, c2), conn2(c2, c3), conn3(c3, c4);
+			trace_line("chan_connector x3 ", runChain(c1, c4), "us");
+			self->trig([&](trig_once_notifer<> ntf){ conn1.disconnect(ntf); });
+			self->trig([&](trig_once_notifer<> ntf){ conn2.disconnect(ntf); });
+			self->trig([&](trig_once_notifer<> ntf){ conn3.disconnect(ntf); });
+		}
+		{
+			//map -> filter 在源strand上融合，via后在另一strand上map
+			channel<int> c1(boost_strand::create(ios), 64), c2(boost_strand::create(ios), 64);
+			chan_pipe_handle pipe = make_chan_pipeline<int>(c1)
+				.map([](int x){ return x * 2; })
+				.filter([](const int& x){ return x >= 0; })
+				.via(boost_strand::create(ios))
+				.map([](int x){ return x / 2; })
+				.to(c2);
+			trace_line("chan_pipeline 3 stages ", runChain(c1, c2), "us");
+			self->trig([&](trig_once_notifer<> ntf){ pipe.stop(ntf); });
+		}
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end chan_pipeline_perfor_test");
+}
+
+void strand_balancer_perfor_test()
+{
+	trace_line("begin strand_balancer_perfor_test");
+	const int actorCount = 8;
+	const int loopCount = 2000;
+	const long long spinUs = 250;
+	io_engine ios;
+	ios.run(4);
+	std::vector<shared_strand> strands = boost_strand::create_multi(4, ios);
+	auto runHot = [&](bool balance)->long long
+	{
+		strand_balancer balancer(strands);
+		long long tk = get_tick_us();
+		actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+		{
+			child_handle balanceActor;
+			if (balance)
+			{
+				balanceActor = self->create_child([&](my_actor* self)
+				{
+					balancer.run(self);
+				});
+				self->child_run(balanceActor);
+			}
+			//全部Actor挤在同一个strand上
+			std::list<actor_handle> hots;
+			for (int i = 0; i < actorCount; i++)
+			{
+				hots.push_back(my_actor::create(strands[0], [&](my_actor* self)
+				{
+					strand_balancer::member_handle mh = balancer.enroll(self);
+					for (int j = 0; j < loopCount; j++)
+					{
+						const long long begin = time_source::tsc_us();
+						while (time_source::tsc_us() - begin < spinUs) {}
+						balancer.balance_point(self, mh);
+						self->yield();
+					}
+					balancer.leave(mh);
+				}));
+				hots.back()->run();
+			}
+			self->actors_wait_quit(hots);
+			balancer.stop();
+			if (balance)
+			{
+				self->child_wait_quit(balanceActor);
+			}
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		tk = get_tick_us() - tk;
+		trace_line(balance ? "balanced " : "unbalanced ", actorCount, " hot actors: ", tk, "us, migrations ", balancer.migrations());
+		return tk;
+	};
+	runHot(false);
+	runHot(true);
+	ios.stop();
+	trace_line("end strand_balancer_perfor_test");
+}
+
+void stack_sampler_perfor_test()
+{
+	trace_line("begin stack_sampler_perfor_test");
+#if (__linux__ && ENABLE_STACK_SAMPLING)
+	const int actorCount = 4;
+	const int loopCount = 200000;
+	io_engine ios;
+	ios.run(actorCount);
+	auto runActors = [&]()->long long
+	{
+		std::atomic<long long> sum(0);
+		long long tk = get_tick_us();
+		std::list<actor_handle> actors;
+		for (int i = 0; i < actorCount; i++)
+		{
+			actors.push_back(my_actor::create(boost_strand::create(ios), [&sum, loopCount](my_actor* self)
+			{
+				long long x = 0;
+				for (int j = 0; j < loopCount; j++)
+				{
+					for (int k = 0; k < 100; k++)
+					{
+						x += (j * k) ^ (x >> 3);
+					}
+					if (0 == j % 1000)
+					{
+						self->yield();
+					}
+				}
+				sum += x;
+			}));
+			actors.back()->run();
+		}
+		for (actor_handle& actor : actors)
+		{
+			actor->outside_wait_quit();
+		}
+		return get_tick_us() - tk;
+	};
+	trace_line("sampling off: ", runActors(), "us");
+	stack_sampler::start(1000);
+	trace_line("sampling 1000Hz: ", runActors(), "us");
+	stack_sampler::stop();
+	const std::string folded = stack_sampler::folded();
+	const stack_sampler::stats_info st = stack_sampler::stats();
+	trace_line("samples ", st.samples, ", in actor ", st.actorSamples, ", dropped ", st.dropped, ", lost ", st.lost);
+	trace_line(folded.substr(0, folded.find('\n')));
+	stack_sampler::reset();
+	ios.stop();
+#else
+	trace_line("ENABLE_STACK_SAMPLING not defined");
+#endif
+	trace_line("end stack_sampler_perfor_test");
+}
+
+void check_lost_perfor_test()
+{
+	trace_line("begin check_lost_perfor_test");
+#ifdef ENABLE_CHECK_LOST
+	const int copyCount = 1000000;
+	io_engine ios;
+	ios.run(2);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		msg_handle<int> amh;
+		msg_notifer<int> ntf = self->make_msg_notifer_to_self(amh, true);
+		long long tk = get_tick_us();
+		for (int i = 0; i < copyCount; i++)
+		{
+			msg_notifer<int> copy = ntf;
+		}
+		trace_line("copy ", copyCount, " check_lost notifers on owner strand: ", get_tick_us() - tk, "us");
+		tk = get_tick_us();
+		self->send(boost_strand::create(ios), [&]
+		{
+			for (int i = 0; i < copyCount; i++)
+			{
+				msg_notifer<int> copy = ntf;
+			}
+		});
+		trace_line("copy ", copyCount, " check_lost notifers on other strand: ", get_tick_us() - tk, "us");
+		//在所属strand复制，在其它strand释放，只在计数第一次为负时投递一次合并
+		std::vector<msg_notifer<int>> copies(copyCount, ntf);
+		tk = get_tick_us();
+		self->send(boost_strand::create(ios), [&]
+		{
+			copies.clear();
+		});
+		trace_line("release ", copyCount, " owner-created check_lost notifers on other strand: ", get_tick_us() - tk, "us");
+		//所有通知句柄释放后检测到丢失
+		ntf.clear();
+		try
+		{
+			self->wait_msg(amh);
+		}
+		catch (ntf_lost_exception&)
+		{
+			trace_line("notifer lost detected");
+		}
+		self->close_msg_notifer(amh);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+#else
+	trace_line("ENABLE_CHECK_LOST not defined");
+#endif
+	trace_line("end check_lost_perfor_test");
+}
+
+void shm_link_perfor_test()
+{
+	trace_line("begin shm_link_perfor_test");
+#ifdef __linux__
+	struct perfor_msg
+	{
+		long long id;
+		char payload[56];
+	};
+	const size_t rounds = 100000;
+	const size_t streamCount = 1000000;
+	io_engine ios;
+	ios.run(2);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		perfor_msg msg = { 0 };
+		tcp_acceptor tcpAcc(self->self_io_engine());
+		if (!tcpAcc.open("127.0.0.1", 1240).ok)
+		{
+			trace_line("server port conflict");
+			return;
+		}
+		child_handle tcpSrv = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+		{
+			perfor_msg msg;
+			tcp_socket sck(self->self_io_engine());
+			if (tcpAcc.accept(self, sck).ok)
+			{
+				sck.no_delay();
+				for (size_t i = 0; i < rounds && sck.read(self, &msg, sizeof(msg)).ok && sck.write(self, &msg, sizeof(msg)).ok; i++) {}
+				for (size_t i = 0; i < streamCount && sck.read(self, &msg, sizeof(msg)).ok; i++) {}
+				sck.write(self, &msg, sizeof(msg));
+			}
+			sck.close();
+		});
+		self->child_run(tcpSrv);
+		tcp_socket sck(self->self_io_engine());
+		if (sck.connect(self, "127.0.0.1", 1240).ok)
+		{
+			sck.no_delay();
+			long long tk = get_tick_us();
+			for (size_t i = 0; i < rounds && sck.write(self, &msg, sizeof(msg)).ok && sck.read(self, &msg, sizeof(msg)).ok; i++) {}
+			trace_line("tcp loopback ping-pong, rtt=", (double)(get_tick_us() - tk) / rounds, "us");
+			tk = get_tick_us();
+			for (size_t i = 0; i < streamCount && sck.write(self, &msg, sizeof(msg)).ok; i++) {}
+			sck.read(self, &msg, sizeof(msg));
+			trace_line("tcp loopback stream, msgs/s=", (size_t)((double)streamCount * 1000000 / (double)(get_tick_us() - tk + 1)));
+		}
+		sck.close();
+		self->child_wait_quit(tcpSrv);
+		tcpAcc.close();
+
+		const char* path = "/tmp/my_actor_shm_link_perfor_test";
+		shm_acceptor shmAcc(self->self_io_engine());
+		if (!shmAcc.open(path).ok)
+		{
+			trace_line("open ", path, " failed");
+			return;
+		}
+		child_handle shmSrv = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+		{
+			perfor_msg msg;
+			std::shared_ptr<shm_link> link = shm_link::create(self->self_strand());
+			if (shmAcc.accept(self, link).ok)
+			{
+				for (size_t i = 0; i < rounds && link->receive_msg(self, msg).ok && link->send_msg(self, 0, msg).ok; i++) {}
+				for (size_t i = 0; i < streamCount && link->receive_msg(self, msg).ok; i++) {}
+				link->send_msg(self, 0, msg);
+				for (size_t i = 0; i < streamCount && link->receive_msg(self, msg).ok; i++) {}
+				link->send_msg(self, 0, msg);
+			}
+			link->close();
+		});
+		self->child_run(shmSrv);
+		std::shared_ptr<shm_link> link = shm_link::create(self->self_strand());
+		if (link->connect(self, path).ok)
+		{
+			long long tk = get_tick_us();
+			for (size_t i = 0; i < rounds && link->send_msg(self, 0, msg).ok && link->receive_msg(self, msg).ok; i++) {}
+			trace_line("shm_link ping-pong, rtt=", (double)(get_tick_us() - tk) / rounds, "us");
+			tk = get_tick_us();
+			for (size_t i = 0; i < streamCount; i++)
+			{
+				msg.id = i;
+				if (!link->send_msg(self, 0, msg).ok)
+				{
+					break;
+				}
+			}
+			link->receive_msg(self, msg);
+			trace_line("shm_link stream, msgs/s=", (size_t)((double)streamCount * 1000000 / (double)(get_tick_us() - tk + 1)));
+			shm_post_msg<perfor_msg> post = link->make_post_msg<perfor_msg>();
+			size_t retries = 0;
+			tk = get_tick_us();
+			for (size_t i = 0; i < streamCount; i++)
+			{
+				msg.id = i;
+				shm_link::result res;
+				while (shm_link::would_block(res = post(msg)))
+				{
+					retries++;
+					self->yield();
+				}
+				if (!res.ok)
+				{
+					break;
+				}
+			}
+			link->receive_msg(self, msg);
+			trace_line("shm_link bounded post stream, msgs/s=", (size_t)((double)streamCount * 1000000 / (double)(get_tick_us() - tk + 1)), ", retries=", retries);
+		}
+		link->close();
+		self->child_wait_quit(shmSrv);
+		shmAcc.close();
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+#else
+	trace_line("shm_link requires linux");
+#endif
+	trace_line("end shm_link_perfor_test");
+}
+
+void remote_actor_perfor_test()
+{
+	trace_line("begin remote_actor_perfor_test");
+	const size_t sizes[] = { 16, 256, 4096 };
+	const size_t window = 1000;
+	io_engine ios;
+	ios.run(2);
+	remote_node nodeA(ios, "A");
+	remote_node nodeB(ios, "B");
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		if (!nodeB.listen("127.0.0.1", 1241).ok)
+		{
+			trace_line("server port conflict");
+			return;
+		}
+		post_actor_msg<int> readyNtf = self->connect_msg_notifer_to_self<int>();
+		child_handle sink = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+		{
+			nodeB.bind(self, "sink");
+			msg_pump_handle<remote_msg> pump = self->connect_msg_pump<remote_msg>();
+			readyNtf(0);
+			std::vector<long long> lats;
+			for (size_t size : sizes)
+			{
+				const size_t count = window * (size < 1024 ? 200 : 20);
+				lats.clear();
+				lats.reserve(count);
+				for (size_t i = 0; i < count; i++)
+				{
+					remote_msg msg = self->pump_msg(pump);
+					long long tk = 0;
+					memcpy(&tk, msg.body.data(), sizeof(tk));
+					lats.push_back(get_tick_us() - tk);
+					if (0 == (i + 1) % window)
+					{
+						remote_node::send(msg.from, "src", 0, std::string());
+					}
+				}
+				std::sort(lats.begin(), lats.end());
+				trace_line("remote_actor ", size, " bytes, p50=", lats[lats.size() / 2], "us p99=", lats[lats.size() * 99 / 100], "us");
+			}
+			nodeB.unbind("sink");
+		});
+		msg_pump_handle<int> readyPump = self->connect_msg_pump<int>();
+		self->child_run(sink);
+		self->pump_msg(readyPump);
+		nodeA.bind(self, "src");
+		msg_pump_handle<remote_msg> ackPump = self->connect_msg_pump<remote_msg>();
+		remote_node::peer_handle peer = nodeA.connect(self, "127.0.0.1", 1241);
+		if (peer)
+		{
+			for (size_t size : sizes)
+			{
+				const size_t count = window * (size < 1024 ? 200 : 20);
+				std::string body(size, '\0');
+				size_t acked = 0;
+				long long tk = get_tick_us();
+				for (size_t i = 0; i < count; i++)
+				{
+					long long now = get_tick_us();
+					memcpy(&body[0], &now, sizeof(now));
+					remote_node::send(peer, "sink", 1, std::string(body));
+					//最多两个窗口在途
+					while (i + 1 - acked * window > 2 * window)
+					{
+						self->pump_msg(ackPump);
+						acked++;
+					}
+				}
+				while (acked < count / window)
+				{
+					self->pump_msg(ackPump);
+					acked++;
+				}
+				trace_line("remote_actor ", size, " bytes, msgs/s=", (size_t)((double)count * 1000000 / (double)(get_tick_us() - tk + 1)));
+			}
+			self->child_wait_quit(sink);
+		}
+		else
+		{
+			trace_line("connect failed");
+			self->child_force_quit(sink);
+		}
+		nodeA.unbind("src");
+		nodeA.stop(self);
+		nodeB.stop(self);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end remote_actor_perfor_test");
+}
+
+void csp_window_perfor_test()
+{
+	trace_line("begin csp_window_perfor_test");
+	const size_t count = 1000000;
+	const size_t windows[] = { 1, 8, 64 };
+	io_engine ios;
+	ios.run(2);
+	actor_handle ah = my_actor::create(boost_strand::create(ios), [&](my_actor* self)
+	{
+		csp_channel<int(int)> csp(boost_strand::create(self->self_io_engine()));
+		child_handle server = self->create_child(boost_strand::create(self->self_io_engine()), [&](my_actor* self)
+		{
+			try
+			{
+				while (true)
+				{
+					csp.wait_batch(self, 64, [](int i)
+					{
+						return i + 1;
+					});
+				}
+			}
+			catch (channel_io_exception&) {}
+		});
+		self->child_run(server);
+		long long tk = get_tick_us();
+		for (size_t i = 0; i < count; i++)
+		{
+			csp.send(self, (int)i);
+		}
+		trace_line("csp_channel send, calls/s=", (size_t)((double)count * 1000000 / (double)(get_tick_us() - tk + 1)));
+		for (size_t window : windows)
+		{
+			csp_window<int> win(self, window);
+			std::vector<csp_future<int>> futs(window);
+			tk = get_tick_us();
+			for (size_t i = 0; i < count; i++)
+			{
+				csp_future<int>& fut = futs[i % window];
+				if (fut.pending())
+				{
+					fut.get(self);
+				}
+				win.send(self, fut, csp, (int)i);
+			}
+			for (csp_future<int>& fut : futs)
+			{
+				if (fut.pending())
+				{
+					fut.get(self);
+				}
+			}
+			trace_line("csp_window ", window, ", calls/s=", (size_t)((double)count * 1000000 / (double)(get_tick_us() - tk + 1)));
+		}
+		csp.close();
+		self->child_wait_quit(server);
+	});
+	ah->run();
+	ah->outside_wait_quit();
+	ios.stop();
+	trace_line("end csp_window_perfor_test");
+}
+
+void async_timer_test()
+{
+	trace_line("begin async_timer_test");
+	io_engine ios;
+	ios.run();
+	{
+		shared_strand strand = boost_strand::create(ios);
+		async_timer timer1 = strand->make_timer();
+		async_timer timer2 = strand->make_timer();
+		async_timer timer3 = strand->make_timer();
+		strand->post([=]
+		{
+			const shared_strand& lockStrand = strand;
+			timer1->timeout(500, [timer1]
+			{
+				info_trace_line("timer1 ", 1);
+				timer1->timeout(1000, [timer1]
+				{
+					info_trace_line("timer1 ", 2);
+					timer1->timeout(1000, []
+					{
+						info_trace_line("timer1 ", 3);
+					});
+				});
+			});
+			timer2->timeout(1000, [timer2]
+			{
+				info_trace_line("timer2 ", 1);
+				timer2->timeout(1000, [timer2]
+				{
+					info_trace_line("timer2 ", 2);
+					timer2->timeout(1000, []
+					{
+						info_trace_line("timer2 ", 3);
+					});
+				});
+			});
+			timer3->timeout(1500, [timer3]
+			{
+				info_trace_line("timer3 ", 1);
+				timer3->timeout(1000, [timer3]
+				{
+					info_trace_line("timer3 ", 2);
+					timer3->timeout(1000, []
+					{
+						info_trace_line("timer3 ", 3);
+					});
+				});
+			});
+		});
+	}
+	ios.stop();
+	trace_line("end async_timer_test");
+}
+
+void create_child_test()
+{
+	trace_line("begin create_child_test");
+	io_engine ios;
+	ios.run();
+	int count = 0;
+	actor_recursive(createActor, self)
+	{
+		if (++count < 100)
+		{
+			info_trace_line("create_child ", count);
+			child_handle child1 = self->create_child([&](my_actor* self)
+			{
+				self->sleep(1000);
+				createActor(self);
+			});
+			child_handle child2 = self->create_child([&](my_actor* self)
+			{
+				self->sleep(1000);
+				createActor(self);
+			});
+			self->child_run(child1, child2);
+			self->child_wait_quit(child1, child2);
+		}
+		self->after_exit_clean_stack();
+	};
+	my_actor::create(boost_strand::create(ios), wrap_ref_handler(createActor))->run();
+	ios.stop();
+	trace_line("end create_child_test");
+}
+
+void suspend_test()
+{
+	trace_line("begin suspend_test");
+	io_engine ios;
+	ios.run();
+	go(ios)[](my_actor* self)
+	{
+		child_handle child = self->create_child([](my_actor* self)
+		{
+			child_handle child = self->create_child([](my_actor* self)
+			{
+				int i = 0;
+				self->sleep(300);
+				info_trace_comma("---child2", i++);
+				info_trace_line("---lock_suspend");
+				self->lock_suspend();
+				for (int j = 0; j < 10; j++)
+				{
+					self->sleep(100);
+					info_trace_comma("---child2", i++);
+				}
+				info_trace_line("---begin_unlock_suspend");
+				self->unlock_suspend();
+				info_trace_line("---end_unlock_suspend");
+				info_trace_comma("---child2", i++);
+				self->sleep(100);
+			});
+			self->child_run(child);
+			int i = 0;
+			self->sleep(100);
+			info_trace_comma("--child1", i++);
+			self->sleep(300);
+			info_trace_comma("--child1", i++);
+			self->sleep(300);
+			info_trace_comma("--child1", i++);
+			self->child_wait_quit(child);
+		});
+		self->child_run(child);
+		self->sleep(500);
+		info_trace_line("-begin suspend");
+		self->child_suspend(child);
+		info_trace_line("-end suspend");
+		self->sleep(1500);
+		info_trace_line("-begin resume");
+		self->child_resume(child);
+		info_trace_line("-end resume");
+		self->child_wait_quit(child);
+	};
+	ios.stop();
+	trace_line("end suspend_test");
+}
+
+void auto_stack_test()
+{
+	trace_line("begin auto_stack_test");
+	io_engine ios;
+	ios.run();
+	for (int i = 0; i < 3; i++)
+	{
+		actor_handle ah = my_actor::create(boost_strand::create(ios), auto_stack_[i](my_actor* self)
+		{
+			int count = 0;
+			HEARTBEAT_EXEC(self, 300, trace_space("heartbeat", i, count++));
+			self->sleep(1000);
+		});
+		ah->run();
+		ah->outside_wait_quit();
+		trace_line("stack size:", ah->stack_size(), ", using size:", ah->using_stack_size());
+	}
+	ios.stop();
+	trace_line("end auto_stack_test");
+}
+
+void co_perfor_test()
+{
+	trace_line("begin co_perfor_test");
+	io_engine ios;
+	ios.run(run_thread::cpu_thread_number());
+	std::vector<size_t> count(ios.ioThreads());
+	std::vector<shared_strand> strands = boost_strand::create_multi(ios.ioThreads(), ios);
+	std::list<generator_handle> gens;
+	size_t num = 1000;
+	for (size_t i = 0; i < ios.ioThreads(); i++)
+	{
+		for (size_t j = 0; j < num; j++)
+		{
+			generator_handle gen = co_go(strands[i])[&count, i](co_generator)
+			{
+				co_no_context;
+
 				co_begin;
 				while (true)
 				{
@@ -1221,6 +2945,77 @@ void co_select_msg_test()
 	trace_line("end co_select_msg_test");
 }
 
+void co_csp_window_test()
+{
+	trace_line("begin co_csp_window_test");
+	io_engine ios;
+	ios.run();
+	co_csp_channel<int(int)> csp(boost_strand::create(ios));
+	co_go(ios)[&](co_generator)
+	{
+		co_begin_context;
+		int i;
+		int msg;
+		csp_result<int> res;
+		co_use_state;
+		co_end_context(ctx);
+
+		co_begin;
+		//4个流水线调用和2个未取回就退出的调用
+		for (ctx.i = 0; ctx.i < 6; ctx.i++)
+		{
+			co_csp_io(csp, ctx.res) >> ctx.msg;
+			co_sleep(50);
+			ctx.res.return_(ctx.msg * 2);
+		}
+		co_end;
+	};
+	co_go(ios)[&](co_generator)
+	{
+		co_begin_context;
+		int i;
+		int res;
+		co_csp_window<int> win;
+		co_csp_future<int> futs[4];
+		co_use_state;
+		co_end_context_init(ctx, (co_self), win(co_self, 2));
+
+		co_begin;
+		for (ctx.i = 0; ctx.i < 4; ctx.i++)
+		{
+			co_csp_window_send(ctx.win, ctx.futs[ctx.i], csp, ctx.i);
+			info_trace_line("csp window send ", ctx.i, ", inflight ", ctx.win.inflight());
+		}
+		//逆序取回
+		for (ctx.i = 3; ctx.i >= 0; ctx.i--)
+		{
+			co_csp_future_wait(ctx.futs[ctx.i], ctx.res);
+			assert(co_last_state_is_ok && ctx.res == ctx.i * 2);
+			info_trace_line("csp window result ", ctx.i, ": ", ctx.res);
+		}
+		co_end;
+	};
+	co_go(ios)[&](co_generator)
+	{
+		co_begin_context;
+		co_csp_window<int> win;
+		co_csp_future<int> fut1;
+		co_csp_future<int> fut2;
+		co_use_state;
+		co_end_context_init(ctx, (co_self), win(co_self, 2));
+
+		co_begin;
+		co_sleep(1000);
+		co_csp_window_send(ctx.win, ctx.fut1, csp, 100);
+		co_csp_window_send(ctx.win, ctx.fut2, csp, 101);
+		//窗口和future随generator销毁，迟到的结果被丢弃
+		info_trace_line("csp window exit, inflight ", ctx.win.inflight());
+		co_end;
+	};
+	ios.stop();
+	trace_line("end co_csp_window_test");
+}
+
 void co_chan_perfor_test()
 {
 	trace_line("begin co_chan_perfor_test");
@@ -1413,6 +3208,7 @@ int main(int argc, char *argv[])
 	trace("\n");
 #endif
 	co_select_msg_test();
+	co_csp_window_test();
 	trace("\n");
 	co_mutex_test();
 	trace("\n");
@@ -1445,6 +3241,7 @@ int main(int argc, char *argv[])
 	csp_test();
 	trace("\n");
 	sync_msg_test();
+	select_wake_test();
 	trace("\n");
 	socket_test();
 	trace("\n");
@@ -1452,6 +3249,38 @@ int main(int argc, char *argv[])
 	trace("\n");
 	udp_test();
 	trace("\n");
+#ifdef NDEBUG
+	async_file_perfor_test();
+	trace("\n");
+	shard_perfor_test();
+	trace("\n");
+	handoff_perfor_test();
+	reuse_port_accept_perfor_test();
+	udp_gso_perfor_test();
+	udp_batch_perfor_test();
+	tcp_cork_perfor_test();
+	relay_perfor_test();
+	huge_page_perfor_test();
+	actor_layout_perfor_test();
+	stack_budget_perfor_test();
+	elastic_io_perfor_test();
+	strand_urgent_perfor_test();
+	time_source_perfor_test();
+	actor_group_perfor_test();
+	parallel_perfor_test();
+	chan_pipeline_perfor_test();
+	strand_balancer_perfor_test();
+	stack_sampler_perfor_test();
+	check_lost_perfor_test();
+	shm_link_perfor_test();
+	remote_actor_perfor_test();
+	csp_window_perfor_test();
+	trace("\n");
+#endif
+#ifdef ENABLE_ACTOR_PROFILE
+	actor_profile_test();
+	trace("\n");
+#endif
 	wait_multi_msg();
 	trace("\n");
 // 	perfor_test();
@@ -3,39 +3,49 @@
 
 /*
 
-CHECK_SELF ü⵱ǰĸActor
-ENABLE_QT_ACTOR QTQT-UI߳Actor
-ENABLE_UV_ACTOR Node.js uv߳Actor
-ENABLE_NEXT_TICK next_tick
-ENABLE_CHECK_LOST ֪ͨʧ
-ENABLE_DUMP_STACK ջ
-PRINT_ACTOR_STACK actorջӡ־
-DISABLE_AUTO_STACK ջռԶ
-DISABLE_HIGH_TIMER high_resolution_timerʱdeadline_timerʱ
-DISABLE_BOOST_TIMER boostʱwaitable_timerʱ
-ENABLE_GLOBAL_TIMER ȫֶʱ(DISABLE_BOOST_TIMERʹ)
-ENABLE_TLS_CHECK_SELF TLS⵱ǰĸActor
-ENABLE_ASIO_HANDLER_ALLOCATE_EX asio handlerչ
-ENABLE_ASIO_PRE_OP tcp/udpasync_ioʱȳԷioʧܺͶ첽
+CHECK_SELF 启用检测当前代码运行在哪个Actor下
+ENABLE_QT_ACTOR 启用QT，在QT-UI线程中运行Actor
+ENABLE_UV_ACTOR 启用在Node.js uv线程中运行Actor
+ENABLE_NEXT_TICK 启用next_tick加速
+ENABLE_CHECK_LOST 启用通知句柄丢失检测
+ENABLE_DUMP_STACK 启用栈溢出检测
+PRINT_ACTOR_STACK 检测actor堆栈，打印日志
+DISABLE_AUTO_STACK 禁用栈空间自动伸缩控制
+DISABLE_HIGH_TIMER 禁用high_resolution_timer计时，将启用deadline_timer计时
+DISABLE_BOOST_TIMER 禁用boost计时器，用waitable_timer计时
+ENABLE_GLOBAL_TIMER 启用全局定时器(DISABLE_BOOST_TIMER下使用)
+ENABLE_TLS_CHECK_SELF 启用TLS技术检测当前代码运行在哪个Actor下
+ENABLE_ASIO_HANDLER_ALLOCATE_EX 启用asio handler扩展分配器
+ENABLE_ASIO_PRE_OP 启用tcp/udp在async_io时先尝试非阻塞io，失败后再投递异步操作
+ENABLE_IO_URING 启用linux io_uring执行async_file操作，否则使用线程池
+ENABLE_ACTOR_PROFILE 启用Actor运行/就绪/阻塞时间统计
+ENABLE_HUGE_PAGE 启用2MB大页承载Actor栈(每个栈独占至少一个大页)和固定尺寸内存池
 
 */
 
 #include "actor_mutex.cpp"
 #include "actor_socket.cpp"
 #include "actor_timer.cpp"
+#include "async_file.cpp"
 #include "async_timer.cpp"
 #include "bind_node_run.cpp"
 #include "bind_qt_run.cpp"
 #include "context_pool.cpp"
 #include "context_yield.cpp"
 #include "generator.cpp"
+#include "huge_page.cpp"
 #include "io_engine.cpp"
 #include "my_actor.cpp"
 #include "qt_strand.cpp"
+#include "remote_actor.cpp"
 #include "run_thread.cpp"
 #include "scattered.cpp"
 #include "shared_strand.cpp"
+#include "shm_link.cpp"
+#include "stack_sampler.cpp"
+#include "strand_balancer.cpp"
 #include "strand_ex.cpp"
+#include "time_source.cpp"
 #include "trace_stack.cpp"
 #include "uv_strand.cpp"
 #include "waitable_timer.cpp"
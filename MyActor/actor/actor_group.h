@@ -0,0 +1,271 @@
+#ifndef __ACTOR_GROUP_H
+#define __ACTOR_GROUP_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include "my_actor.h"
+
+//每个成员在一致性hash环上的虚拟节点数
+#ifndef ACTOR_GROUP_VNODES
+#define ACTOR_GROUP_VNODES 64
+#endif
+
+/*!
+@brief 组成员数变化时发给每个原有成员的通知，成员据此迁出不再属于自己的key，
+index >= newSize 的成员迁出全部key后应退出
+*/
+struct actor_group_rebalance
+{
+	size_t oldSize;
+	size_t newSize;
+};
+
+/*!
+@brief 分片Actor组，N个成员Actor各自运行在独立的strand上，
+按key的一致性hash在发送方线程直接选出目标成员，消息直接投递到成员的消息池，不经过路由Actor；
+成员用 self->connect_msg_pump<ARGS...>() 接收消息，用 self->connect_msg_pump<actor_group_rebalance>() 接收扩缩容通知；
+扩缩容后key的归属发生变化，旧成员可能还会收到已不属于自己的消息，用 owns() 判断后经 post() 转发即可
+*/
+template <typename Key, typename... ARGS>
+class actor_group
+{
+	typedef post_actor_msg<ARGS...> post_type;
+	typedef post_actor_msg<actor_group_rebalance> rebalance_type;
+	typedef std::tuple<TYPE_PIPE(ARGS)...> msg_type;
+
+	struct Member_
+	{
+		actor_handle _actor;
+		post_type _post;
+		rebalance_type _rebalance;
+	};
+
+	/*!
+	@brief 某个成员数下的hash环快照，发布后只读，组析构时释放
+	*/
+	struct Ring_
+	{
+		std::vector<std::pair<size_t, size_t>> _points;
+		std::vector<Member_> _members;
+	};
+public:
+	typedef std::function<void(my_actor* self, size_t index)> member_func;
+	typedef std::function<size_t(const Key&)> hasher_type;
+public:
+	/*!
+	@brief 创建一个空组，用resize启动成员
+	@param body 成员Actor函数体，index为成员序号
+	@param fixedSize 每个成员消息池的预分配长度
+	*/
+	actor_group(io_engine& ios, const member_func& body, const hasher_type& hasher = std::hash<Key>(),
+		size_t stackSize = DEFAULT_STACKSIZE, size_t fixedSize = 16)
+		:_ios(ios), _body(body), _hasher(hasher), _stackSize(stackSize), _fixedSize(fixedSize), _ring(NULL) {}
+
+	~actor_group()
+	{
+		assert(!size());
+	}
+public:
+	/*!
+	@brief 调整成员数(同一时刻只能有一个Actor调用)；新成员启动并连接完成后才发布新的hash环，
+	然后通知所有原有成员重新平衡，缩容时等待被移除的成员退出
+	*/
+	__yield_interrupt void resize(my_actor* host, size_t n)
+	{
+		Ring_* const oldRing = _ring.load(std::memory_order_relaxed);
+		const size_t oldSize = oldRing ? oldRing->_members.size() : 0;
+		if (n == oldSize)
+		{
+			return;
+		}
+		std::unique_ptr<Ring_> newRing(new Ring_);
+		newRing->_members.reserve(n);
+		for (size_t i = 0; i < n && i < oldSize; i++)
+		{
+			newRing->_members.push_back(oldRing->_members[i]);
+		}
+		for (size_t i = oldSize; i < n; i++)
+		{
+			const member_func& body = _body;
+			Member_ member;
+			member._actor = my_actor::create(boost_strand::create(_ios), [body, i](my_actor* self)
+			{
+				body(self, i);
+			}, _stackSize);
+			member._actor->run();
+			member._post = host->connect_msg_notifer_to<ARGS...>(member._actor, false, false, _fixedSize);
+			member._rebalance = host->connect_msg_notifer_to<actor_group_rebalance>(member._actor);
+			newRing->_members.push_back(std::move(member));
+		}
+		newRing->_points.reserve(n * ACTOR_GROUP_VNODES);
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t v = 0; v < ACTOR_GROUP_VNODES; v++)
+			{
+				newRing->_points.push_back(std::make_pair(mix(((unsigned long long)i << 32) | v), i));
+			}
+		}
+		std::sort(newRing->_points.begin(), newRing->_points.end());
+		_ring.store(newRing.get(), std::memory_order_release);
+		_rings.push_back(std::move(newRing));
+		actor_group_rebalance rb = { oldSize, n };
+		for (size_t i = 0; i < oldSize; i++)
+		{
+			if (!oldRing->_members[i]._rebalance.empty())
+			{
+				oldRing->_members[i]._rebalance(rb);
+			}
+		}
+		for (size_t i = n; i < oldSize; i++)
+		{
+			host->actor_wait_quit(oldRing->_members[i]._actor);
+		}
+	}
+
+	/*!
+	@brief 缩容到0，等待全部成员退出
+	*/
+	__yield_interrupt void stop(my_actor* host)
+	{
+		resize(host, 0);
+	}
+
+	/*!
+	@brief 当前成员数
+	*/
+	size_t size() const
+	{
+		Ring_* const ring = _ring.load(std::memory_order_acquire);
+		return ring ? ring->_members.size() : 0;
+	}
+
+	/*!
+	@brief key当前所属的成员序号，组为空时返回-1
+	*/
+	size_t route(const Key& key) const
+	{
+		Ring_* const ring = _ring.load(std::memory_order_acquire);
+		if (!ring || ring->_members.empty())
+		{
+			return -1;
+		}
+		return route(ring, key);
+	}
+
+	/*!
+	@brief 成员index当前是否拥有key
+	*/
+	bool owns(size_t index, const Key& key) const
+	{
+		return route(key) == index;
+	}
+
+	/*!
+	@brief 成员Actor句柄
+	*/
+	actor_handle member(size_t index) const
+	{
+		Ring_* const ring = _ring.load(std::memory_order_acquire);
+		assert(ring && index < ring->_members.size());
+		return ring->_members[index]._actor;
+	}
+
+	/*!
+	@brief 按key投递到所属成员，组为空或成员已退出时返回false
+	*/
+	template <typename... Args>
+	bool post(const Key& key, Args&&... args) const
+	{
+		Ring_* const ring = _ring.load(std::memory_order_acquire);
+		if (!ring || ring->_members.empty())
+		{
+			return false;
+		}
+		const post_type& dst = ring->_members[route(ring, key)]._post;
+		if (dst.empty())
+		{
+			return false;
+		}
+		dst(std::forward<Args>(args)...);
+		return true;
+	}
+
+	/*!
+	@brief 批量按key投递，同一成员的消息合并为一次投递，成员内保持原有顺序
+	*/
+	void post_batch(std::vector<std::pair<Key, msg_type>>&& msgs) const
+	{
+		Ring_* const ring = _ring.load(std::memory_order_acquire);
+		if (!ring || ring->_members.empty())
+		{
+			return;
+		}
+		const size_t n = ring->_members.size();
+		std::vector<std::vector<msg_type>> buckets(n);
+		for (auto& msg : msgs)
+		{
+			buckets[route(ring, msg.first)].push_back(std::move(msg.second));
+		}
+		for (size_t i = 0; i < n; i++)
+		{
+			const post_type& dst = ring->_members[i]._post;
+			if (!buckets[i].empty() && !dst.empty())
+			{
+				dst.post_batch(std::move(buckets[i]));
+			}
+		}
+	}
+
+	/*!
+	@brief 广播给所有成员
+	*/
+	template <typename... Args>
+	void broadcast(const Args&... args) const
+	{
+		Ring_* const ring = _ring.load(std::memory_order_acquire);
+		if (!ring)
+		{
+			return;
+		}
+		for (const Member_& member : ring->_members)
+		{
+			if (!member._post.empty())
+			{
+				member._post(args...);
+			}
+		}
+	}
+private:
+	size_t route(Ring_* ring, const Key& key) const
+	{
+		const size_t h = mix(_hasher(key));
+		auto it = std::upper_bound(ring->_points.begin(), ring->_points.end(), std::make_pair(h, (size_t)-1));
+		if (ring->_points.end() == it)
+		{
+			it = ring->_points.begin();
+		}
+		return it->second;
+	}
+
+	static size_t mix(unsigned long long x)
+	{
+		x += 0x9E3779B97F4A7C15ULL;
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+		return (size_t)(x ^ (x >> 31));
+	}
+private:
+	io_engine& _ios;
+	member_func _body;
+	hasher_type _hasher;
+	const size_t _stackSize;
+	const size_t _fixedSize;
+	std::atomic<Ring_*> _ring;
+	std::vector<std::unique_ptr<Ring_>> _rings;
+	NONE_COPY(actor_group);
+};
+
+#endif
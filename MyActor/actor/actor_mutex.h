@@ -10,7 +10,7 @@
 class my_actor;
 
 /*!
-@brief Actorɵݹ
+@brief Actor锁，可递归
 */
 class actor_mutex
 {
@@ -20,13 +20,13 @@ public:
 	~actor_mutex();
 public:
 	/*!
-	@brief ԴActorУȴֱȣ unlock УɵݹãlockڼActorǿ˳
-	@warning Actorǿ˳п lock ޷ unlock
+	@brief 锁定资源，如果被别的Actor持有，等待，直到被调度，用 unlock 解除持有；可递归调用；lock期间Actor将锁定强制退出
+	@warning 所在Actor如果被强制退出，有可能造成 lock 后，无法 unlock
 	*/
 	void lock(my_actor* host);
 
 	/*!
-	@brief ԴѾlockNtf
+	@brief 锁定资源，如果已经被锁定调用lockNtf
 	*/
 	template <typename Ntf>
 	void lock(my_actor* host, Ntf&& lockNtf)
@@ -35,19 +35,19 @@ public:
 	}
 
 	/*!
-	@brief ԵǰǷѾռãѾĳУԼв㣩ͷûУԼУ unlock 
-	@return ѾActor falseɹзtrue
+	@brief 测试当前是否已经被占用，如果已经被别的持有（被自己持有不算）就放弃；如果没持有，则自己持有，用 unlock 解除持有
+	@return 已经被别的Actor返回 false，成功持有返回true
 	*/
 	bool try_lock(my_actor* host);
 
 	/*!
-	@brief һʱڳԴ
-	@return ɹtrueʱʧܷfalse
+	@brief 在一段时间内尝试锁定资源
+	@return 成功返回true，超时失败返回false
 	*/
 	bool timed_lock(int ms, my_actor* host);
 
 	/*!
-	@brief һʱڳԴѾlockNtf
+	@brief 在一段时间内尝试锁定资源，如果已经被锁定调用lockNtf
 	*/
 	template <typename Ntf>
 	bool timed_lock(int ms, my_actor* host, Ntf&& lockNtf)
@@ -56,12 +56,12 @@ public:
 	}
 
 	/*!
-	@brief ǰActorУݹ lock ΣҪ unlock 
+	@brief 解除当前Actor对其持有，递归 lock 几次，就需要 unlock 几次
 	*/
 	void unlock(my_actor* host);
 
 	/*!
-	@brief ǰstrand
+	@brief 当前依赖的strand
 	*/
 	const shared_strand& self_strand();
 
@@ -82,7 +82,7 @@ private:
 
 class actor_condition_variable;
 /*!
-@brief һΧmutexͬʱеActorҲᱻǿ˳
+@brief 在一定范围内锁定mutex，同时运行的Actor也会被锁定强制退出
 */
 class actor_lock_guard
 {
@@ -102,7 +102,7 @@ private:
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief ActorеĶдɵݹ
+@brief 在Actor下运行的读写锁，不可递归
 */
 class actor_shared_mutex
 {
@@ -111,7 +111,7 @@ public:
 	~actor_shared_mutex();
 public:
 	/*!
-	@brief ռ
+	@brief 独占锁
 	*/
 	void lock(my_actor* host);
 	bool try_lock(my_actor* host);
@@ -130,7 +130,7 @@ public:
 	}
 
 	/*!
-	@brief 
+	@brief 共享锁
 	*/
 	void lock_shared(my_actor* host);
 	bool try_lock_shared(my_actor* host);
@@ -156,7 +156,7 @@ public:
 	}
 
 	/*!
-	@brief Ϊռ
+	@brief 共享锁提升为独占锁
 	*/
 	void lock_upgrade(my_actor* host);
 	bool try_lock_upgrade(my_actor* host);
@@ -168,22 +168,22 @@ public:
 	}
 
 	/*!
-	@brief ռ
+	@brief 解除独占锁定
 	*/
 	void unlock(my_actor* host);
 
 	/*!
-	@brief 
+	@brief 解除共享锁定
 	*/
 	void unlock_shared(my_actor* host);
 
 	/*!
-	@brief ռָΪ
+	@brief 解除独占锁定，恢复为共享锁定
 	*/
 	void unlock_upgrade(my_actor* host);
 
 	/*!
-	@brief ǰstrand
+	@brief 当前依赖的strand
 	*/
 	const shared_strand& self_strand();
 
@@ -205,7 +205,7 @@ private:
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief һΧshared_mutex˽ͬʱеActorҲᱻǿ˳
+@brief 在一定范围内锁定shared_mutex私有锁，同时运行的Actor也会被锁定强制退出
 */
 class actor_unique_lock
 {
@@ -223,7 +223,7 @@ private:
 };
 
 /*!
-@brief һΧshared_mutexͬʱеActorҲᱻǿ˳
+@brief 在一定范围内锁定shared_mutex共享锁，同时运行的Actor也会被锁定强制退出
 */
 class actor_shared_lock
 {
@@ -242,7 +242,7 @@ private:
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief 
+@brief 条件变量
 */
 class actor_condition_variable
 {
@@ -251,26 +251,26 @@ public:
 	~actor_condition_variable();
 public:
 	/*!
-	@brief ȴ֪ͨ
+	@brief 等待通知
 	*/
 	void wait(my_actor* host, actor_lock_guard& lg);
 	void wait(my_actor* host, actor_mutex& mtx);
 	void wait(my_actor* host, co_mutex& mtx);
 
 	/*!
-	@brief ʱȴ֪ͨ
+	@brief 延时等待通知
 	*/
 	bool timed_wait(my_actor* host, actor_lock_guard& lg, int ms);
 	bool timed_wait(my_actor* host, actor_mutex& mtx, int ms);
 	bool timed_wait(my_actor* host, co_mutex& mtx, int ms);
 
 	/*!
-	@brief ֪ͨһȴ
+	@brief 通知一个等待
 	*/
 	void notify_one();
 
 	/*!
-	@brief ֪ͨڵȴ
+	@brief 通知所有在等待的
 	*/
 	void notify_all();
 
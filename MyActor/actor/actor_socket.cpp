@@ -1,4 +1,10 @@
 #include "actor_socket.h"
+#ifdef __linux__
+#include <linux/filter.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netinet/udp.h>
+#endif
 
 tcp_socket::tcp_socket(io_engine& ios)
 :_socket(ios), _nonBlocking(false)
@@ -16,7 +22,234 @@ tcp_socket::tcp_socket(io_engine& ios)
 }
 
 tcp_socket::~tcp_socket()
-{}
+{
+	if (_cork)
+	{
+		_cork->_socket = NULL;
+		CorkWrite_* lists[] = { _cork->_flying, _cork->_head };
+		_cork->_head = _cork->_tail = _cork->_flying = NULL;
+		//未完成的写操作以operation_aborted结束，与关闭socket时asio的行为一致
+		const result res = { 0, boost::asio::error::operation_aborted, false };
+		for (CorkWrite_* cw : lists)
+		{
+			while (cw)
+			{
+				CorkWrite_* const next = cw->_next;
+				cw->complete(res);
+				delete cw;
+				cw = next;
+			}
+		}
+	}
+}
+
+void tcp_socket::cork(const shared_strand& strand, size_t maxBytes, size_t maxIovs)
+{
+	assert(!_cork);
+	assert(maxBytes > 0 && maxIovs > 0);
+	_cork = std::make_shared<CorkState_>();
+	_cork->_socket = this;
+	_cork->_strand = strand;
+	_cork->_maxBytes = maxBytes;
+	_cork->_maxIovs = maxIovs;
+	_cork->_bytes = 0;
+	_cork->_count = 0;
+	_cork->_head = _cork->_tail = _cork->_flying = NULL;
+	_cork->_error = 0;
+	_cork->_tickPosted = false;
+}
+
+void tcp_socket::uncork()
+{
+	if (_cork)
+	{
+		assert(!_cork->_head && !_cork->_flying);
+		_cork->_socket = NULL;
+		_cork.reset();
+	}
+}
+
+bool tcp_socket::is_corked()
+{
+	return !!_cork;
+}
+
+bool tcp_socket::_cork_write(CorkWrite_* cw)
+{
+	bool syncDone = false;
+	cw->_syncDone = &syncDone;
+	CorkState_* const cork = _cork.get();
+	assert(cork->_strand->running_in_this_thread());
+	if (cork->_tail)
+	{
+		cork->_tail->_next = cw;
+	}
+	else
+	{
+		cork->_head = cw;
+	}
+	cork->_tail = cw;
+	cork->_bytes += cw->_length;
+	cork->_count++;
+	if (!cork->_flying)
+	{
+		if (cork->_bytes >= cork->_maxBytes || cork->_count >= cork->_maxIovs)
+		{
+			_cork_flush();
+		}
+		else if (!cork->_tickPosted)
+		{
+			cork->_tickPosted = true;
+			std::shared_ptr<CorkState_> cork_ = _cork;
+			cork->_strand->try_tick([cork_]
+			{
+				cork_->_tickPosted = false;
+				if (cork_->_socket && cork_->_head && !cork_->_flying)
+				{
+					cork_->_socket->_cork_flush();
+				}
+			});
+		}
+	}
+	if (!syncDone)
+	{
+		cw->_syncDone = NULL;
+	}
+	return syncDone;
+}
+
+tcp_socket::result tcp_socket::_cork_write_copy(const void* buff, size_t length)
+{
+	CorkState_* const cork = _cork.get();
+	if (!cork->_error)
+	{
+		_cork_write(new CorkCopy_(cork, buff, length));
+	}
+	//达到合并上限时会立即发送，同步失败的也在这里返回
+	return cork->_error ? result{ 0, cork->_error, false } : result{ length, 0, true };
+}
+
+void tcp_socket::_cork_flush()
+{
+	CorkState_* const cork = _cork.get();
+	assert(cork->_head && !cork->_flying);
+	cork->_flying = cork->_head;
+	cork->_head = cork->_tail = NULL;
+	cork->_bytes = 0;
+	cork->_count = 0;
+	size_t skip = 0;
+#ifdef ENABLE_SCK_MULTI_IO
+	size_t totBytes = 0;
+	cork->_buffs.clear();
+	cork->_lengths.clear();
+	for (CorkWrite_* cw = cork->_flying; cw; cw = cw->_next)
+	{
+		cork->_buffs.push_back(cw->_buff);
+		cork->_lengths.push_back(cw->_length);
+		totBytes += cw->_length;
+	}
+	result res = _nonBlocking ? _try_mwrite_same(&cork->_buffs.front(), &cork->_lengths.front(), cork->_buffs.size()) : result{ 0, boost::asio::error::would_block, false };
+	if (res.ok && res.s == totBytes)
+	{
+		_cork_complete(boost::system::error_code(), totBytes);
+		return;
+	}
+	else if (!res.ok && !try_again(res))
+	{
+		_cork_complete(boost::system::error_code(res.code, boost::system::system_category()), 0);
+		return;
+	}
+	skip = res.s;
+#endif
+	_cork_send(skip);
+}
+
+void tcp_socket::_cork_send(size_t skip)
+{
+	CorkState_* const cork = _cork.get();
+	const size_t tried = skip;
+	cork->_iovs.clear();
+	for (CorkWrite_* cw = cork->_flying; cw; cw = cw->_next)
+	{
+		if (skip >= cw->_length)
+		{
+			skip -= cw->_length;
+		}
+		else
+		{
+			cork->_iovs.push_back(boost::asio::buffer((const char*)cw->_buff + skip, cw->_length - skip));
+			skip = 0;
+		}
+	}
+	std::shared_ptr<CorkState_> cork_ = _cork;
+	boost::asio::async_write(_socket, cork->_iovs, [cork_, tried](const boost::system::error_code& ec, size_t s)
+	{
+		cork_->_strand->distribute([cork_, tried, ec, s]
+		{
+			if (cork_->_socket)
+			{
+				cork_->_socket->_cork_complete(ec, tried + s);
+			}
+		});
+	});
+}
+
+void tcp_socket::_cork_complete(const boost::system::error_code& ec, size_t bytes)
+{
+	std::shared_ptr<CorkState_> cork = _cork;//回调中可能uncork或析构socket
+	CorkWrite_* cw = cork->_flying;
+	cork->_flying = NULL;
+	while (cw)
+	{
+		CorkWrite_* const next = cw->_next;
+		result res = { cw->_length, 0, true };
+		if (bytes >= cw->_length)
+		{
+			bytes -= cw->_length;
+		}
+		else
+		{
+			res.s = bytes;
+			res.code = ec ? ec.value() : (int)boost::asio::error::broken_pipe;
+			res.ok = false;
+			bytes = 0;
+		}
+		cw->complete(res);
+		delete cw;
+		cw = next;
+	}
+	if (cork->_socket && cork->_head && !cork->_flying)
+	{
+		cork->_socket->_cork_flush();
+	}
+}
+
+tcp_socket::CorkCopy_::CorkCopy_(CorkState_* cork, const void* buff, size_t length)
+:_cork(cork)
+{
+	char* const copy = length ? new char[length] : NULL;
+	if (length)
+	{
+		memcpy(copy, buff, length);
+	}
+	CorkWrite_::_buff = copy;
+	CorkWrite_::_length = length;
+	CorkWrite_::_next = NULL;
+	CorkWrite_::_syncDone = NULL;
+}
+
+tcp_socket::CorkCopy_::~CorkCopy_()
+{
+	delete[] (char*)CorkWrite_::_buff;
+}
+
+void tcp_socket::CorkCopy_::invoke(const result& res)
+{
+	if (!res.ok && !_cork->_error)
+	{
+		_cork->_error = res.code;
+	}
+}
 
 tcp_socket::result tcp_socket::close()
 {
@@ -26,6 +259,256 @@ tcp_socket::result tcp_socket::close()
 	return result{ 0, ec.value(), !ec };
 }
 
+tcp_socket::result tcp_socket::assign(native_handle sck, bool v6)
+{
+	boost::system::error_code ec;
+	_socket.assign(v6 ? boost::asio::ip::tcp::v6() : boost::asio::ip::tcp::v4(), sck, ec);
+	if (!ec)
+	{
+		set_internal_non_blocking();
+	}
+	return result{ 0, ec.value(), !ec };
+}
+
+void tcp_socket::close_native(native_handle sck)
+{
+	using namespace boost::asio::detail;
+	boost::system::error_code ec;
+	socket_ops::state_type state = socket_ops::stream_oriented;
+	socket_ops::close(sck, state, true, ec);
+}
+
+tcp_socket::RelayOp_::RelayOp_(const shared_strand& strand, tcp_socket& src, tcp_socket& dst, size_t maxBytes)
+:_strand(strand), _src(src), _dst(dst), _maxBytes(maxBytes), _bytes(0), _inPipe(0), _eof(false)
+{
+	_res.s = 0;
+	_res.code = 0;
+	_res.ok = false;
+	if (!_src._nonBlocking)
+	{
+		_src.set_internal_non_blocking();
+	}
+	if (!_dst._nonBlocking)
+	{
+		_dst.set_internal_non_blocking();
+	}
+#ifdef __linux__
+	if (::pipe2(_pipe, O_NONBLOCK | O_CLOEXEC))
+	{
+		_pipe[0] = _pipe[1] = -1;
+		_res.code = errno;
+	}
+#else
+	_begin = 0;
+#endif
+}
+
+tcp_socket::RelayOp_::~RelayOp_() __disable_noexcept
+{
+#ifdef __linux__
+	if (-1 != _pipe[0])
+	{
+		::close(_pipe[0]);
+		::close(_pipe[1]);
+	}
+#endif
+}
+
+bool tcp_socket::RelayOp_::run()
+{
+	assert(_strand->running_in_this_thread());
+	boost::asio::socket_base::wait_type waitType = boost::asio::socket_base::wait_read;
+	tcp_socket* waitSocket = NULL;
+	if (!step(waitType, waitSocket))
+	{
+		complete(_res);
+		return true;
+	}
+	//回到strand再搬运，strand中的close要么在本步之前(fd已失效，splice返回EBADF)，要么在本步之后
+	waitSocket->_socket.async_wait(waitType, _strand->wrap([this](const boost::system::error_code& ec)
+	{
+		if (ec)
+		{
+			failed(ec.value());
+			complete(_res);
+		}
+		else
+		{
+			run();
+		}
+	}));
+	return false;
+}
+
+bool tcp_socket::RelayOp_::failed(int code)
+{
+	_res.s = _bytes;
+	_res.code = code;
+	_res.ok = false;
+	return false;
+}
+
+bool tcp_socket::RelayOp_::finished()
+{
+	if (_eof)
+	{
+		boost::system::error_code ec;
+		_dst._socket.shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
+	}
+	_res.s = _bytes;
+	_res.code = 0;
+	_res.ok = true;
+	return false;
+}
+
+bool tcp_socket::RelayOp_::step(boost::asio::socket_base::wait_type& waitType, tcp_socket*& waitSocket)
+{
+	const size_t chunkSize = 64 * 1024;
+	if (_res.code || !_src._nonBlocking || !_dst._nonBlocking)
+	{
+		return failed(_res.code ? _res.code : (int)boost::asio::error::would_block);
+	}
+	//一次最多连续搬运16块，之后重新等待可读，避免长时间独占io线程
+	for (size_t rounds = 0;;)
+	{
+		if (_inPipe)
+		{
+#ifdef __linux__
+			ssize_t n = ::splice(_pipe[0], NULL, _dst._socket.native_handle(), NULL, _inPipe, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+			const int err = n < 0 ? errno : 0;
+#else
+			result wr = _dst.try_write_same(&_buff[_begin], _inPipe);
+			const ptrdiff_t n = wr.ok ? (ptrdiff_t)wr.s : -1;
+			const int err = wr.ok ? 0 : (try_again(wr) ? EAGAIN : wr.code);
+#endif
+			if (n > 0)
+			{
+				_inPipe -= (size_t)n;
+				_bytes += (size_t)n;
+#ifndef __linux__
+				_begin += (size_t)n;
+#endif
+				continue;
+			}
+			if (EINTR == err)
+			{
+				continue;
+			}
+			if (EAGAIN == err || EWOULDBLOCK == err)
+			{
+				waitType = boost::asio::socket_base::wait_write;
+				waitSocket = &_dst;
+				return true;
+			}
+			return failed(err ? err : (int)boost::asio::error::broken_pipe);
+		}
+		if (_eof || _bytes >= _maxBytes)
+		{
+			return finished();
+		}
+		if (++rounds > 16)
+		{
+			waitType = boost::asio::socket_base::wait_read;
+			waitSocket = &_src;
+			return true;
+		}
+		const size_t length = std::min(_maxBytes - _bytes, chunkSize);
+#ifdef __linux__
+		ssize_t n = ::splice(_src._socket.native_handle(), NULL, _pipe[1], NULL, length, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+		const int err = n < 0 ? errno : 0;
+#else
+		_buff.resize(chunkSize);
+		_begin = 0;
+		result rd = _src.try_read_same(&_buff[0], length);
+		const ptrdiff_t n = rd.ok ? (ptrdiff_t)rd.s : -1;
+		const int err = rd.ok ? 0 : (try_again(rd) ? EAGAIN : rd.code);
+#endif
+		if (n > 0)
+		{
+			_inPipe = (size_t)n;
+			continue;
+		}
+		if (0 == n)
+		{
+			_eof = true;
+			continue;
+		}
+		if (EINTR == err)
+		{
+			continue;
+		}
+		if (EAGAIN == err || EWOULDBLOCK == err)
+		{
+			waitType = boost::asio::socket_base::wait_read;
+			waitSocket = &_src;
+			return true;
+		}
+		return failed(err);
+	}
+}
+
+tcp_socket::result tcp_socket::relay(my_actor* host, tcp_socket& dst, size_t maxBytes)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_relay(host->self_strand(), dst, maxBytes, std::move(h));
+	});
+}
+
+tcp_socket::result tcp_socket::timed_relay(my_actor* host, int ms, tcp_socket& dst, size_t maxBytes)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_relay(host->self_strand(), dst, maxBytes, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		close();
+		dst.close();
+	}, res));
+	return overtime ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
+
+tcp_socket::result tcp_socket::relay_both(my_actor* host, tcp_socket& a, tcp_socket& b, size_t* bytesAB, size_t* bytesBA)
+{
+	int pending = 2;
+	result res[2] = { { 0, 0, false }, { 0, 0, false } };
+	const shared_strand& strand = host->self_strand();
+	auto completion = [&](size_t i, const trig_once_notifer<>& h)
+	{
+		return strand->wrap([&, i, h](const result& r)
+		{
+			res[i] = r;
+			if (!r.ok)
+			{
+				a.close();
+				b.close();
+			}
+			if (0 == --pending)
+			{
+				h();
+			}
+		});
+	};
+	my_actor::quit_guard qg(host);
+	host->trig([&](trig_once_notifer<>&& h)
+	{
+		a.async_relay(strand, b, -1, completion(0, h));
+		b.async_relay(strand, a, -1, completion(1, h));
+	});
+	if (bytesAB)
+	{
+		*bytesAB = res[0].s;
+	}
+	if (bytesBA)
+	{
+		*bytesBA = res[1].s;
+	}
+	const result& err = res[0].ok ? res[1] : res[0];
+	return result{ res[0].s + res[1].s, err.code, res[0].ok && res[1].ok };
+}
+
 tcp_socket::result tcp_socket::no_delay()
 {
 	boost::system::error_code ec;
@@ -127,6 +610,12 @@ tcp_socket::result tcp_socket::read_some(my_actor* host, void* buff, size_t leng
 
 tcp_socket::result tcp_socket::write(my_actor* host, const void* buff, size_t length)
 {
+	if (_cork && !(_cork->_flying && _cork->_bytes >= _cork->_maxBytes))
+	{
+		//写合并时不等待发送完成，数据拷贝后排队，发送错误在之后的write/flush中返回；
+		//积压超过maxBytes时走下面等待完成的路径，限制排队的数据量
+		return _cork_write_copy(buff, length);
+	}
 	my_actor::quit_guard qg(host);
 	return host->trig<result>([&](trig_once_notifer<result>&& h)
 	{
@@ -134,6 +623,24 @@ tcp_socket::result tcp_socket::write(my_actor* host, const void* buff, size_t le
 	});
 }
 
+tcp_socket::result tcp_socket::flush(my_actor* host)
+{
+	if (!_cork)
+	{
+		return result{ 0, 0, true };
+	}
+	if (_cork->_head || _cork->_flying)
+	{
+		//排在所有已排队数据之后的空写，完成时前面的数据都已发送
+		my_actor::quit_guard qg(host);
+		host->trig<result>([&](trig_once_notifer<result>&& h)
+		{
+			async_write(NULL, 0, std::move(h));
+		});
+	}
+	return _cork->_error ? result{ 0, _cork->_error, false } : result{ 0, 0, true };
+}
+
 tcp_socket::result tcp_socket::write_some(my_actor* host, const void* buff, size_t length)
 {
 	my_actor::quit_guard qg(host);
@@ -696,6 +1203,9 @@ bool tcp_socket::init_send_file(HANDLE hFile, unsigned long long* offset, size_t
 //////////////////////////////////////////////////////////////////////////
 
 tcp_acceptor::tcp_acceptor(io_engine& ios)
+:tcp_acceptor((boost::asio::io_service&)ios) {}
+
+tcp_acceptor::tcp_acceptor(boost::asio::io_service& ios)
 :_ios(ios), _nonBlocking(false)
 #ifdef ENABLE_ASIO_PRE_OP
 , _preOption(false)
@@ -706,58 +1216,83 @@ tcp_acceptor::~tcp_acceptor()
 {
 }
 
-tcp_socket::result tcp_acceptor::open(const char* ip, unsigned short port)
+tcp_socket::result tcp_acceptor::_open(const boost::asio::ip::tcp::endpoint& endpoint, bool reusePort)
 {
 	if (!_acceptor.has())
 	{
 		try
 		{
-			_acceptor.create(_ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::address::from_string(ip), port), false);
+			if (!reusePort)
+			{
+				_acceptor.create(_ios, endpoint, false);
+			}
+			else
+			{
+#ifdef SO_REUSEPORT
+				_acceptor.create(_ios);
+				_acceptor->open(endpoint.protocol());
+				_acceptor->set_option(boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>(true));
+				_acceptor->bind(endpoint);
+				_acceptor->listen();
+#else
+				return tcp_socket::result{ 0, boost::asio::error::operation_not_supported, false };
+#endif
+			}
 			set_internal_non_blocking();
 			return tcp_socket::result{ 0, 0, true };
 		}
 		catch (const boost::system::system_error& se)
 		{
+			_acceptor.destroy();
 			return tcp_socket::result{ 0, se.code().value(), !se.code() };
 		}
 	}
 	return tcp_socket::result{ 0, 0, false };
 }
 
-tcp_socket::result tcp_acceptor::open_v4(unsigned short port)
+tcp_socket::result tcp_acceptor::open(const char* ip, unsigned short port, bool reusePort)
 {
-	if (!_acceptor.has())
+	boost::system::error_code ec;
+	boost::asio::ip::address address = boost::asio::ip::address::from_string(ip, ec);
+	if (ec)
 	{
-		try
-		{
-			_acceptor.create(_ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4(), port), false);
-			set_internal_non_blocking();
-			return tcp_socket::result{ 0, 0, true };
-		}
-		catch (const boost::system::system_error& se)
-		{
-			return tcp_socket::result{ 0, se.code().value(), !se.code() };
-		}
+		return tcp_socket::result{ 0, ec.value(), false };
 	}
-	return tcp_socket::result{ 0, 0, false };
+	return _open(boost::asio::ip::tcp::endpoint(address, port), reusePort);
 }
 
-tcp_socket::result tcp_acceptor::open_v6(unsigned short port)
+tcp_socket::result tcp_acceptor::open_v4(unsigned short port, bool reusePort)
 {
-	if (!_acceptor.has())
+	return _open(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4(), port), reusePort);
+}
+
+tcp_socket::result tcp_acceptor::open_v6(unsigned short port, bool reusePort)
+{
+	return _open(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v6(), port), reusePort);
+}
+
+tcp_socket::result tcp_acceptor::reuse_port_cpu_steering(size_t groups)
+{
+#if defined(__linux__) && defined(SO_ATTACH_REUSEPORT_CBPF)
+	if (!_acceptor.has() || 0 == groups)
 	{
-		try
-		{
-			_acceptor.create(_ios, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v6(), port), false);
-			set_internal_non_blocking();
-			return tcp_socket::result{ 0, 0, true };
-		}
-		catch (const boost::system::system_error& se)
-		{
-			return tcp_socket::result{ 0, se.code().value(), !se.code() };
-		}
+		return tcp_socket::result{ 0, boost::asio::error::invalid_argument, false };
 	}
-	return tcp_socket::result{ 0, 0, false };
+	//A = 当前CPU号; A = A % groups; return A
+	struct sock_filter code[] = {
+		{ BPF_LD | BPF_W | BPF_ABS, 0, 0, (unsigned)(SKF_AD_OFF + SKF_AD_CPU) },
+		{ BPF_ALU | BPF_MOD | BPF_K, 0, 0, (unsigned)groups },
+		{ BPF_RET | BPF_A, 0, 0, 0 },
+	};
+	struct sock_fprog prog = { sizeof(code) / sizeof(code[0]), code };
+	if (0 != setsockopt(_acceptor->native_handle(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)))
+	{
+		return tcp_socket::result{ 0, errno, false };
+	}
+	return tcp_socket::result{ 0, 0, true };
+#else
+	return tcp_socket::result{ 0, boost::asio::error::operation_not_supported, false };
+#endif
 }
 
 tcp_socket::result tcp_acceptor::close()
@@ -810,6 +1345,79 @@ tcp_socket::result tcp_acceptor::timed_accept(my_actor* host, int ms, tcp_socket
 	return overtime ? tcp_socket::result{ 0, boost::asio::error::timed_out, false } : res;
 }
 
+tcp_socket::result tcp_acceptor::accept_many(my_actor* host, tcp_socket::native_handle* sockets, size_t maxCount)
+{
+	my_actor::quit_guard qg(host);
+	while (true)
+	{
+		tcp_socket::result res = try_accept_many(sockets, maxCount);
+		if (res.ok || !tcp_socket::try_again(res) || !_nonBlocking)
+		{
+			return res;
+		}
+		res = host->trig<tcp_socket::result>([&](trig_once_notifer<tcp_socket::result>&& h)
+		{
+			async_wait_accept(std::move(h));
+		});
+		if (!res.ok)
+		{
+			return res;
+		}
+	}
+}
+
+tcp_socket::result tcp_acceptor::try_accept_many(tcp_socket::native_handle* sockets, size_t maxCount)
+{
+	using namespace boost::asio::detail;
+	assert(maxCount > 0);
+	tcp_socket::result res = { 0, 0, false };
+	if (!_acceptor.has())
+	{
+		res.code = boost::asio::error::bad_descriptor;
+		return res;
+	}
+	if (!_nonBlocking)
+	{
+		res.code = boost::asio::error::would_block;
+		return res;
+	}
+	const socket_type acceptorSck = _acceptor->native_handle();
+	while (res.s < maxCount)
+	{
+#ifdef __linux__
+		socket_type newSck = ::accept4(acceptorSck, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+		if (invalid_socket == newSck)
+		{
+			res.code = errno;
+			if (ECONNABORTED == res.code || EINTR == res.code)
+			{
+				continue;
+			}
+			break;
+		}
+#else
+		boost::system::error_code ec;
+		socket_type newSck = socket_ops::accept(acceptorSck, NULL, NULL, ec);
+		if (invalid_socket == newSck)
+		{
+			res.code = ec.value();
+			if (boost::asio::error::connection_aborted == ec)
+			{
+				continue;
+			}
+			break;
+		}
+#endif
+		sockets[res.s++] = newSck;
+	}
+	if (res.s)
+	{
+		res.code = 0;
+		res.ok = true;
+	}
+	return res;
+}
+
 tcp_socket::result tcp_acceptor::try_accept(tcp_socket& socket)
 {
 	using namespace boost::asio::detail;
@@ -860,8 +1468,145 @@ void tcp_acceptor::set_internal_non_blocking()
 }
 //////////////////////////////////////////////////////////////////////////
 
+tcp_shard_acceptor::Listener_::Listener_(const shared_strand& strand)
+:_strand(strand), _acceptor(strand->get_io_service()) {}
+
+tcp_shard_acceptor::tcp_shard_acceptor(io_engine& ios)
+:_ios(ios), _v6(false) {}
+
+tcp_shard_acceptor::~tcp_shard_acceptor()
+{
+	assert(_listeners.empty());
+	_close();
+}
+
+tcp_socket::result tcp_shard_acceptor::open(const char* ip, unsigned short port, size_t listeners, bool cpuSteering)
+{
+	boost::system::error_code ec;
+	boost::asio::ip::address address = boost::asio::ip::address::from_string(ip, ec);
+	if (ec)
+	{
+		return tcp_socket::result{ 0, ec.value(), false };
+	}
+	return _open(boost::asio::ip::tcp::endpoint(address, port), listeners, cpuSteering);
+}
+
+tcp_socket::result tcp_shard_acceptor::open_v4(unsigned short port, size_t listeners, bool cpuSteering)
+{
+	return _open(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4(), port), listeners, cpuSteering);
+}
+
+tcp_socket::result tcp_shard_acceptor::open_v6(unsigned short port, size_t listeners, bool cpuSteering)
+{
+	return _open(boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v6(), port), listeners, cpuSteering);
+}
+
+tcp_socket::result tcp_shard_acceptor::_open(const boost::asio::ip::tcp::endpoint& endpoint, size_t listeners, bool cpuSteering)
+{
+	if (!_listeners.empty())
+	{
+		return tcp_socket::result{ 0, 0, false };
+	}
+	if (0 == listeners)
+	{
+		listeners = _ios.isShard() ? _ios.shardCount() : _ios.ioThreads();
+		listeners = listeners ? listeners : 1;
+	}
+	_v6 = endpoint.address().is_v6();
+	_listeners.reserve(listeners);
+	for (size_t i = 0; i < listeners; i++)
+	{
+		_listeners.push_back(new Listener_(_ios.isShard() ? boost_strand::create(_ios, i) : boost_strand::create(_ios)));
+		tcp_socket::result res = _listeners.back()->_acceptor._open(endpoint, true);
+		if (!res.ok)
+		{
+			_close();
+			return res;
+		}
+	}
+	if (cpuSteering)
+	{
+		tcp_socket::result res = _listeners.front()->_acceptor.reuse_port_cpu_steering(listeners);
+		if (!res.ok)
+		{
+			_close();
+			return res;
+		}
+	}
+	return tcp_socket::result{ 0, 0, true };
+}
+
+void tcp_shard_acceptor::_start(size_t batch)
+{
+	assert(batch > 0);
+	for (Listener_* const listener : _listeners)
+	{
+		assert(!listener->_actor);
+		listener->_actor = my_actor::create(listener->_strand, [this, listener, batch](my_actor* self)
+		{
+			std::vector<tcp_socket::native_handle> sockets(batch);
+			while (true)
+			{
+				tcp_socket::result res = listener->_acceptor.accept_many(self, &sockets.front(), batch);
+				if (res.ok)
+				{
+					for (size_t i = 0; i < res.s; i++)
+					{
+						_handler(listener->_strand, sockets[i], _v6);
+					}
+				}
+				else if (boost::asio::error::no_descriptors == res.code || boost::asio::error::no_buffer_space == res.code ||
+					boost::asio::error::no_memory == res.code || ENFILE == res.code)
+				{
+					//资源暂时耗尽，稍后再取
+					self->sleep(1);
+				}
+				else
+				{
+					break;
+				}
+			}
+		});
+		listener->_actor->run();
+	}
+}
+
+void tcp_shard_acceptor::close(my_actor* host)
+{
+	my_actor::quit_guard qg(host);
+	for (Listener_* const listener : _listeners)
+	{
+		if (listener->_actor)
+		{
+			host->send(listener->_strand, [listener]
+			{
+				listener->_acceptor.close();
+			});
+			host->actor_wait_quit(listener->_actor);
+		}
+	}
+	_close();
+}
+
+void tcp_shard_acceptor::_close()
+{
+	for (Listener_* const listener : _listeners)
+	{
+		listener->_acceptor.close();
+		delete listener;
+	}
+	_listeners.clear();
+	_handler = nullptr;
+}
+
+size_t tcp_shard_acceptor::size()
+{
+	return _listeners.size();
+}
+//////////////////////////////////////////////////////////////////////////
+
 udp_socket::udp_socket(io_engine& ios)
-:_socket(ios), _nonBlocking(false)
+:_socket(ios), _batchBuffSize(2048), _nonBlocking(false)
 #ifdef ENABLE_ASIO_PRE_OP
 , _preOption(false)
 #endif
@@ -1103,6 +1848,285 @@ udp_socket::result udp_socket::timed_receive(my_actor* host, int ms, void* buff,
 	return overtime ? result{ 0, boost::asio::error::timed_out, false } : res;
 }
 
+void udp_socket::set_batch_buffer_size(size_t size)
+{
+	assert(size > 0);
+	if (size != _batchBuffSize)
+	{
+		_batchBuffSize = size;
+		_batchBuff.destroy();
+	}
+}
+
+udp_socket::result udp_socket::receive_batch(my_actor* host, size_t max, datagram* out, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive_batch(max, out, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::timed_receive_batch(my_actor* host, int ms, size_t max, datagram* out, int flags)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	async_receive_batch(max, out, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		boost::system::error_code ec;
+		_socket.cancel(ec);
+	}, res), flags);
+	return overtime ? result{ 0, boost::asio::error::timed_out, false } : res;
+}
+
+udp_socket::result udp_socket::try_receive_batch(size_t max, datagram* out, int flags)
+{
+	assert(max > 0);
+	if (!_nonBlocking)
+	{
+		return result{ 0, boost::asio::error::would_block, false };
+	}
+	if (!_batchBuff.has())
+	{
+		_batchBuff.create();
+	}
+	BatchBuff_& bb = _batchBuff.get();
+	if (bb._buffs.size() < max)
+	{
+		bb._buff.resize(max * _batchBuffSize);
+		bb._buffs.resize(max);
+		bb._lengths.resize(max, _batchBuffSize);
+		bb._bytes.resize(max);
+		bb._endpoints.resize(max);
+		for (size_t i = 0; i < max; i++)
+		{
+			bb._buffs[i] = &bb._buff[i * _batchBuffSize];
+		}
+	}
+	result res = try_mreceive_from(&bb._endpoints.front(), &bb._buffs.front(), &bb._lengths.front(), max, &bb._bytes.front(), flags);
+	if (res.ok)
+	{
+		for (size_t i = 0; i < res.s; i++)
+		{
+			out[i].data = bb._buffs[i];
+			out[i].length = bb._bytes[i];
+			out[i].remoteEndpoint = &bb._endpoints[i];
+		}
+	}
+	return res;
+}
+
+udp_socket::result udp_socket::enable_gro(bool enable)
+{
+#if defined(__linux__) && defined(UDP_GRO)
+	int val = enable ? 1 : 0;
+	if (0 != setsockopt(_socket.native_handle(), SOL_UDP, UDP_GRO, &val, sizeof(val)))
+	{
+		return result{ 0, errno, false };
+	}
+	return result{ 0, 0, true };
+#else
+	return result{ 0, boost::asio::error::operation_not_supported, false };
+#endif
+}
+
+udp_socket::result udp_socket::send_segments(my_actor* host, const void* buff, size_t length, size_t segmentSize, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_send_segments(buff, length, segmentSize, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::send_segments_to(my_actor* host, const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, size_t segmentSize, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_send_segments_to(remoteEndpoint, buff, length, segmentSize, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::receive_segments(my_actor* host, void* buff, size_t length, size_t& segmentSize, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive_segments(buff, length, segmentSize, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::receive_segments_from(my_actor* host, void* buff, size_t length, size_t& segmentSize, int flags)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive_segments_from(buff, length, segmentSize, std::move(h), flags);
+	});
+}
+
+udp_socket::result udp_socket::try_send_segments(const void* buff, size_t length, size_t segmentSize, int flags)
+{
+	return _try_send_segments(NULL, buff, length, segmentSize, flags);
+}
+
+udp_socket::result udp_socket::try_send_segments_to(const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, size_t segmentSize, int flags)
+{
+	return _try_send_segments(&remoteEndpoint, buff, length, segmentSize, flags);
+}
+
+udp_socket::result udp_socket::try_receive_segments(void* buff, size_t length, size_t& segmentSize, int flags)
+{
+	return _try_receive_segments(NULL, buff, length, segmentSize, flags);
+}
+
+udp_socket::result udp_socket::try_receive_segments_from(boost::asio::ip::udp::endpoint& remoteEndpoint, void* buff, size_t length, size_t& segmentSize, int flags)
+{
+	return _try_receive_segments(&remoteEndpoint, buff, length, segmentSize, flags);
+}
+
+udp_socket::result udp_socket::_try_send_segments(const boost::asio::ip::udp::endpoint* remoteEndpoint, const void* buff, size_t length, size_t segmentSize, int flags)
+{
+	result res = { 0, 0, false };
+	if (!_nonBlocking)
+	{
+		res.code = boost::asio::error::would_block;
+		return res;
+	}
+#if defined(__linux__) && defined(UDP_SEGMENT)
+	assert(segmentSize > 0 && segmentSize <= 0xFFFF);
+	struct iovec iov;
+	iov.iov_base = (void*)buff;
+	iov.iov_len = length;
+	union
+	{
+		char buf[CMSG_SPACE(sizeof(uint16_t))];
+		struct cmsghdr align;
+	} ctrl;
+	struct msghdr mhdr;
+	memset(&mhdr, 0, sizeof(mhdr));
+	mhdr.msg_iov = &iov;
+	mhdr.msg_iovlen = 1;
+	if (remoteEndpoint)
+	{
+		mhdr.msg_name = (void*)remoteEndpoint->data();
+		mhdr.msg_namelen = (socklen_t)remoteEndpoint->size();
+	}
+	if (length > segmentSize)
+	{
+		mhdr.msg_control = ctrl.buf;
+		mhdr.msg_controllen = sizeof(ctrl.buf);
+		struct cmsghdr* cm = CMSG_FIRSTHDR(&mhdr);
+		cm->cmsg_level = SOL_UDP;
+		cm->cmsg_type = UDP_SEGMENT;
+		cm->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+		*(uint16_t*)CMSG_DATA(cm) = (uint16_t)segmentSize;
+	}
+	while (true)
+	{
+		const ssize_t bytes = ::sendmsg(_socket.native_handle(), &mhdr, flags | MSG_NOSIGNAL);
+		if (bytes >= 0)
+		{
+			res.ok = true;
+			res.s = (size_t)bytes;
+			break;
+		}
+		if (EINTR != errno)
+		{
+			res.code = errno;
+			break;
+		}
+	}
+	return res;
+#else
+	//不支持GSO时逐个数据报发送
+	while (res.s < length)
+	{
+		const size_t segLen = std::min(segmentSize, length - res.s);
+		result tr = remoteEndpoint ? try_send_to(*remoteEndpoint, (const char*)buff + res.s, segLen, flags) : try_send((const char*)buff + res.s, segLen, flags);
+		if (!tr.ok)
+		{
+			if (res.s && try_again(tr))
+			{
+				break;
+			}
+			res.code = tr.code;
+			return res;
+		}
+		res.s += tr.s;
+	}
+	res.ok = true;
+	return res;
+#endif
+}
+
+udp_socket::result udp_socket::_try_receive_segments(boost::asio::ip::udp::endpoint* remoteEndpoint, void* buff, size_t length, size_t& segmentSize, int flags)
+{
+	result res = { 0, 0, false };
+	if (!_nonBlocking)
+	{
+		res.code = boost::asio::error::would_block;
+		return res;
+	}
+#if defined(__linux__) && defined(UDP_GRO)
+	struct iovec iov;
+	iov.iov_base = buff;
+	iov.iov_len = length;
+	union
+	{
+		char buf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} ctrl;
+	struct msghdr mhdr;
+	memset(&mhdr, 0, sizeof(mhdr));
+	mhdr.msg_iov = &iov;
+	mhdr.msg_iovlen = 1;
+	mhdr.msg_control = ctrl.buf;
+	mhdr.msg_controllen = sizeof(ctrl.buf);
+	if (remoteEndpoint)
+	{
+		mhdr.msg_name = (void*)remoteEndpoint->data();
+		mhdr.msg_namelen = (socklen_t)remoteEndpoint->capacity();
+	}
+	while (true)
+	{
+		const ssize_t bytes = ::recvmsg(_socket.native_handle(), &mhdr, flags);
+		if (bytes >= 0)
+		{
+			res.ok = true;
+			res.s = (size_t)bytes;
+			segmentSize = (size_t)bytes;
+			for (struct cmsghdr* cm = CMSG_FIRSTHDR(&mhdr); cm; cm = CMSG_NXTHDR(&mhdr, cm))
+			{
+				if (SOL_UDP == cm->cmsg_level && UDP_GRO == cm->cmsg_type)
+				{
+					segmentSize = (size_t)*(int*)CMSG_DATA(cm);
+					break;
+				}
+			}
+			if (remoteEndpoint)
+			{
+				remoteEndpoint->resize(mhdr.msg_namelen);
+			}
+			break;
+		}
+		if (EINTR != errno)
+		{
+			res.code = errno;
+			break;
+		}
+	}
+	return res;
+#else
+	res = remoteEndpoint ? try_receive_from(*remoteEndpoint, buff, length, flags) : try_receive(buff, length, flags);
+	segmentSize = res.s;
+	return res;
+#endif
+}
+
 udp_socket::result udp_socket::try_send(const void* buff, size_t length, int flags)
 {
 	using namespace boost::asio::detail;
@@ -1624,7 +2648,7 @@ udp_socket::result udp_socket::try_mreceive_from(boost::asio::ip::udp::endpoint*
 			res.s += pcks;
 			for (size_t j = 0; j < (size_t)pcks; j++)
 			{
-				remoteEndpoints[i*fixed_array_length(msgs) + j].resize(mhdr[ct].msg_hdr.msg_namelen);
+				remoteEndpoints[i*fixed_array_length(msgs) + j].resize(mhdr[j].msg_hdr.msg_namelen);
 			}
 			if (bytes)
 			{
@@ -8,8 +8,9 @@
 #include "my_actor.h"
 
 class tcp_acceptor;
+class tcp_shard_acceptor;
 /*!
-@brief tcpͨ
+@brief tcp通信
 */
 class tcp_socket
 {
@@ -17,11 +18,136 @@ class tcp_socket
 public:
 	struct result
 	{
-		size_t s;///<ֽ/
-		int code;///<
-		bool ok;///<Ƿɹ
+		size_t s;///<字节数/缓存数
+		int code;///<错误码
+		bool ok;///<是否成功
 	};
+
+	typedef boost::asio::ip::tcp::socket::native_handle_type native_handle;
 private:
+	struct CorkWrite_
+	{
+		virtual ~CorkWrite_() __disable_noexcept {}
+		virtual void invoke(const result& res) = 0;
+
+		void complete(const result& res)
+		{
+			if (_syncDone)
+			{
+				*_syncDone = true;
+			}
+			invoke(res);
+		}
+
+		const void* _buff;
+		size_t _length;
+		CorkWrite_* _next;
+		bool* _syncDone;///<async_write调用期间指向其栈上标记，用于判断是否同步完成
+	};
+
+	template <typename Handler>
+	struct cork_write : public CorkWrite_
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		cork_write(const void* buff, size_t length, Handler& handler)
+			:_handler(std::forward<Handler>(handler))
+		{
+			CorkWrite_::_buff = buff;
+			CorkWrite_::_length = length;
+			CorkWrite_::_next = NULL;
+			CorkWrite_::_syncDone = NULL;
+		}
+
+		void invoke(const result& res)
+		{
+			_handler(res);
+		}
+
+		handler_type _handler;
+		NONE_COPY(cork_write);
+	};
+
+	struct CorkState_
+	{
+		tcp_socket* _socket;
+		shared_strand _strand;
+		size_t _maxBytes;
+		size_t _maxIovs;
+		size_t _bytes;
+		size_t _count;
+		CorkWrite_* _head;
+		CorkWrite_* _tail;
+		CorkWrite_* _flying;
+		int _error;///<Actor中write拷贝排队的数据发送失败的错误码，之后的write/flush返回它
+		bool _tickPosted;
+		std::vector<const void*> _buffs;
+		std::vector<size_t> _lengths;
+		std::vector<boost::asio::const_buffer> _iovs;
+	};
+
+	/*!
+	@brief Actor中write的数据拷贝到这里排队，不等待发送完成，失败时记录到CorkState_::_error
+	*/
+	struct CorkCopy_ : public CorkWrite_
+	{
+		CorkCopy_(CorkState_* cork, const void* buff, size_t length);
+		~CorkCopy_();
+		void invoke(const result& res);
+
+		CorkState_* _cork;
+		NONE_COPY(CorkCopy_);
+	};
+
+	/*!
+	@brief 一个方向的转发，每一步都在_strand中执行，与在同一strand中的close串行，不会在splice途中关闭并复用fd
+	*/
+	struct RelayOp_
+	{
+		RelayOp_(const shared_strand& strand, tcp_socket& src, tcp_socket& dst, size_t maxBytes);
+		virtual ~RelayOp_() __disable_noexcept;
+		virtual void complete(const result& res) = 0;
+		bool run();
+	private:
+		bool step(boost::asio::socket_base::wait_type& waitType, tcp_socket*& waitSocket);
+		bool failed(int code);
+		bool finished();
+	private:
+		shared_strand _strand;
+		tcp_socket& _src;
+		tcp_socket& _dst;
+		size_t _maxBytes;
+		size_t _bytes;
+		size_t _inPipe;
+#ifdef __linux__
+		int _pipe[2];
+#else
+		std::vector<char> _buff;
+		size_t _begin;
+#endif
+		result _res;
+		bool _eof;
+		NONE_COPY(RelayOp_);
+	};
+
+	template <typename Handler>
+	struct relay_op : public RelayOp_
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		relay_op(const shared_strand& strand, tcp_socket& src, tcp_socket& dst, size_t maxBytes, Handler& handler)
+			:RelayOp_(strand, src, dst, maxBytes), _handler(std::forward<Handler>(handler)) {}
+
+		void complete(const result& res)
+		{
+			handler_type handler(std::move(_handler));
+			delete this;
+			handler(res);
+		}
+
+		handler_type _handler;
+		NONE_COPY(relay_op);
+	};
 #ifdef ENABLE_ASIO_PRE_OP
 #ifdef HAS_ASIO_HANDLER_IS_TRIED
 	template <typename Handler>
@@ -144,12 +270,12 @@ public:
 	~tcp_socket();
 public:
 	/*!
-	@brief no_delay
+	@brief 设置no_delay属性
 	*/
 	result no_delay();
 
 	/*!
-	@brief linuxŻ첽أݣasync_xxxֱӻص
+	@brief linux下优化异步返回（如果有数据，在async_xxx操作中直接回调）
 	*/
 	void pre_option();
 
@@ -159,79 +285,132 @@ public:
 	bool is_pre_option();
 
 	/*!
-	@brief ض˿IP
+	@brief 本地端口IP
 	*/
 	std::string local_endpoint(unsigned short& port);
 
 	/*!
-	@brief Զ˶˿IP
+	@brief 远端端口IP
 	*/
 	std::string remote_endpoint(unsigned short& port);
 
 	/*!
-	@brief һԶĿ
+	@brief 创建一个远端目标
 	*/
 	static boost::asio::ip::tcp::endpoint make_endpoint(const char* remoteIp, unsigned short remotePort);
 
 	/*!
-	@brief ͻģʽԶ˷
+	@brief 客户端模式下连接远端服务器
 	*/
 	result connect(my_actor* host, const boost::asio::ip::tcp::endpoint& remoteEndpoint);
 	result connect(my_actor* host, const char* remoteIp, unsigned short remotePort);
 
 	/*!
-	@brief ڶȡݣֱ
+	@brief 往缓冲区内读取数据，直到读满
 	*/
 	result read(my_actor* host, void* buff, size_t length);
 
 	/*!
-	@brief ڶȡݣжٶ
+	@brief 往缓冲区内读取数据，有多少读多少
 	*/
 	result read_some(my_actor* host, void* buff, size_t length);
 
 	/*!
-	@brief ȫͳȥ
+	@brief 将数据全部发送出去；写合并时把数据拷贝到待发送队列后立即返回，
+	之前排队的数据发送失败时返回该错误(不再排队)，正在发送且队列超过maxBytes时等待本次写完成
 	*/
 	result write(my_actor* host, const void* buff, size_t length);
 
 	/*!
-	@brief ݷͳȥܷǶ
+	@brief 写合并时等待已排队的数据全部发送，返回之前Actor中write排队的数据的发送错误；未启用写合并时直接返回成功
+	*/
+	result flush(my_actor* host);
+
+	/*!
+	@brief 将数据发送出去，能发多少是多少
 	*/
 	result write_some(my_actor* host, const void* buff, size_t length);
 
 	/*!
-	@brief msʱ䷶ΧڣͻģʽԶ˷
+	@brief 在ms时间范围内，客户端模式下连接远端服务器
 	*/
 	result timed_connect(my_actor* host, int ms, const boost::asio::ip::tcp::endpoint& remoteEndpoint);
 	result timed_connect(my_actor* host, int ms, const char* remoteIp, unsigned short remotePort);
 
 	/*!
-	@brief msʱ䷶Χڣڶȡݣֱ
+	@brief 在ms时间范围内，往缓冲区内读取数据，直到读满
 	*/
 	result timed_read(my_actor* host, int ms, void* buff, size_t length);
 
 	/*!
-	@brief msʱ䷶Χڣڶȡݣжٶ
+	@brief 在ms时间范围内，往缓冲区内读取数据，有多少读多少
 	*/
 	result timed_read_some(my_actor* host, int ms, void* buff, size_t length);
 
 	/*!
-	@brief msʱ䷶Χڣȫͳȥ
+	@brief 在ms时间范围内，将数据全部发送出去
 	*/
 	result timed_write(my_actor* host, int ms, const void* buff, size_t length);
 
 	/*!
-	@brief msʱ䷶ΧڣݷͳȥܷǶ
+	@brief 在ms时间范围内，将数据发送出去，能发多少是多少
 	*/
 	result timed_write_some(my_actor* host, int ms, const void* buff, size_t length);
 
 	/*!
-	@brief رsocket
+	@brief 关闭socket
 	*/
 	result close();
 
 	/*!
-	@brief 첽ģʽ£ͻģʽԶ˷
+	@brief 启用写合并(auto-cork)，之后write/async_write先追加到待发送队列，在strand本轮结束时(或累计超过maxBytes/maxIovs时)
+	合并为一次writev发送，每个写操作仍单独回调；启用后write/async_write只能在strand中调用
+	*/
+	void cork(const shared_strand& strand, size_t maxBytes = 64 * 1024, size_t maxIovs = 64);
+
+	/*!
+	@brief 关闭写合并(只能在没有未完成的write/async_write时调用，Actor中write过的要先flush)
+	*/
+	void uncork();
+
+	/*!
+	@brief 是否启用了写合并
+	*/
+	bool is_corked();
+
+	/*!
+	@brief 接管一个已连接的原生socket(如tcp_acceptor::accept_many取得的连接)
+	@param v6 是否ip v6连接
+	*/
+	result assign(native_handle sck, bool v6 = false);
+
+	/*!
+	@brief 关闭一个未被接管的原生socket
+	*/
+	static void close_native(native_handle sck);
+
+	/*!
+	@brief 把本端收到的数据转发到dst(linux下经由管道splice，数据不经过用户空间)，直到本端EOF、出错或转发满maxBytes；
+	本端EOF时关闭dst的发送端(半关闭)；转发在host的strand中进行，转发期间两端只能在该strand中关闭
+	@return s 实际转发到dst的字节数
+	*/
+	result relay(my_actor* host, tcp_socket& dst, size_t maxBytes = -1);
+
+	/*!
+	@brief 在ms时间范围内转发数据到dst，超时关闭两端socket
+	*/
+	result timed_relay(my_actor* host, int ms, tcp_socket& dst, size_t maxBytes = -1);
+
+	/*!
+	@brief 在一个actor中双向转发a、b两端数据，直到两个方向都结束；一个方向出错时关闭两端，
+	两个方向都在host的strand中执行，关闭不会与另一方向的splice交错
+	@param bytesAB a到b转发的字节数，bytesBA b到a转发的字节数
+	@return s 两个方向转发的总字节数
+	*/
+	static result relay_both(my_actor* host, tcp_socket& a, tcp_socket& b, size_t* bytesAB = NULL, size_t* bytesBA = NULL);
+
+	/*!
+	@brief 异步模式下，客户端模式下连接远端服务器
 	*/
 	template <typename Handler>
 	bool async_connect(const boost::asio::ip::tcp::endpoint& remoteEndpoint, Handler&& handler)
@@ -255,7 +434,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£ڶȡݣֱ
+	@brief 异步模式下，往缓冲区内读取数据，直到读满
 	*/
 	template <typename Handler>
 	bool async_read(void* buff, size_t length, Handler&& handler)
@@ -304,7 +483,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£ȡݣжٶ
+	@brief 异步模式下，往读取数据，有多少读多少
 	*/
 	template <typename Handler>
 	bool async_read_some(void* buff, size_t length, Handler&& handler)
@@ -337,11 +516,15 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£ȫͳȥ
+	@brief 异步模式下，将数据全部发送出去
 	*/
 	template <typename Handler>
 	bool async_write(const void* buff, size_t length, Handler&& handler)
 	{
+		if (_cork)
+		{
+			return _cork_write(new cork_write<Handler>(buff, length, handler));
+		}
 #ifdef ENABLE_ASIO_PRE_OP
 		size_t trySize = 0;
 		if (is_pre_option())
@@ -386,7 +569,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£ݷͳȥܷǶ
+	@brief 异步模式下，将数据发送出去，能发多少是多少
 	*/
 	template <typename Handler>
 	bool async_write_some(const void* buff, size_t length, Handler&& handler)
@@ -418,9 +601,21 @@ public:
 		return false;
 	}
 
+	/*!
+	@brief 异步模式下，把本端收到的数据转发到dst，参数同relay；必须在strand中调用，
+	每一步转发和handler都在strand中执行，完成前两端只能在strand中关闭
+	@return true 同步完成
+	*/
+	template <typename Handler>
+	bool async_relay(const shared_strand& strand, tcp_socket& dst, size_t maxBytes, Handler&& handler)
+	{
+		assert(strand->running_in_this_thread());
+		return (new relay_op<Handler>(strand, *this, dst, maxBytes, handler))->run();
+	}
+
 #ifdef HAS_ASIO_SEND_FILE
 	/*!
-	@brief һļ
+	@brief 发送一个文件
 	*/
 #ifdef __linux__
 	template <typename Handler>
@@ -485,31 +680,31 @@ public:
 #endif
 
 	/*!
-	@brief д
+	@brief 非阻塞尝试写入数据
 	*/
 	result try_write_same(const void* buff, size_t length);
 
 	/*!
-	@brief Զȡ
+	@brief 非阻塞尝试读取数据
 	*/
 	result try_read_same(void* buff, size_t length);
 
 	/*!
-	@brief һд
-	@param lastBytesΪ NULL ʱдһʵд˶ֽ
-	@return lastBytes Ϊ NULL ʱʵд˶ٸݣΪ NULL ʱܹд˶ֽ
+	@brief 非阻塞尝试一次写入多个数据
+	@param lastBytes，不为 NULL 时返回写入的最后一个缓存实际写了多少字节
+	@return lastBytes 不为 NULL 时返回实际写入了多少个缓存数据，为 NULL 时总共写了多少字节数据
 	*/
 	result try_mwrite_same(const void* const* buffs, const size_t* lengths, size_t count, size_t* lastBytes = NULL);
 
 	/*!
-	@brief һζȡ
-	@param lastBytesΪ NULL ʱضȡһʵд˶ֽ
-	@return lastBytes Ϊ NULL ʱʵʶȡ˶ٸݣΪ NULL ʱܹȡ˶ֽ
+	@brief 非阻塞尝试一次读取多个数据
+	@param lastBytes，不为 NULL 时返回读取的最后一个缓存实际写了多少字节
+	@return lastBytes 不为 NULL 时返回实际读取了多少个缓存数据，为 NULL 时总共读取了多少字节数据
 	*/
 	result try_mread_same(void* const* buffs, const size_t* lengths, size_t count, size_t* lastBytes = NULL);
 
 	/*!
-	@brief try_ioʧǷΪEAGAIN
+	@brief try_io操作失败是否是因为EAGAIN
 	*/
 	static bool try_again(const result& res);
 private:
@@ -523,8 +718,14 @@ private:
 	result _try_mwrite_same(const void* const* buffs, const size_t* lengths, size_t count);
 	result _try_mread_same(void* const* buffs, const size_t* lengths, size_t count);
 	void set_internal_non_blocking();
+	bool _cork_write(CorkWrite_* cw);
+	result _cork_write_copy(const void* buff, size_t length);
+	void _cork_flush();
+	void _cork_send(size_t skip);
+	void _cork_complete(const boost::system::error_code& ec, size_t bytes);
 private:
 	boost::asio::ip::tcp::socket _socket;
+	std::shared_ptr<CorkState_> _cork;
 #ifdef HAS_ASIO_SEND_FILE
 #ifdef __linux__
 	boost::asio::detail::socket_ops::send_file_pck _sendFileState;
@@ -538,36 +739,45 @@ private:
 };
 
 /*!
-@brief 
+@brief 服务器侦听器
 */
 class tcp_acceptor
 {
+	friend tcp_shard_acceptor;
 public:
 	tcp_acceptor(io_engine& ios);
+	tcp_acceptor(boost::asio::io_service& ios);
 	~tcp_acceptor();
 public:
 	/*!
-	@brief ֻضipӸ÷
+	@brief 只允许特定ip连接该服务器
+	@param reusePort 设置SO_REUSEPORT，多个侦听器共享同一端口，由内核分发连接
+	*/
+	tcp_socket::result open(const char* ip, unsigned short port, bool reusePort = false);
+
+	/*!
+	@brief ip v4下打开服务器
 	*/
-	tcp_socket::result open(const char* ip, unsigned short port);
+	tcp_socket::result open_v4(unsigned short port, bool reusePort = false);
 
 	/*!
-	@brief ip v4´򿪷
+	@brief ip v6下打开服务器
 	*/
-	tcp_socket::result open_v4(unsigned short port);
+	tcp_socket::result open_v6(unsigned short port, bool reusePort = false);
 
 	/*!
-	@brief ip v6´򿪷
+	@brief linux下为SO_REUSEPORT侦听组附加CBPF分发策略，新连接按(处理该连接的CPU号 % groups)分发到组内第几个侦听器，
+	只需在组内任意一个侦听器上设置，侦听线程绑定到对应CPU时连接的整个处理过程都不跨核
 	*/
-	tcp_socket::result open_v6(unsigned short port);
+	tcp_socket::result reuse_port_cpu_steering(size_t groups);
 
 	/*!
-	@brief ر
+	@brief 关闭侦听器
 	*/
 	tcp_socket::result close();
 
 	/*!
-	@brief linuxŻ첽أݣasync_xxxֱӻص
+	@brief linux下优化异步返回（如果有数据，在async_xxx操作中直接回调）
 	*/
 	void pre_option();
 
@@ -577,17 +787,42 @@ public:
 	bool is_pre_option();
 
 	/*!
-	@brief socketͻ
+	@brief 用socket侦听客户端连接
 	*/
 	tcp_socket::result accept(my_actor* host, tcp_socket& socket);
 
 	/*!
-	@brief msʱ䷶Χڣsocketͻ
+	@brief 在ms时间范围内，用socket侦听客户端连接
 	*/
 	tcp_socket::result timed_accept(my_actor* host, int ms, tcp_socket& socket);
 
 	/*!
-	@brief 첽ģʽ£socketͻ
+	@brief 批量侦听客户端连接，backlog为空时等待侦听器可读，之后一次取尽backlog(最多maxCount个)
+	@param sockets 取得的原生socket(非阻塞)，由调用者用tcp_socket::assign接管或tcp_socket::close_native关闭
+	@return s为取得的连接数
+	*/
+	tcp_socket::result accept_many(my_actor* host, tcp_socket::native_handle* sockets, size_t maxCount);
+
+	/*!
+	@brief 非阻塞批量取出backlog中的连接，没有连接时返回would_block
+	*/
+	tcp_socket::result try_accept_many(tcp_socket::native_handle* sockets, size_t maxCount);
+
+	/*!
+	@brief 异步模式下，等待侦听器上有新连接到达
+	*/
+	template <typename Handler>
+	void async_wait_accept(Handler&& handler)
+	{
+		_acceptor->async_wait(boost::asio::ip::tcp::acceptor::wait_read, std::bind([](Handler& handler, const boost::system::error_code& ec)
+		{
+			tcp_socket::result res = { 0, ec.value(), !ec };
+			handler(res);
+		}, std::forward<Handler>(handler), __1));
+	}
+
+	/*!
+	@brief 异步模式下，用socket侦听客户端连接
 	*/
 	template <typename Handler>
 	bool async_accept(tcp_socket& socket, Handler&& handler)
@@ -631,10 +866,11 @@ public:
 		return false;
 	}
 private:
+	tcp_socket::result _open(const boost::asio::ip::tcp::endpoint& endpoint, bool reusePort);
 	void set_internal_non_blocking();
 	tcp_socket::result try_accept(tcp_socket& socket);
 private:
-	io_engine& _ios;
+	boost::asio::io_service& _ios;
 	stack_obj<boost::asio::ip::tcp::acceptor> _acceptor;
 	bool _nonBlocking;
 #ifdef ENABLE_ASIO_PRE_OP
@@ -644,63 +880,151 @@ private:
 };
 
 /*!
-@brief udpͨ
+@brief 多侦听器服务器，每个io线程(分片模式下每个分片)打开一个SO_REUSEPORT侦听器，由内核在侦听器间分发连接，
+每个侦听器在自己的strand上用一个Actor批量取尽backlog，新连接直接在该strand上回调，避免单侦听器逐个accept的瓶颈
+*/
+class tcp_shard_acceptor
+{
+	struct Listener_
+	{
+		Listener_(const shared_strand& strand);
+
+		shared_strand _strand;
+		tcp_acceptor _acceptor;
+		actor_handle _actor;
+	};
+public:
+	tcp_shard_acceptor(io_engine& ios);
+	~tcp_shard_acceptor();
+public:
+	/*!
+	@brief 只允许特定ip连接该服务器
+	@param listeners 侦听器数，0表示分片模式下为分片数，否则为io线程数
+	@param cpuSteering 是否附加按CPU分发的CBPF策略(linux)
+	*/
+	tcp_socket::result open(const char* ip, unsigned short port, size_t listeners = 0, bool cpuSteering = false);
+
+	/*!
+	@brief ip v4下打开服务器
+	*/
+	tcp_socket::result open_v4(unsigned short port, size_t listeners = 0, bool cpuSteering = false);
+
+	/*!
+	@brief ip v6下打开服务器
+	*/
+	tcp_socket::result open_v6(unsigned short port, size_t listeners = 0, bool cpuSteering = false);
+
+	/*!
+	@brief 开始侦听，新连接在所在侦听器的strand中以handler(const shared_strand& strand, tcp_socket::native_handle sck, bool v6)回调，
+	handler负责用tcp_socket::assign接管或tcp_socket::close_native关闭sck
+	@param batch 每次最多取出的连接数
+	*/
+	template <typename Handler>
+	void start(Handler&& handler, size_t batch = 64)
+	{
+		assert(!_handler);
+		_handler = std::forward<Handler>(handler);
+		_start(batch);
+	}
+
+	/*!
+	@brief 关闭所有侦听器，并等待侦听Actor退出
+	*/
+	void close(my_actor* host);
+
+	/*!
+	@brief 侦听器数
+	*/
+	size_t size();
+private:
+	tcp_socket::result _open(const boost::asio::ip::tcp::endpoint& endpoint, size_t listeners, bool cpuSteering);
+	void _start(size_t batch);
+	void _close();
+private:
+	io_engine& _ios;
+	std::vector<Listener_*> _listeners;
+	std::function<void(const shared_strand&, tcp_socket::native_handle, bool)> _handler;
+	bool _v6;
+	NONE_COPY(tcp_shard_acceptor);
+};
+
+/*!
+@brief udp通信
 */
 class udp_socket
 {
 public:
 	struct result
 	{
-		size_t s;///<ֽ/
-		int code;///<
-		bool ok;///<Ƿɹ
+		size_t s;///<字节数/缓存数
+		int code;///<错误码
+		bool ok;///<是否成功
+	};
+
+	/*!
+	@brief receive_batch取得的数据报，data指向套接字内部复用的缓存，在下一次receive_batch前有效
+	*/
+	struct datagram
+	{
+		const void* data;
+		size_t length;
+		const boost::asio::ip::udp::endpoint* remoteEndpoint;
+	};
+private:
+	struct BatchBuff_
+	{
+		std::vector<char> _buff;
+		std::vector<void*> _buffs;
+		std::vector<size_t> _lengths;
+		std::vector<size_t> _bytes;
+		std::vector<boost::asio::ip::udp::endpoint> _endpoints;
 	};
 public:
 	udp_socket(io_engine& ios);
 	~udp_socket();
 public:
 	/*!
-	@brief رsocket
+	@brief 关闭socket
 	*/
 	result close();
 
 	/*!
-	@brief ip v4ģʽsocket
+	@brief ip v4模式打开socket
 	*/
 	result open_v4();
 
 	/*!
-	@brief ip v6ģʽsocket
+	@brief ip v6模式打开socket
 	*/
 	result open_v6();
 
 	/*!
-	@brief 󶨱һipĳ˿ڽշ
+	@brief 绑定本地一个ip下某个端口接收发送数据
 	*/
 	result bind(const char* ip, unsigned short port);
 
 	/*!
-	@brief ip v4ĳ˿ڽշ
+	@brief 绑定ip v4下某个端口接收发送数据
 	*/
 	result bind_v4(unsigned short port);
 
 	/*!
-	@brief ip v6ĳ˿ڽշ
+	@brief 绑定ip v6下某个端口接收发送数据
 	*/
 	result bind_v6(unsigned short port);
 
 	/*!
-	@brief 򿪲ip v4ĳ˿ڽշ
+	@brief 打开并绑定ip v4下某个端口接收发送数据
 	*/
 	result open_bind_v4(unsigned short port);
 
 	/*!
-	@brief 򿪲ip v6ĳ˿ڽշ
+	@brief 打开并绑定ip v6下某个端口接收发送数据
 	*/
 	result open_bind_v6(unsigned short port);
 
 	/*!
-	@brief linuxŻ첽أݣasync_xxxֱӻص
+	@brief linux下优化异步返回（如果有数据，在async_xxx操作中直接回调）
 	*/
 	void pre_option();
 
@@ -710,78 +1034,123 @@ public:
 	bool is_pre_option();
 
 	/*!
-	@brief 趨һԶ̶˿ΪĬϷͽĿ
+	@brief 设定一个远程端口作为默认发送接收目标
 	*/
 	result connect(const char* remoteIp, unsigned short remotePort);
 	result connect(const boost::asio::ip::udp::endpoint& remoteEndpoint);
 
 	/*!
-	@brief ݵָĿ
+	@brief 发送数据到指定目标
 	*/
 	result send_to(my_actor* host, const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief ݵָĿ
+	@brief 发送数据到指定目标
 	*/
 	result send_to(my_actor* host, const char* remoteIp, unsigned short remotePort, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief connectɹ󣬷ݵĬĿ
+	@brief 在connect成功后，发送数据到默认目标
 	*/
 	result send(my_actor* host, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief Զ˷͵ݵ¼Զ˵ַ
+	@brief 接收远端发送的数据到缓冲区，并记录下远端地址
 	*/
 	result receive_from(my_actor* host, void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief Զ˷͵ݵ
+	@brief 接收远端发送的数据到缓冲区
 	*/
 	result receive(my_actor* host, void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief msʱ䷶ΧڣݵָĿ꣨ϵͳ˻ᵼ·
+	@brief 在ms时间范围内，发送数据到指定目标（本地系统缓存满了会导致发送阻塞）
 	*/
 	result timed_send_to(my_actor* host, int ms, const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief msʱ䷶ΧڣݵָĿ꣨ϵͳ˻ᵼ·
+	@brief 在ms时间范围内，发送数据到指定目标（本地系统缓存满了会导致发送阻塞）
 	*/
 	result timed_send_to(my_actor* host, int ms, const char* remoteIp, unsigned short remotePort, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief connectɹmsʱ䷶ΧڣݵĬĿ꣨ϵͳ˻ᵼ·
+	@brief connect成功后，在ms时间范围内，发送数据到默认目标（本地系统缓存满了会导致发送阻塞）
 	*/
 	result timed_send(my_actor* host, int ms, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief msʱ䷶ΧڣԶ˷͵ݵ¼Զ˵ַ
+	@brief 在ms时间范围内，接收远端发送的数据到缓冲区，并记录下远端地址
 	*/
 	result timed_receive_from(my_actor* host, int ms, void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief msʱ䷶ΧڣԶ˷͵ݵ
+	@brief 在ms时间范围内，接收远端发送的数据到缓冲区
 	*/
 	result timed_receive(my_actor* host, int ms, void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief һԶĿ
+	@brief 设置receive_batch中每个数据报的缓存大小(默认2048字节，超出部分被截断)
+	*/
+	void set_batch_buffer_size(size_t size);
+
+	/*!
+	@brief 批量接收，没有数据时挂起Actor，就绪后一次取出最多max个数据报(linux下为一次recvmmsg)到套接字内部复用的缓存中，
+	避免逐个数据报切换和分配
+	@param out 至少max个元素，其中data在下一次receive_batch前有效
+	@return s为接收到的数据报数
+	*/
+	result receive_batch(my_actor* host, size_t max, datagram* out, int flags = 0);
+
+	/*!
+	@brief 在ms时间范围内批量接收，超时只取消等待，不关闭套接字
+	*/
+	result timed_receive_batch(my_actor* host, int ms, size_t max, datagram* out, int flags = 0);
+
+	/*!
+	@brief linux下启用/关闭UDP_GRO，启用后receive_segments可一次收到内核合并的多个同源数据报
+	*/
+	result enable_gro(bool enable = true);
+
+	/*!
+	@brief 以UDP_SEGMENT(GSO)方式发送到默认目标(connect成功后)，buff按segmentSize切分为多个数据报(最后一个可以较短)，
+	一次系统调用、一个skb完成，length不能超过64KB
+	*/
+	result send_segments(my_actor* host, const void* buff, size_t length, size_t segmentSize, int flags = 0);
+
+	/*!
+	@brief 以UDP_SEGMENT(GSO)方式发送到指定目标
+	*/
+	result send_segments_to(my_actor* host, const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, size_t segmentSize, int flags = 0);
+
+	/*!
+	@brief 接收数据到缓冲区(启用GRO后可能为多个数据报合并后的数据，缓冲区应不小于64KB)
+	@param segmentSize 每个数据报的长度(最后一个可以较短)，未合并时等于接收长度
+	*/
+	result receive_segments(my_actor* host, void* buff, size_t length, size_t& segmentSize, int flags = 0);
+
+	/*!
+	@brief 接收数据到缓冲区，并记录下远端地址，参数同receive_segments
+	*/
+	result receive_segments_from(my_actor* host, void* buff, size_t length, size_t& segmentSize, int flags = 0);
+
+	/*!
+	@brief 创建一个远端目标
 	*/
 	static boost::asio::ip::udp::endpoint make_endpoint(const char* remoteIp, unsigned short remotePort);
 
 	/*!
-	@brief receive_fromɺȡԶ˵ַ
+	@brief receive_from完成后获取远端地址
 	*/
 	const boost::asio::ip::udp::endpoint& last_remote_sender_endpoint();
 
 	/*!
-	@brief Զ˵ַ
+	@brief 重置远端地址
 	*/
 	void reset_remote_sender_endpoint();
 
 	/*!
-	@brief 첽ģʽ£ݵָĿ
+	@brief 异步模式下，发送数据到指定目标
 	*/
 	template <typename Handler>
 	bool async_send_to(const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, Handler&& handler, int flags = 0)
@@ -814,7 +1183,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£ݵָĿ
+	@brief 异步模式下，发送数据到指定目标
 	*/
 	template <typename Handler>
 	bool async_send_to(const char* remoteIp, unsigned short remotePort, const void* buff, size_t length, Handler&& handler, int flags = 0)
@@ -823,7 +1192,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£ݵĬĿ(connectɹ)
+	@brief 异步模式下，发送数据到默认目标(connect成功后)
 	*/
 	template <typename Handler>
 	bool async_send(const void* buff, size_t length, Handler&& handler, int flags = 0)
@@ -856,7 +1225,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£Զ˷͵ݵ¼Զ˵ַ
+	@brief 异步模式下，接收远端发送的数据到缓冲区，并记录下远端地址
 	*/
 	template <typename Handler>
 	bool async_receive_from(boost::asio::ip::udp::endpoint& remoteEndpoint, void* buff, size_t length, Handler&& handler, int flags = 0)
@@ -895,7 +1264,7 @@ public:
 	}
 
 	/*!
-	@brief 첽ģʽ£Զ˷͵ݵ
+	@brief 异步模式下，接收远端发送的数据到缓冲区
 	*/
 	template <typename Handler>
 	bool async_receive(void* buff, size_t length, Handler&& handler, int flags = 0)
@@ -928,69 +1297,179 @@ public:
 	}
 
 	/*!
-	@brief Է
+	@brief 异步模式下，以UDP_SEGMENT(GSO)方式发送到默认目标(connect成功后)
+	*/
+	template <typename Handler>
+	bool async_send_segments(const void* buff, size_t length, size_t segmentSize, Handler&& handler, int flags = 0)
+	{
+		return _async_try_io(boost::asio::ip::udp::socket::wait_write, [this, buff, length, segmentSize, flags]()->result
+		{
+			return try_send_segments(buff, length, segmentSize, flags);
+		}, std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 异步模式下，以UDP_SEGMENT(GSO)方式发送到指定目标
+	*/
+	template <typename Handler>
+	bool async_send_segments_to(const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, size_t segmentSize, Handler&& handler, int flags = 0)
+	{
+		return _async_try_io(boost::asio::ip::udp::socket::wait_write, [this, remoteEndpoint, buff, length, segmentSize, flags]()->result
+		{
+			return try_send_segments_to(remoteEndpoint, buff, length, segmentSize, flags);
+		}, std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 异步模式下批量接收，参数同receive_batch
+	*/
+	template <typename Handler>
+	bool async_receive_batch(size_t max, datagram* out, Handler&& handler, int flags = 0)
+	{
+		return _async_try_io(boost::asio::ip::udp::socket::wait_read, [this, max, out, flags]()->result
+		{
+			return try_receive_batch(max, out, flags);
+		}, std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 异步模式下，接收(启用GRO后可能合并的)数据
+	*/
+	template <typename Handler>
+	bool async_receive_segments(void* buff, size_t length, size_t& segmentSize, Handler&& handler, int flags = 0)
+	{
+		size_t* const segSize = &segmentSize;
+		return _async_try_io(boost::asio::ip::udp::socket::wait_read, [this, buff, length, segSize, flags]()->result
+		{
+			return try_receive_segments(buff, length, *segSize, flags);
+		}, std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 异步模式下，接收(启用GRO后可能合并的)数据，并记录下远端地址
+	*/
+	template <typename Handler>
+	bool async_receive_segments_from(void* buff, size_t length, size_t& segmentSize, Handler&& handler, int flags = 0)
+	{
+		size_t* const segSize = &segmentSize;
+		return _async_try_io(boost::asio::ip::udp::socket::wait_read, [this, buff, length, segSize, flags]()->result
+		{
+			return try_receive_segments_from(_remoteSenderEndpoint, buff, length, *segSize, flags);
+		}, std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 非阻塞尝试发送数据
 	*/
 	result try_send(const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief ԷݵָĿ
+	@brief 非阻塞尝试发送数据到指定目标
 	*/
 	result try_send_to(const char* remoteIp, unsigned short remotePort, const void* buff, size_t length, int flags = 0);
 	result try_send_to(const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief Խ
+	@brief 非阻塞尝试接收数据
 	*/
 	result try_receive(void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief Խݣ¼Զ˵ַ
+	@brief 非阻塞尝试接收数据，并记录下远端地址
 	*/
 	result try_receive_from(void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief Խݣ¼Զ˵ַ
+	@brief 非阻塞尝试接收数据，并记录下远端地址
 	*/
 	result try_receive_from(boost::asio::ip::udp::endpoint& remoteEndpoint, void* buff, size_t length, int flags = 0);
 
 	/*!
-	@brief һηͶ
-	@brief bytes, ÿʵʷֽ
-	@return ʵʷ
+	@brief 非阻塞尝试一次发送多条数据
+	@brief bytes, 每块数据实际发送字节数
+	@return 实际发送数据条数
 	*/
 	result try_msend(const void* const* buffs, const size_t* lengths, size_t count, size_t* bytes = NULL, int flags = 0);
 
 	/*!
-	@brief һηͶݵָĿ
-	@brief bytes, ÿʵʷֽ
-	@return ʵʷ
+	@brief 非阻塞尝试一次发送多条数据到指定目标
+	@brief bytes, 每块数据实际发送字节数
+	@return 实际发送数据条数
 	*/
 	result try_msend_to(const boost::asio::ip::udp::endpoint* remoteEndpoints, const void* const* buffs, const size_t* lengths, size_t count, size_t* bytes = NULL, int flags = 0);
 	result try_msend_to(const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* const* buffs, const size_t* lengths, size_t count, size_t* bytes = NULL, int flags = 0);
 
 	/*!
-	@brief һνն
-	@brief bytes, ÿ黺ʵʽֽ
-	@return ʵʽ
+	@brief 非阻塞尝试一次接收多条数据
+	@brief bytes, 每块缓存实际接收字节数
+	@return 实际接收数据条数
 	*/
 	result try_mreceive(void* const* buffs, const size_t* lengths, size_t count, size_t* bytes = NULL, int flags = 0);
 
 	/*!
-	@brief һνնݣ¼Զ˵ַ
-	@brief bytes, ÿ黺ʵʽֽ
-	@return ʵʽ
+	@brief 非阻塞尝试一次接收多条数据，并记录下远端地址
+	@brief bytes, 每块缓存实际接收字节数
+	@return 实际接收数据条数
 	*/
 	result try_mreceive_from(boost::asio::ip::udp::endpoint* remoteEndpoints, void* const* buffs, const size_t* lengths, size_t count, size_t* bytes = NULL, int flags = 0);
 
 	/*!
-	@brief try_ioʧǷΪEAGAIN
+	@brief 非阻塞尝试以UDP_SEGMENT(GSO)方式发送
+	*/
+	result try_send_segments(const void* buff, size_t length, size_t segmentSize, int flags = 0);
+	result try_send_segments_to(const boost::asio::ip::udp::endpoint& remoteEndpoint, const void* buff, size_t length, size_t segmentSize, int flags = 0);
+
+	/*!
+	@brief 非阻塞尝试批量接收，参数同receive_batch
+	*/
+	result try_receive_batch(size_t max, datagram* out, int flags = 0);
+
+	/*!
+	@brief 非阻塞尝试接收(启用GRO后可能合并的)数据
+	*/
+	result try_receive_segments(void* buff, size_t length, size_t& segmentSize, int flags = 0);
+	result try_receive_segments_from(boost::asio::ip::udp::endpoint& remoteEndpoint, void* buff, size_t length, size_t& segmentSize, int flags = 0);
+
+	/*!
+	@brief try_io操作失败是否是因为EAGAIN
 	*/
 	static bool try_again(const result& res);
 private:
 	void set_internal_non_blocking();
+	result _try_send_segments(const boost::asio::ip::udp::endpoint* remoteEndpoint, const void* buff, size_t length, size_t segmentSize, int flags);
+	result _try_receive_segments(boost::asio::ip::udp::endpoint* remoteEndpoint, void* buff, size_t length, size_t& segmentSize, int flags);
+
+	/*!
+	@brief 先尝试非阻塞io，EAGAIN时等待套接字就绪后重试，直到成功或出错
+	*/
+	template <typename TryIo, typename Handler>
+	bool _async_try_io(boost::asio::socket_base::wait_type waitType, TryIo&& tryIo, Handler&& handler)
+	{
+		result res = tryIo();
+		if (res.ok || !try_again(res) || !_nonBlocking)
+		{
+			handler(res);
+			return true;
+		}
+		_socket.async_wait(waitType, std::bind([this, waitType](TryIo& tryIo, Handler& handler, const boost::system::error_code& ec)
+		{
+			if (ec)
+			{
+				result res = { 0, ec.value(), false };
+				handler(res);
+			}
+			else
+			{
+				_async_try_io(waitType, std::move(tryIo), std::move(handler));
+			}
+		}, std::forward<TryIo>(tryIo), std::forward<Handler>(handler), __1));
+		return false;
+	}
 private:
 	boost::asio::ip::udp::socket _socket;
 	boost::asio::ip::udp::endpoint _remoteSenderEndpoint;
+	stack_obj<BatchBuff_> _batchBuff;
+	size_t _batchBuffSize;
 	bool _nonBlocking;
 #ifdef ENABLE_ASIO_PRE_OP
 	bool _preOption;
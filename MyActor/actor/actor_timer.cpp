@@ -1,5 +1,6 @@
 #include "actor_timer.h"
 #include "scattered.h"
+#include "time_source.h"
 #include "my_actor.h"
 #ifndef DISABLE_BOOST_TIMER
 #ifdef DISABLE_HIGH_TIMER
@@ -25,7 +26,7 @@ _extMaxTick(0), _extFinishTime(-1), _handlerQueue(MEM_POOL_LENGTH)
 #ifdef DISABLE_BOOST_TIMER
 	_timer = new timer_type(strand->get_io_engine(), this);
 #else
-	_timer = new timer_type(strand->get_io_engine());
+	_timer = new timer_type(strand->get_io_service());
 #endif
 }
 
@@ -47,7 +48,8 @@ ActorTimer_::timer_handle ActorTimer_::timeout(long long us, actor_face_handle&&
 	}
 	assert(_lockStrand->running_in_this_thread());
 	timer_handle timerHandle;
-	timerHandle._beginStamp = get_tick_us();
+	//粗粒度时间可能滞后一个任务批次，起始时间要用精确时间，否则定时器会提前到期
+	timerHandle._beginStamp = time_source::tsc_us();
 	long long et = deadline ? us : (timerHandle._beginStamp + us);
 	if (et >= _extMaxTick)
 	{
@@ -60,14 +62,14 @@ ActorTimer_::timer_handle ActorTimer_::timeout(long long us, actor_face_handle&&
 	}
 	
 	if (!_looping)
-	{//ʱѾ˳ѭʱ
+	{//定时器已经退出循环，重新启动定时器
 		_looping = true;
 		assert(_handlerQueue.size() == 1);
 		_extFinishTime = et;
 		timer_loop(et, et - timerHandle._beginStamp);
 	}
 	else if ((unsigned long long)et < (unsigned long long)_extFinishTime)
-	{//ʱǰڵǰʱޣȡ¼ʱ
+	{//定时期限前于当前定时器期限，取消后重新计时
 		boost::system::error_code ec;
 		as_ptype<timer_type>(_timer)->cancel(ec);
 		_timerCount++;
@@ -81,7 +83,7 @@ void ActorTimer_::cancel(timer_handle& th)
 {
 	assert(_weakStrand.lock()->running_in_this_thread());
 	if (!th.is_null())
-	{//ɾǰʱڵ
+	{//删除当前定时器节点
 		assert(_lockStrand);
 		th.reset();
 		handler_queue::iterator itNode = th._queueNode;
@@ -89,7 +91,7 @@ void ActorTimer_::cancel(timer_handle& th)
 		{
 			_extMaxTick = 0;
 			_handlerQueue.erase(itNode);
-			//ûжʱ˳ʱѭ
+			//如果没有定时任务就退出定时循环
 			boost::system::error_code ec;
 			as_ptype<timer_type>(_timer)->cancel(ec);
 			_timerCount++;
@@ -157,7 +159,8 @@ void ActorTimer_::event_handler(int tc)
 		while (!_handlerQueue.empty())
 		{
 			handler_queue::iterator iter = _handlerQueue.begin();
-			long long ct = get_tick_us();
+			long long ct = time_source::tsc_us();
+			time_source::refresh_coarse(ct);
 			if (iter->first > ct)
 			{
 				_extFinishTime = iter->first;
@@ -14,7 +14,7 @@ class generator;
 class AsyncTimer_;
 
 /*!
-@brief Actor ڲʹõĶʱ
+@brief Actor 内部使用的定时器
 */
 class ActorTimer_
 #ifdef DISABLE_BOOST_TIMER
@@ -53,26 +53,26 @@ private:
 	~ActorTimer_();
 private:
 	/*!
-	@brief ʼʱ
-	@param us ΢
-	@param host ׼ʱActor
-	@param deadline ǷΪʱ
-	@return ʱcancel
+	@brief 开始计时
+	@param us 微秒
+	@param host 准备计时的Actor
+	@param deadline 是否为绝对时间
+	@return 计时句柄，用于cancel
 	*/
 	timer_handle timeout(long long us, actor_face_handle&& host, bool deadline = false);
 
 	/*!
-	@brief ȡʱ
+	@brief 取消计时
 	*/
 	void cancel(timer_handle& th);
 
 	/*!
-	@brief timerѭ
+	@brief timer循环
 	*/
 	void timer_loop(long long abs, long long rel);
 
 	/*!
-	@brief timer¼
+	@brief timer事件
 	*/
 	void event_handler(int tc);
 #ifdef DISABLE_BOOST_TIMER
@@ -0,0 +1,1037 @@
+#include "async_file.h"
+#include <string.h>
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/stat.h>
+#ifdef ENABLE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#endif
+#endif
+
+async_file::op_face::op_face(async_file* file, op_type type, unsigned long long offset, bool full)
+:_next(NULL), _prev(NULL), _file(file), _fd(file->_fd), _id(0), _offset(offset), _iov(_localIov), _iovAlloc(NULL),
+_iovCount(0), _bytes(0), _totalBytes(0), _code(0), _type(type), _full(full) {}
+
+async_file::op_face::~op_face() __disable_noexcept
+{
+	delete[] _iovAlloc;
+}
+
+void async_file::op_face::set_buffer(const void* buff, size_t length)
+{
+	_iov = _localIov;
+	_iov[0].iov_base = (void*)buff;
+	_iov[0].iov_len = length;
+	_iovCount = 1;
+	_totalBytes = length;
+}
+
+void async_file::op_face::set_buffers(const void* const* buffs, const size_t* lengths, size_t count)
+{
+	assert(!_iovAlloc);
+	if (count > FILE_IO_LOCAL_IOV)
+	{
+		_iovAlloc = new io_vec[count];
+		_iov = _iovAlloc;
+	}
+	else
+	{
+		_iov = _localIov;
+	}
+	_totalBytes = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		_iov[i].iov_base = (void*)buffs[i];
+		_iov[i].iov_len = lengths[i];
+		_totalBytes += lengths[i];
+	}
+	_iovCount = count;
+}
+
+void async_file::op_face::consume(size_t s)
+{
+	_bytes += s;
+	while (s && _iovCount)
+	{
+		if (s >= _iov->iov_len)
+		{
+			s -= _iov->iov_len;
+			_iov++;
+			_iovCount--;
+		}
+		else
+		{
+			_iov->iov_base = (char*)_iov->iov_base + s;
+			_iov->iov_len -= s;
+			s = 0;
+		}
+	}
+	while (_iovCount && !_iov->iov_len)
+	{
+		_iov++;
+		_iovCount--;
+	}
+}
+
+bool async_file::op_face::need_more(size_t s) const
+{
+	return _full && 0 != s && _bytes < _totalBytes;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+async_file::seq_read_face::seq_read_face(size_t length)
+:_length(length)
+{
+	_chunkCount = (length + FILE_IO_SEQ_CHUNK - 1) / FILE_IO_SEQ_CHUNK;
+	_chunkBytes = new size_t[_chunkCount];
+	_chunkCode = new int[_chunkCount];
+	_pending = _chunkCount;
+}
+
+async_file::seq_read_face::~seq_read_face() __disable_noexcept
+{
+	delete[] _chunkBytes;
+	delete[] _chunkCode;
+}
+
+void async_file::seq_read_face::chunk_complete(size_t index, const result& chunkRes)
+{
+	_chunkBytes[index] = chunkRes.s;
+	_chunkCode[index] = chunkRes.code;
+	if (1 == _pending--)
+	{
+		//只返回从起点开始连续读到的数据，遇到错误或文件尾截止
+		result res = { 0, 0, false };
+		for (size_t i = 0; i < _chunkCount; i++)
+		{
+			if (_chunkCode[i])
+			{
+				res.code = _chunkCode[i];
+				break;
+			}
+			res.s += _chunkBytes[i];
+			if (_chunkBytes[i] != std::min((size_t)FILE_IO_SEQ_CHUNK, _length - i * FILE_IO_SEQ_CHUNK))
+			{
+				break;
+			}
+		}
+		res.ok = !res.code;
+		complete(res);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FileIoService_::FileIoService_(io_engine& ios)
+:_ios(ios), _queueHead(NULL), _queueTail(NULL), _opId(0), _exit(false), _uring(false)
+{
+#ifdef ENABLE_IO_URING
+	_eventDesc = NULL;
+	_inflightHead = NULL;
+	_sqPtr = _cqPtr = NULL;
+	_sqes = NULL;
+	_sqSize = _cqSize = _sqesSize = 0;
+	_inflight = 0;
+	_sqEntries = 0;
+	_ringFd = _eventFd = -1;
+	_armed = false;
+	_uring = uring_init();
+#endif
+}
+
+FileIoService_::~FileIoService_()
+{
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		assert(!_queueHead);
+		_exit = true;
+		_conVar.notify_all();
+	}
+	for (run_thread* ele : _threads)
+	{
+		ele->join();
+		delete ele;
+	}
+	_threads.clear();
+#ifdef ENABLE_IO_URING
+	uring_uninit();
+#endif
+}
+
+bool FileIoService_::parallel()
+{
+	return _uring || FILE_IO_POOL_THREADS > 1;
+}
+
+void FileIoService_::submit(op_face* ops)
+{
+	size_t count = 0;
+	op_face* tail = ops;
+	for (op_face* it = ops; it; it = it->_next)
+	{
+		tail = it;
+		count++;
+		_ios.holdWork();
+	}
+	std::lock_guard<std::mutex> lg(_mutex);
+	if (_queueTail)
+	{
+		_queueTail->_next = ops;
+	}
+	else
+	{
+		_queueHead = ops;
+	}
+	_queueTail = tail;
+#ifdef ENABLE_IO_URING
+	if (_uring)
+	{
+		uring_flush();
+		uring_arm();
+		return;
+	}
+#endif
+	if (_threads.empty())
+	{
+		_threads.reserve(FILE_IO_POOL_THREADS);
+		for (size_t i = 0; i < FILE_IO_POOL_THREADS; i++)
+		{
+			_threads.push_back(new run_thread([this]
+			{
+				run_thread::set_current_thread_name("async_file");
+				pool_run();
+			}));
+		}
+	}
+	if (1 == count)
+	{
+		_conVar.notify_one();
+	}
+	else
+	{
+		_conVar.notify_all();
+	}
+}
+
+void FileIoService_::cancel(async_file* file, unsigned long long id)
+{
+	//id非0时只取消该次操作(大块顺序读的所有分块)，否则取消文件上的所有操作
+	op_face* canceled = NULL;
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		op_face* prev = NULL;
+		for (op_face* it = _queueHead; it;)
+		{
+			op_face* const next = it->_next;
+			if (id ? id == it->_id : file == it->_file)
+			{
+				if (prev)
+				{
+					prev->_next = next;
+				}
+				else
+				{
+					_queueHead = next;
+				}
+				if (_queueTail == it)
+				{
+					_queueTail = prev;
+				}
+				it->_next = canceled;
+				canceled = it;
+			}
+			else
+			{
+				prev = it;
+			}
+			it = next;
+		}
+#ifdef ENABLE_IO_URING
+		if (_uring)
+		{
+			//已提交到内核的操作投递取消请求，实际结果以内核返回为准
+			unsigned count = 0;
+			for (op_face* it = _inflightHead; it; it = it->_next)
+			{
+				if ((id ? id == it->_id : file == it->_file) && _inflight < _sqEntries)
+				{
+					const unsigned tail = *_sqTail;
+					if (tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) >= _sqEntries)
+					{
+						break;
+					}
+					const unsigned idx = tail & *_sqMask;
+					struct io_uring_sqe* const sqe = &_sqes[idx];
+					memset(sqe, 0, sizeof(*sqe));
+					sqe->opcode = IORING_OP_ASYNC_CANCEL;
+					sqe->fd = -1;
+					sqe->addr = (unsigned long long)it;
+					sqe->user_data = 0;
+					_sqArray[idx] = idx;
+					__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+					_inflight++;
+					count++;
+				}
+			}
+			if (count)
+			{
+				uring_enter(count);
+			}
+		}
+#endif
+	}
+	while (canceled)
+	{
+		op_face* const next = canceled->_next;
+		canceled->_next = NULL;
+		canceled->_code = boost::asio::error::operation_aborted;
+		post_complete(canceled);
+		canceled = next;
+	}
+}
+
+void FileIoService_::post_complete(op_face* op)
+{
+	((boost::asio::io_service&)_ios).post(std::bind([this](op_face* op)
+	{
+		complete(op);
+	}, op));
+	_ios.releaseWork();
+}
+
+void FileIoService_::complete(op_face* op)
+{
+	result res = { op->_bytes, op->_code, !op->_code };
+	op->complete(res);
+}
+
+void FileIoService_::pool_run()
+{
+	std::unique_lock<std::mutex> ul(_mutex);
+	while (true)
+	{
+		while (!_queueHead && !_exit)
+		{
+			_conVar.wait(ul);
+		}
+		op_face* const op = _queueHead;
+		if (!op)
+		{
+			break;
+		}
+		_queueHead = op->_next;
+		if (!_queueHead)
+		{
+			_queueTail = NULL;
+		}
+		op->_next = NULL;
+		ul.unlock();
+		exec(op);
+		post_complete(op);
+		ul.lock();
+	}
+}
+
+void FileIoService_::exec(op_face* op)
+{
+	const bool isRead = op_face::op_read == op->_type || op_face::op_readv == op->_type;
+#ifdef __linux__
+	switch (op->_type)
+	{
+	case op_face::op_fsync:
+		op->_code = ::fsync(op->_fd) ? errno : 0;
+		break;
+	case op_face::op_fdatasync:
+		op->_code = ::fdatasync(op->_fd) ? errno : 0;
+		break;
+	default:
+		while (op->_iovCount)
+		{
+			const off_t offset = (off_t)(op->_offset + op->_bytes);
+			ssize_t s;
+			if (1 == op->_iovCount)
+			{
+				s = isRead ? ::pread(op->_fd, op->_iov->iov_base, op->_iov->iov_len, offset)
+					: ::pwrite(op->_fd, op->_iov->iov_base, op->_iov->iov_len, offset);
+			}
+			else
+			{
+				const int count = (int)std::min(op->_iovCount, (size_t)IOV_MAX);
+				s = isRead ? ::preadv(op->_fd, op->_iov, count, offset) : ::pwritev(op->_fd, op->_iov, count, offset);
+			}
+			if (s < 0)
+			{
+				if (EINTR == errno)
+				{
+					continue;
+				}
+				op->_code = errno;
+				break;
+			}
+			op->consume((size_t)s);
+			if (!op->need_more((size_t)s))
+			{
+				break;
+			}
+		}
+		break;
+	}
+#elif WIN32
+	switch (op->_type)
+	{
+	case op_face::op_fsync:
+	case op_face::op_fdatasync:
+		op->_code = FlushFileBuffers(op->_fd) ? 0 : (int)GetLastError();
+		break;
+	default:
+		while (op->_iovCount)
+		{
+			const unsigned long long offset = op->_offset + op->_bytes;
+			OVERLAPPED overlapped = { 0 };
+			overlapped.Offset = (DWORD)offset;
+			overlapped.OffsetHigh = (DWORD)(offset >> 32);
+			const DWORD length = (DWORD)std::min(op->_iov->iov_len, (size_t)0x40000000);
+			DWORD s = 0;
+			BOOL ok = isRead ? ReadFile(op->_fd, op->_iov->iov_base, length, &s, &overlapped)
+				: WriteFile(op->_fd, op->_iov->iov_base, length, &s, &overlapped);
+			if (!ok)
+			{
+				const DWORD err = GetLastError();
+				if (ERROR_HANDLE_EOF != err)
+				{
+					op->_code = (int)err;
+				}
+				break;
+			}
+			op->consume((size_t)s);
+			if (!op->need_more((size_t)s))
+			{
+				break;
+			}
+		}
+		break;
+	}
+#endif
+}
+
+#ifdef ENABLE_IO_URING
+bool FileIoService_::uring_init()
+{
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	_ringFd = (int)syscall(__NR_io_uring_setup, FILE_IO_URING_DEPTH, &params);
+	if (_ringFd < 0)
+	{
+		return false;
+	}
+	_sqEntries = params.sq_entries;
+	_sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+	_cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		_sqSize = _cqSize = std::max(_sqSize, _cqSize);
+	}
+	_sqPtr = mmap(NULL, _sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQ_RING);
+	if (MAP_FAILED == _sqPtr)
+	{
+		_sqPtr = NULL;
+		uring_uninit();
+		return false;
+	}
+	if (params.features & IORING_FEAT_SINGLE_MMAP)
+	{
+		_cqPtr = _sqPtr;
+	}
+	else
+	{
+		_cqPtr = mmap(NULL, _cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_CQ_RING);
+		if (MAP_FAILED == _cqPtr)
+		{
+			_cqPtr = NULL;
+			uring_uninit();
+			return false;
+		}
+	}
+	_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	_sqes = (struct io_uring_sqe*)mmap(NULL, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ringFd, IORING_OFF_SQES);
+	if (MAP_FAILED == (void*)_sqes)
+	{
+		_sqes = NULL;
+		uring_uninit();
+		return false;
+	}
+	_sqHead = (unsigned*)((char*)_sqPtr + params.sq_off.head);
+	_sqTail = (unsigned*)((char*)_sqPtr + params.sq_off.tail);
+	_sqMask = (unsigned*)((char*)_sqPtr + params.sq_off.ring_mask);
+	_sqArray = (unsigned*)((char*)_sqPtr + params.sq_off.array);
+	_cqHead = (unsigned*)((char*)_cqPtr + params.cq_off.head);
+	_cqTail = (unsigned*)((char*)_cqPtr + params.cq_off.tail);
+	_cqMask = (unsigned*)((char*)_cqPtr + params.cq_off.ring_mask);
+	_cqes = (struct io_uring_cqe*)((char*)_cqPtr + params.cq_off.cqes);
+	_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if (_eventFd < 0 || syscall(__NR_io_uring_register, _ringFd, IORING_REGISTER_EVENTFD, &_eventFd, 1) < 0)
+	{
+		uring_uninit();
+		return false;
+	}
+	_eventDesc = new boost::asio::posix::stream_descriptor(_ios, _eventFd);
+	return true;
+}
+
+void FileIoService_::uring_uninit()
+{
+	assert(!_inflight);
+	if (_eventDesc)
+	{
+		_eventDesc->release();
+		delete _eventDesc;
+		_eventDesc = NULL;
+	}
+	if (_eventFd >= 0)
+	{
+		::close(_eventFd);
+		_eventFd = -1;
+	}
+	if (_sqes)
+	{
+		munmap(_sqes, _sqesSize);
+		_sqes = NULL;
+	}
+	if (_cqPtr && _cqPtr != _sqPtr)
+	{
+		munmap(_cqPtr, _cqSize);
+	}
+	_cqPtr = NULL;
+	if (_sqPtr)
+	{
+		munmap(_sqPtr, _sqSize);
+		_sqPtr = NULL;
+	}
+	if (_ringFd >= 0)
+	{
+		::close(_ringFd);
+		_ringFd = -1;
+	}
+}
+
+bool FileIoService_::uring_push(op_face* op)
+{
+	const unsigned tail = *_sqTail;
+	if (tail - __atomic_load_n(_sqHead, __ATOMIC_ACQUIRE) >= _sqEntries)
+	{
+		return false;
+	}
+	const unsigned idx = tail & *_sqMask;
+	struct io_uring_sqe* const sqe = &_sqes[idx];
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->fd = op->_fd;
+	sqe->user_data = (unsigned long long)op;
+	switch (op->_type)
+	{
+	case op_face::op_fsync:
+		sqe->opcode = IORING_OP_FSYNC;
+		break;
+	case op_face::op_fdatasync:
+		sqe->opcode = IORING_OP_FSYNC;
+		sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+		break;
+	case op_face::op_read:
+	case op_face::op_readv:
+		sqe->opcode = IORING_OP_READV;
+		sqe->addr = (unsigned long long)op->_iov;
+		sqe->len = (unsigned)std::min(op->_iovCount, (size_t)IOV_MAX);
+		sqe->off = op->_offset + op->_bytes;
+		break;
+	default:
+		sqe->opcode = IORING_OP_WRITEV;
+		sqe->addr = (unsigned long long)op->_iov;
+		sqe->len = (unsigned)std::min(op->_iovCount, (size_t)IOV_MAX);
+		sqe->off = op->_offset + op->_bytes;
+		break;
+	}
+	_sqArray[idx] = idx;
+	__atomic_store_n(_sqTail, tail + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+void FileIoService_::uring_flush()
+{
+	//一次系统调用提交所有能放进提交队列的操作，在途操作数不超过队列深度以免完成队列溢出
+	unsigned count = 0;
+	while (_queueHead && _inflight < _sqEntries)
+	{
+		op_face* const op = _queueHead;
+		if (!uring_push(op))
+		{
+			break;
+		}
+		_queueHead = op->_next;
+		if (!_queueHead)
+		{
+			_queueTail = NULL;
+		}
+		op->_prev = NULL;
+		op->_next = _inflightHead;
+		if (_inflightHead)
+		{
+			_inflightHead->_prev = op;
+		}
+		_inflightHead = op;
+		_inflight++;
+		count++;
+	}
+	if (count)
+	{
+		uring_enter(count);
+	}
+}
+
+void FileIoService_::uring_enter(unsigned count)
+{
+	while (syscall(__NR_io_uring_enter, _ringFd, count, 0, 0, NULL, 0) < 0 && EINTR == errno) {}
+}
+
+void FileIoService_::uring_arm()
+{
+	if (!_armed && (_inflight || _queueHead))
+	{
+		_armed = true;
+		_eventDesc->async_read_some(boost::asio::null_buffers(), std::bind(&FileIoService_::uring_ready, this, __1));
+	}
+}
+
+void FileIoService_::uring_ready(const boost::system::error_code& ec)
+{
+	unsigned long long eventCount = 0;
+	while (::read(_eventFd, &eventCount, sizeof(eventCount)) < 0 && EINTR == errno) {}
+	op_face* completed = NULL;
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		_armed = false;
+		unsigned head = *_cqHead;
+		const unsigned tail = __atomic_load_n(_cqTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++)
+		{
+			struct io_uring_cqe* const cqe = &_cqes[head & *_cqMask];
+			op_face* const op = (op_face*)cqe->user_data;
+			const int res = cqe->res;
+			assert(_inflight);
+			_inflight--;
+			if (!op)
+			{
+				continue;
+			}
+			if (op->_prev)
+			{
+				op->_prev->_next = op->_next;
+			}
+			else
+			{
+				_inflightHead = op->_next;
+			}
+			if (op->_next)
+			{
+				op->_next->_prev = op->_prev;
+			}
+			op->_prev = op->_next = NULL;
+			bool done = true;
+			if (res < 0)
+			{
+				if (-EINTR == res || -EAGAIN == res)
+				{
+					done = false;
+				}
+				else
+				{
+					op->_code = -res == ECANCELED ? (int)boost::asio::error::operation_aborted : -res;
+				}
+			}
+			else
+			{
+				op->consume((size_t)res);
+				done = !op->need_more((size_t)res);
+			}
+			if (done)
+			{
+				op->_next = completed;
+				completed = op;
+			}
+			else
+			{
+				//未读满/写完，重新排队提交剩余部分
+				if (_queueTail)
+				{
+					_queueTail->_next = op;
+				}
+				else
+				{
+					_queueHead = op;
+				}
+				_queueTail = op;
+			}
+		}
+		__atomic_store_n(_cqHead, head, __ATOMIC_RELEASE);
+		uring_flush();
+		uring_arm();
+	}
+	while (completed)
+	{
+		op_face* const next = completed->_next;
+		completed->_next = NULL;
+		complete(completed);
+		_ios.releaseWork();
+		completed = next;
+	}
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+async_file::async_file(io_engine& ios)
+:_ios(ios)
+{
+#ifdef __linux__
+	_fd = -1;
+#elif WIN32
+	_fd = INVALID_HANDLE_VALUE;
+#endif
+	std::lock_guard<std::mutex> lg(_ios._ctrlMutex);
+	if (!_ios._fileService)
+	{
+		_ios._fileService = new FileIoService_(_ios);
+	}
+	_service = _ios._fileService;
+}
+
+async_file::~async_file()
+{
+	close();
+}
+
+async_file::result async_file::open(const char* path, int flags, int mode)
+{
+	result res = { 0, 0, false };
+	close();
+#ifdef __linux__
+	int oflags = O_CLOEXEC;
+	switch (flags & read_write)
+	{
+	case read_only: oflags |= O_RDONLY; break;
+	case write_only: oflags |= O_WRONLY; break;
+	default: oflags |= O_RDWR; break;
+	}
+	if (flags & create) oflags |= O_CREAT;
+	if (flags & truncate) oflags |= O_TRUNC;
+	if (flags & append) oflags |= O_APPEND;
+	if (flags & direct) oflags |= O_DIRECT;
+	_fd = ::open(path, oflags, mode);
+	if (_fd < 0)
+	{
+		res.code = errno;
+		return res;
+	}
+	if (flags & sequential)
+	{
+		posix_fadvise(_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+#elif WIN32
+	DWORD access = 0;
+	if (flags & read_only) access |= GENERIC_READ;
+	if (flags & write_only) access |= (flags & append) ? FILE_APPEND_DATA : GENERIC_WRITE;
+	DWORD disposition = OPEN_EXISTING;
+	if ((flags & create) && (flags & truncate)) disposition = CREATE_ALWAYS;
+	else if (flags & create) disposition = OPEN_ALWAYS;
+	else if (flags & truncate) disposition = TRUNCATE_EXISTING;
+	DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+	if (flags & sequential) attributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+	if (flags & direct) attributes |= FILE_FLAG_NO_BUFFERING;
+	_fd = CreateFileA(path, access, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, disposition, attributes, NULL);
+	if (INVALID_HANDLE_VALUE == _fd)
+	{
+		res.code = (int)GetLastError();
+		return res;
+	}
+#endif
+	res.ok = true;
+	return res;
+}
+
+async_file::result async_file::close()
+{
+	result res = { 0, 0, true };
+	if (is_open())
+	{
+#ifdef __linux__
+		if (::close(_fd))
+		{
+			res.code = errno;
+			res.ok = false;
+		}
+		_fd = -1;
+#elif WIN32
+		if (!CloseHandle(_fd))
+		{
+			res.code = (int)GetLastError();
+			res.ok = false;
+		}
+		_fd = INVALID_HANDLE_VALUE;
+#endif
+	}
+	return res;
+}
+
+void async_file::cancel()
+{
+	_service->cancel(this, 0);
+}
+
+void async_file::cancel(op_tag tag)
+{
+	cancel_op(tag.id);
+}
+
+bool async_file::is_open()
+{
+#ifdef __linux__
+	return _fd >= 0;
+#elif WIN32
+	return INVALID_HANDLE_VALUE != _fd;
+#endif
+}
+
+async_file::result async_file::size()
+{
+	result res = { 0, 0, false };
+#ifdef __linux__
+	struct stat st;
+	if (fstat(_fd, &st))
+	{
+		res.code = errno;
+		return res;
+	}
+	res.s = (size_t)st.st_size;
+#elif WIN32
+	LARGE_INTEGER st;
+	if (!GetFileSizeEx(_fd, &st))
+	{
+		res.code = (int)GetLastError();
+		return res;
+	}
+	res.s = (size_t)st.QuadPart;
+#endif
+	res.ok = true;
+	return res;
+}
+
+async_file::result async_file::resize(unsigned long long length)
+{
+	result res = { 0, 0, false };
+#ifdef __linux__
+	if (ftruncate(_fd, (off_t)length))
+	{
+		res.code = errno;
+		return res;
+	}
+#elif WIN32
+	LARGE_INTEGER pos;
+	pos.QuadPart = (LONGLONG)length;
+	if (!SetFilePointerEx(_fd, pos, NULL, FILE_BEGIN) || !SetEndOfFile(_fd))
+	{
+		res.code = (int)GetLastError();
+		return res;
+	}
+#endif
+	res.s = (size_t)length;
+	res.ok = true;
+	return res;
+}
+
+async_file::native_handle_type async_file::native_handle()
+{
+	return _fd;
+}
+
+bool async_file::is_uring()
+{
+	return _service->_uring;
+}
+
+bool async_file::parallel_read()
+{
+	return _service->parallel();
+}
+
+void async_file::submit(op_face* op)
+{
+	_service->submit(op);
+}
+
+unsigned long long async_file::new_op_id()
+{
+	//最高位置1，不会与调用方用地址做的op_tag冲突
+	return (1ULL << 63) | ++_service->_opId;
+}
+
+void async_file::cancel_op(unsigned long long id)
+{
+	assert(id);
+	_service->cancel(this, id);
+}
+
+void async_file::seq_read(seq_read_face* parent, unsigned long long offset, void* buff, unsigned long long id)
+{
+	op_face* head = NULL;
+	for (size_t i = parent->_chunkCount; i > 0; i--)
+	{
+		const size_t pos = (i - 1) * FILE_IO_SEQ_CHUNK;
+		op_face* const op = new seq_read_face::chunk_op(parent, i - 1, this, offset + pos);
+		op->_id = id;
+		op->set_buffer((char*)buff + pos, std::min((size_t)FILE_IO_SEQ_CHUNK, parent->_length - pos));
+		op->_next = head;
+		head = op;
+	}
+	_service->submit(head);
+}
+
+async_file::result async_file::read_at(my_actor* host, unsigned long long offset, void* buff, size_t length)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_read_at(offset, buff, length, std::move(h));
+	});
+}
+
+async_file::result async_file::read_some_at(my_actor* host, unsigned long long offset, void* buff, size_t length)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_read_some_at(offset, buff, length, std::move(h));
+	});
+}
+
+async_file::result async_file::write_at(my_actor* host, unsigned long long offset, const void* buff, size_t length)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_write_at(offset, buff, length, std::move(h));
+	});
+}
+
+async_file::result async_file::readv_at(my_actor* host, unsigned long long offset, void* const* buffs, const size_t* lengths, size_t count)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_readv_at(offset, buffs, lengths, count, std::move(h));
+	});
+}
+
+async_file::result async_file::writev_at(my_actor* host, unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_writev_at(offset, buffs, lengths, count, std::move(h));
+	});
+}
+
+async_file::result async_file::fsync(my_actor* host, bool dataOnly)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_fsync(dataOnly, std::move(h));
+	});
+}
+
+async_file::result async_file::timed_read_at(my_actor* host, int ms, unsigned long long offset, void* buff, size_t length)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	const unsigned long long id = new_op_id();
+	submit_read(id, offset, buff, length, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		cancel_op(id);
+	}, res));
+	return overtime && !res.ok ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
+
+async_file::result async_file::timed_read_some_at(my_actor* host, int ms, unsigned long long offset, void* buff, size_t length)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	const unsigned long long id = new_op_id();
+	submit_buffer(id, op_face::op_read, offset, buff, length, false, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		cancel_op(id);
+	}, res));
+	return overtime && !res.ok ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
+
+async_file::result async_file::timed_write_at(my_actor* host, int ms, unsigned long long offset, const void* buff, size_t length)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	const unsigned long long id = new_op_id();
+	submit_buffer(id, op_face::op_write, offset, buff, length, true, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		cancel_op(id);
+	}, res));
+	return overtime && !res.ok ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
+
+async_file::result async_file::timed_readv_at(my_actor* host, int ms, unsigned long long offset, void* const* buffs, const size_t* lengths, size_t count)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	const unsigned long long id = new_op_id();
+	submit_buffers(id, op_face::op_readv, offset, buffs, lengths, count, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		cancel_op(id);
+	}, res));
+	return overtime && !res.ok ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
+
+async_file::result async_file::timed_writev_at(my_actor* host, int ms, unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	const unsigned long long id = new_op_id();
+	submit_buffers(id, op_face::op_writev, offset, buffs, lengths, count, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		cancel_op(id);
+	}, res));
+	return overtime && !res.ok ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
+
+async_file::result async_file::timed_fsync(my_actor* host, int ms, bool dataOnly)
+{
+	bool overtime = false;
+	result res = { 0, 0, false };
+	my_actor::quit_guard qg(host);
+	const unsigned long long id = new_op_id();
+	submit_fsync(id, dataOnly, host->make_asio_timed_context(ms, [&]()
+	{
+		overtime = true;
+		cancel_op(id);
+	}, res));
+	return overtime && !res.ok ? result{ res.s, boost::asio::error::timed_out, false } : res;
+}
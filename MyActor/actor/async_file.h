@@ -0,0 +1,553 @@
+#ifndef __ASYNC_FILE_H
+#define __ASYNC_FILE_H
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include "my_actor.h"
+#ifdef __linux__
+#include <sys/uio.h>
+#ifdef ENABLE_IO_URING
+#include <linux/io_uring.h>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#endif
+#endif
+
+//线程池模式下文件IO线程数
+#ifndef FILE_IO_POOL_THREADS
+#define FILE_IO_POOL_THREADS 4
+#endif
+
+//io_uring提交队列深度
+#ifndef FILE_IO_URING_DEPTH
+#define FILE_IO_URING_DEPTH 256
+#endif
+
+//大块顺序读拆分阈值及分块大小
+#define FILE_IO_SEQ_THRESHOLD (1024*1024)
+#define FILE_IO_SEQ_CHUNK (256*1024)
+
+//操作内部缓存的分散/聚集块数
+#define FILE_IO_LOCAL_IOV 8
+
+class FileIoService_;
+
+/*!
+@brief 异步文件读写（linux下启用ENABLE_IO_URING后使用io_uring，否则使用线程池）
+*/
+class async_file
+{
+	friend FileIoService_;
+public:
+	struct result
+	{
+		size_t s;///<字节数
+		int code;///<错误码
+		bool ok;///<是否成功
+	};
+
+	enum open_flag
+	{
+		read_only = 0x01,
+		write_only = 0x02,
+		read_write = 0x03,
+		create = 0x04,
+		truncate = 0x08,
+		append = 0x10,
+		sequential = 0x20,///<提示顺序访问
+		direct = 0x40///<绕过系统缓存(linux O_DIRECT)
+	};
+
+#ifdef __linux__
+	typedef int native_handle_type;
+	typedef struct iovec io_vec;
+#elif WIN32
+	typedef HANDLE native_handle_type;
+	struct io_vec
+	{
+		void* iov_base;
+		size_t iov_len;
+	};
+#endif
+
+	/*!
+	@brief 操作标记，带标记发起的异步操作可以用cancel(op_tag)单独取消；
+	由调用方保证同一时刻唯一(如用发起者的地址)，不能为0
+	*/
+	struct op_tag
+	{
+		unsigned long long id;
+	};
+private:
+	struct op_face
+	{
+		enum op_type
+		{
+			op_read,
+			op_write,
+			op_readv,
+			op_writev,
+			op_fsync,
+			op_fdatasync
+		};
+
+		op_face(async_file* file, op_type type, unsigned long long offset, bool full);
+		virtual ~op_face() __disable_noexcept;
+		virtual void complete(const result& res) = 0;
+
+		void set_buffer(const void* buff, size_t length);
+		void set_buffers(const void* const* buffs, const size_t* lengths, size_t count);
+		void consume(size_t s);
+		bool need_more(size_t s) const;
+
+		op_face* _next;
+		op_face* _prev;
+		async_file* _file;
+		native_handle_type _fd;
+		unsigned long long _id;///<带超时的操作编号，用于单独取消，0表示无
+		unsigned long long _offset;
+		io_vec* _iov;
+		io_vec* _iovAlloc;
+		size_t _iovCount;
+		size_t _bytes;
+		size_t _totalBytes;
+		int _code;
+		op_type _type;
+		bool _full;
+		io_vec _localIov[FILE_IO_LOCAL_IOV];
+		NONE_COPY(op_face);
+	};
+
+	template <typename Handler>
+	struct op_handler : public op_face
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		op_handler(Handler& handler, async_file* file, op_type type, unsigned long long offset, bool full)
+			:op_face(file, type, offset, full), _handler(std::forward<Handler>(handler)) {}
+
+		void complete(const result& res)
+		{
+			handler_type handler(std::move(_handler));
+			delete this;
+			handler(res);
+		}
+
+		handler_type _handler;
+	};
+
+	/*!
+	@brief 大块顺序读，拆分成多个分块并发读取，全部完成后合并结果
+	*/
+	struct seq_read_face
+	{
+		struct chunk_op : public op_face
+		{
+			chunk_op(seq_read_face* parent, size_t index, async_file* file, unsigned long long offset)
+				:op_face(file, op_read, offset, true), _parent(parent), _index(index) {}
+
+			void complete(const result& res)
+			{
+				seq_read_face* const parent = _parent;
+				const size_t index = _index;
+				delete this;
+				parent->chunk_complete(index, res);
+			}
+
+			seq_read_face* const _parent;
+			const size_t _index;
+		};
+
+		seq_read_face(size_t length);
+		virtual ~seq_read_face() __disable_noexcept;
+		virtual void complete(const result& res) = 0;
+		void chunk_complete(size_t index, const result& res);
+
+		std::atomic<size_t> _pending;
+		size_t* _chunkBytes;
+		int* _chunkCode;
+		size_t _chunkCount;
+		size_t _length;
+		NONE_COPY(seq_read_face);
+	};
+
+	template <typename Handler>
+	struct seq_read_handler : public seq_read_face
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		seq_read_handler(Handler& handler, size_t length)
+			:seq_read_face(length), _handler(std::forward<Handler>(handler)) {}
+
+		void complete(const result& res)
+		{
+			handler_type handler(std::move(_handler));
+			delete this;
+			handler(res);
+		}
+
+		handler_type _handler;
+	};
+public:
+	async_file(io_engine& ios);
+	~async_file();
+public:
+	/*!
+	@brief 打开文件
+	@param flags open_flag组合
+	*/
+	result open(const char* path, int flags, int mode = 0644);
+
+	/*!
+	@brief 关闭文件（关闭前应等待所有异步操作完成）
+	*/
+	result close();
+
+	/*!
+	@brief 取消本文件上所有还未开始执行的异步操作(包括其它Actor发起的)，被取消的操作以operation_aborted完成；
+	io_uring下已提交到内核的操作也请求取消，线程池中正在执行的操作不能取消
+	*/
+	void cancel();
+
+	/*!
+	@brief 只取消以tag发起的、还未完成的异步操作
+	*/
+	void cancel(op_tag tag);
+
+	/*!
+	@brief 是否已打开
+	*/
+	bool is_open();
+
+	/*!
+	@brief 文件大小
+	*/
+	result size();
+
+	/*!
+	@brief 改变文件大小
+	*/
+	result resize(unsigned long long length);
+
+	/*!
+	@brief 底层文件句柄
+	*/
+	native_handle_type native_handle();
+
+	/*!
+	@brief 当前是否使用io_uring
+	*/
+	bool is_uring();
+
+	/*!
+	@brief 从offset处读取数据，直到读满或到文件尾(大块读取会拆分并发执行)
+	*/
+	result read_at(my_actor* host, unsigned long long offset, void* buff, size_t length);
+
+	/*!
+	@brief 从offset处读取数据，有多少读多少
+	*/
+	result read_some_at(my_actor* host, unsigned long long offset, void* buff, size_t length);
+
+	/*!
+	@brief 从offset处写入全部数据
+	*/
+	result write_at(my_actor* host, unsigned long long offset, const void* buff, size_t length);
+
+	/*!
+	@brief 从offset处分散读取到多个缓存中，直到读满或到文件尾
+	*/
+	result readv_at(my_actor* host, unsigned long long offset, void* const* buffs, const size_t* lengths, size_t count);
+
+	/*!
+	@brief 从offset处聚集写入多个缓存
+	*/
+	result writev_at(my_actor* host, unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count);
+
+	/*!
+	@brief 将文件数据刷入磁盘
+	@param dataOnly 只刷新数据，不刷新元数据
+	*/
+	result fsync(my_actor* host, bool dataOnly = false);
+
+	/*!
+	@brief 在ms时间范围内，从offset处读取数据，直到读满或到文件尾；
+	timed_*系列超时只取消本次操作(不影响同一文件上的其它操作)，超时后以timed_out返回；
+	线程池模式下已经开始执行的操作不能中断，超时后仍等它执行完，所以超时只限制排队时间；
+	io_uring下向内核请求取消，能否中断由内核决定
+	*/
+	result timed_read_at(my_actor* host, int ms, unsigned long long offset, void* buff, size_t length);
+
+	/*!
+	@brief 在ms时间范围内，从offset处读取数据，有多少读多少
+	*/
+	result timed_read_some_at(my_actor* host, int ms, unsigned long long offset, void* buff, size_t length);
+
+	/*!
+	@brief 在ms时间范围内，从offset处写入全部数据
+	*/
+	result timed_write_at(my_actor* host, int ms, unsigned long long offset, const void* buff, size_t length);
+
+	/*!
+	@brief 在ms时间范围内，从offset处分散读取到多个缓存中
+	*/
+	result timed_readv_at(my_actor* host, int ms, unsigned long long offset, void* const* buffs, const size_t* lengths, size_t count);
+
+	/*!
+	@brief 在ms时间范围内，从offset处聚集写入多个缓存
+	*/
+	result timed_writev_at(my_actor* host, int ms, unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count);
+
+	/*!
+	@brief 在ms时间范围内，将文件数据刷入磁盘
+	*/
+	result timed_fsync(my_actor* host, int ms, bool dataOnly = false);
+
+	/*!
+	@brief 异步模式下，从offset处读取数据，直到读满或到文件尾
+	*/
+	template <typename Handler>
+	bool async_read_at(unsigned long long offset, void* buff, size_t length, Handler&& handler)
+	{
+		submit_read(0, offset, buff, length, std::forward<Handler>(handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下，从offset处读取数据，有多少读多少
+	*/
+	template <typename Handler>
+	bool async_read_some_at(unsigned long long offset, void* buff, size_t length, Handler&& handler)
+	{
+		submit_buffer(0, op_face::op_read, offset, buff, length, false, std::forward<Handler>(handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下，从offset处写入全部数据
+	*/
+	template <typename Handler>
+	bool async_write_at(unsigned long long offset, const void* buff, size_t length, Handler&& handler)
+	{
+		submit_buffer(0, op_face::op_write, offset, buff, length, true, std::forward<Handler>(handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下，从offset处分散读取到多个缓存中
+	*/
+	template <typename Handler>
+	bool async_readv_at(unsigned long long offset, void* const* buffs, const size_t* lengths, size_t count, Handler&& handler)
+	{
+		submit_buffers(0, op_face::op_readv, offset, buffs, lengths, count, std::forward<Handler>(handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下，从offset处聚集写入多个缓存
+	*/
+	template <typename Handler>
+	bool async_writev_at(unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count, Handler&& handler)
+	{
+		submit_buffers(0, op_face::op_writev, offset, buffs, lengths, count, std::forward<Handler>(handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下，将文件数据刷入磁盘
+	*/
+	template <typename Handler>
+	bool async_fsync(bool dataOnly, Handler&& handler)
+	{
+		submit_fsync(0, dataOnly, std::forward<Handler>(handler));
+		return false;
+	}
+
+	/*!
+	@brief 带标记的异步操作，与不带标记的版本相同，之后可以用cancel(tag)只取消这一个操作
+	*/
+	template <typename Handler>
+	bool async_read_at(op_tag tag, unsigned long long offset, void* buff, size_t length, Handler&& handler)
+	{
+		assert(tag.id);
+		submit_read(tag.id, offset, buff, length, std::forward<Handler>(handler));
+		return false;
+	}
+
+	template <typename Handler>
+	bool async_read_some_at(op_tag tag, unsigned long long offset, void* buff, size_t length, Handler&& handler)
+	{
+		assert(tag.id);
+		submit_buffer(tag.id, op_face::op_read, offset, buff, length, false, std::forward<Handler>(handler));
+		return false;
+	}
+
+	template <typename Handler>
+	bool async_write_at(op_tag tag, unsigned long long offset, const void* buff, size_t length, Handler&& handler)
+	{
+		assert(tag.id);
+		submit_buffer(tag.id, op_face::op_write, offset, buff, length, true, std::forward<Handler>(handler));
+		return false;
+	}
+
+	template <typename Handler>
+	bool async_readv_at(op_tag tag, unsigned long long offset, void* const* buffs, const size_t* lengths, size_t count, Handler&& handler)
+	{
+		assert(tag.id);
+		submit_buffers(tag.id, op_face::op_readv, offset, buffs, lengths, count, std::forward<Handler>(handler));
+		return false;
+	}
+
+	template <typename Handler>
+	bool async_writev_at(op_tag tag, unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count, Handler&& handler)
+	{
+		assert(tag.id);
+		submit_buffers(tag.id, op_face::op_writev, offset, buffs, lengths, count, std::forward<Handler>(handler));
+		return false;
+	}
+
+	template <typename Handler>
+	bool async_fsync(op_tag tag, bool dataOnly, Handler&& handler)
+	{
+		assert(tag.id);
+		submit_fsync(tag.id, dataOnly, std::forward<Handler>(handler));
+		return false;
+	}
+private:
+	/*!
+	@brief 提交操作，id非0时可以用cancel_op单独取消
+	*/
+	template <typename Handler>
+	void submit_read(unsigned long long id, unsigned long long offset, void* buff, size_t length, Handler&& handler)
+	{
+		if (length >= FILE_IO_SEQ_THRESHOLD && parallel_read())
+		{
+			seq_read(new seq_read_handler<Handler>(handler, length), offset, buff, id);
+			return;
+		}
+		submit_buffer(id, op_face::op_read, offset, buff, length, true, std::forward<Handler>(handler));
+	}
+
+	template <typename Handler>
+	void submit_buffer(unsigned long long id, op_face::op_type type, unsigned long long offset, const void* buff, size_t length, bool full, Handler&& handler)
+	{
+		op_face* op = new op_handler<Handler>(handler, this, type, offset, full);
+		op->_id = id;
+		op->set_buffer(buff, length);
+		submit(op);
+	}
+
+	template <typename Handler>
+	void submit_buffers(unsigned long long id, op_face::op_type type, unsigned long long offset, const void* const* buffs, const size_t* lengths, size_t count, Handler&& handler)
+	{
+		op_face* op = new op_handler<Handler>(handler, this, type, offset, true);
+		op->_id = id;
+		op->set_buffers(buffs, lengths, count);
+		submit(op);
+	}
+
+	template <typename Handler>
+	void submit_fsync(unsigned long long id, bool dataOnly, Handler&& handler)
+	{
+		op_face* op = new op_handler<Handler>(handler, this, dataOnly ? op_face::op_fdatasync : op_face::op_fsync, 0, false);
+		op->_id = id;
+		submit(op);
+	}
+
+	void submit(op_face* op);
+	void seq_read(seq_read_face* parent, unsigned long long offset, void* buff, unsigned long long id);
+	bool parallel_read();
+	unsigned long long new_op_id();
+	void cancel_op(unsigned long long id);
+private:
+	io_engine& _ios;
+	FileIoService_* _service;
+	native_handle_type _fd;
+	NONE_COPY(async_file);
+};
+
+/*!
+@brief 每个io_engine一个，执行async_file的异步操作，完成回调在io_engine线程中执行
+*/
+class FileIoService_
+{
+	friend async_file;
+	friend io_engine;
+	typedef async_file::op_face op_face;
+	typedef async_file::result result;
+private:
+	FileIoService_(io_engine& ios);
+	~FileIoService_();
+private:
+	void submit(op_face* ops);
+	void cancel(async_file* file, unsigned long long id);
+	bool parallel();
+	void post_complete(op_face* op);
+	void complete(op_face* op);
+	void pool_run();
+	static void exec(op_face* op);
+#ifdef ENABLE_IO_URING
+	bool uring_init();
+	void uring_uninit();
+	bool uring_push(op_face* op);
+	void uring_flush();
+	void uring_enter(unsigned count);
+	void uring_arm();
+	void uring_ready(const boost::system::error_code& ec);
+#endif
+private:
+	io_engine& _ios;
+	std::mutex _mutex;
+	std::condition_variable _conVar;
+	std::vector<run_thread*> _threads;
+	op_face* _queueHead;///<线程池任务队列/io_uring提交溢出队列
+	op_face* _queueTail;
+	std::atomic<unsigned long long> _opId;
+	bool _exit;
+#ifdef ENABLE_IO_URING
+	boost::asio::posix::stream_descriptor* _eventDesc;///<eventfd接入reactor，有完成事件时唤醒
+	op_face* _inflightHead;///<已提交到内核的操作
+	void* _sqPtr;
+	void* _cqPtr;
+	struct io_uring_sqe* _sqes;
+	unsigned* _sqHead;
+	unsigned* _sqTail;
+	unsigned* _sqMask;
+	unsigned* _sqArray;
+	unsigned* _cqHead;
+	unsigned* _cqTail;
+	unsigned* _cqMask;
+	struct io_uring_cqe* _cqes;
+	size_t _sqSize;
+	size_t _cqSize;
+	size_t _sqesSize;
+	size_t _inflight;
+	unsigned _sqEntries;
+	int _ringFd;
+	int _eventFd;
+	bool _armed;
+#endif
+	bool _uring;
+	NONE_COPY(FileIoService_);
+};
+
+//generator中异步文件操作，__res__ 为 async_file::result
+#define co_file_read_at(__file__, __offset__, __buff__, __len__, __res__) co_await (__file__).async_read_at(__offset__, __buff__, __len__, co_async_result(__res__))
+#define co_file_read_some_at(__file__, __offset__, __buff__, __len__, __res__) co_await (__file__).async_read_some_at(__offset__, __buff__, __len__, co_async_result(__res__))
+#define co_file_write_at(__file__, __offset__, __buff__, __len__, __res__) co_await (__file__).async_write_at(__offset__, __buff__, __len__, co_async_result(__res__))
+#define co_file_readv_at(__file__, __offset__, __buffs__, __lens__, __count__, __res__) co_await (__file__).async_readv_at(__offset__, __buffs__, __lens__, __count__, co_async_result(__res__))
+#define co_file_writev_at(__file__, __offset__, __buffs__, __lens__, __count__, __res__) co_await (__file__).async_writev_at(__offset__, __buffs__, __lens__, __count__, co_async_result(__res__))
+#define co_file_fsync(__file__, __dataOnly__, __res__) co_await (__file__).async_fsync(__dataOnly__, co_async_result(__res__))
+
+//超时后只取消本次发起的操作(以generator地址为标记，同一generator同时只有一个)，co_last_state 为 co_async_overtime
+#define _co_file_tag async_file::op_tag{ (unsigned long long)(size_t)&co_self }
+#define _co_file_timed(__file__, __ms__) co_last_state = co_async_state::co_async_ok;\
+	co_timed_await(__ms__, { co_last_state = co_async_state::co_async_overtime; (__file__).cancel(_co_file_tag); })
+#define co_file_timed_read_at(__file__, __ms__, __offset__, __buff__, __len__, __res__) _co_file_timed(__file__, __ms__) (__file__).async_read_at(_co_file_tag, __offset__, __buff__, __len__, co_async_result(__res__))
+#define co_file_timed_read_some_at(__file__, __ms__, __offset__, __buff__, __len__, __res__) _co_file_timed(__file__, __ms__) (__file__).async_read_some_at(_co_file_tag, __offset__, __buff__, __len__, co_async_result(__res__))
+#define co_file_timed_write_at(__file__, __ms__, __offset__, __buff__, __len__, __res__) _co_file_timed(__file__, __ms__) (__file__).async_write_at(_co_file_tag, __offset__, __buff__, __len__, co_async_result(__res__))
+#define co_file_timed_readv_at(__file__, __ms__, __offset__, __buffs__, __lens__, __count__, __res__) _co_file_timed(__file__, __ms__) (__file__).async_readv_at(_co_file_tag, __offset__, __buffs__, __lens__, __count__, co_async_result(__res__))
+#define co_file_timed_writev_at(__file__, __ms__, __offset__, __buffs__, __lens__, __count__, __res__) _co_file_timed(__file__, __ms__) (__file__).async_writev_at(_co_file_tag, __offset__, __buffs__, __lens__, __count__, co_async_result(__res__))
+#define co_file_timed_fsync(__file__, __ms__, __dataOnly__, __res__) _co_file_timed(__file__, __ms__) (__file__).async_fsync(_co_file_tag, __dataOnly__, co_async_result(__res__))
+
+#endif
@@ -1,5 +1,6 @@
 #include "async_timer.h"
 #include "scattered.h"
+#include "time_source.h"
 #include "io_engine.h"
 #include "actor_timer.h"
 #ifndef DISABLE_BOOST_TIMER
@@ -137,7 +138,7 @@ _extMaxTick(0), _extFinishTime(-1), _handlerQueue(MEM_POOL_LENGTH)
 #ifdef DISABLE_BOOST_TIMER
 	_timer = new timer_type(strand->get_io_engine(), this);
 #else
-	_timer = new timer_type(strand->get_io_engine());
+	_timer = new timer_type(strand->get_io_service());
 #endif
 }
 
@@ -157,7 +158,7 @@ void overlap_timer::_timeout(long long us, timer_handle& timerHandle, bool deadl
 #endif
 	}
 	assert(_lockStrand->running_in_this_thread());
-	timerHandle._timestamp = get_tick_us();
+	timerHandle._timestamp = time_source::tsc_us();
 	long long et = deadline ? us : (timerHandle._timestamp + us);
 	if (et >= _extMaxTick)
 	{
@@ -170,14 +171,14 @@ void overlap_timer::_timeout(long long us, timer_handle& timerHandle, bool deadl
 	}
 
 	if (!_looping)
-	{//ʱѾ˳ѭʱ
+	{//定时器已经退出循环，重新启动定时器
 		_looping = true;
 		assert(_handlerQueue.size() == 1);
 		_extFinishTime = et;
 		timer_loop(et, et - timerHandle._timestamp);
 	}
 	else if ((unsigned long long)et < (unsigned long long)_extFinishTime)
-	{//ʱǰڵǰʱޣȡ¼ʱ
+	{//定时期限前于当前定时器期限，取消后重新计时
 		boost::system::error_code ec;
 		as_ptype<timer_type>(_timer)->cancel(ec);
 		_timerCount++;
@@ -196,7 +197,7 @@ void overlap_timer::_cancel(timer_handle& timerHandle)
 		{
 			_extMaxTick = 0;
 			_handlerQueue.erase(itNode);
-			//ûжʱ˳ʱѭ
+			//如果没有定时任务就退出定时循环
 			boost::system::error_code ec;
 			as_ptype<timer_type>(_timer)->cancel(ec);
 			_timerCount++;
@@ -225,7 +226,7 @@ void overlap_timer::cancel(timer_handle& timerHandle)
 {
 	assert(self_strand()->running_in_this_thread());
 	if (!timerHandle.completed())
-	{//ɾǰʱڵ
+	{//删除当前定时器节点
 		_cancel(timerHandle);
 		timerHandle._handler->destroy(_reuMem);
 		timerHandle.reset();
@@ -336,7 +337,8 @@ void overlap_timer::event_handler(int tc)
 		while (!_handlerQueue.empty())
 		{
 			handler_queue::iterator iter = _handlerQueue.begin();
-			long long ct = get_tick_us();
+			long long ct = time_source::tsc_us();
+			time_source::refresh_coarse(ct);
 			if (iter->first > ct)
 			{
 				_extFinishTime = iter->first;
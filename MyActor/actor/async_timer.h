@@ -6,6 +6,7 @@
 #include "msg_queue.h"
 #include "mem_pool.h"
 #include "stack_object.h"
+#include "time_source.h"
 
 class ActorTimer_;
 class overlap_timer;
@@ -15,7 +16,7 @@ class boost_strand;
 typedef std::shared_ptr<AsyncTimer_> async_timer;
 
 /*!
-@brief 첽ʱһʱѭһAsyncTimer_
+@brief 异步定时器，一个定时循环一个AsyncTimer_
 */
 class AsyncTimer_ : public ActorTimerFace_
 {
@@ -169,7 +170,7 @@ private:
 	~AsyncTimer_();
 public:
 	/*!
-	@brief һʱstrand߳е
+	@brief 开启一个定时，在依赖的strand线程中调用
 	*/
 	template <typename Handler>
 	long long timeout(int ms, Handler&& handler)
@@ -208,7 +209,7 @@ public:
 	}
 
 	/*!
-	@brief һԶʱstrand߳е
+	@brief 开启一个绝对定时，在依赖的strand线程中调用
 	*/
 	template <typename Handler>
 	long long deadline(long long us, Handler&& handler)
@@ -233,7 +234,7 @@ public:
 	}
 
 	/*!
-	@brief ѭʱһhandlerstrand߳е
+	@brief 循环定时调用一个handler，在依赖的strand线程中调用
 	*/
 	template <typename Handler>
 	void interval(int ms, Handler&& handler, bool immed = false)
@@ -284,7 +285,7 @@ public:
 		}, wrap_advance_timer_handler(_reuMem, std::forward<Handler>(handler)));
 		if (immed)
 		{
-			_handler->set_deadtime(get_tick_us());
+			_handler->set_deadtime(time_source::tsc_us());
 			_handler->invoke();
 		}
 		else
@@ -295,27 +296,27 @@ public:
 	}
 
 	/*!
-	@brief ȡμʱstrand߳е
+	@brief 取消本次计时，在依赖的strand线程中调用
 	*/
 	void cancel();
 
 	/*!
-	@brief ǰμʱstrand߳е
+	@brief 提前本次计时触发，在依赖的strand线程中调用
 	*/
 	bool advance();
 
 	/*!
-	@brief ǰμʱstrand߳е
+	@brief 提前本次计时触发，在依赖的strand线程中调用
 	*/
 	void tick_advance();
 
 	/*!
-	@brief Լʱ£¿ʼʱ
+	@brief 相对计时下，重新开始计时
 	*/
 	bool restart();
 
 	/*!
-	@brief ǷѾ
+	@brief 是否已经完成
 	*/
 	bool completed();
 
@@ -325,7 +326,7 @@ public:
 	shared_strand self_strand();
 
 	/*!
-	@brief һͬһshared_strandĶʱ
+	@brief 创建一个依赖同一个shared_strand的定时器
 	*/
 	async_timer clone();
 private:
@@ -363,7 +364,7 @@ private:
 };
 
 /*!
-@brief صʹõĶʱ
+@brief 可重叠使用的定时器
 */
 class overlap_timer
 #ifdef DISABLE_BOOST_TIMER
@@ -458,7 +459,7 @@ private:
 	~overlap_timer();
 public:
 	/*!
-	@brief һʱstrand߳е
+	@brief 开启一个定时，在依赖的strand线程中调用
 	*/
 	template <typename Handler>
 	void timeout(int ms, timer_handle& timerHandle, Handler&& handler)
@@ -495,7 +496,7 @@ public:
 	}
 
 	/*!
-	@brief һԶʱstrand߳е
+	@brief 开启一个绝对定时，在依赖的strand线程中调用
 	*/
 	template <typename Handler>
 	void deadline(long long us, timer_handle& timerHandle, Handler&& handler)
@@ -518,7 +519,7 @@ public:
 	}
 
 	/*!
-	@brief ѭʱһhandlerstrand߳е
+	@brief 循环定时调用一个handler，在依赖的strand线程中调用
 	*/
 	template <typename Handler>
 	void interval(int ms, timer_handle& timerHandle, Handler&& handler, bool immed = false)
@@ -569,7 +570,7 @@ public:
 		}, AsyncTimer_::wrap_advance_timer_handler(_reuMem, std::forward<Handler>(handler)));
 		if (immed)
 		{
-			timerHandle._handler->set_deadtime(get_tick_us());
+			timerHandle._handler->set_deadtime(time_source::tsc_us());
 			timerHandle._handler->invoke();
 		}
 		else
@@ -580,22 +581,22 @@ public:
 	}
 
 	/*!
-	@brief ȡһμʱstrand߳е
+	@brief 取消一次计时，在依赖的strand线程中调用
 	*/
 	void cancel(timer_handle& timerHandle);
 
 	/*!
-	@brief ǰμʱstrand߳е
+	@brief 提前本次计时触发，在依赖的strand线程中调用
 	*/
 	bool advance(timer_handle& timerHandle);
 
 	/*!
-	@brief ǰμʱstrand߳е
+	@brief 提前本次计时触发，在依赖的strand线程中调用
 	*/
 	void tick_advance(timer_handle& timerHandle);
 
 	/*!
-	@brief Լʱ£¿ʼʱ
+	@brief 相对计时下，重新开始计时
 	*/
 	bool restart(timer_handle& timerHandle);
 
@@ -700,7 +700,7 @@ private:
 };
 
 /*!
-@brief һv8nodejs˵C++˺Բûεã
+@brief 构造一个v8对象，用于nodejs端调用C++端函数（可以不调用或多次调用）
 */
 template <typename CastHandler>
 static v8::Local<v8::Function> make_js_call_cpp(v8::Isolate* isolate, CastHandler&& castHandler)
@@ -713,7 +713,7 @@ static v8::Local<v8::Function> make_js_call_cpp(v8::Isolate* isolate, CastHandle
 }
 
 /*!
-@brief һv8nodejs˵C++˺ãֻܵһΣ
+@brief 构造一个v8对象，用于nodejs端调用C++端函数（必须调用，且只能调用一次）
 */
 template <typename CastHandler>
 static v8::Local<v8::Function> make_js_call_cpp_once(v8::Isolate* isolate, CastHandler&& castHandler)
@@ -734,7 +734,7 @@ static v8::Local<v8::Function> make_js_call_cpp_once(v8::Isolate* isolate, CastH
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief nodejsʼʱעᣬcppȫַʽjs
+@brief nodejs初始化的时候注册，让cpp可以以全局方式调用js
 */
 #define NODE_SET_GLOBAL \
 	NODE_SET_METHOD(exports, "set_global", [](const v8::FunctionCallbackInfo<v8::Value>& args){\
@@ -743,7 +743,7 @@ static v8::Local<v8::Function> make_js_call_cpp_once(v8::Isolate* isolate, CastH
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief һC++nodejs˷Ķ󣬱Actorڲʹ
+@brief 构造一个C++调用nodejs端方法的对象，必须在Actor内部使用
 */
 class cpp_call_js
 {
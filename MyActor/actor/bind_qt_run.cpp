@@ -20,7 +20,7 @@ void bind_qt_run_base::ui_tls::init()
 	{
 		ui_tls*& uiTls = (ui_tls*&)tlsBuff[QT_UI_TLS_INDEX];
 		if (!uiTls)
-		{//ios߳дUI
+		{//ios线程中创建的UI
 			uiTls = new ui_tls();
 		}
 		uiTls->_count++;
@@ -46,7 +46,7 @@ void bind_qt_run_base::ui_tls::reset()
 			io_engine::setTlsBuff(NULL);
 		}
 		else
-		{//ios߳дUI
+		{//ios线程中创建的UI
 			tlsBuff[QT_UI_TLS_INDEX] = NULL;
 		}
 		delete uiTls;
@@ -18,33 +18,33 @@
 #define QT_POST_TASK	(QEvent::MaxUser-1)
 #define	QT_UI_ACTOR_STACK_SIZE	(128 kB - STACK_RESERVED_SPACE_SIZE)
 
-//ʼActorУǶһqt-uiִ߳е߼
+//开始在Actor中，嵌入一段在qt-ui线程中执行的连续逻辑
 #define BEGIN_RUN_IN_QT_UI_AT(__this_ui__, __host__) do {(__this_ui__)->send(__host__, [&]() {
 #define BEGIN_RUN_IN_QT_UI BEGIN_RUN_IN_QT_UI_AT(this, self)
 #define CO_BEGIN_RUN_IN_QT_UI_AT(__this_ui__) do {(__this_ui__)->co_send(co_self, [&]() {
 #define CO_BEGIN_RUN_IN_QT_UI CO_BEGIN_RUN_IN_QT_UI_AT(this)
-//qt-uiִ߳еһ߼ֻе߼ִϺŻִEND
+//结束在qt-ui线程中执行的一段连续逻辑，只有当这段逻辑执行完毕后才会执行END后续代码
 #define END_RUN_IN_QT_UI });} while (false)
 #define CO_END_RUN_IN_QT_UI }); _co_await;} while (false)
 //////////////////////////////////////////////////////////////////////////
-//ActorУǶһqt-uiִ߳е
+//在Actor中，嵌入一段在qt-ui线程中执行的语句
 #define run_in_qt_ui_at(__this_ui__, __host__, ...)  do {(__this_ui__)->send(__host__, [&]{ option_pck(__VA_ARGS__) });} while (false)
 #define co_run_in_qt_ui_at(__this_ui__, ...)  do {(__this_ui__)->co_send(co_self, [&]{ option_pck(__VA_ARGS__) }); _co_await;} while (false)
 
-//ActorУǶһqt-uiִ߳е
+//在Actor中，嵌入一段在qt-ui线程中执行的语句
 #define run_in_qt_ui(...) run_in_qt_ui_at(this, self, __VA_ARGS__)
 #define co_run_in_qt_ui(...) co_run_in_qt_ui_at(this, __VA_ARGS__)
 //////////////////////////////////////////////////////////////////////////
-//ActorУǶһqt-uiִ߳еActor߼߼а첽ʱʹãBEGIN_RUN_IN_QT_UI_AT
+//在Actor中，嵌入一段在qt-ui线程中执行的Actor逻辑（当该逻辑中包含异步操作时使用，否则建议用BEGIN_RUN_IN_QT_UI_AT）
 #define BEGIN_ACTOR_RUN_IN_QT_UI_AT(__this_ui__, __host__, __ios__) do {\
 	auto ___host = __host__; \
 	my_actor::quit_guard ___qg(__host__); \
 	auto ___tactor = (__this_ui__)->create_ui_actor(__ios__, [&](my_actor* __host__) {
 
-//ActorУǶһqt-uiִ߳еActor߼߼а첽ʱʹãBEGIN_RUN_IN_QT_UI
+//在Actor中，嵌入一段在qt-ui线程中执行的Actor逻辑（当该逻辑中包含异步操作时使用，否则建议用BEGIN_RUN_IN_QT_UI）
 #define BEGIN_ACTOR_RUN_IN_QT_UI(__ios__) BEGIN_ACTOR_RUN_IN_QT_UI_AT(this, self, __ios__)
 
-//qt-uiִ߳еActorֻеActor߼ִϺŻִEND
+//结束在qt-ui线程中执行的Actor，只有当Actor内逻辑执行完毕后才会执行END后续代码
 #define END_ACTOR_RUN_IN_QT_UI }); \
 	___tactor->run(); \
 	___host->actor_wait_quit(___tactor); \
@@ -94,7 +94,7 @@
 	co_unlock_stop;\
 } while (false)
 
-//ڷUI߳ActorУرһqt-ui
+//在非UI线程Actor中，关闭一个qt-ui对象
 #define close_qt_ui_at(__this_ui__, __host__, __frame__) __CLOSE_QT_UI_AT(__this_ui__, __host__, __frame__, __NO_DELETE_FRAME)
 #define close_qt_ui(__frame__) close_qt_ui_at(this, self, __frame__)
 #define close_qt_ui_delete_at(__this_ui__, __host__, __frame__) __CLOSE_QT_UI_AT(__this_ui__, __host__, __frame__, __DELETE_FRAME)
@@ -132,7 +132,7 @@
 	co_unlock_stop;\
 } while (false)
 
-//UI߳ActorУرһqt-ui
+//在UI线程Actor中，关闭一个qt-ui对象
 #define close_in_qt_ui_at(__this_ui__, __host__, __frame__) __CLOSE_IN_QT_UI_AT(__this_ui__, __host__, __frame__, __NO_DELETE_FRAME)
 #define close_in_qt_ui(__frame__) close_in_qt_ui_at(this, self, __frame__)
 #define close_in_qt_ui_delete_at(__this_ui__, __host__, __frame__) __CLOSE_IN_QT_UI_AT(__this_ui__, __host__, __frame__, __DELETE_FRAME)
@@ -149,18 +149,18 @@
 
 //////////////////////////////////////////////////////////////////////////
 
-//closeEvent׼رui
+//closeEvent函数中准备关闭入口ui
 #define BEGIN_CLOSE_QT_MAIN_UI if (!is_wait_close() && !in_close_scope()) { set_in_close_scope_sign(true);
-//closeEventеȴرui
+//closeEvent函数中等待关闭入口ui
 #define WAIT_CLOSE_QT_MAIN_UI enter_wait_close();
-//closeEventнرui
+//closeEvent函数中结束关闭入口ui
 #define END_CLOSE_QT_MAIN_UI set_in_close_scope_sign(false);}
 
-//closeEvent׼رui
+//closeEvent函数中准备关闭ui
 #define BEGIN_CLOSE_QT_UI if (!is_wait_close() && !in_close_scope()) { set_in_close_scope_sign(true);
-//closeEventеȴرui
+//closeEvent函数中等待关闭ui
 #define WAIT_CLOSE_QT_UI async_enter_wait_close([&]{
-//closeEventнرui
+//closeEvent函数中结束关闭ui
 #define END_CLOSE_QT_UI set_in_close_scope_sign(false);});}
 
 class bind_qt_run_base
@@ -298,52 +298,52 @@ protected:
 	~bind_qt_run_base();
 public:
 	/*!
-	@brief ȡ߳ID
+	@brief 获取主线程ID
 	*/
 	run_thread::thread_id thread_id();
 
 	/*!
-	@brief ǷUIִ߳
+	@brief 是否在UI线程中执行
 	*/
 	bool run_in_ui_thread();
 
 	/*!
-	@brief ǷڱUIpost
+	@brief 检测现在是否运行在本UI的post任务下
 	*/
 	bool running_in_this_thread();
 
 	/*!
-	@brief ǰջǷֻеǰui
+	@brief 当前调用栈里是否只有当前ui
 	*/
 	bool only_self();
 
 	/*!
-	@brief Ƿڵȴر
+	@brief 是否在等待关闭
 	*/
 	bool is_wait_close();
 
 	/*!
-	@brief ȴر
+	@brief 等待关闭完成
 	*/
 	bool wait_close_reached();
 
 	/*!
-	@brief ڹر
+	@brief 正在关闭中
 	*/
 	bool inside_wait_close_loop();
 
 	/*!
-	@brief ڹرղΧ
+	@brief 在关闭操作范围内
 	*/
 	bool in_close_scope();
 
 	/*!
-	@brief ùرղΧ
+	@brief 设置关闭操作范围标记
 	*/
 	void set_in_close_scope_sign(bool b);
 
 	/*!
-	@brief һִкUIϢִ
+	@brief 发送一个执行函数到UI消息队列中执行
 	*/
 	template <typename Handler>
 	void post(Handler&& handler)
@@ -365,7 +365,7 @@ public:
 	}
 
 	/*!
-	@brief һִкUIϢִУɺ󷵻
+	@brief 发送一个执行函数到UI消息队列中执行，完成后返回
 	*/
 	template <typename Handler>
 	void send(my_actor* host, Handler&& handler)
@@ -381,7 +381,7 @@ public:
 	}
 
 	/*!
-	@brief generaotr·һִкUIϢִ
+	@brief generaotr下发送一个执行函数到UI消息队列中执行
 	*/
 	template <typename Handler>
 	void co_send(co_generator, Handler&& handler)
@@ -394,7 +394,7 @@ public:
 	}
 
 	/*!
-	@brief һʱִкUIϢִУɺ󷵻
+	@brief 发送一个超时执行函数到UI消息队列中执行，完成后返回
 	*/
 	template <typename Handler>
 	bool timed_send(int ms, my_actor* host, Handler&& handler)
@@ -427,12 +427,12 @@ public:
 	}
 
 	/*!
-	@brief ͵UIִһyield
+	@brief 发送到UI，执行一次yield操作
 	*/
 	void ui_yield(my_actor* host);
 
 	/*!
-	@brief һUIִ
+	@brief 绑定一个函数到UI队列执行
 	*/
 	template <typename Handler>
 	wrapped_distribute_handler<bind_qt_run_base, Handler> wrap(Handler&& handler)
@@ -473,7 +473,7 @@ public:
 	std::function<void()> wrap_check_close();
 
 	/*!
-	@brief һUIִ߳
+	@brief 绑定一个函数到UI线程中执行
 	*/
 	template <typename R, typename Handler>
 	wrap_run_in_ui_handler<Handler, R> wrap_run_in_ui(Handler&& handler)
@@ -482,23 +482,23 @@ public:
 	}
 
 	/*!
-	@brief shared_qt_strand
+	@brief 开启shared_qt_strand
 	*/
 	const shared_qt_strand& start_qt_strand(io_engine& ios);
 
 	/*!
-	@brief ȡshared_qt_strand
+	@brief 获取shared_qt_strand
 	*/
 	const shared_qt_strand& ui_strand();
 
 	/*!
-	@brief UI߳дһActorִstart_qt_strand
+	@brief 在UI线程中创建一个Actor，先执行start_qt_strand
 	*/
 	actor_handle create_ui_actor(const my_actor::main_func& mainFunc, size_t stackSize = QT_UI_ACTOR_STACK_SIZE);
 	actor_handle create_ui_actor(my_actor::main_func&& mainFunc, size_t stackSize = QT_UI_ACTOR_STACK_SIZE);
 
 	/*!
-	@brief UI߳дһActorִstart_qt_strand
+	@brief 在UI线程中创建一个子Actor，先执行start_qt_strand
 	*/
 	child_handle create_ui_child_actor(my_actor* host, const my_actor::main_func& mainFunc, size_t stackSize = QT_UI_ACTOR_STACK_SIZE);
 	child_handle create_ui_child_actor(my_actor* host, my_actor::main_func&& mainFunc, size_t stackSize = QT_UI_ACTOR_STACK_SIZE);
@@ -783,7 +783,7 @@ struct ui_sync_closed_exception {};
 struct ui_sync_lost_exception{};
 
 /*!
-@brief uiͬϢֵ
+@brief ui非阻塞同步消息返回值
 */
 template <typename R = void>
 struct qt_ui_sync_result
@@ -821,7 +821,7 @@ private:
 };
 
 /*!
-@brief uiͬϢʱȷ͵ĺ󷵻
+@brief ui非阻塞同步消息发送器，接连多个发送时，先发送的后返回
 */
 template <typename R, typename... ARGS>
 struct qt_ui_sync_notifer;
@@ -927,7 +927,7 @@ private:
 };
 
 /*!
-@brief uiϢǷʧδ
+@brief 检测ui消息是否丢失未处理
 */
 template <typename R>
 struct check_lost_qt_ui_sync_result
@@ -987,7 +987,7 @@ private:
 };
 
 /*!
-@brief uiͬϢ(ʧ)ʱȷ͵ĺ󷵻
+@brief ui非阻塞同步消息发送器(带丢失检测)，接连多个发送时，先发送的后返回
 */
 template <typename R, typename... ARGS>
 struct qt_ui_sync_check_lost_notifer;
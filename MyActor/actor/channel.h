@@ -323,6 +323,22 @@ public:
 		}
 		throw channel_io_exception(state);
 	}
+
+	/*!
+	@brief 等到一个调用后，继续处理已在排队的调用，最多maxCount个，返回处理个数
+	*/
+	template <typename Handler>
+	size_t wait_batch(my_actor* host, size_t maxCount, Handler&& handler)
+	{
+		assert(maxCount > 0);
+		wait(host, handler);
+		size_t count = 1;
+		while (count < maxCount && try_wait(host, handler))
+		{
+			count++;
+		}
+		return count;
+	}
 private:
 	template <typename TR, typename Handler, typename Parames>
 	void check_result_void(csp_result<TR>& result, Handler&& handler, Parames&& params)
@@ -379,7 +395,74 @@ public:
 };
 
 /*!
-@brief channeldisconnectʱпϢʧ
+@brief csp_window发出的一次调用，用get取回结果
+*/
+template <typename R>
+class csp_future : public co_csp_future<R>
+{
+	typedef co_csp_future<R> parent;
+public:
+	R get(my_actor* host)
+	{
+		my_actor::quit_guard qg(host);
+		stack_obj<R> res;
+		co_async_state state = co_async_state::co_async_undefined;
+		parent::wait(host->make_same_context(state, res));
+		if (co_async_state::co_async_ok != state)
+		{
+			throw channel_io_exception(state);
+		}
+		return std::forward<R>(res.get());
+	}
+};
+
+template <>
+class csp_future<void> : public co_csp_future<void_type>
+{
+	typedef co_csp_future<void_type> parent;
+public:
+	void get(my_actor* host)
+	{
+		my_actor::quit_guard qg(host);
+		co_async_state state = co_async_state::co_async_undefined;
+		parent::wait(host->make_context(state));
+		if (co_async_state::co_async_ok != state)
+		{
+			throw channel_io_exception(state);
+		}
+	}
+};
+
+/*!
+@brief csp_channel的流水线调用，最多window个未返回的调用，结果可按任意顺序get
+*/
+template <typename R>
+class csp_window : public co_csp_window<typename std::conditional<std::is_void<R>::value, void_type, R>::type>
+{
+	typedef co_csp_window<typename std::conditional<std::is_void<R>::value, void_type, R>::type> parent;
+public:
+	csp_window(my_actor* host, size_t window)
+		:parent(host->self_strand(), window) {}
+public:
+	/*!
+	@brief 窗口满时等待，发出后立即返回
+	*/
+	template <typename Chan, typename... Args>
+	void send(my_actor* host, csp_future<R>& fut, Chan& chan, Args&&... msg)
+	{
+		my_actor::quit_guard qg(host);
+		co_async_state state = co_async_state::co_async_undefined;
+		parent::acquire(host->make_context(state));
+		if (co_async_state::co_async_ok != state)
+		{
+			throw channel_io_exception(state);
+		}
+		parent::push(fut, chan, std::forward<Args>(msg)...);
+	}
+};
+
+/*!
+@brief channel连接器，disconnect时有可能造成消息丢失
 */
 template <typename Chan1, typename Chan2>
 class chan_connector
@@ -458,4 +541,484 @@ private:
 	NONE_COPY(chan_connector);
 };
 
+//管线每批从源channel读取的最大消息数
+#ifndef CHAN_PIPELINE_BATCH
+#define CHAN_PIPELINE_BATCH 64
+#endif
+
+//管线最多同时在途(未全部写入目标channel)的批次数
+#ifndef CHAN_PIPELINE_WINDOW
+#define CHAN_PIPELINE_WINDOW 4
+#endif
+
+/*!
+@brief 管线运行状态，除在途批次的回执外都只在源channel的strand中访问
+*/
+struct ChanPipeCtx_ : public std::enable_shared_from_this<ChanPipeCtx_>
+{
+	ChanPipeCtx_(const shared_strand& srcStrand)
+		:_srcStrand(srcStrand), _inflight(0), _waiting(false), _stopped(false), _closed(false), _finished(false) {}
+
+	/*!
+	@brief 一个批次已全部写入目标channel(或被过滤为空)，回到源strand继续读取
+	*/
+	static void ack(const std::shared_ptr<ChanPipeCtx_>& ctx, bool ok)
+	{
+		ctx->_srcStrand->post(std::bind([ok](std::shared_ptr<ChanPipeCtx_>& ctx)
+		{
+			assert(ctx->_inflight);
+			ctx->_inflight--;
+			if (!ok)
+			{
+				ctx->_closed = true;
+			}
+			if (ctx->_stopped || ctx->_closed)
+			{
+				ctx->check_finish();
+			}
+			else if (!ctx->_waiting)
+			{
+				ctx->_read();
+			}
+		}, ctx));
+	}
+
+	void check_finish()
+	{
+		assert(_srcStrand->running_in_this_thread());
+		if (!_finished && !_waiting && !_inflight && (_stopped || _closed))
+		{
+			_finished = true;
+			_read = std::function<void()>();
+			_remove = std::function<void()>();
+			std::function<void()> ntf;
+			ntf.swap(_stopNtf);
+			if (ntf)
+			{
+				CHECK_EXCEPTION(ntf);
+			}
+		}
+	}
+
+	shared_strand _srcStrand;
+	std::function<void()> _read;
+	std::function<void()> _remove;
+	std::function<void()> _stopNtf;
+	co_notify_sign _sign;
+	size_t _inflight;
+	bool _waiting;
+	bool _stopped;
+	bool _closed;
+	bool _finished;
+	NONE_COPY(ChanPipeCtx_);
+};
+
+struct ChanPipeIdentity_
+{
+	template <typename A, typename Emit>
+	void operator()(A&& a, Emit& emit)
+	{
+		emit(std::forward<A>(a));
+	}
+};
+
+template <typename F, typename G>
+struct ChanPipeMap_
+{
+	template <typename Emit>
+	struct emit_type
+	{
+		template <typename B>
+		void operator()(B&& b)
+		{
+			_emit(_g(std::forward<B>(b)));
+		}
+
+		Emit& _emit;
+		G& _g;
+	};
+
+	template <typename A, typename Emit>
+	void operator()(A&& a, Emit& emit)
+	{
+		emit_type<Emit> e = { emit, _g };
+		_f(std::forward<A>(a), e);
+	}
+
+	F _f;
+	G _g;
+};
+
+template <typename F, typename P>
+struct ChanPipeFilter_
+{
+	template <typename Emit>
+	struct emit_type
+	{
+		template <typename B>
+		void operator()(B&& b)
+		{
+			if (_p((const RM_CREF(B)&)b))
+			{
+				_emit(std::forward<B>(b));
+			}
+		}
+
+		Emit& _emit;
+		P& _p;
+	};
+
+	template <typename A, typename Emit>
+	void operator()(A&& a, Emit& emit)
+	{
+		emit_type<Emit> e = { emit, _p };
+		_f(std::forward<A>(a), e);
+	}
+
+	F _f;
+	P _p;
+};
+
+template <typename F, typename G, typename C>
+struct ChanPipeFlatMap_
+{
+	template <typename Emit>
+	struct emit_type
+	{
+		template <typename B>
+		void operator()(B&& b)
+		{
+			const size_t n = _buff.size();
+			_g(std::forward<B>(b), _buff);
+			for (size_t i = n; i < _buff.size(); i++)
+			{
+				_emit(std::move(_buff[i]));
+			}
+			_buff.erase(_buff.begin() + n, _buff.end());
+		}
+
+		Emit& _emit;
+		G& _g;
+		std::vector<C>& _buff;
+	};
+
+	template <typename A, typename Emit>
+	void operator()(A&& a, Emit& emit)
+	{
+		emit_type<Emit> e = { emit, _g, _buff };
+		_f(std::forward<A>(a), e);
+	}
+
+	F _f;
+	G _g;
+	std::vector<C> _buff;
+};
+
+template <typename Out>
+struct ChanPipeCollect_
+{
+	template <typename B>
+	void operator()(B&& b)
+	{
+		_out.push_back(std::forward<B>(b));
+	}
+
+	std::vector<Out>& _out;
+};
+
+template <typename T>
+struct ChanPipePop_
+{
+	template <typename Msg>
+	void operator()(co_async_state state, Msg&& msg)
+	{
+		_state = state;
+		_batch.push_back(std::forward<Msg>(msg));
+	}
+
+	void operator()(co_async_state state)
+	{
+		_state = state;
+	}
+
+	std::vector<T>& _batch;
+	co_async_state& _state;
+};
+
+/*!
+@brief 运行中的管线
+*/
+class chan_pipe_handle
+{
+public:
+	chan_pipe_handle() {}
+
+	chan_pipe_handle(const std::shared_ptr<ChanPipeCtx_>& ctx)
+		:_ctx(ctx) {}
+public:
+	/*!
+	@brief 停止从源channel读取，在途批次全部写入目标channel后回调ntf()(在源strand中)
+	*/
+	template <typename Notify>
+	void stop(Notify&& ntf)
+	{
+		assert(_ctx);
+		_ctx->_srcStrand->distribute(std::bind([](std::shared_ptr<ChanPipeCtx_>& ctx, RM_CREF(Notify)& ntf)
+		{
+			if (ctx->_finished)
+			{
+				CHECK_EXCEPTION(ntf);
+				return;
+			}
+			ctx->_stopped = true;
+			ctx->_stopNtf = std::move(ntf);
+			if (ctx->_waiting)
+			{
+				ctx->_remove();
+			}
+			else
+			{
+				ctx->check_finish();
+			}
+		}, _ctx, std::forward<Notify>(ntf)));
+	}
+
+	bool empty() const
+	{
+		return !_ctx;
+	}
+private:
+	std::shared_ptr<ChanPipeCtx_> _ctx;
+};
+
+template <typename In, typename Out, typename Fused>
+class chan_pipeline;
+
+template <typename T, typename Chan>
+chan_pipeline<T, T, ChanPipeIdentity_> make_chan_pipeline(Chan& src);
+
+/*!
+@brief channel管线，在两个channel之间串联map/filter/flat_map阶段；
+相邻的阶段在同一strand上融合为一次直接调用，没有中间channel；
+via(strand)切换到另一个strand继续后面的阶段，跨strand时整批(最多CHAN_PIPELINE_BATCH条)只投递一次；
+源channel读取受CHAN_PIPELINE_WINDOW个在途批次限制，目标channel写满时反压到源
+*/
+template <typename In, typename Out, typename Fused>
+class chan_pipeline
+{
+	template <typename, typename, typename>
+	friend class chan_pipeline;
+	template <typename T, typename Chan>
+	friend chan_pipeline<T, T, ChanPipeIdentity_> make_chan_pipeline(Chan& src);
+
+	typedef std::shared_ptr<ChanPipeCtx_> ctx_type;
+	typedef std::function<void(const ctx_type&, std::vector<In>&&)> in_sink;
+	typedef std::function<void(const ctx_type&, in_sink&&)> upstream_type;
+
+	chan_pipeline(const shared_strand& srcStrand, upstream_type&& upstream, Fused&& fused)
+		:_srcStrand(srcStrand), _upstream(std::move(upstream)), _fused(std::move(fused)) {}
+public:
+	/*!
+	@brief 一对一变换
+	*/
+	template <typename G, typename C = RM_CREF(decltype(std::declval<G&>()(std::declval<Out>())))>
+	chan_pipeline<In, C, ChanPipeMap_<Fused, RM_CREF(G)>> map(G&& g)
+	{
+		ChanPipeMap_<Fused, RM_CREF(G)> fused = { std::move(_fused), std::forward<G>(g) };
+		return chan_pipeline<In, C, ChanPipeMap_<Fused, RM_CREF(G)>>(_srcStrand, std::move(_upstream), std::move(fused));
+	}
+
+	/*!
+	@brief 过滤，p(const Out&)返回false的消息被丢弃
+	*/
+	template <typename P>
+	chan_pipeline<In, Out, ChanPipeFilter_<Fused, RM_CREF(P)>> filter(P&& p)
+	{
+		ChanPipeFilter_<Fused, RM_CREF(P)> fused = { std::move(_fused), std::forward<P>(p) };
+		return chan_pipeline<In, Out, ChanPipeFilter_<Fused, RM_CREF(P)>>(_srcStrand, std::move(_upstream), std::move(fused));
+	}
+
+	/*!
+	@brief 一对多变换，g(Out&&, std::vector<C>& out)把结果追加到out
+	*/
+	template <typename C, typename G>
+	chan_pipeline<In, C, ChanPipeFlatMap_<Fused, RM_CREF(G), C>> flat_map(G&& g)
+	{
+		ChanPipeFlatMap_<Fused, RM_CREF(G), C> fused = { std::move(_fused), std::forward<G>(g), std::vector<C>() };
+		return chan_pipeline<In, C, ChanPipeFlatMap_<Fused, RM_CREF(G), C>>(_srcStrand, std::move(_upstream), std::move(fused));
+	}
+
+	/*!
+	@brief 之后的阶段在strand中执行
+	*/
+	chan_pipeline<Out, Out, ChanPipeIdentity_> via(const shared_strand& strand)
+	{
+		upstream_type upstream = std::move(_upstream);
+		Fused fused = std::move(_fused);
+		typedef std::function<void(const ctx_type&, std::vector<Out>&&)> out_sink;
+		return chan_pipeline<Out, Out, ChanPipeIdentity_>(_srcStrand, [upstream, fused, strand](const ctx_type& ctx, out_sink&& sink)
+		{
+			upstream(ctx, [fused, strand, sink](const ctx_type& ctx, std::vector<In>&& batch) mutable
+			{
+				std::vector<Out> out;
+				out.reserve(batch.size());
+				ChanPipeCollect_<Out> collect = { out };
+				for (In& msg : batch)
+				{
+					fused(std::move(msg), collect);
+				}
+				if (out.empty())
+				{
+					ChanPipeCtx_::ack(ctx, true);
+				}
+				else if (strand->running_in_this_thread())
+				{
+					sink(ctx, std::move(out));
+				}
+				else
+				{
+					strand->post(std::bind([](out_sink& sink, ctx_type& ctx, std::vector<Out>& out)
+					{
+						sink(ctx, std::move(out));
+					}, sink, ctx, std::move(out)));
+				}
+			});
+		}, ChanPipeIdentity_());
+	}
+
+	/*!
+	@brief 把结果写入dst并开始运行，dst与源channel必须在stop完成前有效
+	*/
+	template <typename Chan>
+	chan_pipe_handle to(Chan& dst)
+	{
+		ctx_type ctx = std::make_shared<ChanPipeCtx_>(_srcStrand);
+		Fused fused = std::move(_fused);
+		shared_strand dstStrand = dst.self_strand();
+		_upstream(ctx, [fused, dstStrand, &dst](const ctx_type& ctx, std::vector<In>&& batch) mutable
+		{
+			std::vector<Out> out;
+			out.reserve(batch.size());
+			ChanPipeCollect_<Out> collect = { out };
+			for (In& msg : batch)
+			{
+				fused(std::move(msg), collect);
+			}
+			if (out.empty())
+			{
+				ChanPipeCtx_::ack(ctx, true);
+				return;
+			}
+			auto pushAll = [&dst](const ctx_type& ctx, std::vector<Out>& out)
+			{
+				//pair<剩余条数, 是否全部写入成功>
+				std::shared_ptr<std::pair<size_t, bool>> remain = std::make_shared<std::pair<size_t, bool>>(out.size(), true);
+				for (Out& msg : out)
+				{
+					dst.aff_push(wrap_bind_(std::bind([remain](co_async_state state, ctx_type& ctx)
+					{
+						if (co_async_state::co_async_ok != state)
+						{
+							remain->second = false;
+						}
+						if (0 == --remain->first)
+						{
+							ChanPipeCtx_::ack(ctx, remain->second);
+						}
+					}, __1, ctx)), std::move(msg));
+				}
+			};
+			if (dstStrand->running_in_this_thread())
+			{
+				pushAll(ctx, out);
+			}
+			else
+			{
+				dstStrand->post(std::bind(pushAll, ctx, std::move(out)));
+			}
+		});
+		_srcStrand->post(std::bind([](ctx_type& ctx)
+		{
+			if (ctx->_read)
+			{
+				ctx->_read();
+			}
+		}, ctx));
+		return chan_pipe_handle(ctx);
+	}
+private:
+	shared_strand _srcStrand;
+	upstream_type _upstream;
+	Fused _fused;
+};
+
+/*!
+@brief 以src为源创建管线，T为src的消息类型(单参数channel)
+*/
+template <typename T, typename Chan>
+chan_pipeline<T, T, ChanPipeIdentity_> make_chan_pipeline(Chan& src)
+{
+	typedef std::shared_ptr<ChanPipeCtx_> ctx_type;
+	typedef std::function<void(const ctx_type&, std::vector<T>&&)> in_sink;
+	return chan_pipeline<T, T, ChanPipeIdentity_>(src.self_strand(), [&src](const ctx_type& ctx, in_sink&& sink)
+	{
+		ChanPipeCtx_* const ctx_ = ctx.get();
+		ctx->_read = [&src, ctx_, sink]()
+		{
+			assert(ctx_->_srcStrand->running_in_this_thread());
+			while (!ctx_->_stopped && !ctx_->_closed && ctx_->_inflight < CHAN_PIPELINE_WINDOW)
+			{
+				std::vector<T> batch;
+				batch.reserve(CHAN_PIPELINE_BATCH);
+				co_async_state state = co_async_state::co_async_ok;
+				while (co_async_state::co_async_ok == state && batch.size() < CHAN_PIPELINE_BATCH)
+				{
+					src.aff_try_pop(ChanPipePop_<T>{batch, state});
+				}
+				if (!batch.empty())
+				{
+					ctx_->_inflight++;
+					sink(ctx_->shared_from_this(), std::move(batch));
+				}
+				if (co_async_state::co_async_closed == state)
+				{
+					ctx_->_closed = true;
+					ctx_->check_finish();
+					return;
+				}
+				if (co_async_state::co_async_ok != state)
+				{
+					//源已空，等待新消息
+					ctx_->_waiting = true;
+					src.append_pop_notify(wrap_bind_(std::bind([](co_async_state state, std::shared_ptr<ChanPipeCtx_>& ctx)
+					{
+						ctx->_waiting = false;
+						if (co_async_state::co_async_ok != state)
+						{
+							ctx->_closed = true;
+						}
+						if (ctx->_stopped || ctx->_closed)
+						{
+							ctx->check_finish();
+						}
+						else
+						{
+							ctx->_read();
+						}
+					}, __1, ctx_->shared_from_this())), ctx_->_sign);
+					return;
+				}
+			}
+		};
+		ctx->_remove = [&src, ctx_]()
+		{
+			src.remove_pop_notify(wrap_bind_(std::bind([](co_async_state, std::shared_ptr<ChanPipeCtx_>& ctx)
+			{
+				ctx->_waiting = false;
+				ctx->check_finish();
+			}, __1, ctx_->shared_from_this())), ctx_->_sign);
+		};
+	}, ChanPipeIdentity_());
+}
+
 #endif
\ No newline at end of file
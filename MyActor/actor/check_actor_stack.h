@@ -3,7 +3,7 @@
 
 #define kB	*1024
 
-//ҳС
+//页面大小
 #ifndef MEM_PAGE_SIZE
 #define MEM_PAGE_SIZE (4 kB)
 #endif
@@ -20,7 +20,7 @@
 #endif
 #endif
 
-//Ĭ϶ջ
+//默认堆栈
 #ifdef WIN32
 #	if (_DEBUG || DEBUG) && (_WIN32_WINNT >= 0x0502)
 #define DEFAULT_STACKSIZE	(256 kB - STACK_RESERVED_SPACE_SIZE)
@@ -35,7 +35,7 @@
 #	endif
 #endif
 
-//ջ
+//最大堆栈
 #define MAX_STACKSIZE	(1024 kB - STACK_RESERVED_SPACE_SIZE)
 
 #define TRY_SIZE(__s__) (0x80000000 | (__s__))
@@ -68,7 +68,7 @@
 #endif
 //////////////////////////////////////////////////////////////////////////
 
-//ջԤռ䣬ջ
+//堆栈底预留空间，检测堆栈溢出
 #if (_DEBUG || DEBUG)
 #	if (defined _WIN64) || (defined __x86_64__) || (defined _ARM64)
 #define STACK_RESERVED_SPACE_SIZE (24 kB)
@@ -83,7 +83,7 @@
 #	endif
 #endif
 
-//ջ״̬ռ
+//栈状态保留空间
 #define CORO_CONTEXT_STATE_SPACE (1 * MEM_PAGE_SIZE)
 
 #ifndef MEM_POOL_LENGTH
@@ -99,6 +99,12 @@
 #define CHECK_LOST_ALLOC_INDEX 6
 #define CHECK_PUMP_LOST_ALLOC_INDEX 7
 #define ASIO_HANDLER_ALLOC_EX_INDEX 8
+#define IO_SHARD_TLS_INDEX 9
+#define ACTOR_COLD_ALLOC_INDEX 10
+#define IO_ENGINE_TLS_INDEX 11
+#define TIME_COARSE_TLS_INDEX 12
+#define STACK_SAMPLE_TLS_INDEX 13
+#define ACTOR_PROFILE_TLS_INDEX 14
 
 static_assert(0 < MEM_PAGE_SIZE && MEM_PAGE_SIZE % (4 kB) == 0, "");
 static_assert(0 < MEM_POOL_LENGTH && MEM_POOL_LENGTH < 10000000, "");
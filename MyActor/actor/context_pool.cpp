@@ -5,7 +5,7 @@
 #include <fibersapi.h>
 #endif
 
-//С()
+//清理最小周期(秒)
 #ifndef CONTEXT_MIN_CLEAR_CYCLE
 #define CONTEXT_MIN_CLEAR_CYCLE 30
 #endif
@@ -16,6 +16,16 @@
 static_assert(1 < CONTEXT_MIN_CLEAR_CYCLE, "");
 static_assert(1 < CONTEXT_MIN_DELETE_CYCLE, "");
 
+//设置RSS预算后的检查周期(毫秒)
+#ifndef CONTEXT_BUDGET_CHECK_CYCLE
+#define CONTEXT_BUDGET_CHECK_CYCLE 100
+#endif
+
+//统计时每个尺寸的空闲栈驻留内存采样数
+#ifndef CONTEXT_RESIDENT_SAMPLE
+#define CONTEXT_RESIDENT_SAMPLE 4
+#endif
+
 void ContextPool_::coro_push_interface::yield()
 {
 	context_yield::push_yield(_coroInfo);
@@ -69,7 +79,9 @@ void ContextPool_::uninstall()
 }
 
 ContextPool_::ContextPool_()
-:_exitSign(false), _clearWait(false), _stackCount(0), _stackTotalSize(0)
+:_exitSign(false), _clearWait(false), _stackCount(0), _stackTotalSize(0), _rssBudget(0),
+_clearCycle(CONTEXT_MIN_CLEAR_CYCLE), _deleteCycle(CONTEXT_MIN_DELETE_CYCLE),
+_lazyDecommitCount(0), _budgetDecommitCount(0), _budgetDeleteCount(0)
 {
 	run_thread th([this] { cleanThread(); });
 	_clearThread.swap(th);
@@ -197,11 +209,93 @@ void ContextPool_::contextHandler(context_yield::context_info* info, void* param
 	}
 }
 
+void ContextPool_::set_rss_budget(size_t bytes)
+{
+	assert(_fiberPool);
+	std::lock_guard<std::mutex> lg(_fiberPool->_clearMutex);
+	_fiberPool->_rssBudget = bytes;
+	if (_fiberPool->_clearWait)
+	{
+		_fiberPool->_clearWait = false;
+		_fiberPool->_clearVar.notify_one();
+	}
+}
+
+void ContextPool_::set_clear_cycle(int clearSec, int deleteSec)
+{
+	assert(_fiberPool);
+	assert(1 < clearSec && 1 < deleteSec);
+	std::lock_guard<std::mutex> lg(_fiberPool->_clearMutex);
+	_fiberPool->_clearCycle = clearSec;
+	_fiberPool->_deleteCycle = deleteSec;
+	if (_fiberPool->_clearWait)
+	{
+		_fiberPool->_clearWait = false;
+		_fiberPool->_clearVar.notify_one();
+	}
+}
+
+ContextPool_::stack_stats ContextPool_::stats()
+{
+	assert(_fiberPool);
+	ContextPool_* const self = _fiberPool;
+	stack_stats res;
+	res.stackCount = self->_stackCount;
+	res.stackTotalSize = self->_stackTotalSize;
+	res.idleCount = 0;
+	res.decommitCount = 0;
+	res.idleResidentSize = 0;
+	res.rssBudget = self->_rssBudget;
+	res.lazyDecommitCount = self->_lazyDecommitCount;
+	res.budgetDecommitCount = self->_budgetDecommitCount;
+	res.budgetDeleteCount = self->_budgetDeleteCount;
+	//锁内只复制栈位置，mincore在锁外进行(采样期间栈可能被取走或解除映射，只影响估算精度)
+	std::vector<context_yield::context_info> samples;
+	std::vector<std::pair<size_t, size_t> > groups;//<空闲栈数, 采样数>
+	samples.reserve(256 * 2 * CONTEXT_RESIDENT_SAMPLE);
+	groups.reserve(256 * 2);
+	{
+		std::lock_guard<std::mutex> lg(*context_pool_pck::_mutex);
+		for (int i = 0; i < 256; i++)
+		{
+			res.idleCount += self->_contextPool[i]._pool.size();
+			res.decommitCount += self->_contextPool[i]._decommitPool.size();
+			for (int j = 0; j < 2; j++)
+			{
+				context_pool_pck::pool_queue& queue = j ? self->_contextPool[i]._decommitPool : self->_contextPool[i]._pool;
+				size_t sampleCount = 0;
+				for (auto it = queue.begin(); queue.end() != it && sampleCount < CONTEXT_RESIDENT_SAMPLE; ++it, sampleCount++)
+				{
+					samples.push_back(*(*it)->_coroInfo);
+				}
+				if (sampleCount)
+				{
+					groups.push_back(std::make_pair(queue.size(), sampleCount));
+				}
+			}
+		}
+	}
+	size_t k = 0;
+	for (auto& ele : groups)
+	{
+		size_t resident = 0;
+		for (size_t i = 0; i < ele.second; i++)
+		{
+			resident += context_yield::resident_size(&samples[k++]);
+		}
+		res.idleResidentSize += resident * ele.first / ele.second;
+	}
+	res.processResidentSize = context_yield::process_resident_size();
+	return res;
+}
+
 void ContextPool_::cleanThread()
 {
 	run_thread::set_current_thread_name("actor stack clean thread");
+	int clearTick = get_tick_s();
 	while (true)
 	{
+		size_t budget = _rssBudget;
 		{
 			std::unique_lock<std::mutex> ul(_clearMutex);
 			if (_exitSign)
@@ -209,63 +303,160 @@ void ContextPool_::cleanThread()
 				break;
 			}
 			_clearWait = true;
-			if (std::cv_status::no_timeout == _clearVar.wait_for(ul, std::chrono::seconds(CONTEXT_MIN_CLEAR_CYCLE)) || !_clearWait)
+			if (budget)
+			{
+				_clearVar.wait_for(ul, std::chrono::milliseconds(CONTEXT_BUDGET_CHECK_CYCLE));
+			}
+			else
+			{
+				_clearVar.wait_for(ul, std::chrono::seconds(_clearCycle));
+			}
+			_clearWait = false;
+			if (_exitSign)
+			{
+				break;
+			}
+		}
+		budget = _rssBudget;
+		if (budget)
+		{
+			reclaimBudget(budget);
+		}
+		if (!budget || get_tick_s() - clearTick >= _clearCycle)
+		{
+			clearTick = get_tick_s();
+			clearIdle();
+		}
+	}
+}
+
+void ContextPool_::clearIdle()
+{
+	size_t freeCount;
+	goto _checkFree;
+	do
+	{
+		{
+			std::unique_lock<std::mutex> ul(_clearMutex);
+			if (_exitSign)
 			{
 				break;
 			}
+			_clearWait = true;
+			_clearVar.wait_for(ul, std::chrono::milliseconds(1));
 			_clearWait = false;
+			if (_exitSign)
+			{
+				break;
+			}
 		}
-		size_t freeCount;
-		goto _checkFree;
-		do
+	_checkFree:;
+		freeCount = 0;
+		const int clearCycle = _clearCycle;
+		const int deleteCycle = _deleteCycle;
+		int extTick = get_tick_s();
+		for (int i = 255; i >= 0; i--)
 		{
+			context_pool_pck& contextPool = _contextPool[i];
+			contextPool._mutex->lock();
+			if (!contextPool._pool.empty() && extTick - contextPool._pool.front()->_tick >= clearCycle)
+			{
+				coro_pull_interface* const pull = contextPool._pool.front();
+				contextPool._pool.pop_front();
+				contextPool._mutex->unlock();
+				context_yield::decommit_context(pull->_coroInfo, true);
+				_lazyDecommitCount++;
+				contextPool._mutex->lock();
+				contextPool._decommitPool.push_front(pull);
+				contextPool._mutex->unlock();
+			}
+			else if (!contextPool._decommitPool.empty() && extTick - contextPool._decommitPool.front()->_tick >= deleteCycle)
 			{
-				std::unique_lock<std::mutex> ul(_clearMutex);
-				if (_exitSign)
+				coro_pull_interface* const pull = contextPool._decommitPool.front();
+				contextPool._decommitPool.pop_front();
+				contextPool._mutex->unlock();
+				context_yield::context_info* const info = pull->_coroInfo;
+				freeCount++;
+				_stackCount--;
+				_stackTotalSize -= info->stackSize + info->reserveSize;
+				context_yield::delete_context(info);
+				delete pull;
+			}
+			else
+			{
+				contextPool._mutex->unlock();
+			}
+		}
+	} while (freeCount);
+}
+
+void ContextPool_::reclaimBudget(size_t budget)
+{
+	size_t rss = context_yield::process_resident_size();
+	if (rss <= budget)
+	{
+		return;
+	}
+	size_t excess = rss - budget;
+	//先立即释放未释放物理页的空闲栈，再解除已释放(含惰性释放后尚未被内核回收)的空闲栈映射，每轮都取所有尺寸中最久未用的一个
+	for (int phase = 0; phase < 2 && !_exitSign; phase++)
+	{
+		while (!_exitSign)
+		{
+			coro_pull_interface* pull = NULL;
+			context_pool_pck* contextPool = NULL;
+			{
+				std::lock_guard<std::mutex> lg(*context_pool_pck::_mutex);
+				for (int i = 0; i < 256; i++)
 				{
-					break;
+					context_pool_pck::pool_queue& queue = phase ? _contextPool[i]._decommitPool : _contextPool[i]._pool;
+					if (!queue.empty() && (!pull || queue.front()->_tick - pull->_tick < 0))
+					{
+						pull = queue.front();
+						contextPool = &_contextPool[i];
+					}
 				}
-				_clearWait = true;
-				if (std::cv_status::no_timeout == _clearVar.wait_for(ul, std::chrono::milliseconds(1)) || !_clearWait)
+				if (!pull)
 				{
 					break;
 				}
-				_clearWait = false;
-			}
-		_checkFree:;
-			freeCount = 0;
-			int extTick = get_tick_s();
-			for (int i = 255; i >= 0; i--)
-			{
-				context_pool_pck& contextPool = _contextPool[i];
-				contextPool._mutex->lock();
-				if (!contextPool._pool.empty() && extTick - contextPool._pool.front()->_tick >= CONTEXT_MIN_CLEAR_CYCLE)
-				{
-					coro_pull_interface* const pull = contextPool._pool.front();
-					contextPool._pool.pop_front();
-					contextPool._mutex->unlock();
-					context_yield::decommit_context(pull->_coroInfo);
-					contextPool._mutex->lock();
-					contextPool._decommitPool.push_front(pull);
-					contextPool._mutex->unlock();
-				}
-				else if (!contextPool._decommitPool.empty() && extTick - contextPool._decommitPool.front()->_tick >= CONTEXT_MIN_DELETE_CYCLE)
+				if (phase)
 				{
-					coro_pull_interface* const pull = contextPool._decommitPool.front();
-					contextPool._decommitPool.pop_front();
-					contextPool._mutex->unlock();
-					context_yield::context_info* const info = pull->_coroInfo;
-					freeCount++;
-					_stackCount--;
-					_stackTotalSize -= info->stackSize + info->reserveSize;
-					context_yield::delete_context(info);
-					delete pull;
+					contextPool->_decommitPool.pop_front();
 				}
 				else
 				{
-					contextPool._mutex->unlock();
+					contextPool->_pool.pop_front();
 				}
 			}
-		} while (freeCount);
+			context_yield::context_info* const info = pull->_coroInfo;
+			const size_t resident = context_yield::resident_size(info);
+			if (!phase && !info->hugePage)
+			{
+				context_yield::decommit_context(info);
+				_budgetDecommitCount++;
+				std::lock_guard<std::mutex> lg(*context_pool_pck::_mutex);
+				contextPool->_decommitPool.push_front(pull);
+			}
+			else
+			{
+				_budgetDeleteCount++;
+				_stackCount--;
+				_stackTotalSize -= info->stackSize + info->reserveSize;
+				context_yield::delete_context(info);
+				delete pull;
+			}
+			if (resident < excess)
+			{
+				excess -= resident;
+				continue;
+			}
+			rss = context_yield::process_resident_size();
+			if (rss <= budget)
+			{
+				return;
+			}
+			excess = rss - budget;
+		}
 	}
 }
\ No newline at end of file
@@ -10,7 +10,7 @@
 #include "run_thread.h"
 
 /*!
-@brief context
+@brief context池
 */
 class ContextPool_
 {
@@ -53,6 +53,20 @@ private:
 		static std::mutex* _mutex;
 		static pool_queue::shared_node_alloc* _alloc;
 	};
+public:
+	struct stack_stats
+	{
+		size_t stackCount;///<栈总数
+		size_t stackTotalSize;///<栈占用的虚拟地址空间
+		size_t idleCount;///<池中未释放物理页的空闲栈数
+		size_t decommitCount;///<池中已释放(或惰性释放)物理页的空闲栈数
+		size_t idleResidentSize;///<空闲栈驻留的物理内存(mincore采样估算)
+		size_t processResidentSize;///<进程驻留物理内存(RSS)
+		size_t rssBudget;///<RSS预算，0表示不限制
+		size_t lazyDecommitCount;///<按空闲周期惰性释放(MADV_FREE)物理页的次数
+		size_t budgetDecommitCount;///<超出预算时立即释放物理页的栈数
+		size_t budgetDeleteCount;///<超出预算时解除映射的栈数
+	};
 public:
 	ContextPool_();
 	~ContextPool_();
@@ -61,9 +75,27 @@ public:
 	static void recovery(coro_pull_interface* coro);
 	static void install();
 	static void uninstall();
+
+	/*!
+	@brief 设置RSS预算(字节)，超出后清理线程按最久未用顺序立即释放空闲栈物理页，仍超出则解除空闲栈映射；0表示不限制；
+	大页中的空闲栈不能只释放物理页(会拆分大页)，超出预算时直接解除映射
+	*/
+	static void set_rss_budget(size_t bytes);
+
+	/*!
+	@brief 设置空闲栈惰性释放物理页、解除映射的空闲时长(秒)
+	*/
+	static void set_clear_cycle(int clearSec, int deleteSec);
+
+	/*!
+	@brief 栈池统计
+	*/
+	static stack_stats stats();
 private:
 	static void contextHandler(context_yield::context_info* info, void* param);
 	void cleanThread();
+	void clearIdle();
+	void reclaimBudget(size_t budget);
 private:
 	volatile bool _exitSign;
 	volatile bool _clearWait;
@@ -73,6 +105,12 @@ private:
 	std::atomic<int> _stackCount;
 	std::condition_variable _clearVar;
 	std::atomic<size_t> _stackTotalSize;
+	std::atomic<size_t> _rssBudget;
+	std::atomic<int> _clearCycle;
+	std::atomic<int> _deleteCycle;
+	std::atomic<size_t> _lazyDecommitCount;
+	std::atomic<size_t> _budgetDecommitCount;
+	std::atomic<size_t> _budgetDeleteCount;
 	static ContextPool_* _fiberPool;
 };
 
@@ -7,8 +7,15 @@
 #ifdef __GNUG__
 #include <fibersapi.h>
 #endif
+#include <Psapi.h>
+#pragma comment(lib, "Psapi.lib")
 #elif __linux__
 #include <sys/mman.h>
+#include <stdio.h>
+#include <unistd.h>
+#ifdef ENABLE_HUGE_PAGE
+#include "huge_page.h"
+#endif
 #endif
 
 namespace context_yield
@@ -122,11 +129,43 @@ namespace context_yield
 		delete info;
 	}
 
-	void decommit_context(context_yield::context_info* info)
+	void decommit_context(context_yield::context_info* info, bool lazy)
 	{
 		adjust_stack(info);
 	}
 
+	size_t resident_size(const context_yield::context_info* info)
+	{
+		char* const stackTop = (char*)info->stackTop;
+		char* p = stackTop - info->stackSize - info->reserveSize;
+		size_t committed = 0;
+		while (p < stackTop)
+		{
+			MEMORY_BASIC_INFORMATION mbi;
+			if (!VirtualQuery(p, &mbi, sizeof(mbi)))
+			{
+				break;
+			}
+			char* const end = std::min((char*)mbi.BaseAddress + mbi.RegionSize, stackTop);
+			if (MEM_COMMIT == mbi.State)
+			{
+				committed += end - p;
+			}
+			p = end;
+		}
+		return committed;
+	}
+
+	size_t process_resident_size()
+	{
+		PROCESS_MEMORY_COUNTERS pmc;
+		if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		{
+			return pmc.WorkingSetSize;
+		}
+		return 0;
+	}
+
 #elif __linux__
 
 struct transfer_t
@@ -152,17 +191,28 @@ struct transfer_t
 	context_yield::context_info* make_context(size_t stackSize, context_yield::context_handler handler, void* p)
 	{
 		size_t allocSize = MEM_ALIGN(stackSize + STACK_RESERVED_SPACE_SIZE, STACK_BLOCK_SIZE);
-		void* stack = mmap(0, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);//ڴ㹻¿ʧܣ /proc/sys/vm/max_map_count
+		void* stack = NULL;
+		bool hugePage = false;
+#ifdef ENABLE_HUGE_PAGE
+		//从大页中分配，allocSize向上取整到大页尺寸，多出的部分并入reserveSize；失败后用4K页
+		stack = huge_page::stack_alloc(allocSize);
+		hugePage = NULL != stack;
 		if (!stack)
+#endif
 		{
-			return NULL;
+			stack = mmap(0, allocSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);//内存足够下可能失败，调整 /proc/sys/vm/max_map_count
+			if (MAP_FAILED == stack)
+			{
+				return NULL;
+			}
+			bool ok = 0 == mprotect(stack, MEM_PAGE_SIZE, PROT_NONE);//设置哨兵，可能失败，调整 /proc/sys/vm/max_map_count
+			assert(ok);
 		}
 		context_yield::context_info* info = new context_yield::context_info;
 		info->stackTop = (char*)stack + allocSize;
 		info->stackSize = stackSize;
 		info->reserveSize = allocSize - info->stackSize;
-		bool ok = 0 == mprotect(stack, MEM_PAGE_SIZE, PROT_NONE);//ڱʧܣ /proc/sys/vm/max_map_count
-		assert(ok);
+		info->hugePage = hugePage;
 		struct local_ref
 		{
 			context_yield::context_handler handler;
@@ -211,14 +261,76 @@ struct transfer_t
 	void delete_context(context_yield::context_info* info)
 	{
 		const size_t s = info->stackSize + info->reserveSize;
+#ifdef ENABLE_HUGE_PAGE
+		if (info->hugePage)
+		{
+			huge_page::stack_free((char*)info->stackTop - s, s);
+			delete info;
+			return;
+		}
+#endif
 		munmap((char*)info->stackTop - s, s);
 		delete info;
 	}
 
-	void decommit_context(context_yield::context_info* info)
+	void decommit_context(context_yield::context_info* info, bool lazy)
+	{
+		if (info->hugePage)
+		{
+			return;//在大页中释放部分物理页会拆分大页，大页栈空闲时不释放物理内存
+		}
+		const size_t s = info->stackSize + info->reserveSize;
+		char* const sb = (char*)info->stackTop - (s - MEM_PAGE_SIZE);
+#ifdef MADV_FREE
+		//MADV_FREE只在内存紧张时才由内核回收，复用前未被回收的页不会重新缺页清零
+		static volatile bool s_lazyFree = true;
+		if (lazy && s_lazyFree)
+		{
+			if (0 == madvise(sb, s - 2 * MEM_PAGE_SIZE, MADV_FREE))
+			{
+				return;
+			}
+			s_lazyFree = false;//内核不支持(4.5以下)
+		}
+#endif
+		madvise(sb, s - 2 * MEM_PAGE_SIZE, MADV_DONTNEED);
+	}
+
+	size_t resident_size(const context_yield::context_info* info)
 	{
 		const size_t s = info->stackSize + info->reserveSize;
-		madvise((char*)info->stackTop - (s - MEM_PAGE_SIZE), s - 2 * MEM_PAGE_SIZE, MADV_DONTNEED);
+		char* const sb = (char*)info->stackTop - s;
+		unsigned char vec[256];
+		size_t resident = 0;
+		for (size_t offset = 0; offset < s; offset += sizeof(vec) * MEM_PAGE_SIZE)
+		{
+			const size_t pages = std::min(sizeof(vec), (s - offset) / MEM_PAGE_SIZE);
+			if (0 != mincore(sb + offset, pages * MEM_PAGE_SIZE, vec))
+			{
+				break;
+			}
+			for (size_t i = 0; i < pages; i++)
+			{
+				resident += vec[i] & 1;
+			}
+		}
+		return resident * MEM_PAGE_SIZE;
+	}
+
+	size_t process_resident_size()
+	{
+		size_t resident = 0;
+		FILE* fp = fopen("/proc/self/statm", "r");
+		if (fp)
+		{
+			unsigned long long size = 0, rss = 0;
+			if (2 == fscanf(fp, "%llu %llu", &size, &rss))
+			{
+				resident = (size_t)rss * (size_t)sysconf(_SC_PAGESIZE);
+			}
+			fclose(fp);
+		}
+		return resident;
 	}
 #endif
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ namespace context_yield
 		void* nc = 0;
 		size_t stackSize = 0;
 		size_t reserveSize = 0;
+		bool hugePage = false;//大页中的栈，decommit_context对它不做任何事
 	};
 
 	bool is_thread_a_fiber();
@@ -21,7 +22,9 @@ namespace context_yield
 	void push_yield(context_info* info);
 	void pull_yield(context_info* info);
 	void delete_context(context_info* info);
-	void decommit_context(context_info* info);
+	void decommit_context(context_info* info, bool lazy = false);
+	size_t resident_size(const context_info* info);
+	size_t process_resident_size();
 }
 
 #endif
@@ -5,11 +5,11 @@
 #include "actor_timer.h"
 #include "async_timer.h"
 
-//generatorڣȡǰgenerator
+//在generator函数体内，获取当前generator对象
 #define co_self __coSelf
-//Ϊgenerator׸
+//作为generator函数体首个参数
 #define co_generator generator& co_self
-//generatorĳʼ(co_end_context_init)õǰⲿ
+//在generator上下文初始化中(co_end_context_init)，设置当前不捕获外部变量
 #define co_context_no_capture __noContextCapture
 struct __co_context_no_capture{};
 
@@ -28,7 +28,7 @@ struct __co_context_no_capture{};
 
 #define _co_counter (__COUNTER__ - __coBeginCount)
 
-//ʼgenerator
+//开始定义generator函数体上下文
 #define co_begin_context \
 	enum { __coBeginCount = __COUNTER__+2 };\
 	static_assert(__COUNTER__+1 == __COUNTER__, ""); __co_context_no_capture const co_context_no_capture = __co_context_no_capture();\
@@ -93,7 +93,7 @@ struct __co_context_no_capture{};
 	assert((void*)-1==(void*)co_self.__ctx);\
 	co_self.__ctx = NULL;}
 
-//generatorĶ
+//结束generator函数体上下文定义
 #define co_end_context(__ctx__) };\
 	if (!co_self.__ctx){co_self.__ctx = -1==co_self.__coNext ? (void*)-1 : new co_context_tag();\
 	_co_end_context(__ctx__); _co_stop(); if(0){
@@ -112,16 +112,16 @@ struct __co_context_no_capture{};
 #define _co_capture10(p1,p2,p3,p4,p5,p6,p7,p8,p9,p10) co_context_tag(_cop(p1),_cop(p2),_cop(p3),_cop(p4),_cop(p5),_cop(p6),_cop(p7),_cop(p8),_cop(p9),_cop(p10))
 #define _co_capture(...) _BOND_LR__(_co_capture, MPL_ARGS_SIZE(__VA_ARGS__))(__VA_ARGS__)
 
-//generatorĶ壬ڲʼ
+//结束generator函数体上下文定义，带内部变量初始化
 #define co_end_context_init(__ctx__, __capture__, ...) _co_capture __capture__:__VA_ARGS__{}};\
 	if (!co_self.__ctx){co_self.__ctx = -1==co_self.__coNext ? (void*)-1 : new co_context_tag __capture__;\
 	_co_end_context(__ctx__); _co_stop(); if(0){
 
-//generatorʱ״̬Բ
+//在generator结束时，做最后状态清理，可以不用
 #define co_context_destroy ~co_context_tag()
-//û״̬Ϣ
+//没有上下文状态信息
 #define co_no_context co_begin_context}; _co_end_no_context
-//û״̬co_ref_xxΪز
+//没有上下文状态，引用co_ref_xx为隐藏参数
 #define co_end_ref_context(...) } __coContext = {__VA_ARGS__}; _co_end_no_context
 
 #define co_ref_state co_async_state& __coState
@@ -148,13 +148,13 @@ struct __co_context_no_capture{};
 
 #define co_check_stop do{if(-1==co_self.__coNext) co_stop;}while(0)
 
-//ʼgeneratorĴ
+//开始generator的代码区域
 #define co_begin }\
 	if (!co_self.__coNext) {co_self.__coNext = (_co_counter+1)/2;}else co_check_stop;\
 	__coNext=co_self.__coNext; co_self.__coNext=0;\
 	switch(co_self.__coNextEx ? co_self.__coNextEx : __coNext) { case _co_counter/2:;
 
-//generatorĴ
+//结束generator的代码区域
 #define co_end break;default:assert(false);} co_stop;
 
 #define _co_yield do{\
@@ -166,21 +166,21 @@ struct __co_context_no_capture{};
 	return; case _co_counter/2:;\
 	}while (0)
 
-//generatoryieldԭ
+//generator的yield原语
 #define co_yield \
 	assert(co_self.__inside);\
 	_co_for(__forYieldSwitch = false;;__forYieldSwitch = true)\
 	if (__forYieldSwitch) {_co_yield; _co_for_break;}\
 	else
 
-//첽ص
+//不带参数的异步回调方法
 #define co_async CoAsync_(std::move(co_async_this))
-//Ŀɹ첽ص
+//不带参数的可共享异步回调方法
 #define co_shared_async CoShardAsync_(co_shared_this, co_async_sign)
-//Ĳ߳жϵ첽ص
+//不带参数的不加线程判断的异步回调方法
 #define co_anext CoAnext_(std::move(co_shared_this))
 
-//첽ص
+//带参数的异步回调方法
 #define co_async_result(...) _co_async_result(std::move(co_async_this), __VA_ARGS__)
 #define co_asio_result(...) _co_asio_result(std::move(co_async_this), __VA_ARGS__)
 #define co_anext_result(...) _co_anext_result(std::move(co_shared_this), __VA_ARGS__)
@@ -190,36 +190,36 @@ struct __co_context_no_capture{};
 #define co_anext_safe_result(...) _co_anext_safe_result(std::move(co_shared_this), __VA_ARGS__)
 #define co_async_safe_result_(...) _co_async_same_safe_result(std::move(co_async_this), __VA_ARGS__)
 #define co_anext_safe_result_(...) _co_anext_same_safe_result(std::move(co_shared_this), __VA_ARGS__)
-//Ŀɹ첽ص
+//带参数的可共享异步回调方法
 #define co_shared_async_result(...) _co_shared_async_result(co_shared_this, co_async_sign, __VA_ARGS__)
 #define co_shared_async_result_(...) _co_shared_async_same_result(co_shared_this, co_async_sign, __VA_ARGS__)
 #define co_shared_async_safe_result(...) _co_shared_async_safe_result(co_shared_this, co_async_sign, __VA_ARGS__)
 #define co_shared_async_safe_result_(...) _co_shared_async_same_safe_result(co_shared_this, co_async_sign, __VA_ARGS__)
-//һ
+//忽略一个参数
 #define co_ignore (generator::__anyAccept)
-//첽
+//忽略所有异步参数
 #define co_async_ignore CoAsyncIgnoreResult_(std::move(co_async_this))
 #define co_shared_async_ignore CoShardAsyncIgnoreResult_(co_shared_this, co_async_sign)
 #define co_anext_ignore CoAnextIgnoreResult_(std::move(co_shared_this))
 #define co_asio_ignore CoAsioIgnoreResult_(std::move(co_async_this))
 
-//generatorȴ´δ
+//挂起generator，等待调度器下次触发
 #define co_tick do{\
 	assert(co_self.__inside);\
 	co_strand->next_tick(std::bind([](generator_handle& host){\
 	if(!host->__ctx)return; host->_revert_this(host)->_next(); }, std::move(co_shared_this))); _co_yield;}while (0)
 
-//generatorȴ´IO󴥷
+//挂起generator，等待调度器下次IO后触发
 #define co_io_tick do{\
 	assert(co_self.__inside);\
 	co_strand->post(std::bind([](generator_handle& host){\
 	if(!host->__ctx)return; host->_revert_this(host)->_next(); }, std::move(co_shared_this))); _co_yield;}while (0)
 
-//ϴ첽ûзлûолһ
+//检测上次异步操作有没有发生切换，没有就切换一次
 #define co_try_tick do{if(!co_last_yield){co_tick;}}while (0)
 #define co_try_io_tick do{if(!co_last_yield){co_io_tick;}}while (0)
 
-//ϴ첽ûзл
+//检测上次异步操作有没有发生切换
 #define co_last_yield ((const bool&)co_self.__yieldSign)
 
 #define _co_await do{\
@@ -244,7 +244,7 @@ struct __co_context_no_capture{};
 	_co_await; co_cancel_timer(co_timer);\
 	}while (0)
 
-//generator awaitԭco_async֮ʹ
+//generator await原语，与co_async之类使用
 #define co_await \
 	assert(co_self.__inside);\
 	_co_for(__forYieldSwitch = false;;__forYieldSwitch = true)\
@@ -295,7 +295,7 @@ struct __co_context_no_capture{};
 	__host__->_co_shared_async_next(__sign__);\
 	}while (0)
 
-//ݹһgeneratorֱִϺһ
+//递归调用另一个generator，直到执行完毕后接着下一行
 #define co_call_of \
 	assert(co_self.__inside);\
 	co_check_stop;\
@@ -306,7 +306,7 @@ struct __co_context_no_capture{};
 
 #define co_call(...) co_call_of co_bind(__VA_ARGS__)
 
-//ָstrandУݹһgeneratorֱִϺһ
+//在指定strand中，递归调用另一个generator，直到执行完毕后接着下一行
 #define co_st_call_of(__strand__) \
 	assert(co_self.__inside);\
 	co_check_stop; co_lock_stop;\
@@ -316,7 +316,7 @@ struct __co_context_no_capture{};
 
 #define co_st_call(__strand__, ...) co_st_call_of(__strand__) co_bind(__VA_ARGS__)
 
-//жstrandԣco_call_ofco_st_call_of
+//判断strand属性，决定是用co_call_of还是co_st_call_of
 #define co_best_call_of(__strand__) \
 	assert(co_self.__inside);\
 	co_check_stop;\
@@ -328,16 +328,16 @@ struct __co_context_no_capture{};
 
 #define co_best_call(__strand__, ...) co_best_call_of(__strand__) co_bind(__VA_ARGS__)
 
-//һʱ
+//启动一个临时作用域
 #define co_scope co_call_of [&](co_generator)->void
 
-//sleepȴ
+//sleep等待
 #define co_sleep(__ms__) do{co_self._co_sleep(__ms__); _co_yield;}while (0)
 #define co_usleep(__us__) do{co_self._co_usleep(__us__); _co_yield;}while (0)
 #define co_sleep_(__ms__) do{co_timeout(__ms__, co_timer, co_anext); _co_yield;}while (0)
 #define co_usleep_(__us__) do{co_utimeout(__us__, co_timer, co_anext); _co_yield;}while (0)
 
-//첽ʱ
+//各种异步延时
 #define co_dead_sleep(__ms__) do{co_self._co_dead_sleep(__ms__); _co_yield;}while (0)
 #define co_dead_usleep(__us__) do{co_self._co_dead_usleep(__us__); _co_yield;}while (0)
 #define co_timeout_of(__ms__, __th__) CoTimeout_(__ms__, co_over_timer, __th__)-
@@ -350,53 +350,53 @@ struct __co_context_no_capture{};
 #define co_deadline co_over_timer->deadline
 #define co_interval co_over_timer->interval
 #define co_uinterval co_over_timer->uinterval
-//ȡʱ
+//取消延时
 #define co_cancel_timer co_over_timer->cancel
-//ǰʱ
+//提前触发延时
 #define co_advance_timer co_over_timer->advance
-//¿ʼʱ
+//重新开始计时
 #define co_restart_timer co_over_timer->restart
-//ǰoverlap_timerʱ
+//当前overlap_timer定时器
 #define co_over_timer co_strand->over_timer()
 
-//һgenerator
+//创建一个generator，立即运行
 #define co_go(...) CoGo_(__VA_ARGS__)-
-//һgenerator
+//创建一个generator，但不立即运行
 #define co_create(...) CoCreate_(__VA_ARGS__)-
-//ǰgenerator
+//结束当前generator的运行
 #define co_stop do{__stop(); return;} while(0)
-//ⲿgeneratorstop
+//锁定外部generator的stop操作
 #define co_lock_stop do{\
 	assert(co_self.__inside);\
 	co_check_stop;\
 	assert(co_self.__lockStop<255);\
 	co_self.__lockStop++;\
 	}while (0)
-//ⲿgeneratorstop
+//解锁外部generator的stop操作
 #define co_unlock_stop do{\
 	assert(co_self.__inside);\
 	assert(co_self.__lockStop);\
 	assert(-1!=co_self.__coNext);\
 	if (0==--co_self.__lockStop && co_self.__readyQuit) co_stop;\
 	}while (0)
-//ǰgenerator
+//当前generator调度器
 #define co_strand co_self.self_strand()
 #define co_ios co_strand->get_io_engine()
-//߻صʱco_yieldʹãߵʱco_async_signco_awaitʹ
+//单线回调时与co_yield配合使用，多线调度时与co_async_sign，co_await配合使用
 #define co_shared_this co_self.shared_this()
-//co_awaitصʱʹ
+//与co_await回调时配合使用
 #define co_async_this co_self.async_this()
-//߻صʱʹñǣco_shared_this
+//多线回调时使用标记，与co_shared_this配合
 #define co_async_sign co_self.shared_async_sign()
 
-//һһstrandִУִɺһ
+//发送一个任务到另一个strand中执行，执行完成后接着下一行
 #define co_begin_send(__strand__) {if (co_self._co_send(__strand__, [&]{
 #define co_end_send }))_co_yield;}
-//һһstrandִУִɺһ
+//发送一个任务到另一个strand中执行，执行完成后接着下一行
 #define co_begin_async_send(__strand__) {co_self._co_async_send(__strand__, [&]{
 #define co_end_async_send });_co_yield;}
 
-//ṩúʵֶ̬caseswitchЧ
+//提供该宏间接实现动态case的switch效果
 #define co_begin_switch(__val__) for(__coSwitchPreSign=false,__coSwitchDefaultSign=false,__coSwitchFirstLoopSign=true,__coSwitchTempVal=(size_t)(__val__);\
 	__coSwitchFirstLoopSign || (!__coSwitchPreSign && __coSwitchDefaultSign);__coSwitchFirstLoopSign=false){if(0){
 #define co_switch_case_(__val__) __coSwitchPreSign=true;}if (__coSwitchPreSign || __coSwitchTempVal==(size_t)(__val__)){
@@ -405,7 +405,7 @@ struct __co_context_no_capture{};
 #define co_end_switch __coSwitchPreSign=true;}}
 
 #define _switch_mark (((unsigned long long)1) << 32)
-//generator޷reenterswitch-caseڣ滻ԭswitchؼʵgeneratorswitch-caseܣ֧Ƕ
+//generator无法reenter到switch-case内，替换原有switch关键字实现generator内switch-case功能，不支持嵌套
 #define co_switch(__exp__) \
 	_co_for(assert(co_self.__inside && !co_self.__coNextEx),\
 		co_self.__coNextEx=(_co_counter+1)/2, __coSwitchSign=true, __forYieldSwitch=false;;__forYieldSwitch=true)\
@@ -419,7 +419,7 @@ struct __co_context_no_capture{};
 
 #define co_default() default:;
 
-//pushݵchannel/msg_buffer
+//push数据到channel/msg_buffer
 #define co_chan_push(__chan__, ...) do{(__chan__).push(co_async_result(co_last_state), __VA_ARGS__); _co_await;}while (0)
 #define co_chan_copy_push(__chan__, ...) do{(__chan__).push(co_async_result(co_last_state), forward_copys(__VA_ARGS__)); _co_await;}while (0)
 #define co_chan_push_void(__chan__) do{(__chan__).push(co_async_result(co_last_state)); _co_await;}while (0)
@@ -456,7 +456,7 @@ struct __co_context_no_capture{};
 #define co_csp_timed_tick_push(__chan__, __ms__, __res__, ...) do{(__chan__).timed_tick_push(co_timer, __ms__, co_async_result_(co_last_state, __res__), __VA_ARGS__); _co_await;}while (0)
 #define co_csp_timed_copy_tick_push(__chan__, __ms__, __res__, ...) do{(__chan__).timed_tick_push(co_timer, __ms__, co_async_result_(co_last_state, __res__), forward_copys(__VA_ARGS__)); _co_await;}while (0)
 #define co_csp_timed_tick_push_void(__chan__, __ms__, __res__) do{(__chan__).timed_tick_push(co_timer, __ms__, co_async_result_(co_last_state, __res__)); _co_await;}while (0)
-//pushݵͬһstrandchannel/msg_buffer
+//push数据到依赖同一个strand的channel/msg_buffer
 #define co_chan_aff_push(__chan__, ...) do{(__chan__).aff_push(co_async_result(co_last_state), __VA_ARGS__); _co_await;}while (0)
 #define co_chan_aff_copy_push(__chan__, ...) do{(__chan__).aff_push(co_async_result(co_last_state), forward_copys(__VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_push_void(__chan__) do{(__chan__).aff_push(co_async_result(co_last_state)); _co_await;}while (0)
@@ -475,7 +475,7 @@ struct __co_context_no_capture{};
 #define co_csp_aff_timed_push(__chan__, __ms__, __res__, ...) do{(__chan__).aff_timed_push(co_timer, __ms__, co_async_result_(co_last_state, __res__), __VA_ARGS__); _co_await;}while (0)
 #define co_csp_aff_timed_copy_push(__chan__, __ms__, __res__, ...) do{(__chan__).aff_timed_push(co_timer, __ms__, co_async_result_(co_last_state, __res__), forward_copys(__VA_ARGS__)); _co_await;}while (0)
 #define co_csp_aff_timed_push_void(__chan__, __ms__, __res__) do{(__chan__).aff_timed_push(co_timer, __ms__, co_async_result_(co_last_state, __res__)); _co_await;}while (0)
-//channel/msg_bufferжȡ
+//从channel/msg_buffer中读取数据
 #define co_chan_pop(__chan__, ...) do{(__chan__).pop(co_async_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_safe_pop(__chan__, ...) do{(__chan__).pop(co_async_safe_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_pop_void(__chan__) do{(__chan__).pop(co_async_result_(co_last_state)); _co_await;}while (0)
@@ -494,7 +494,7 @@ struct __co_context_no_capture{};
 #define co_chan_timed_tick_pop(__chan__, __ms__, ...) do{(__chan__).timed_tick_pop(co_timer, __ms__, co_async_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_timed_safe_tick_pop(__chan__, __ms__, ...) do{(__chan__).timed_tick_pop(co_timer, __ms__, co_anext_safe_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_timed_tick_pop_void(__chan__, __ms__) do{(__chan__).timed_tick_pop(co_timer, __ms__, co_async_result_(co_last_state)); _co_await;}while (0)
-//ͬһstrandchannel/msg_bufferжȡ
+//从依赖同一个strand的channel/msg_buffer中读取数据
 #define co_chan_aff_pop(__chan__, ...) do{(__chan__).aff_pop(co_async_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_safe_pop(__chan__, ...) do{(__chan__).aff_pop(co_async_safe_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_pop_void(__chan__) do{(__chan__).aff_pop(co_async_result_(co_last_state)); _co_await;}while (0)
@@ -504,17 +504,17 @@ struct __co_context_no_capture{};
 #define co_chan_aff_timed_pop(__chan__, __ms__, ...) do{(__chan__).aff_timed_pop(co_timer, __ms__, co_async_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_timed_safe_pop(__chan__, __ms__, ...) do{(__chan__).aff_timed_pop(co_timer, __ms__, co_async_safe_result_(co_last_state, __VA_ARGS__)); _co_await;}while (0)
 #define co_chan_aff_timed_pop_void(__chan__, __ms__) do{(__chan__).aff_timed_pop(co_timer, __ms__, co_async_result_(co_last_state)); _co_await;}while (0)
-//һchannelжȡһתӵһchannel
+//从一个channel中读取一次数据转接到另一个channel中
 #define co_chan_relay(__src_chan__, __dst_chan__) do{(__src_chan__).pop(CoChanRelay_<decltype(__dst_chan__)>(std::move(co_async_this), co_last_state, __dst_chan__)); _co_await;}while (0)
 #define co_chan_try_relay(__src_chan__, __dst_chan__) do{(__src_chan__).try_pop(CoChanTryRelay_<decltype(__dst_chan__)>(std::move(co_async_this), co_last_state, __dst_chan__)); _co_await;}while (0)
 #define co_chan_tick_relay(__src_chan__, __dst_chan__) do{(__src_chan__).tick_pop(CoChanRelay_<decltype(__dst_chan__)>(std::move(co_async_this), co_last_state, __dst_chan__)); _co_await;}while (0)
 #define co_chan_try_tick_relay(__src_chan__, __dst_chan__) do{(__src_chan__).try_tick_pop(CoChanTryRelay_<decltype(__dst_chan__)>(std::move(co_async_this), co_last_state, __dst_chan__)); _co_await;}while (0)
-//رchannel/msg_buffer
+//关闭channel/msg_buffer
 #define co_chan_close(__chan__) do{(__chan__).close(co_async); _co_await;}while (0)
-//co_chan_io/co_chan_try_ioдʱ
+//co_chan_io/co_chan_try_io多参数读写时打包
 #define co_chan_multi(...) _co_chan_multi(__VA_ARGS__)
 #define co_chan_copy_multi(...)  _co_chan_multi(forward_copys(__VA_ARGS__))
-//push/popݵchannel/msg_buffer
+//push/pop数据到channel/msg_buffer
 #define co_chan_io(__chan__) co_await _make_co_chan_io(__chan__, co_last_state, co_self)
 #define co_chan_try_io(__chan__) co_await _make_co_chan_try_io(__chan__, co_last_state, co_self)
 #define co_chan_timed_io(__chan__, __ms__) co_await _make_co_chan_timed_io(__ms__, __chan__, co_last_state, co_self, co_timer)
@@ -530,6 +530,11 @@ struct __co_context_no_capture{};
 #define co_csp_wait_void(__chan__, __res__) co_csp_io(__chan__, __res__) >> void_type()
 #define co_csp_try_wait_void(__chan__, __res__) co_csp_try_io(__chan__, __res__) >> void_type()
 #define co_csp_timed_wait_void(__chan__, __ms__, __res__) co_csp_timed_io(__chan__, __ms__, __res__) >> void_type()
+//流水线调用，窗口满时等待，发出后立即返回，之后用co_csp_future_wait取回结果
+#define co_csp_window_send(__win__, __fut__, __chan__, ...) do{(__win__).acquire(co_async_result(co_last_state)); _co_await; if (co_last_state_is_ok) (__win__).push(__fut__, __chan__, __VA_ARGS__);}while (0)
+#define co_csp_window_send_void(__win__, __fut__, __chan__) do{(__win__).acquire(co_async_result(co_last_state)); _co_await; if (co_last_state_is_ok) (__win__).push(__fut__, __chan__);}while (0)
+#define co_csp_future_wait(__fut__, __res__) do{(__fut__).wait(co_async_result_(co_last_state, __res__)); _co_await;}while (0)
+#define co_csp_future_wait_void(__fut__) do{(__fut__).wait(co_async_result(co_last_state)); _co_await;}while (0)
 #define co_chan_tick_io(__chan__) co_await _make_co_chan_tick_io(__chan__, co_last_state, co_self)
 #define co_chan_try_tick_io(__chan__) co_await _make_co_chan_try_tick_io(__chan__, co_last_state, co_self)
 #define co_chan_timed_tick_io(__chan__, __ms__) co_await _make_co_chan_timed_tick_io(__ms__, __chan__, co_last_state, co_self, co_timer)
@@ -545,7 +550,7 @@ struct __co_context_no_capture{};
 #define co_csp_tick_wait_void(__chan__, __res__) co_csp_tick_io(__chan__, __res__) >> void_type()
 #define co_csp_try_tick_wait_void(__chan__, __res__) co_csp_try_tick_io(__chan__, __res__) >> void_type()
 #define co_csp_timed_tick_wait_void(__chan__, __ms__, __res__) co_csp_timed_tick_io(__chan__, __ms__, __res__) >> void_type()
-//push/popݵͬһstrandchannel/msg_buffer
+//push/pop数据到依赖同一个strand的channel/msg_buffer
 #define co_chan_aff_io(__chan__) co_await _make_co_chan_aff_io(__chan__, co_last_state, co_self)
 #define co_chan_aff_try_io(__chan__) co_await _make_co_chan_aff_try_io(__chan__, co_last_state, co_self)
 #define co_chan_aff_timed_io(__chan__, __ms__) co_await _make_co_chan_aff_timed_io(__ms__, __chan__, co_last_state, co_self, co_timer)
@@ -565,7 +570,7 @@ struct __co_context_no_capture{};
 #define co_use_timer overlap_timer::timer_handle __coTimerHandle
 #define co_timer (__coContext.__coTimerHandle)
 
-//һ첽״̬
+//上一次异步结果状态
 #define co_last_state (__coContext.__coState)
 #define co_last_state_is_ok (co_async_state::co_async_ok == co_last_state)
 #define co_last_state_is_fail (co_async_state::co_async_fail == co_last_state)
@@ -629,15 +634,14 @@ struct __co_context_no_capture{};
 #define co_select_state_is_closed (co_async_state::co_async_closed == co_select_state)
 #define co_select_state_is_overtime (co_async_state::co_async_overtime == co_select_state)
 
-//ʼӶchannel/msg_bufferselectʽȡ(ֻco_end_select)
+//开始从多个channel/msg_buffer中以select方式轮流读取数据(只能与co_end_select配合)
 #define co_begin_select_(__label__) {\
 	co_lock_stop; co_select._ntfPump.close(co_async); _co_await; co_select.reset();\
 	DEBUG_OPERATION(co_select._labelId=__label__);\
 	for (__selectStep=0, co_select._selectId=-1, __selectCaseTyiedIoFailed=false;;) {\
 		if (1==__selectStep) {\
 			do{\
-				co_select._ntfPump.pop(co_async_result_(co_ignore, co_select._selectId, co_select_state)); _co_await;\
-				co_select._currSign=&co_select._ntfSign[co_select_curr_id];\
+				co_select._ntfPump.pop(co_async_result_(co_ignore, co_select._selectId, co_select._currSign, co_select_state)); _co_await;\
 				co_select._currSign->_appended=false;\
 			}while(co_select._currSign->_disable);\
 			__selectStep=1;\
@@ -652,13 +656,12 @@ struct __co_context_no_capture{};
 #define co_begin_select1 co_begin_select_(1)
 #define co_begin_select2 co_begin_select_(2)
 
-//ʼӶchannel/msg_bufferselectʽȡһ(ֻco_end_select_once)
+//开始从多个channel/msg_buffer中以select方式读取一次数据(只能与co_end_select_once配合)
 #define co_begin_select_once {{\
 	co_lock_stop; co_select._ntfPump.close(co_async); _co_await; co_select.reset();\
 	for (__selectStep=0, co_select._selectId=-1, __selectCaseTyiedIoFailed=false; __selectStep<=2; __selectStep++) {\
 		if (1==__selectStep || __selectCaseTyiedIoFailed) {\
-			co_select._ntfPump.pop(co_async_result_(co_ignore, co_select._selectId, co_select_state)); _co_await;\
-			co_select._currSign=&co_select._ntfSign[co_select_curr_id];\
+			co_select._ntfPump.pop(co_async_result_(co_ignore, co_select._selectId, co_select._currSign, co_select_state)); _co_await;\
 			assert(!co_select._currSign->_disable);\
 			co_select._currSign->_appended=false;\
 			__selectCaseTyiedIoFailed=false;\
@@ -671,12 +674,11 @@ struct __co_context_no_capture{};
 
 #define co_begin_timed_select_once(__ms__) {{\
 	co_lock_stop; co_select._ntfPump.close(co_async); _co_await; co_select.reset();\
-	co_timeout(__ms__, co_timer, [&]{co_select._ntfPump.send(0, co_async_state::co_async_ok);});\
+	co_timeout(__ms__, co_timer, [&]{co_select._ntfPump.send(0, (co_notify_sign*)NULL, co_async_state::co_async_ok);});\
 	for (__selectStep=0, co_select._selectId=-1, __selectCaseTyiedIoFailed=false; __selectStep<=2; __selectStep++) {\
 		if (1==__selectStep || __selectCaseTyiedIoFailed) {\
-			co_select._ntfPump.pop(co_async_result_(co_ignore, co_select._selectId, co_select_state)); _co_await;\
+			co_select._ntfPump.pop(co_async_result_(co_ignore, co_select._selectId, co_select._currSign, co_select_state)); _co_await;\
 			if (0!=co_select_curr_id) {\
-				co_select._currSign=&co_select._ntfSign[co_select_curr_id];\
 				assert(!co_select._currSign->_disable);\
 				co_select._currSign->_appended=false;\
 			}\
@@ -706,9 +708,9 @@ struct __co_context_no_capture{};
 			if (!currSign->_appended && !currSign->_disable) {\
 				currSign->_appended=true;\
 				const size_t chanId=co_select_curr_id;\
-				(__chan__).append_pop_notify([&__coContext, chanId](co_async_state st) {\
+				(__chan__).append_pop_notify([&__coContext, chanId, currSign](co_async_state st) {\
 					if (co_async_state::co_async_fail!=st) {\
-						co_select._ntfPump.send(chanId, st);\
+						co_select._ntfPump.send(chanId, currSign, st);\
 					}\
 				}, *currSign);\
 			}\
@@ -738,9 +740,9 @@ struct __co_context_no_capture{};
 			if (!currSign->_appended && !currSign->_disable) {\
 				currSign->_appended=true;\
 				const size_t chanId=co_select_curr_id;\
-				(__chan__).append_push_notify([&__coContext, chanId](co_async_state st) {\
+				(__chan__).append_push_notify([&__coContext, chanId, currSign](co_async_state st) {\
 					if (co_async_state::co_async_fail!=st) {\
-						co_select._ntfPump.send(chanId, st);\
+						co_select._ntfPump.send(chanId, currSign, st);\
 					}\
 				}, *currSign);\
 			}\
@@ -770,9 +772,9 @@ struct __co_context_no_capture{};
 			if (!currSign->_appended && !currSign->_disable) {\
 				currSign->_appended=true;\
 				const size_t chanId=co_select_curr_id;\
-				(__chan__).append_pop_notify([&__coContext, chanId](co_async_state st) {\
+				(__chan__).append_pop_notify([&__coContext, chanId, currSign](co_async_state st) {\
 					if (co_async_state::co_async_fail!=st) {\
-						co_select._ntfPump.send(chanId, st);\
+						co_select._ntfPump.send(chanId, currSign, st);\
 					}\
 				}, *currSign);\
 			}\
@@ -802,9 +804,9 @@ struct __co_context_no_capture{};
 			if (!currSign->_appended && !currSign->_disable) {\
 				currSign->_appended=true;\
 				const size_t chanId=co_select_curr_id;\
-				(__chan__).append_push_notify([&__coContext, chanId](co_async_state st) {\
+				(__chan__).append_push_notify([&__coContext, chanId, currSign](co_async_state st) {\
 					if (co_async_state::co_async_fail!=st) {\
-						co_select._ntfPump.send(chanId, st);\
+						co_select._ntfPump.send(chanId, currSign, st);\
 					}\
 				}, *currSign);\
 			}\
@@ -831,29 +833,29 @@ struct __co_context_no_capture{};
 		}\
 	} else
 
-//channel/msg_bufferм⵱ǰǷݣȡ
+//从channel/msg_buffer中检测当前是否有数据，但不立即读取
 #define co_select_case_once_(__chan__) _co_select_case_once(__chan__)
 #define co_select_case_(__chan__) _co_select_case(__chan__)
-//channel/msg_bufferжȡݣɺʼһ
+//从channel/msg_buffer中读取数据，处理完成后开始下一轮侦听
 #define co_select_slow_case_to(__chan__) _co_select_case(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_chan_try_o(__chan__, co_select_state, co_self)
 #define co_select_slow_case_csp_to(__chan__, __res__) _co_select_case(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_csp_try_o(__res__, __chan__, co_select_state, co_self)
-//channel/msg_bufferдݣɺʼһ
+//从channel/msg_buffer中写入数据，处理完成后开始下一轮侦听
 #define co_select_slow_case_of(__chan__) _co_select_case_of(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_chan_try_i(__chan__, co_select_state, co_self)
 #define co_select_slow_case_csp_of(__chan__, __res__) _co_select_case_of(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_csp_try_i(__res__, __chan__, co_select_state, co_self)
-//channel/msg_bufferжȡʱһ
+//从channel/msg_buffer中读取数据时立即下一轮侦听
 #define co_select_case_to(__chan__) _co_select_case(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_chan_seamless_try_o(__chan__, co_select_state, co_self, co_select)
 #define co_select_case_csp_to(__chan__, __res__) _co_select_case(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_csp_seamless_try_o(__res__, __chan__, co_select_state, co_self, co_select)
-//channel/msg_bufferдʱһ
+//从channel/msg_buffer中写入数据时立即下一轮侦听
 #define co_select_case_of(__chan__) _co_select_case_of(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_chan_seamless_try_i(__chan__, co_select_state, co_self, co_select)
 #define co_select_case_csp_of(__chan__, __res__) _co_select_case_of(__chan__)_co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_csp_seamless_try_i(__res__, __chan__, co_select_state, co_self, co_select)
-//channel/msg_bufferжȡһ
+//从channel/msg_buffer中读取一次数据
 #define co_select_case_once_to(__chan__) _co_select_case_once(__chan__) _co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_chan_try_o(__chan__, co_select_state, co_self)
 #define co_select_case_csp_once_to(__chan__, __res__) _co_select_case_once(__chan__) _co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_csp_try_o(__res__, __chan__, co_select_state, co_self)
-//channel/msg_bufferдһ
+//从channel/msg_buffer中写入一次数据
 #define co_select_case_once_of(__chan__) _co_select_case_once_of(__chan__) _co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_chan_try_i(__chan__, co_select_state, co_self)
 #define co_select_case_csp_once_of(__chan__, __res__) _co_select_case_once_of(__chan__) _co_switch_case_try_io_await if(co_select_state_is_ok)__selectCaseTyiedIo=true,_make_co_csp_try_i(__res__, __chan__, co_select_state, co_self)
 
-//channel/msg_bufferжȡݣɺʼһ
+//从channel/msg_buffer中读取数据，处理完成后开始下一轮侦听
 #define co_select_slow_case(__chan__, ...) _co_select_case(__chan__)\
 	if(co_select_state_is_ok){\
 		(__chan__).try_pop(co_async_result_(co_select_state, __VA_ARGS__)); _co_await;\
@@ -863,7 +865,7 @@ struct __co_context_no_capture{};
 		}\
 	}
 
-//channel/msg_bufferжȡʱһ
+//从channel/msg_buffer中读取数据时立即下一轮侦听
 #define co_select_case(__chan__, ...) _co_select_case(__chan__)\
 	if(co_select_state_is_ok){\
 		{\
@@ -871,9 +873,9 @@ struct __co_context_no_capture{};
 			assert(!currSign->_appended && !currSign->_disable);\
 			currSign->_appended=true;\
 			const size_t chanId=co_select_curr_id;\
-			(__chan__).try_pop_and_append_notify(co_async_result_(co_select_state, __VA_ARGS__), [&__coContext, chanId](co_async_state st) {\
+			(__chan__).try_pop_and_append_notify(co_async_result_(co_select_state, __VA_ARGS__), [&__coContext, chanId, currSign](co_async_state st) {\
 				if (co_async_state::co_async_fail!=st) {\
-					co_select._ntfPump.send(chanId, st);\
+					co_select._ntfPump.send(chanId, currSign, st);\
 				}\
 			}, *currSign);\
 		} _co_await;\
@@ -883,7 +885,7 @@ struct __co_context_no_capture{};
 		}\
 	}
 
-//channel/msg_bufferжȡݣɺʼһ
+//从channel/msg_buffer中读取空数据，处理完成后开始下一轮侦听
 #define co_select_slow_case_void(__chan__) _co_select_case(__chan__)\
 	if(co_select_state_is_ok){\
 		(__chan__).try_pop(co_async_result_(co_select_state)); _co_await;\
@@ -893,7 +895,7 @@ struct __co_context_no_capture{};
 		}\
 	}
 
-//channel/msg_bufferжȡʱһ
+//从channel/msg_buffer中读取数据时立即下一轮侦听
 #define co_select_case_void(__chan__) _co_select_case(__chan__)\
 	if(co_select_state_is_ok){\
 		{\
@@ -901,9 +903,9 @@ struct __co_context_no_capture{};
 			assert(!currSign->_appended && !currSign->_disable);\
 			currSign->_appended=true;\
 			const size_t chanId=co_select_curr_id;\
-			(__chan__).try_pop_and_append_notify(co_async_result_(co_select_state), [&__coContext, chanId](co_async_state st) {\
+			(__chan__).try_pop_and_append_notify(co_async_result_(co_select_state), [&__coContext, chanId, currSign](co_async_state st) {\
 				if (co_async_state::co_async_fail!=st) {\
-					co_select._ntfPump.send(chanId, st);\
+					co_select._ntfPump.send(chanId, currSign, st);\
 				}\
 			}, *currSign);\
 		} _co_await;\
@@ -913,7 +915,7 @@ struct __co_context_no_capture{};
 		}\
 	}
 
-//channel/msg_bufferжȡһ
+//从channel/msg_buffer中读取一次数据
 #define co_select_case_once(__chan__, ...) _co_select_case_once(__chan__)\
 	if(co_select_state_is_ok){\
 		(__chan__).try_pop(co_async_result_(co_select_state, __VA_ARGS__)); _co_await;\
@@ -923,7 +925,7 @@ struct __co_context_no_capture{};
 		}\
 	}
 
-//channel/msg_bufferжȡһο
+//从channel/msg_buffer中读取一次空数据
 #define co_select_case_void_once(__chan__) _co_select_case_once(__chan__)\
 	if(co_select_state_is_ok){\
 		(__chan__).try_pop(co_async_result_(co_select_state)); _co_await;\
@@ -933,21 +935,21 @@ struct __co_context_no_capture{};
 		}\
 	}
 
-//Ӷchannel/msg_bufferselectʽȡ(ֻco_begin_select)
+//结束从多个channel/msg_buffer中以select方式读取数据(只能与co_begin_select配合)
 #define co_end_select }while(0); __selectCaseStep=0;__selectStep=1;__selectCaseDoSign=true;}\
 	co_end_switch; if (0==__selectStep) {assert(!co_select._ntfSign.empty()); __selectStep=1;}}co_unlock_stop;}
 
-//Ӷchannel/msg_bufferselectʽȡ(ֻco_begin_select_once)
+//结束从多个channel/msg_buffer中以select方式读取数据(只能与co_begin_select_once配合)
 #define co_end_select_once }while(0); __selectCaseStep=0;__selectStep=1;}\
 	co_end_switch; if (0==__selectStep) {assert(!co_select._ntfSign.empty());}}co_unlock_stop;}}
 
-//selectȡ(ֻco_begin_select(__label__)/co_end_selectʹ)
+//结束select读取(只能在co_begin_select(__label__)/co_end_select中使用)
 #define co_select_exit_(__label__) do{assert(__label__==co_select._labelId);__selectCaseStep=3;__selectStep=1;__selectCaseDoSign=false;goto __select_ ## __label__;}while(0)
 #define co_select_exit co_select_exit_(0)
 #define co_select_exit1 co_select_exit_(1)
 #define co_select_exit2 co_select_exit_(2)
 
-//ȡһchannelcase
+//取消一个channel的case
 #define co_select_cancel_case(__chan__) \
 	do{\
 		{\
@@ -967,27 +969,28 @@ struct __co_context_no_capture{};
 		} _co_await;\
 	}while (0)
 
-//ָһchannelcase
+//恢复一个channel的case
 #define co_select_resume_case(__chan__) \
 	do{\
 		const size_t chanId=(size_t)&(__chan__);\
 		assert(co_select._ntfSign.end()!=co_select._ntfSign.find(chanId));\
 		co_notify_sign& sign=co_select._ntfSign[chanId];\
+		co_notify_sign* const currSign=&sign;\
 		sign._disable=false;\
 		if (chanId!=co_select_curr_id){\
 			if (sign._appended)\
 				break;\
 			sign._appended=true;\
 			if (sign._isPush) {\
-				(__chan__).append_push_notify([&__coContext, chanId](co_async_state st){\
+				(__chan__).append_push_notify([&__coContext, chanId, currSign](co_async_state st){\
 					if (co_async_state::co_async_fail!=st){\
-						co_select._ntfPump.send(chanId, st);\
+						co_select._ntfPump.send(chanId, currSign, st);\
 					}\
 				}, sign);\
 			} else {\
-				(__chan__).append_pop_notify([&__coContext, chanId](co_async_state st){\
+				(__chan__).append_pop_notify([&__coContext, chanId, currSign](co_async_state st){\
 					if (co_async_state::co_async_fail!=st){\
-						co_select._ntfPump.send(chanId, st);\
+						co_select._ntfPump.send(chanId, currSign, st);\
 					}\
 				}, sign);\
 			}\
@@ -996,11 +999,11 @@ struct __co_context_no_capture{};
 		}\
 	}while (0)
 
-//generator
+//锁定generator调度器
 #define co_hold_work io_work __holdWork
 #define co_hold_work_init __holdWork(co_ios)
 
-//װһоֲļ㣬Ȼ󷵻һ
+//包装一个有局部变量的计算，然后返回一个结果
 #define co_calc CoLocalWrapCalc_()*[&]
 #define co_calc_of CoLocalWrapCalc_()*
 
@@ -1009,13 +1012,13 @@ class generator;
 class generator_done_sign;
 struct CoGo_;
 struct CoCreate_;
-//generator 
+//generator 句柄
 typedef std::shared_ptr<generator> generator_handle;
-//generator function
+//generator function入口
 typedef std::function<void(generator&)> co_function;
 
 /*!
-@brief ջЭ(stackless coroutine)ʵֵgenerator
+@brief 基于无栈协程(stackless coroutine)实现的generator
 */
 class generator : public ActorTimerFace_
 {
@@ -1137,7 +1140,7 @@ public:
 };
 
 /*!
-@brief generator done
+@brief generator done监听
 */
 class generator_done_sign
 {
@@ -2697,7 +2700,7 @@ template <typename T>
 struct CoChanMsgMove_<T&&> {};
 
 /*!
-@brief 첽Ϣ
+@brief 异步消息队列
 */
 template <typename... Types>
 class co_msg_buffer
@@ -3474,7 +3477,7 @@ public:
 };
 
 /*!
-@brief 첽channelͨ
+@brief 异步channel通信
 */
 template <typename... Types>
 class co_channel
@@ -3482,7 +3485,7 @@ class co_channel
 	typedef std::tuple<TYPE_PIPE(Types)...> msg_type;
 public:
 	co_channel(const shared_strand& strand, size_t buffLength = 1)
-		:_closed(false), _strand(strand), _buffer(buffLength) {}
+		:_closed(false), _strand(strand), _buffer(buffLength), _urgentCount(0), _urgentWaitCount(0) {}
 
 	~co_channel()
 	{
@@ -3536,6 +3539,33 @@ public:
 		}
 	}
 
+	/*!
+	@brief 高优先级写入，跨strand时走strand紧急队列，写入后排在缓冲区中所有普通消息之前；
+	缓冲区满时排在所有等待写入者之前
+	*/
+	template <typename Notify, typename... Args>
+	void urgent_push(Notify&& ntf, Args&&... msg)
+	{
+		if (_strand->running_in_this_thread())
+		{
+			_urgent_push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+		}
+		else
+		{
+			_strand->post_urgent(std::bind([this](typename CoChanMsgMove_<Notify>::type& ntf, typename CoChanMsgMove_<Args>::type&... msg)
+			{
+				_urgent_push(CoChanMsgMove_<Notify>::move(ntf), CoChanMsgMove_<Args>::move(msg)...);
+			}, CoChanMsgMove_<Notify>::forward(ntf), CoChanMsgMove_<Args>::forward(msg)...));
+		}
+	}
+
+	template <typename Notify, typename... Args>
+	void aff_urgent_push(Notify&& ntf, Args&&... msg)
+	{
+		assert(_strand->running_in_this_thread());
+		_urgent_push(std::forward<Notify>(ntf), std::forward<Args>(msg)...);
+	}
+
 	template <typename Notify, typename... Args>
 	void tick_push(Notify&& ntf, Args&&... msg)
 	{
@@ -4043,6 +4073,68 @@ private:
 		}
 	}
 
+	template <typename Notify, typename... Args>
+	void _urgent_push(Notify&& ntf, Args&&... msg)
+	{
+		assert(_strand->running_in_this_thread());
+		if (_closed)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_closed);
+			return;
+		}
+		if (_buffer.full())
+		{
+			//排在已等待的紧急写入者之后、普通写入者之前
+			auto it = _pushWait.begin();
+			std::advance(it, _urgentWaitCount++);
+			_pushWait.insert(it, CoNotifyHandlerFace_::wrap_notify(_alloc, std::bind([this](co_async_state state, typename CoChanMsgMove_<Notify>::type& ntf, typename CoChanMsgMove_<Args>::type&... msg)
+			{
+				if (co_async_state::co_async_ok == state)
+				{
+					assert(!_buffer.full());
+					_urgent_push(CoChanMsgMove_<Notify>::move(ntf), CoChanMsgMove_<Args>::move(msg)...);
+				}
+				else
+				{
+					CHECK_EXCEPTION(ntf, state);
+				}
+			}, __1, CoChanMsgMove_<Notify>::forward(ntf), CoChanMsgMove_<Args>::forward(msg)...)));
+		}
+		else
+		{
+			//排在已缓存的紧急消息之后、普通消息之前
+			_buffer.insert(_urgentCount++, std::forward<Args>(msg)...);
+			if (!_popWait.empty())
+			{
+				assert(1 == _buffer.size());
+				CoNotifyHandlerFace_* popNtf = _popWait.front();
+				_popWait.pop_front();
+				popNtf->invoke(_alloc);
+			}
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
+		}
+	}
+
+	void pop_msg()
+	{
+		_buffer.pop_front();
+		if (_urgentCount)
+		{
+			_urgentCount--;
+		}
+	}
+
+	CoNotifyHandlerFace_* _pop_push_wait()
+	{
+		CoNotifyHandlerFace_* const pushNtf = _pushWait.front();
+		_pushWait.pop_front();
+		if (_urgentWaitCount)
+		{
+			_urgentWaitCount--;
+		}
+		return pushNtf;
+	}
+
 	template <typename Notify, typename... Args>
 	void _try_push(Notify&& ntf, Args&&... msg)
 	{
@@ -4189,11 +4281,10 @@ private:
 		if (!_buffer.empty())
 		{
 			msg_type msg(std::move(_buffer.front()));
-			_buffer.pop_front();
+			pop_msg();
 			if (!_pushWait.empty())
 			{
-				CoNotifyHandlerFace_* pushNtf = _pushWait.front();
-				_pushWait.pop_front();
+				CoNotifyHandlerFace_* pushNtf = _pop_push_wait();
 				pushNtf->invoke(_alloc);
 			}
 			CHECK_EXCEPTION(tuple_invoke, ntf, std::tuple<co_async_state>(co_async_state::co_async_ok), std::move(msg));
@@ -4227,11 +4318,10 @@ private:
 		if (!_buffer.empty())
 		{
 			msg_type msg(std::move(_buffer.front()));
-			_buffer.pop_front();
+			pop_msg();
 			if (!_pushWait.empty())
 			{
-				CoNotifyHandlerFace_* pushNtf = _pushWait.front();
-				_pushWait.pop_front();
+				CoNotifyHandlerFace_* pushNtf = _pop_push_wait();
 				pushNtf->invoke(_alloc);
 			}
 			CHECK_EXCEPTION(tuple_invoke, ntf, std::tuple<co_async_state>(co_async_state::co_async_ok), std::move(msg));
@@ -4254,11 +4344,10 @@ private:
 		if (!_buffer.empty())
 		{
 			msg_type msg(std::move(_buffer.front()));
-			_buffer.pop_front();
+			pop_msg();
 			if (!_pushWait.empty())
 			{
-				CoNotifyHandlerFace_* pushNtf = _pushWait.front();
-				_pushWait.pop_front();
+				CoNotifyHandlerFace_* pushNtf = _pop_push_wait();
 				pushNtf->invoke(_alloc);
 			}
 			CHECK_EXCEPTION(tuple_invoke, ntf, std::tuple<co_async_state>(co_async_state::co_async_ok), std::move(msg));
@@ -4306,11 +4395,10 @@ private:
 		if (!_buffer.empty())
 		{
 			msg_type msg(std::move(_buffer.front()));
-			_buffer.pop_front();
+			pop_msg();
 			if (!_pushWait.empty())
 			{
-				CoNotifyHandlerFace_* pushNtf = _pushWait.front();
-				_pushWait.pop_front();
+				CoNotifyHandlerFace_* pushNtf = _pop_push_wait();
 				pushNtf->invoke(_alloc);
 			}
 			CHECK_EXCEPTION(tuple_invoke, ntf, std::tuple<co_async_state>(co_async_state::co_async_ok), std::move(msg));
@@ -4384,11 +4472,10 @@ private:
 		if (!_buffer.empty())
 		{
 			msg_type msg(std::move(_buffer.front()));
-			_buffer.pop_front();
+			pop_msg();
 			if (!_pushWait.empty())
 			{
-				CoNotifyHandlerFace_* pushNtf = _pushWait.front();
-				_pushWait.pop_front();
+				CoNotifyHandlerFace_* pushNtf = _pop_push_wait();
 				pushNtf->invoke(_alloc);
 			}
 			_append_pop_notify(CoChanMsgMove_<MsgNotify>::forward(msgNtf), ntfSign);
@@ -4512,8 +4599,7 @@ private:
 		}
 		if (!_buffer.full() && !_pushWait.empty())
 		{
-			CoNotifyHandlerFace_* pushNtf = _pushWait.front();
-			_pushWait.pop_front();
+			CoNotifyHandlerFace_* pushNtf = _pop_push_wait();
 			pushNtf->invoke(_alloc);
 		}
 		CHECK_EXCEPTION(ntf, effect ? co_async_state::co_async_ok : co_async_state::co_async_fail);
@@ -4524,6 +4610,7 @@ private:
 		assert(_strand->running_in_this_thread());
 		_closed = true;
 		_buffer.clear();
+		_urgentCount = 0;
 		size_t ntfNum = 0;
 		CoNotifyHandlerFace_* ntfs[32];
 		std::list<CoNotifyHandlerFace_*> ntfsEx;
@@ -4539,6 +4626,7 @@ private:
 			}
 			_pushWait.pop_front();
 		}
+		_urgentWaitCount = 0;
 		while (!_popWait.empty())
 		{
 			if (ntfNum < fixed_array_length(ntfs))
@@ -4580,6 +4668,7 @@ private:
 			}
 			_pushWait.pop_front();
 		}
+		_urgentWaitCount = 0;
 		while (!_popWait.empty())
 		{
 			if (ntfNum < fixed_array_length(ntfs))
@@ -4621,6 +4710,7 @@ private:
 			}
 			_pushWait.pop_front();
 		}
+		_urgentWaitCount = 0;
 		for (size_t i = 0; i < ntfNum; i++)
 		{
 			ntfs[i]->invoke(_alloc, co_async_state::co_async_cancel);
@@ -4663,6 +4753,8 @@ private:
 private:
 	shared_strand _strand;
 	fixed_buffer<msg_type> _buffer;
+	size_t _urgentCount;///<_buffer队首的紧急消息数
+	size_t _urgentWaitCount;///<_pushWait队首的紧急写入者数
 	reusable_mem _alloc;
 	msg_list<CoNotifyHandlerFace_*> _pushWait;
 	msg_list<CoNotifyHandlerFace_*> _popWait;
@@ -4684,6 +4776,8 @@ public:
 public:
 	template <typename Notify> void push(Notify&& ntf, void_type = void_type()){ co_channel<void_type>::push(std::forward<Notify>(ntf), void_type()); }
 	template <typename Notify> void aff_push(Notify&& ntf, void_type = void_type()){ co_channel<void_type>::aff_push(std::forward<Notify>(ntf), void_type()); }
+	template <typename Notify> void urgent_push(Notify&& ntf, void_type = void_type()){ co_channel<void_type>::urgent_push(std::forward<Notify>(ntf), void_type()); }
+	template <typename Notify> void aff_urgent_push(Notify&& ntf, void_type = void_type()){ co_channel<void_type>::aff_urgent_push(std::forward<Notify>(ntf), void_type()); }
 	template <typename Notify> void try_push(Notify&& ntf, void_type = void_type()){ co_channel<void_type>::try_push(std::forward<Notify>(ntf), void_type()); }
 	template <typename Notify> void aff_try_push(Notify&& ntf, void_type = void_type()){ co_channel<void_type>::aff_try_push(std::forward<Notify>(ntf), void_type()); }
 	template <typename Notify> void timed_push(int ms, Notify&& ntf, void_type = void_type()){ co_channel<void_type>::timed_push(ms, std::forward<Notify>(ntf), void_type()); }
@@ -4696,7 +4790,7 @@ public:
 };
 
 /*!
-@brief 첽޻channelͨ
+@brief 异步无缓冲channel通信
 */
 template <typename... Types>
 class co_nil_channel
@@ -6051,7 +6145,7 @@ struct CspResultSign_
 #endif
 
 /*!
-@brief co_csp_channel÷ؽ
+@brief co_csp_channel调用返回结果
 */
 template <typename R>
 struct csp_result
@@ -6102,7 +6196,7 @@ struct csp_result<void> : public csp_result<void_type1>
 };
 
 /*!
-@brief ֵchannel
+@brief 带返回值的channel
 */
 template <typename... Types> class co_csp_channel{};
 template <typename R, typename... Types>
@@ -7428,6 +7522,300 @@ public:
 	}
 };
 
+template <typename R> class co_csp_window;
+
+/*!
+@brief co_csp_window的共享部分，窗口销毁后仍在途的调用靠它归还名额
+*/
+struct CoCspWindowState_
+{
+	CoCspWindowState_(const shared_strand& strand, size_t window)
+		:_strand(strand), _pushWait(NULL), _window(window), _inflight(0) {}
+
+	~CoCspWindowState_()
+	{
+		assert(!_pushWait);
+	}
+
+	void release()
+	{
+		assert(_inflight > 0);
+		_inflight--;
+		if (_pushWait)
+		{
+			CoNotifyHandlerFace_* const ntf = _pushWait;
+			_pushWait = NULL;
+			ntf->invoke(_alloc);
+		}
+	}
+
+	void discard(CoNotifyHandlerFace_*& ntf)
+	{
+		if (ntf)
+		{
+			ntf->destroy();
+			_alloc.deallocate(ntf);
+			ntf = NULL;
+		}
+	}
+
+	shared_strand _strand;
+	reusable_mem _alloc;
+	CoNotifyHandlerFace_* _pushWait;
+	const size_t _window;
+	size_t _inflight;
+	NONE_COPY(CoCspWindowState_);
+};
+
+/*!
+@brief co_csp_window发出的一次调用，结果按任意顺序取回；
+调用返回前future或窗口被销毁(如generator被停止)时，迟到的结果被丢弃；
+无返回值的co_csp_channel<void(...)>用co_csp_future<void_type>
+*/
+template <typename R>
+class co_csp_future
+{
+	typedef RM_CREF(R) result_type;
+	friend co_csp_window<R>;
+
+	/*!
+	@brief 结果槽，由future和在途调用的result_notify共同持有
+	*/
+	struct FutureState_
+	{
+		FutureState_(const std::shared_ptr<CoCspWindowState_>& window)
+			:_window(window), _waitNtf(NULL), _state(co_async_state::co_async_undefined), _pending(false), _done(false), _detached(false) {}
+
+		std::shared_ptr<CoCspWindowState_> _window;
+		CoNotifyHandlerFace_* _waitNtf;
+		stack_obj<result_type> _res;
+		co_async_state _state;
+		bool _pending;
+		bool _done;
+		bool _detached;///<future已销毁
+		NONE_COPY(FutureState_);
+	};
+
+	struct result_notify
+	{
+		result_notify(const std::shared_ptr<FutureState_>& st)
+		:_st(st) {}
+
+		template <typename Res>
+		void operator()(co_async_state state, Res&& res)
+		{
+			//结果槽可能在distribute中释放，连同窗口持有的strand
+			const shared_strand strand = _st->_window->_strand;
+			strand->distribute(std::bind([state](std::shared_ptr<FutureState_>& st, result_type& res)
+			{
+				co_csp_future::_complete(st, state, &res);
+			}, std::move(_st), std::forward<Res>(res)));
+		}
+
+		void operator()(co_async_state state)
+		{
+			const shared_strand strand = _st->_window->_strand;
+			strand->distribute(std::bind([state](std::shared_ptr<FutureState_>& st)
+			{
+				co_csp_future::_complete(st, state, NULL);
+			}, std::move(_st)));
+		}
+
+		std::shared_ptr<FutureState_> _st;
+	};
+public:
+	co_csp_future() {}
+
+	~co_csp_future()
+	{
+		if (_st && _st->_pending)
+		{
+			assert(_st->_window->_strand->running_in_this_thread());
+			_st->_detached = true;
+			_st->_window->discard(_st->_waitNtf);
+		}
+	}
+public:
+	/*!
+	@brief 取回结果，ntf(co_async_state, R)，之后可再次用于发送
+	*/
+	template <typename Notify>
+	void wait(Notify&& ntf)
+	{
+		assert(pending() && _st->_window->_strand->running_in_this_thread());
+		assert(!_st->_waitNtf);
+		if (_st->_done)
+		{
+			_take(ntf);
+		}
+		else
+		{
+			_st->_waitNtf = CoNotifyHandlerFace_::wrap_notify(_st->_window->_alloc, std::bind([this](co_async_state, typename CoChanMsgMove_<Notify>::type& ntf)
+			{
+				_take(ntf);
+			}, __1, CoChanMsgMove_<Notify>::forward(ntf)));
+		}
+	}
+
+	/*!
+	@brief 已发出，还未取回结果
+	*/
+	bool pending() const
+	{
+		return _st && _st->_pending;
+	}
+
+	/*!
+	@brief 结果已返回，wait不会等待
+	*/
+	bool ready() const
+	{
+		return _st && _st->_done;
+	}
+private:
+	template <typename Notify>
+	void _take(Notify& ntf)
+	{
+		const co_async_state state = _st->_state;
+		_st->_pending = false;
+		_st->_done = false;
+		_take(ntf, state, std::is_same<result_type, void_type>());
+	}
+
+	template <typename Notify>
+	void _take(Notify& ntf, co_async_state state, std::true_type)
+	{
+		CHECK_EXCEPTION(ntf, state);
+	}
+
+	template <typename Notify>
+	void _take(Notify& ntf, co_async_state state, std::false_type)
+	{
+		if (_st->_res.has())
+		{
+			result_type res(std::move(_st->_res.get()));
+			_st->_res.destroy();
+			CHECK_EXCEPTION(ntf, state, std::move(res));
+		}
+		else
+		{
+			CHECK_EXCEPTION(ntf, state);
+		}
+	}
+
+	static void _complete(const std::shared_ptr<FutureState_>& st, co_async_state state, result_type* res)
+	{
+		assert(st->_window->_strand->running_in_this_thread());
+		assert(!st->_done);
+		if (!st->_detached)
+		{
+			if (res)
+			{
+				st->_res.create(std::move(*res));
+			}
+			st->_state = state;
+			st->_done = true;
+		}
+		//发送方只会在一处等待，release唤醒发送时不会再有取结果的等待
+		std::shared_ptr<CoCspWindowState_> window = st->_window;
+		CoNotifyHandlerFace_* const ntf = st->_waitNtf;
+		st->_waitNtf = NULL;
+		window->release();
+		if (ntf)
+		{
+			ntf->invoke(window->_alloc);
+		}
+	}
+private:
+	std::shared_ptr<FutureState_> _st;
+	NONE_COPY(co_csp_future);
+};
+
+/*!
+@brief co_csp_channel的流水线调用窗口，一个发送方最多同时有window个未返回的调用，不必等上一个调用返回；
+窗口属于一个发送方，只能在构造时的strand中使用
+*/
+template <typename R>
+class co_csp_window
+{
+	friend co_csp_future<R>;
+public:
+	co_csp_window(co_generator, size_t window)
+		:co_csp_window(co_strand, window) {}
+
+	co_csp_window(const shared_strand& strand, size_t window)
+		:_state(std::make_shared<CoCspWindowState_>(strand, window))
+	{
+		assert(window > 0);
+	}
+
+	~co_csp_window()
+	{
+		//在途调用仍持有_state，返回时只归还名额
+		_state->discard(_state->_pushWait);
+	}
+public:
+	/*!
+	@brief 等到未返回的调用少于window，ntf(co_async_state)
+	*/
+	template <typename Notify>
+	void acquire(Notify&& ntf)
+	{
+		assert(_state->_strand->running_in_this_thread());
+		if (_state->_inflight < _state->_window)
+		{
+			CHECK_EXCEPTION(ntf, co_async_state::co_async_ok);
+		}
+		else
+		{
+			assert(!_state->_pushWait);
+			_state->_pushWait = CoNotifyHandlerFace_::wrap_notify(_state->_alloc, std::forward<Notify>(ntf));
+		}
+	}
+
+	/*!
+	@brief acquire成功后发出调用，结果用fut.wait取回
+	*/
+	template <typename Chan, typename... Args>
+	void push(co_csp_future<R>& fut, Chan& chan, Args&&... msg)
+	{
+		typedef typename co_csp_future<R>::FutureState_ future_state;
+		assert(_state->_strand->running_in_this_thread());
+		assert(_state->_inflight < _state->_window);
+		assert(!fut.pending());
+		//上次调用的结果槽已无人共享时复用
+		if (!fut._st || 1 != fut._st.use_count())
+		{
+			fut._st = std::make_shared<future_state>(_state);
+		}
+		else
+		{
+			fut._st->_window = _state;
+		}
+		fut._st->_pending = true;
+		_state->_inflight++;
+		chan.push(typename co_csp_future<R>::result_notify(fut._st), std::forward<Args>(msg)...);
+	}
+
+	size_t inflight() const
+	{
+		return _state->_inflight;
+	}
+
+	size_t window() const
+	{
+		return _state->_window;
+	}
+
+	const shared_strand& self_strand() const
+	{
+		return _state->_strand;
+	}
+private:
+	std::shared_ptr<CoCspWindowState_> _state;
+	NONE_COPY(co_csp_window);
+};
+
 struct co_select_sign
 {
 	co_select_sign(co_generator):co_select_sign(co_strand) {}	
@@ -7447,7 +7835,7 @@ struct co_select_sign
 		DEBUG_OPERATION(_labelId = -1);
 	}
 
-	co_msg_buffer<size_t, co_async_state> _ntfPump;
+	co_msg_buffer<size_t, co_notify_sign*, co_async_state> _ntfPump;//就绪通知队列，直接携带对应的co_notify_sign，唤醒时无需再查表
 	msg_map<size_t, co_notify_sign> _ntfSign;
 	co_notify_sign* _currSign;
 	size_t _selectId;
@@ -7458,7 +7846,7 @@ struct co_select_sign
 
 class co_shared_mutex;
 /*!
-@brief generator߼mutexͬ
+@brief generator中逻辑mutex同步
 */
 class co_mutex
 {
@@ -7789,7 +8177,7 @@ private:
 };
 
 /*!
-@brief generator߼shared_mutexͬ
+@brief generator中逻辑shared_mutex同步
 */
 class co_shared_mutex
 {
@@ -8788,7 +9176,7 @@ private:
 };
 
 /*!
-@brief 
+@brief 条件变量
 */
 class co_condition_variable
 {
@@ -8999,11 +9387,11 @@ void CoChanSeamlessTryO_<Chan>::pop(CoChanSeamlessTryO_* this_, Args&&... args)
 	const size_t chanId = selectSign._selectId;
 	assert(chanId == (size_t)&this_->_chan && !currSign->_appended && !currSign->_disable);
 	currSign->_appended = true;
-	this_->_chan.try_pop_and_append_notify(co_async_result_(this_->_state, args...), [&, chanId](co_async_state st)
+	this_->_chan.try_pop_and_append_notify(co_async_result_(this_->_state, args...), [&, chanId, currSign](co_async_state st)
 	{
 		if (co_async_state::co_async_fail != st)
 		{
-			selectSign._ntfPump.send(chanId, st);
+			selectSign._ntfPump.send(chanId, currSign, st);
 		}
 	}, *currSign);
 }
@@ -9017,11 +9405,11 @@ void CoChanSeamlessTryI_<Chan>::push(CoChanSeamlessTryI_* this_, Args&&... args)
 	const size_t chanId = selectSign._selectId;
 	assert(chanId == (size_t)&this_->_chan && !currSign->_appended && !currSign->_disable);
 	currSign->_appended = true;
-	this_->_chan.try_push_and_append_notify(co_async_result(this_->_state), [&, chanId](co_async_state st)
+	this_->_chan.try_push_and_append_notify(co_async_result(this_->_state), [&, chanId, currSign](co_async_state st)
 	{
 		if (co_async_state::co_async_fail != st)
 		{
-			selectSign._ntfPump.send(chanId, st);
+			selectSign._ntfPump.send(chanId, currSign, st);
 		}
 	}, *currSign, std::forward<Args>(args)...);
 }
@@ -9035,11 +9423,11 @@ void CoCspSeamlessTryO_<R, CspChan>::pop(CoCspSeamlessTryO_* this_, Args&&... ar
 	const size_t chanId = selectSign._selectId;
 	assert(chanId == (size_t)&this_->_chan && !currSign->_appended && !currSign->_disable);
 	currSign->_appended = true;
-	this_->_chan.try_pop_and_append_notify(co_async_result_(this_->_state, this_->_res, args...), [&, chanId](co_async_state st)
+	this_->_chan.try_pop_and_append_notify(co_async_result_(this_->_state, this_->_res, args...), [&, chanId, currSign](co_async_state st)
 	{
 		if (co_async_state::co_async_fail != st)
 		{
-			selectSign._ntfPump.send(chanId, st);
+			selectSign._ntfPump.send(chanId, currSign, st);
 		}
 	}, *currSign);
 }
@@ -9053,11 +9441,11 @@ void CoCspSeamlessTryI_<R, CspChan>::push(CoCspSeamlessTryI_* this_, Args&&... a
 	const size_t chanId = selectSign._selectId;
 	assert(chanId == (size_t)&this_->_chan && !currSign->_appended && !currSign->_disable);
 	currSign->_appended = true;
-	this_->_chan.try_push_and_append_notify(co_async_result_(this_->_state, this_->_res), [&, chanId](co_async_state st)
+	this_->_chan.try_push_and_append_notify(co_async_result_(this_->_state, this_->_res), [&, chanId, currSign](co_async_state st)
 	{
 		if (co_async_state::co_async_fail != st)
 		{
-			selectSign._ntfPump.send(chanId, st);
+			selectSign._ntfPump.send(chanId, currSign, st);
 		}
 	}, *currSign, std::forward<Args>(args)...);
 }
@@ -0,0 +1,294 @@
+#include "huge_page.h"
+#include "check_actor_stack.h"
+#include "scattered.h"
+#include <mutex>
+#include <atomic>
+#include <map>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+static_assert(HUGE_PAGE_SIZE % HUGE_PAGE_NODE_CHUNK == 0, "");
+static_assert(HUGE_PAGE_NODE_MAX % 16 == 0 && HUGE_PAGE_NODE_MAX <= HUGE_PAGE_NODE_CHUNK, "");
+
+namespace huge_page
+{
+	static std::atomic<size_t> s_stackSlabs(0);
+	static std::atomic<size_t> s_stackSlabBytes(0);
+	static std::atomic<size_t> s_stackCount(0);
+	static std::atomic<size_t> s_fallbackStacks(0);
+	static std::atomic<size_t> s_poolSlabs(0);
+	static std::atomic<size_t> s_poolSlabBytes(0);
+	static std::atomic<size_t> s_poolFallbackBytes(0);
+	static std::atomic<size_t> s_hugetlbBytes(0);
+	static std::atomic<size_t> s_thpBytes(0);
+
+	static std::mutex s_stackMutex;
+	static std::map<char*, bool> s_stacks;
+
+	static std::mutex s_chunkMutex;
+	static char* s_chunkPos = NULL;
+	static size_t s_chunkLeft = 0;
+	static std::map<char*, bool> s_blocks;
+
+	static std::mutex s_nodeMutex[HUGE_PAGE_NODE_MAX / 16];
+	static void* s_nodeFree[HUGE_PAGE_NODE_MAX / 16] = { 0 };
+	static char* s_nodePos[HUGE_PAGE_NODE_MAX / 16] = { 0 };
+	static size_t s_nodeLeft[HUGE_PAGE_NODE_MAX / 16] = { 0 };
+
+#ifdef __linux__
+	/*!
+	@brief 映射一段HUGE_PAGE_SIZE对齐的内存，guard为true时紧邻其下保留一个PROT_NONE页
+	*/
+	static char* map_slab(size_t size, bool guard, bool& hugetlb)
+	{
+		const size_t reserve = size + HUGE_PAGE_SIZE;
+		char* const base = (char*)mmap(0, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (MAP_FAILED == base)
+		{
+			return NULL;
+		}
+		char* const slab = (char*)MEM_ALIGN((size_t)base + MEM_PAGE_SIZE, (size_t)HUGE_PAGE_SIZE);
+		hugetlb = MAP_FAILED != mmap(slab, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB, -1, 0);
+		if (!hugetlb)
+		{
+			//显式大页不足，MAP_FIXED失败后原区间可能已被解除，重新映射普通页再申请透明大页
+			if (MAP_FAILED == mmap(slab, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0))
+			{
+				munmap(base, reserve);
+				return NULL;
+			}
+			madvise(slab, size, MADV_HUGEPAGE);
+			s_thpBytes += size;
+		}
+		else
+		{
+			s_hugetlbBytes += size;
+		}
+		char* const head = slab - (guard ? MEM_PAGE_SIZE : 0);
+		if (head != base)
+		{
+			munmap(base, head - base);
+		}
+		if (slab + size != base + reserve)
+		{
+			munmap(slab + size, (base + reserve) - (slab + size));
+		}
+		return slab;
+	}
+
+	static void unmap_slab(char* slab, size_t size, bool guard, bool hugetlb)
+	{
+		if (hugetlb)
+		{
+			s_hugetlbBytes -= size;
+		}
+		else
+		{
+			s_thpBytes -= size;
+		}
+		munmap(slab - (guard ? MEM_PAGE_SIZE : 0), size + (guard ? MEM_PAGE_SIZE : 0));
+	}
+#else
+	static char* map_slab(size_t size, bool guard, bool& hugetlb)
+	{
+		hugetlb = false;
+		return NULL;
+	}
+
+	static void unmap_slab(char* slab, size_t size, bool guard, bool hugetlb)
+	{
+	}
+#endif
+
+	void* stack_alloc(size_t& allocSize)
+	{
+		if (!allocSize)
+		{
+			s_fallbackStacks++;
+			return NULL;
+		}
+		//哨兵页不能放在大页内部(mprotect会拆分大页)，栈向上取整到HUGE_PAGE_SIZE整数倍并独占映射，哨兵页在映射之下
+		const size_t mapSize = MEM_ALIGN(allocSize, (size_t)HUGE_PAGE_SIZE);
+		bool hugetlb = false;
+		char* const stack = map_slab(mapSize, true, hugetlb);
+		if (!stack)
+		{
+			s_fallbackStacks++;
+			return NULL;
+		}
+		{
+			std::lock_guard<std::mutex> lg(s_stackMutex);
+			s_stacks[stack] = hugetlb;
+		}
+		s_stackSlabs++;
+		s_stackSlabBytes += mapSize;
+		s_stackCount++;
+		allocSize = mapSize;
+		return stack;
+	}
+
+	void stack_free(void* stack, size_t allocSize)
+	{
+		assert(0 == allocSize % HUGE_PAGE_SIZE);
+		bool hugetlb = false;
+		{
+			std::lock_guard<std::mutex> lg(s_stackMutex);
+			auto it = s_stacks.find((char*)stack);
+			assert(s_stacks.end() != it);
+			hugetlb = it->second;
+			s_stacks.erase(it);
+		}
+		s_stackSlabs--;
+		s_stackSlabBytes -= allocSize;
+		s_stackCount--;
+		unmap_slab((char*)stack, allocSize, true, hugetlb);
+	}
+
+	static char* pool_chunk()
+	{
+		std::lock_guard<std::mutex> lg(s_chunkMutex);
+		if (!s_chunkLeft)
+		{
+			bool hugetlb = false;
+			s_chunkPos = map_slab(HUGE_PAGE_SIZE, false, hugetlb);
+			if (!s_chunkPos)
+			{
+				s_poolFallbackBytes += HUGE_PAGE_NODE_CHUNK;
+				return (char*)malloc(HUGE_PAGE_NODE_CHUNK);
+			}
+			s_chunkLeft = HUGE_PAGE_SIZE;
+			s_poolSlabs++;
+			s_poolSlabBytes += HUGE_PAGE_SIZE;
+		}
+		char* const chunk = s_chunkPos;
+		s_chunkPos += HUGE_PAGE_NODE_CHUNK;
+		s_chunkLeft -= HUGE_PAGE_NODE_CHUNK;
+		return chunk;
+	}
+
+	void* node_alloc(size_t size)
+	{
+		if (!size || size > HUGE_PAGE_NODE_MAX)
+		{
+			return malloc(size);
+		}
+		const size_t i = (size - 1) / 16;
+		const size_t nodeSize = (i + 1) * 16;
+		std::lock_guard<std::mutex> lg(s_nodeMutex[i]);
+		if (s_nodeFree[i])
+		{
+			void* const p = s_nodeFree[i];
+			s_nodeFree[i] = *(void**)p;
+			return p;
+		}
+		if (s_nodeLeft[i] < nodeSize)
+		{
+			char* const chunk = pool_chunk();
+			if (!chunk)
+			{
+				return NULL;
+			}
+			s_nodePos[i] = chunk;
+			s_nodeLeft[i] = HUGE_PAGE_NODE_CHUNK;
+		}
+		void* const p = s_nodePos[i];
+		s_nodePos[i] += nodeSize;
+		s_nodeLeft[i] -= nodeSize;
+		return p;
+	}
+
+	void node_free(void* p, size_t size)
+	{
+		if (!size || size > HUGE_PAGE_NODE_MAX)
+		{
+			free(p);
+			return;
+		}
+		const size_t i = (size - 1) / 16;
+		std::lock_guard<std::mutex> lg(s_nodeMutex[i]);
+		*(void**)p = s_nodeFree[i];
+		s_nodeFree[i] = p;
+	}
+
+	void* block_alloc(size_t size)
+	{
+		if (size < HUGE_PAGE_SIZE / 2)
+		{
+			return malloc(size);
+		}
+		const size_t mapSize = MEM_ALIGN(size, (size_t)HUGE_PAGE_SIZE);
+		bool hugetlb = false;
+		char* const p = map_slab(mapSize, false, hugetlb);
+		if (!p)
+		{
+			s_poolFallbackBytes += size;
+			return malloc(size);
+		}
+		std::lock_guard<std::mutex> lg(s_chunkMutex);
+		s_blocks[p] = hugetlb;
+		s_poolSlabs++;
+		s_poolSlabBytes += mapSize;
+		return p;
+	}
+
+	void block_free(void* p, size_t size)
+	{
+		bool hugetlb = false;
+		const size_t mapSize = MEM_ALIGN(size, (size_t)HUGE_PAGE_SIZE);
+		{
+			std::lock_guard<std::mutex> lg(s_chunkMutex);
+			auto it = s_blocks.find((char*)p);
+			if (s_blocks.end() == it)
+			{
+				if (size >= HUGE_PAGE_SIZE / 2)
+				{
+					s_poolFallbackBytes -= size;
+				}
+				free(p);
+				return;
+			}
+			hugetlb = it->second;
+			s_blocks.erase(it);
+			s_poolSlabs--;
+			s_poolSlabBytes -= mapSize;
+		}
+		unmap_slab((char*)p, mapSize, false, hugetlb);
+	}
+
+	stats_info stats()
+	{
+		stats_info res;
+		res.stackSlabs = s_stackSlabs;
+		res.stackSlabBytes = s_stackSlabBytes;
+		res.stackCount = s_stackCount;
+		res.fallbackStacks = s_fallbackStacks;
+		res.poolSlabs = s_poolSlabs;
+		res.poolSlabBytes = s_poolSlabBytes;
+		res.poolFallbackBytes = s_poolFallbackBytes;
+		res.hugetlbBytes = s_hugetlbBytes;
+		res.thpBytes = s_thpBytes;
+		res.anonHugeBytes = 0;
+#ifdef __linux__
+		FILE* fp = fopen("/proc/self/smaps_rollup", "r");
+		if (fp)
+		{
+			char line[256];
+			while (fgets(line, sizeof(line), fp))
+			{
+				unsigned long long kb = 0;
+				if (1 == sscanf(line, "AnonHugePages: %llu kB", &kb))
+				{
+					res.anonHugeBytes = (size_t)kb * 1024;
+					break;
+				}
+			}
+			fclose(fp);
+		}
+#endif
+		return res;
+	}
+}
@@ -0,0 +1,82 @@
+#ifndef __HUGE_PAGE_H
+#define __HUGE_PAGE_H
+
+#include <stddef.h>
+
+//大页尺寸
+#ifndef HUGE_PAGE_SIZE
+#define HUGE_PAGE_SIZE (2*1024*1024)
+#endif
+
+//小于等于该尺寸的内存池节点从大页slab中分配
+#ifndef HUGE_PAGE_NODE_MAX
+#define HUGE_PAGE_NODE_MAX 4096
+#endif
+
+//每个节点尺寸一次从slab中切取的块大小
+#ifndef HUGE_PAGE_NODE_CHUNK
+#define HUGE_PAGE_NODE_CHUNK (64*1024)
+#endif
+
+/*!
+@brief 大页(2MB)内存，ENABLE_HUGE_PAGE下用于承载Actor栈(每个栈独占大页)和mem_pool中的固定尺寸内存池；
+优先使用显式大页(MAP_HUGETLB，需预留 /proc/sys/vm/nr_hugepages)，失败后使用透明大页(MADV_HUGEPAGE)
+*/
+namespace huge_page
+{
+	struct stats_info
+	{
+		size_t stackSlabs;///<栈映射数
+		size_t stackSlabBytes;///<栈映射字节数(含取整多出的部分)
+		size_t stackCount;///<从大页中分配的栈数
+		size_t fallbackStacks;///<未能从slab中分配(使用4K页)的栈数
+		size_t poolSlabs;///<内存池slab数
+		size_t poolSlabBytes;///<内存池slab字节数
+		size_t poolFallbackBytes;///<大页映射失败后改用malloc的内存池字节数
+		size_t hugetlbBytes;///<显式大页字节数
+		size_t thpBytes;///<申请透明大页的字节数
+		size_t anonHugeBytes;///<进程实际驻留的透明大页字节数(/proc/self/smaps_rollup AnonHugePages)
+	};
+
+	/*!
+	@brief 从大页中分配一个栈空间，失败返回NULL(调用方改用4K页)；
+	哨兵页不能放在大页内部(mprotect会拆分大页)，多个栈挤在一个大页中就无法互相隔离，
+	所以每个栈向上取整到HUGE_PAGE_SIZE整数倍并独占映射，映射之下有一个PROT_NONE哨兵页；
+	代价是每个栈至少占用一个大页的物理内存(默认栈只有几十kB)，并且大页中的栈不做decommit，空闲时一直占用，
+	适合Actor数量不多、切换频繁的场景
+	@param allocSize 输入栈空间大小(含保留空间)，成功后返回取整后的实际大小，多出的部分由调用方并入栈底保留空间
+	*/
+	void* stack_alloc(size_t& allocSize);
+
+	/*!
+	@brief 归还stack_alloc分配的栈空间，allocSize为stack_alloc返回的实际大小
+	*/
+	void stack_free(void* stack, size_t allocSize);
+
+	/*!
+	@brief 分配一个内存池节点(不超过HUGE_PAGE_NODE_MAX时从大页slab切取，节点回收后只在同尺寸内复用，不归还系统)
+	*/
+	void* node_alloc(size_t size);
+
+	/*!
+	@brief 释放node_alloc分配的节点，size必须与分配时相同
+	*/
+	void node_free(void* p, size_t size);
+
+	/*!
+	@brief 分配一块连续内存(不小于HUGE_PAGE_SIZE/2时直接映射大页)
+	*/
+	void* block_alloc(size_t size);
+
+	/*!
+	@brief 释放block_alloc分配的内存，size必须与分配时相同
+	*/
+	void block_free(void* p, size_t size);
+
+	/*!
+	@brief 大页使用统计
+	*/
+	stats_info stats();
+}
+
+#endif
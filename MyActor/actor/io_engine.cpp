@@ -4,6 +4,9 @@
 #include "generator.h"
 #include "context_yield.h"
 #include "waitable_timer.h"
+#include "async_file.h"
+#include "time_source.h"
+#include "stack_sampler.h"
 
 #ifdef ASIO_HANDLER_ALLOCATE_EX
 
@@ -103,21 +106,43 @@ namespace boost
 			struct io_service_work_check_outstanding_count
 			{
 			};
+
+			struct io_service_work_get_outstanding_count
+			{
+				long count;
+			};
 #ifdef WIN32
 			template <>
 			void boost::asio::detail::win_iocp_io_service::dispatch(io_service_work_check_outstanding_count&)
 			{
 				assert(outstanding_work_ >= 0);
 			}
+
+			template <>
+			void boost::asio::detail::win_iocp_io_service::dispatch(io_service_work_get_outstanding_count& gc)
+			{
+				gc.count = outstanding_work_;
+			}
 #elif __linux__
 			template <>
 			void boost::asio::detail::task_io_service::dispatch(io_service_work_check_outstanding_count&)
 			{
 				assert(outstanding_work_ >= 0);
 			}
+
+			template <>
+			void boost::asio::detail::task_io_service::dispatch(io_service_work_get_outstanding_count& gc)
+			{
+				gc.count = outstanding_work_;
+			}
 #endif
 		}
 
+		struct io_service_work_outstanding
+		{
+			long* count;
+		};
+
 		template <>
 		void boost::asio::io_service::dispatch(io_service_work_started&&)
 		{
@@ -137,6 +162,14 @@ namespace boost
 			impl_.dispatch(cc);
 #endif
 		}
+
+		template <>
+		void boost::asio::io_service::dispatch(io_service_work_outstanding&& wo)
+		{
+			boost::asio::detail::io_service_work_get_outstanding_count gc;
+			impl_.dispatch(gc);
+			*wo.count = gc.count;
+		}
 	}
 }
 
@@ -185,6 +218,26 @@ io_engine::io_engine(bool enableTimer, const char* title)
 io_engine::io_engine(size_t poolSize, bool enableTimer, const char* title)
 {
 	_opend = false;
+	_fileService = NULL;
+	_shardNum = 0;
+	_shardRound = 0;
+	_elastic = false;
+	_elasticMin = 0;
+	_elasticMax = 0;
+	_elasticLatency = IO_ELASTIC_LATENCY;
+	_elasticIdle = IO_ELASTIC_IDLE;
+	_elasticExit = false;
+	_elasticMonitor = NULL;
+	_idealIndex = -1;
+	_threadCount = 0;
+	_spawnCount = 0;
+	_retireCount = 0;
+	_retireReady = 0;
+	_retirePending = 0;
+	_probePending = false;
+	_probeTick = 0;
+	_probeLatency = 0;
+	_lastLatency = 0;
 	_poolSize = poolSize > 4 ? poolSize : 4;
 	_title = title ? title : "io_engine";
 #ifdef WIN32
@@ -219,6 +272,12 @@ io_engine::io_engine(size_t poolSize, bool enableTimer, const char* title)
 io_engine::~io_engine()
 {
 	assert(!_opend);
+	delete _fileService;
+	for (IoShard_* const shard : _shards)
+	{
+		delete shard;
+	}
+	_shards.clear();
 #ifdef DISABLE_BOOST_TIMER
 #ifndef ENABLE_GLOBAL_TIMER
 	delete _waitableTimer;
@@ -228,6 +287,24 @@ io_engine::~io_engine()
 }
 
 void io_engine::run(size_t threads, sched policy)
+{
+	_run(threads, 0, policy, false);
+}
+
+void io_engine::runShard(size_t shards, sched policy)
+{
+	_run(shards, 0, policy, true);
+}
+
+void io_engine::runElastic(size_t minThreads, size_t maxThreads, int latencyUs, int idleMs, sched policy)
+{
+	assert(minThreads >= 1 && maxThreads >= minThreads && latencyUs > 0 && idleMs > 0);
+	_elasticLatency = latencyUs;
+	_elasticIdle = idleMs;
+	_run(minThreads, maxThreads, policy, false);
+}
+
+void io_engine::_run(size_t threads, size_t maxThreads, sched policy, bool shard)
 {
 	assert(threads >= 1);
 	std::lock_guard<std::mutex> lg(_runMutex);
@@ -235,8 +312,37 @@ void io_engine::run(size_t threads, sched policy)
 	{
 		_opend = true;
 		_runCount = 0;
+		if (shard)
+		{
+			//分片一直保留到io_engine析构，strand池中的strand仍然绑定在分片上
+			while (_shards.size() < threads)
+			{
+				const size_t i = _shards.size();
+				_shards.push_back(new IoShard_(*this, i, 0 == i ? &_ios : new boost::asio::io_service(1)));
+			}
+			for (IoShard_* const ele : _shards)
+			{
+				ele->resize_rings(_shards.size());
+			}
+			for (size_t i = 1; i < threads; i++)
+			{
+				_shards[i]->_work = new boost::asio::io_service::work(*_shards[i]->_ios);
+			}
+			_shardNum = threads;
+		}
 		holdWork();
-		_handleList.resize(threads);
+		//弹性模式下按最大线程数预留槽位，退出线程的槽位留给之后新增的线程
+		_elastic = 0 != maxThreads;
+		_elasticMin = threads;
+		_elasticMax = _elastic ? maxThreads : threads;
+		_threadCount = threads;
+		_handleList.resize(_elasticMax);
+		_slotUsed.assign(_elasticMax, false);
+		_freeSlots.clear();
+		for (size_t i = _elasticMax; i > threads; i--)
+		{
+			_freeSlots.push_back(i - 1);
+		}
 #ifdef __linux__
 		_policy = policy;
 #endif
@@ -248,107 +354,317 @@ void io_engine::run(size_t threads, sched policy)
 		{
 			run_thread* newThread = new run_thread([&, i]
 			{
-				try
 				{
+					initThreadHandle(i);
+					auto lockMutex = blockMutex;
+					auto lockConVar = blockConVar;
+					std::unique_lock<std::mutex> ul(*lockMutex);
+					if (threads == ++rc)
+					{
+						lockConVar->notify_all();
+					}
+					else
 					{
-						run_thread::set_current_thread_name(_title.c_str());
+						lockConVar->wait(ul);
+					}
+				}
+				threadRun(i, shard ? _shards[i] : NULL);
+			});
+			_ctrlMutex.lock();
+			_threadsID.insert(newThread->get_id());
+			_ctrlMutex.unlock();
+			_runThreads.push_back(newThread);
+		}
+		blockConVar->wait(ul);
+		if (_elastic)
+		{
+			_elasticExit = false;
+			_probePending = false;
+			_probeLatency = 0;
+			_retireReady = 0;
+			_retirePending = 0;
+			_elasticMonitor = new run_thread([this]
+			{
+				elasticMonitor();
+			});
+		}
+	}
+}
+
+void io_engine::initThreadHandle(size_t slot)
+{
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	run_thread::set_current_thread_name(_title.c_str());
+	_slotUsed[slot] = true;
 #ifdef WIN32
-						SetThreadPriority(GetCurrentThread(), _priority);
-						DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &_handleList[i], 0, FALSE, DUPLICATE_SAME_ACCESS);
+	SetThreadPriority(GetCurrentThread(), _priority);
+	DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &_handleList[slot], 0, FALSE, DUPLICATE_SAME_ACCESS);
 #elif __linux__
-						pthread_attr_init(&_handleList[i]);
-						pthread_attr_setschedpolicy(&_handleList[i], _policy);
-						if (0 == i)
-						{
-							struct sched_param pm;
-							int rs = pthread_attr_getschedparam(&_handleList[i], &pm);
-							_priority = (priority)pm.sched_priority;
-						}
+	pthread_attr_init(&_handleList[slot]);
+	pthread_attr_setschedpolicy(&_handleList[slot], _policy);
+	if (0 == slot)
+	{
+		struct sched_param pm;
+		int rs = pthread_attr_getschedparam(&_handleList[slot], &pm);
+		_priority = (priority)pm.sched_priority;
+	}
 #endif
-						auto lockMutex = blockMutex;
-						auto lockConVar = blockConVar;
-						std::unique_lock<std::mutex> ul(*lockMutex);
-						if (threads == ++rc)
-						{
-							lockConVar->notify_all();
-						}
-						else
-						{
-							lockConVar->wait(ul);
-						}
-					}
-					context_yield::convert_thread_to_fiber();
-					__space_align void* tlsBuff[64] = { 0 };
-					_tls->set_space(tlsBuff);
-					my_actor::tls_init();
-					generator::tls_init();
+}
+
+void io_engine::closeThreadHandle(size_t slot)
+{
+	assert(_slotUsed[slot]);
+	_slotUsed[slot] = false;
+#ifdef WIN32
+	CloseHandle(_handleList[slot]);
+#elif __linux__
+	pthread_attr_destroy(&_handleList[slot]);
+#endif
+}
+
+void io_engine::threadRun(size_t slot, IoShard_* shard)
+{
+	bool retired = false;
+	try
+	{
+		context_yield::convert_thread_to_fiber();
+		__space_align void* tlsBuff[64] = { 0 };
+		_tls->set_space(tlsBuff);
+		my_actor::tls_init();
+		generator::tls_init();
 #ifdef ASIO_HANDLER_ALLOCATE_EX
-					void* asioAll[5] =
-					{
-						new handler_alloc1(_poolSize),
-						new handler_alloc2(_poolSize / 2),
-						new handler_alloc3(_poolSize / 3),
-						new handler_alloc4(_poolSize / 4),
-						new handler_reu_alloc()
-					};
-					tlsBuff[ASIO_HANDLER_ALLOC_EX_INDEX] = asioAll;
+		void* asioAll[5] =
+		{
+			new handler_alloc1(_poolSize),
+			new handler_alloc2(_poolSize / 2),
+			new handler_alloc3(_poolSize / 3),
+			new handler_alloc4(_poolSize / 4),
+			new handler_reu_alloc()
+		};
+		tlsBuff[ASIO_HANDLER_ALLOC_EX_INDEX] = asioAll;
 #endif
-					safe_stack_info safeStack;
-					setTlsValue(ACTOR_SAFE_STACK_INDEX, &safeStack);
-					safeStack.ctx = context_yield::make_context(MAX_STACKSIZE, [](context_yield::context_info* ctx, void* param)
-					{
-						while (true)
-						{
-							context_yield::push_yield(ctx);
-							safe_stack_info* const safeStack = (safe_stack_info*)param;
-							CHECK_EXCEPTION(*safeStack->handler);
-						}
-					}, &safeStack);
+		boost::asio::io_service& runIos = shard ? *shard->_ios : _ios;
+		tlsBuff[IO_SHARD_TLS_INDEX] = shard;
+		tlsBuff[IO_ENGINE_TLS_INDEX] = this;
+#ifdef ENABLE_NEXT_TICK
+		long long coarseUs = time_source::tsc_us();
+		tlsBuff[TIME_COARSE_TLS_INDEX] = &coarseUs;
+#endif
+		safe_stack_info safeStack;
+		setTlsValue(ACTOR_SAFE_STACK_INDEX, &safeStack);
+		safeStack.ctx = context_yield::make_context(MAX_STACKSIZE, [](context_yield::context_info* ctx, void* param)
+		{
+			while (true)
+			{
+				context_yield::push_yield(ctx);
+				safe_stack_info* const safeStack = (safe_stack_info*)param;
+				CHECK_EXCEPTION(*safeStack->handler);
+			}
+		}, &safeStack);
 #if (__linux__ && ENABLE_DUMP_STACK)
-					__space_align char dumpStack[8 kB];
-					my_actor::dump_segmentation_fault(dumpStack, sizeof(dumpStack));
+		__space_align char dumpStack[8 kB];
+		my_actor::dump_segmentation_fault(dumpStack, sizeof(dumpStack));
+#endif
+#if (__linux__ && ENABLE_STACK_SAMPLING)
+		stack_sampler::thread_attach();
+#endif
+		if (_elastic)
+		{
+			retired = elasticRun();
+		}
+		else
+		{
+			_runCount += runIos.run();
+		}
+#if (__linux__ && ENABLE_STACK_SAMPLING)
+		stack_sampler::thread_detach();
 #endif
-					_runCount += _ios.run();
 #if (__linux__ && ENABLE_DUMP_STACK)
-					my_actor::undump_segmentation_fault();
+		my_actor::undump_segmentation_fault();
 #endif
-					context_yield::delete_context(safeStack.ctx);
+		context_yield::delete_context(safeStack.ctx);
 #ifdef ASIO_HANDLER_ALLOCATE_EX
-					delete (handler_alloc1*)asioAll[0];
-					delete (handler_alloc2*)asioAll[1];
-					delete (handler_alloc3*)asioAll[2];
-					delete (handler_alloc4*)asioAll[3];
-					delete (handler_reu_alloc*)asioAll[4];
+		delete (handler_alloc1*)asioAll[0];
+		delete (handler_alloc2*)asioAll[1];
+		delete (handler_alloc3*)asioAll[2];
+		delete (handler_alloc4*)asioAll[3];
+		delete (handler_reu_alloc*)asioAll[4];
 #endif
-					generator::tls_uninit();
-					my_actor::tls_uninit();
-					_tls->set_space(NULL);
-					context_yield::convert_fiber_to_thread();
-				}
-				catch (boost::exception&)
-				{
-					trace_line("\nerror: ", "boost::exception");
-					exit(2);
-				}
-				catch (std::exception&)
-				{
-					trace_line("\nerror: ", "std::exception");
-					exit(3);
-				}
-				catch (std::shared_ptr<std::string>& msg)
+		generator::tls_uninit();
+		my_actor::tls_uninit();
+		_tls->set_space(NULL);
+		context_yield::convert_fiber_to_thread();
+	}
+	catch (boost::exception&)
+	{
+		trace_line("\nerror: ", "boost::exception");
+		exit(2);
+	}
+	catch (std::exception&)
+	{
+		trace_line("\nerror: ", "std::exception");
+		exit(3);
+	}
+	catch (std::shared_ptr<std::string>& msg)
+	{
+		trace_line("\nerror: ", *msg);
+		exit(4);
+	}
+	catch (...)
+	{
+		exit(-1);
+	}
+	if (retired)
+	{
+		//线程对象由监控线程回收
+		std::lock_guard<std::mutex> lg(_ctrlMutex);
+		_threadsID.erase(run_thread::this_thread_id());
+		_retiredIDs.push_back(run_thread::this_thread_id());
+		closeThreadHandle(slot);
+		_freeSlots.push_back(slot);
+	}
+}
+
+bool io_engine::elasticRun()
+{
+	long long count = 0;
+	bool retired = false;
+	while (_ios.run_one())
+	{
+		count++;
+		size_t ready = _retireReady;
+		while (ready && !_retireReady.compare_exchange_weak(ready, ready - 1)) {}
+		if (ready)
+		{
+			//执行退出任务的线程(或紧随其后的线程)退出
+			_retirePending--;
+			_threadCount--;
+			_retireCount++;
+			retired = true;
+			break;
+		}
+	}
+	_runCount += count;
+	return retired;
+}
+
+void io_engine::elasticMonitor()
+{
+	run_thread::set_current_thread_name((_title + " elastic").c_str());
+	long long idleBegin = get_tick_us();
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> ul(_elasticMutex);
+			if (_elasticExit)
+			{
+				break;
+			}
+			_elasticVar.wait_for(ul, std::chrono::milliseconds(IO_ELASTIC_SAMPLE));
+			if (_elasticExit)
+			{
+				break;
+			}
+		}
+		reapRetired();
+		//探测任务从post到执行的延迟，上一个探测还未执行时以已等待的时长作为延迟
+		const long long now = get_tick_us();
+		long long latency = _probeLatency;
+		if (_probePending)
+		{
+			latency = std::max(latency, now - _probeTick);
+		}
+		else
+		{
+			_probePending = true;
+			_probeTick = now;
+			_ios.post([this]
+			{
+				_probeLatency = get_tick_us() - _probeTick;
+				_probePending = false;
+			});
+		}
+		_lastLatency = latency;
+		if (latency >= _elasticLatency)
+		{
+			idleBegin = now;
+			if (_threadCount < _elasticMax)
+			{
+				spawnThread();
+			}
+		}
+		else if (4 * latency >= _elasticLatency)
+		{
+			idleBegin = now;
+		}
+		else if (now - idleBegin >= 1000 * (long long)_elasticIdle)
+		{
+			idleBegin = now;
+			if (_threadCount - _retirePending > _elasticMin)
+			{
+				_retirePending++;
+				_ios.post([this]
 				{
-					trace_line("\nerror: ", *msg);
-					exit(4);
-				}
-				catch (...)
+					_retireReady++;
+				});
+			}
+		}
+	}
+	reapRetired();
+}
+
+void io_engine::spawnThread()
+{
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	if (_freeSlots.empty())
+	{
+		return;
+	}
+	const size_t slot = _freeSlots.back();
+	_freeSlots.pop_back();
+	_threadCount++;
+	_spawnCount++;
+	run_thread* newThread = new run_thread([this, slot]
+	{
+		initThreadHandle(slot);
+		threadRun(slot, NULL);
+	});
+	//新线程沿用已设置的处理器亲缘性
+	if (!_affinityMasks.empty())
+	{
+		newThread->mask_affinity(_affinityMasks[slot % _affinityMasks.size()]);
+	}
+	else if (_idealIndex >= 0)
+	{
+		newThread->set_ideal(_idealIndex);
+	}
+	_threadsID.insert(newThread->get_id());
+	_runThreads.push_back(newThread);
+}
+
+void io_engine::reapRetired()
+{
+	std::vector<run_thread*> retired;
+	{
+		std::lock_guard<std::mutex> lg(_ctrlMutex);
+		for (const run_thread::thread_id& id : _retiredIDs)
+		{
+			for (auto it = _runThreads.begin(); it != _runThreads.end(); ++it)
+			{
+				if ((*it)->get_id() == id)
 				{
-					exit(-1);
+					retired.push_back(*it);
+					_runThreads.erase(it);
+					break;
 				}
-			});
-			_threadsID.insert(newThread->get_id());
-			_runThreads.push_back(newThread);
+			}
 		}
-		blockConVar->wait(ul);
+		_retiredIDs.clear();
+	}
+	for (run_thread* const ele : retired)
+	{
+		ele->join();
+		delete ele;
 	}
 }
 
@@ -358,7 +674,27 @@ void io_engine::stop()
 	if (_opend)
 	{
 		assert(!runningInThisIos());
+		if (_elasticMonitor)
+		{
+			{
+				std::lock_guard<std::mutex> lg(_elasticMutex);
+				_elasticExit = true;
+				_elasticVar.notify_one();
+			}
+			_elasticMonitor->join();
+			delete _elasticMonitor;
+			_elasticMonitor = NULL;
+		}
+		if (_shardNum)
+		{
+			waitShardIdle();
+		}
 		releaseWork();
+		for (size_t i = 1; i < _shardNum; i++)
+		{
+			delete _shards[i]->_work;
+			_shards[i]->_work = NULL;
+		}
 		while (!_runThreads.empty())
 		{
 			_runThreads.front()->join();
@@ -366,18 +702,27 @@ void io_engine::stop()
 			_runThreads.pop_front();
 		}
 		_ios.reset();
-		_threadsID.clear();
+		for (size_t i = 1; i < _shardNum; i++)
+		{
+			_shards[i]->_ios->reset();
+		}
+		_shardNum = 0;
+		_threadCount = 0;
 		_ctrlMutex.lock();
-		for (auto& ele : _handleList)
+		_threadsID.clear();
+		for (size_t i = 0; i < _handleList.size(); i++)
 		{
-#ifdef WIN32
-			CloseHandle(ele);
-#elif __linux__
-			pthread_attr_destroy(&ele);
-#endif
+			if (_slotUsed[i])
+			{
+				closeThreadHandle(i);
+			}
 		}
 		_handleList.clear();
+		_slotUsed.clear();
+		_freeSlots.clear();
+		_retiredIDs.clear();
 		_ctrlMutex.unlock();
+		_elastic = false;
 		_opend = false;
 	}
 }
@@ -385,18 +730,97 @@ void io_engine::stop()
 bool io_engine::runningInThisIos()
 {
 	assert(_opend);
-	return _threadsID.find(run_thread::this_thread_id()) != _threadsID.end();
+	void** const tls = getTlsValueBuff();
+	return tls && this == tls[IO_ENGINE_TLS_INDEX];
 }
 
 size_t io_engine::ioThreads()
 {
 	assert(_opend);
-	return _threadsID.size();
+	return _threadCount;
+}
+
+bool io_engine::isElastic()
+{
+	return _elastic;
+}
+
+io_engine::elastic_stats io_engine::elasticStats()
+{
+	elastic_stats res;
+	res.threads = _threadCount;
+	res.minThreads = _elasticMin;
+	res.maxThreads = _elasticMax;
+	res.spawnCount = _spawnCount;
+	res.retireCount = _retireCount;
+	res.latencyUs = _lastLatency;
+	return res;
+}
+
+bool io_engine::isShard()
+{
+	return 0 != _shardNum;
+}
+
+size_t io_engine::shardCount()
+{
+	return _shardNum;
+}
+
+size_t io_engine::currentShard()
+{
+	IoShard_* const shard = tlsShard();
+	return shard && this == &shard->_engine ? shard->_index : -1;
+}
+
+size_t io_engine::pickShard()
+{
+	const size_t shards = _shardNum;
+	return shards ? _shardRound++ % shards : 0;
+}
+
+void io_engine::waitShardIdle()
+{
+	//分片之间会互相投递，先退出的分片会丢掉之后投递给它的任务，
+	//所以要等所有分片的环形队列和未完成任务都清空后才能一起释放work；
+	//连续两轮检查都空闲，并且期间没有分片执行过drain，才认为已经清空
+	int stable = 0;
+	while (stable < 2)
+	{
+		size_t drains = 0;
+		for (size_t i = 0; i < _shardNum; i++)
+		{
+			drains += _shards[i]->_drainCount.load(std::memory_order_acquire);
+		}
+		bool idle = true;
+		for (size_t i = 0; i < _shardNum && idle; i++)
+		{
+			idle = _shards[i]->idle();
+		}
+		for (size_t i = 0; i < _shardNum; i++)
+		{
+			drains -= _shards[i]->_drainCount.load(std::memory_order_acquire);
+		}
+		stable = idle && !drains ? stable + 1 : 0;
+		if (stable < 2)
+		{
+			run_thread::sleep(1);
+		}
+	}
+}
+
+IoShard_* io_engine::tlsShard()
+{
+	void** const tls = getTlsValueBuff();
+	return tls ? (IoShard_*)tls[IO_SHARD_TLS_INDEX] : NULL;
 }
 
 bool io_engine::ioIdeal(int i)
 {
 	assert(_opend);
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	_idealIndex = i;
+	_affinityMasks.clear();
 	for (auto& ele : _runThreads)
 	{
 		if (!ele->set_ideal(i))
@@ -410,7 +834,13 @@ bool io_engine::ioIdeal(int i)
 bool io_engine::ioAffinity(const std::initializer_list<int>& indexes)
 {
 	assert(_opend);
-	assert(indexes.size() == _threadsID.size());
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	assert(_elastic ? 0 != indexes.size() : indexes.size() == _threadsID.size());
+	_affinityMasks.clear();
+	for (auto& ele : indexes)
+	{
+		_affinityMasks.push_back((unsigned long long)1 << ele);
+	}
 	auto it = indexes.begin();
 	for (auto& ele : _runThreads)
 	{
@@ -418,7 +848,10 @@ bool io_engine::ioAffinity(const std::initializer_list<int>& indexes)
 		{
 			return false;
 		}
-		++it;
+		if (indexes.end() == ++it)
+		{
+			it = indexes.begin();
+		}
 	}
 	return true;
 }
@@ -426,7 +859,13 @@ bool io_engine::ioAffinity(const std::initializer_list<int>& indexes)
 bool io_engine::ioAffinity(const std::vector<int>& indexes)
 {
 	assert(_opend);
-	assert(indexes.size() == _threadsID.size());
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	assert(_elastic ? 0 != indexes.size() : indexes.size() == _threadsID.size());
+	_affinityMasks.clear();
+	for (auto& ele : indexes)
+	{
+		_affinityMasks.push_back((unsigned long long)1 << ele);
+	}
 	auto it = indexes.begin();
 	for (auto& ele : _runThreads)
 	{
@@ -434,7 +873,10 @@ bool io_engine::ioAffinity(const std::vector<int>& indexes)
 		{
 			return false;
 		}
-		++it;
+		if (indexes.end() == ++it)
+		{
+			it = indexes.begin();
+		}
 	}
 	return true;
 }
@@ -442,7 +884,13 @@ bool io_engine::ioAffinity(const std::vector<int>& indexes)
 bool io_engine::ioAffinityMask(const std::initializer_list<unsigned long long>& masks)
 {
 	assert(_opend);
-	assert(masks.size() == _threadsID.size());
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	assert(_elastic ? 0 != masks.size() : masks.size() == _threadsID.size());
+	_affinityMasks.clear();
+	for (auto& ele : masks)
+	{
+		_affinityMasks.push_back(ele);
+	}
 	auto it = masks.begin();
 	for (auto& ele : _runThreads)
 	{
@@ -450,7 +898,10 @@ bool io_engine::ioAffinityMask(const std::initializer_list<unsigned long long>&
 		{
 			return false;
 		}
-		++it;
+		if (masks.end() == ++it)
+		{
+			it = masks.begin();
+		}
 	}
 	return true;
 }
@@ -458,7 +909,13 @@ bool io_engine::ioAffinityMask(const std::initializer_list<unsigned long long>&
 bool io_engine::ioAffinityMask(const std::vector<unsigned long long>& masks)
 {
 	assert(_opend);
-	assert(masks.size() == _threadsID.size());
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
+	assert(_elastic ? 0 != masks.size() : masks.size() == _threadsID.size());
+	_affinityMasks.clear();
+	for (auto& ele : masks)
+	{
+		_affinityMasks.push_back(ele);
+	}
 	auto it = masks.begin();
 	for (auto& ele : _runThreads)
 	{
@@ -466,7 +923,10 @@ bool io_engine::ioAffinityMask(const std::vector<unsigned long long>& masks)
 		{
 			return false;
 		}
-		++it;
+		if (masks.end() == ++it)
+		{
+			it = masks.begin();
+		}
 	}
 	return true;
 }
@@ -495,18 +955,24 @@ void io_engine::runPriority(priority pri)
 	std::lock_guard<std::mutex> lg(_ctrlMutex);
 #ifdef WIN32
 	_priority = pri;
-	for (auto& ele : _handleList)
+	for (size_t i = 0; i < _handleList.size(); i++)
 	{
-		SetThreadPriority(ele, _priority);
+		if (_slotUsed[i])
+		{
+			SetThreadPriority(_handleList[i], _priority);
+		}
 	}
 #elif __linux__
 	if (sched_fifo == _policy || sched_rr == _policy)
 	{
 		_priority = pri;
 		struct sched_param pm = { pri };
-		for (auto& ele : _handleList)
+		for (size_t i = 0; i < _handleList.size(); i++)
 		{
-			pthread_attr_setschedparam(&ele, &pm);
+			if (_slotUsed[i])
+			{
+				pthread_attr_setschedparam(&_handleList[i], &pm);
+			}
 		}
 	}
 #endif
@@ -522,8 +988,9 @@ long long io_engine::getRunCount()
 	return _runCount;
 }
 
-const std::set<run_thread::thread_id>& io_engine::threadsID()
+std::set<run_thread::thread_id> io_engine::threadsID()
 {
+	std::lock_guard<std::mutex> lg(_ctrlMutex);
 	return _threadsID;
 }
 
@@ -537,6 +1004,25 @@ io_engine::operator boost::asio::io_service&() const
 	return (boost::asio::io_service&)_ios;
 }
 
+boost::asio::io_service& io_engine::shardService(size_t shard)
+{
+	if (shard && shard < _shards.size())
+	{
+		return *_shards[shard]->_ios;
+	}
+	return _ios;
+}
+
+boost::asio::io_service& io_engine::currentShardService()
+{
+	IoShard_* const shard = tlsShard();
+	if (shard && this == &shard->_engine)
+	{
+		return *shard->_ios;
+	}
+	return _ios;
+}
+
 void io_engine::setTlsBuff(void** buf)
 {
 	_tls->set_space(buf);
@@ -575,6 +1061,160 @@ void** io_engine::getTlsValueBuff()
 }
 //////////////////////////////////////////////////////////////////////////
 
+ShardRing_::ShardRing_()
+:_head(0), _tail(0), _overflowing(false), _overflowHead(NULL), _overflowTail(NULL) {}
+
+ShardRing_::~ShardRing_()
+{
+	for (size_t head = _head; head != _tail; head++)
+	{
+		delete _buffer[head % IO_SHARD_RING_SIZE];
+	}
+	while (_overflowHead)
+	{
+		ShardOp_* const op = _overflowHead;
+		_overflowHead = op->_next;
+		delete op;
+	}
+}
+
+void ShardRing_::push(ShardOp_* op)
+{
+	if (!_overflowing.load(std::memory_order_acquire))
+	{
+		const size_t tail = _tail.load(std::memory_order_relaxed);
+		if (tail - _head.load(std::memory_order_acquire) < IO_SHARD_RING_SIZE)
+		{
+			_buffer[tail % IO_SHARD_RING_SIZE] = op;
+			_tail = tail + 1;
+			return;
+		}
+	}
+	//环满了，之后的投递都进入溢出队列，直到消费者清空环和溢出队列
+	op->_next = NULL;
+	std::lock_guard<std::mutex> lg(_overflowMutex);
+	if (_overflowTail)
+	{
+		_overflowTail->_next = op;
+	}
+	else
+	{
+		_overflowHead = op;
+	}
+	_overflowTail = op;
+	_overflowing.store(true, std::memory_order_release);
+}
+
+bool ShardRing_::drain()
+{
+	size_t head = _head.load(std::memory_order_relaxed);
+	size_t tail = _tail;
+	for (; head != tail; head++)
+	{
+		ShardOp_* const op = _buffer[head % IO_SHARD_RING_SIZE];
+		_head.store(head + 1, std::memory_order_release);
+		op->invoke();
+	}
+	if (_overflowing.load(std::memory_order_acquire))
+	{
+		//溢出期间生产者不再写环，先执行完环中剩余的，再接上溢出队列
+		for (tail = _tail; head != tail; head++)
+		{
+			ShardOp_* const op = _buffer[head % IO_SHARD_RING_SIZE];
+			_head.store(head + 1, std::memory_order_release);
+			op->invoke();
+		}
+		_overflowMutex.lock();
+		ShardOp_* op = _overflowHead;
+		_overflowHead = _overflowTail = NULL;
+		_overflowing.store(false, std::memory_order_release);
+		_overflowMutex.unlock();
+		while (op)
+		{
+			ShardOp_* const next = op->_next;
+			op->invoke();
+			op = next;
+		}
+	}
+	return head != _tail;
+}
+//////////////////////////////////////////////////////////////////////////
+
+IoShard_::IoShard_(io_engine& engine, size_t index, boost::asio::io_service* ios)
+:_engine(engine), _ios(ios), _work(NULL), _notified(false), _drainCount(0), _index(index), _ownIos(ios != &engine._ios) {}
+
+IoShard_::~IoShard_()
+{
+	assert(!_work);
+	for (ShardRing_* const ring : _rings)
+	{
+		delete ring;
+	}
+	if (_ownIos)
+	{
+		delete _ios;
+	}
+}
+
+void IoShard_::resize_rings(size_t shards)
+{
+	while (_rings.size() < shards)
+	{
+		_rings.push_back(new ShardRing_());
+	}
+}
+
+void IoShard_::push(size_t fromIndex, ShardOp_* op)
+{
+	assert(fromIndex < _rings.size() && fromIndex != _index);
+	_rings[fromIndex]->push(op);
+	if (!_notified.exchange(true))
+	{
+		_ios->post([this]
+		{
+			drain();
+		});
+	}
+}
+
+bool IoShard_::idle()
+{
+	if (_notified)
+	{
+		return false;
+	}
+	for (ShardRing_* const ring : _rings)
+	{
+		if (ring->_head != ring->_tail || ring->_overflowing)
+		{
+			return false;
+		}
+	}
+	//除了分片自己保留的work(0号分片是holdWork)，没有其它未完成任务
+	long count = 0;
+	_ios->dispatch(boost::asio::io_service_work_outstanding{ &count });
+	return 1 == count;
+}
+
+void IoShard_::drain()
+{
+	_drainCount.store(_drainCount.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	_notified = false;
+	bool more = false;
+	for (ShardRing_* const ring : _rings)
+	{
+		more |= ring->drain();
+	}
+	if (more && !_notified.exchange(true))
+	{
+		_ios->post([this]
+		{
+			drain();
+		});
+	}
+}
+//////////////////////////////////////////////////////////////////////////
+
 io_work::io_work(io_engine& ios)
 :_ios(ios)
 {
@@ -16,14 +16,104 @@
 
 class my_actor;
 class boost_strand;
+class async_file;
+class FileIoService_;
+class io_engine;
+class IoShard_;
 #ifdef DISABLE_BOOST_TIMER
 class WaitableTimer_;
 class WaitableTimerEvent_;
 #endif
 
+//分片模式下每对分片间的投递环形队列长度
+#ifndef IO_SHARD_RING_SIZE
+#define IO_SHARD_RING_SIZE 1024
+#endif
+
+//弹性模式下触发增加线程的排队延迟(微秒)
+#ifndef IO_ELASTIC_LATENCY
+#define IO_ELASTIC_LATENCY 1000
+#endif
+
+//弹性模式下持续空闲多久后减少一个线程(毫秒)
+#ifndef IO_ELASTIC_IDLE
+#define IO_ELASTIC_IDLE 3000
+#endif
+
+//弹性模式下排队延迟采样周期(毫秒)
+#ifndef IO_ELASTIC_SAMPLE
+#define IO_ELASTIC_SAMPLE 5
+#endif
+
+/*!
+@brief 跨分片投递的任务
+*/
+struct ShardOp_
+{
+	ShardOp_() :_next(NULL) {}
+	virtual ~ShardOp_() __disable_noexcept {}
+	virtual void invoke() = 0;//执行后释放自身
+
+	ShardOp_* _next;
+};
+
+/*!
+@brief 分片间单生产者单消费者环形队列，满了以后暂存到溢出队列，保持投递顺序
+*/
+class ShardRing_
+{
+	friend IoShard_;
+private:
+	ShardRing_();
+	~ShardRing_();
+private:
+	void push(ShardOp_* op);
+	bool drain();
+private:
+	std::atomic<size_t> _head;///<消费者位置
+	char _headPad[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<size_t> _tail;///<生产者位置
+	char _tailPad[64 - sizeof(std::atomic<size_t>)];
+	std::atomic<bool> _overflowing;
+	std::mutex _overflowMutex;
+	ShardOp_* _overflowHead;
+	ShardOp_* _overflowTail;
+	ShardOp_* _buffer[IO_SHARD_RING_SIZE];
+	NONE_COPY(ShardRing_);
+};
+
+/*!
+@brief 分片，拥有一个只由一个线程运行的io_service，绑定在该分片上的strand都在这个线程中执行
+*/
+class IoShard_
+{
+	friend io_engine;
+	friend boost_strand;
+private:
+	IoShard_(io_engine& engine, size_t index, boost::asio::io_service* ios);
+	~IoShard_();
+private:
+	void push(size_t fromIndex, ShardOp_* op);
+	void drain();
+	void resize_rings(size_t shards);
+	bool idle();
+private:
+	io_engine& _engine;
+	boost::asio::io_service* _ios;
+	boost::asio::io_service::work* _work;
+	std::vector<ShardRing_*> _rings;///<按生产者分片索引
+	std::atomic<bool> _notified;///<已经投递了唤醒
+	std::atomic<size_t> _drainCount;///<drain次数，只由本分片线程写
+	const size_t _index;
+	const bool _ownIos;
+	NONE_COPY(IoShard_);
+};
+
 class io_engine
 {
 	friend boost_strand;
+	friend async_file;
+	friend IoShard_;
 #ifdef DISABLE_BOOST_TIMER
 	friend WaitableTimerEvent_;
 #endif
@@ -65,40 +155,94 @@ public:
 		sched_other = SCHED_OTHER
 	};
 #endif
+
+	struct elastic_stats
+	{
+		size_t threads;///<当前线程数
+		size_t minThreads;///<最少线程数
+		size_t maxThreads;///<最多线程数
+		size_t spawnCount;///<累计增加的线程数
+		size_t retireCount;///<累计退出的线程数
+		long long latencyUs;///<最近一次采样的排队延迟(微秒)
+	};
 public:
 	io_engine(bool enableTimer = true, const char* title = NULL);
 	io_engine(size_t poolSize, bool enableTimer = true, const char* title = NULL);
 	~io_engine();
 public:
 	/*!
-	@brief ʼеϺ
-	@param threads ߳
-	@param policy ̵߳Ȳ(linuxЧwinº)
+	@brief 开始运行调度器，非阻塞，启动完毕后立即返回
+	@param threads 调度器并发线程数
+	@param policy 线程调度策略(linux下有效，win下忽略)
 	*/
 	void run(size_t threads = 1, sched policy = sched_other);
 
 	/*!
-	@brief ȴʱ
+	@brief 以分片模式开始运行调度器，每个线程一个独立io_service，strand在创建时绑定到一个分片，
+	跨分片投递通过分片间环形队列批量唤醒
+	@param shards 分片数(线程数)
+	@param policy 线程调度策略(linux下有效，win下忽略)
+	*/
+	void runShard(size_t shards = run_thread::cpu_thread_number(), sched policy = sched_other);
+
+	/*!
+	@brief 以弹性模式开始运行调度器，线程数在[minThreads, maxThreads]间随负载变化，
+	任务从post到执行的排队延迟超过latencyUs时增加线程，延迟持续低于latencyUs/4达idleMs后退出一个线程
+	@param minThreads 最少线程数(启动线程数)
+	@param maxThreads 最多线程数
+	@param latencyUs 触发增加线程的排队延迟(微秒)
+	@param idleMs 持续空闲多久后减少一个线程(毫秒)
+	@param policy 线程调度策略(linux下有效，win下忽略)
+	*/
+	void runElastic(size_t minThreads, size_t maxThreads, int latencyUs = IO_ELASTIC_LATENCY, int idleMs = IO_ELASTIC_IDLE, sched policy = sched_other);
+
+	/*!
+	@brief 等待调度器中无任务时返回
 	*/
 	void stop();
 
 	/*!
-	@brief ⵱ǰǷڱִ
+	@brief 检测当前函数是否在本调度器中执行
 	*/
 	bool runningInThisIos();
 
 	/*!
-	@brief ߳
+	@brief 调度器线程数(弹性模式下为当前线程数)
 	*/
 	size_t ioThreads();
 
 	/*!
-	@brief ȴ
+	@brief 是否运行在弹性模式
+	*/
+	bool isElastic();
+
+	/*!
+	@brief 弹性模式统计
+	*/
+	elastic_stats elasticStats();
+
+	/*!
+	@brief 是否运行在分片模式
+	*/
+	bool isShard();
+
+	/*!
+	@brief 分片数，非分片模式为0
+	*/
+	size_t shardCount();
+
+	/*!
+	@brief 当前线程所在分片索引，不在本调度器分片线程中返回-1
+	*/
+	size_t currentShard();
+
+	/*!
+	@brief 设置优先处理器
 	*/
 	bool ioIdeal(int i);
 
 	/*!
-	@brief ôԵ
+	@brief 设置处理器亲缘性(弹性模式下依次循环分配给各线程，之后新增的线程沿用)
 	*/
 	bool ioAffinity(const std::initializer_list<int>& indexes);
 	bool ioAffinity(const std::vector<int>& indexes);
@@ -106,34 +250,34 @@ public:
 	bool ioAffinityMask(const std::vector<unsigned long long>& masks);
 
 	/*!
-	@brief Ȼ˳
+	@brief 锁定调度器自然退出
 	*/
 	void holdWork();
 
 	/*!
-	@brief ͷŵȻ˳
+	@brief 释放调度器自然退出
 	*/
 	void releaseWork();
 
 	/*!
-	@brief ߳ȼãlinux sched_fifo, sched_rr Ч 
+	@brief 调度器线程优先级设置，（linux下 sched_fifo, sched_rr 有效 ）
 	*/
 	void runPriority(priority pri);
 
 	/*!
-	@brief ȡǰȼ
+	@brief 获取当前调度器优先级
 	*/
 	priority getPriority();
 
 	/*!
-	@brief ȡδrun()stop()ĵ
+	@brief 获取调度器本次从run()到stop()后的迭代次数
 	*/
 	long long getRunCount();
 
 	/*!
-	@brief ߳ID
+	@brief 运行线程ID的拷贝(弹性模式下会随线程增减变化)
 	*/
-	const std::set<run_thread::thread_id>& threadsID();
+	std::set<run_thread::thread_id> threadsID();
 
 	/*!
 	@brief ios title
@@ -141,56 +285,78 @@ public:
 	const std::string& title();
 
 	/*!
-	@brief 
+	@brief 调度器对象引用(总是主io_service，分片模式下即0号分片)
 	*/
 	operator boost::asio::io_service& () const;
 
 	/*!
-	@brief лһȫջִ
+	@brief 分片的io_service，非分片模式下都返回主io_service
+	*/
+	boost::asio::io_service& shardService(size_t shard);
+
+	/*!
+	@brief 当前分片线程所在分片的io_service，不在本调度器的分片线程中返回主io_service
+	*/
+	boost::asio::io_service& currentShardService();
+
+	/*!
+	@brief 切换到一个安全栈内执行
 	*/
 	void switchInvoke(wrap_local_handler_face<void()>* handler);
 
 	/*!
-	@brief ڷios߳гʼһtlsռ
+	@brief 在非ios线程中初始化一个tls空间
 	*/
 	static void setTlsBuff(void** buf);
 
 	/*!
-	@brief ȡtlsֵ
+	@brief 获取tls值
 	@param 0 <= i < 64
 	*/
 	static void* getTlsValue(int i);
 
 	/*!
-	@brief ȡtlsֵ
+	@brief 获取tls值引用
 	@param 0 <= i < 64
 	*/
 	static void*& getTlsValueRef(int i);
 
 	/*!
-	@brief tlsֵ
+	@brief 设置tls值
 	@param 0 <= i < 64
 	*/
 	static void setTlsValue(int i, void* val);
 
 	/*!
-	@brief tlsֵ
+	@brief 交换tls值
 	@param 0 <= i < 64
 	*/
 	static void* swapTlsValue(int i, void* val);
 
 	/*!
-	@brief ȡtlsռ
+	@brief 获取tls变量空间
 	*/
 	static void** getTlsValueBuff();
 private:
 	friend my_actor;
 	static void install();
 	static void uninstall();
+	void _run(size_t threads, size_t maxThreads, sched policy, bool shard);
+	void initThreadHandle(size_t slot);
+	void closeThreadHandle(size_t slot);
+	void threadRun(size_t slot, IoShard_* shard);
+	bool elasticRun();
+	void elasticMonitor();
+	void spawnThread();
+	void reapRetired();
+	size_t pickShard();
+	void waitShardIdle();
+	static IoShard_* tlsShard();
 private:
 	bool _opend;
 	size_t _poolSize;
 	shared_obj_pool<boost_strand>* _strandPool;
+	FileIoService_* _fileService;
 #ifdef DISABLE_BOOST_TIMER
 #ifdef ENABLE_GLOBAL_TIMER
 	static WaitableTimer_* _waitableTimer;
@@ -203,6 +369,9 @@ private:
 	std::mutex _runMutex;
 	std::mutex _ctrlMutex;
 	std::atomic<long long> _runCount;
+	std::atomic<size_t> _shardRound;
+	size_t _shardNum;///<运行中的分片数，0为非分片模式
+	std::vector<IoShard_*> _shards;
 	std::set<run_thread::thread_id> _threadsID;
 	std::list<run_thread*> _runThreads;
 	boost::asio::io_service _ios;
@@ -212,6 +381,29 @@ private:
 	sched _policy;
 	std::vector<pthread_attr_t> _handleList;
 #endif
+	std::vector<bool> _slotUsed;///<_handleList中正在使用的槽位
+	std::vector<size_t> _freeSlots;
+	std::vector<run_thread::thread_id> _retiredIDs;///<已退出待回收的弹性线程
+	std::vector<unsigned long long> _affinityMasks;
+	int _idealIndex;
+	bool _elastic;
+	size_t _elasticMin;
+	size_t _elasticMax;
+	std::atomic<int> _elasticLatency;
+	std::atomic<int> _elasticIdle;
+	std::atomic<size_t> _threadCount;
+	std::atomic<size_t> _spawnCount;
+	std::atomic<size_t> _retireCount;
+	std::atomic<size_t> _retireReady;///<已执行待认领的退出任务数
+	std::atomic<size_t> _retirePending;///<已投递未完成的退出任务数
+	std::atomic<bool> _probePending;
+	std::atomic<long long> _probeTick;
+	std::atomic<long long> _probeLatency;
+	std::atomic<long long> _lastLatency;
+	bool _elasticExit;
+	std::mutex _elasticMutex;
+	std::condition_variable _elasticVar;
+	run_thread* _elasticMonitor;
 	static tls_space* _tls;
 	NONE_COPY(io_engine);
 };
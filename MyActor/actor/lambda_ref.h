@@ -3,7 +3,7 @@
 
 #include "stack_object.h"
 
-//ûǶlambdaⲿò񣬿ԼСֱ"&"sizeof(lambda)ĴСߵЧ
+//用户内嵌lambda的外部变量引用捕获，可以减小直接"&捕获"sizeof(lambda)的大小，提高调度效率
 #define LAMBDA_REF1(__NAME__, __P0__)\
 	typedef decltype(__P0__) _BOND_LR_(type0, __LINE__); \
 struct\
@@ -174,7 +174,7 @@ struct\
 } __NAME__ = { __P0__, __P1__, __P2__, __P3__, __P4__, __P5__, __P6__, __P7__, __P8__, __P9__ };
 //////////////////////////////////////////////////////////////////////////
 
-//ûǶlambdaⲿòǰthisͨ->ʣԼСֱ"&"sizeof(lambda)ĴСߵЧ
+//用户内嵌lambda的外部变量引用捕获（外带当前this捕获，通过->访问），可以减小直接"&捕获"sizeof(lambda)的大小，提高调度效率
 #define LAMBDA_THIS_REF1(__NAME__, __P0__)\
 	typedef decltype(this) this_type; \
 	typedef decltype(__P0__) _BOND_LR_(type0, __LINE__); \
@@ -395,9 +395,9 @@ struct\
 #define _BOND_LR(a, b) a##b
 #define _BOND_LR_(a, b) _BOND_LR(a, b)
 #define _BOND_LR__(a, b) _BOND_LR_(a, b)
-//ûǶlambdaⲿò񣬿ԼСֱ"&"sizeof(lambda)ĴСߵЧ
+//用户内嵌lambda的外部变量引用捕获，可以减小直接"&捕获"sizeof(lambda)的大小，提高调度效率
 #define LAMBDA_REF(__NAME__, ...) _BOND_LR__(LAMBDA_REF, _PP_NARG(__VA_ARGS__))(__NAME__, __VA_ARGS__)
-//ûǶlambdaⲿòǰthisͨ->ʣԼСֱ"&"sizeof(lambda)ĴСߵЧ
+//用户内嵌lambda的外部变量引用捕获（外带当前this捕获，通过->访问），可以减小直接"&捕获"sizeof(lambda)的大小，提高调度效率
 #define LAMBDA_THIS_REF(__NAME__, ...) _BOND_LR__(LAMBDA_THIS_REF, _PP_NARG(__VA_ARGS__))(__NAME__, __VA_ARGS__)
 
 //////////////////////////////////////////////////////////////////////////
@@ -7,6 +7,22 @@
 #include <atomic>
 #include "try_move.h"
 #include "scattered.h"
+#ifdef ENABLE_HUGE_PAGE
+#include "huge_page.h"
+#endif
+
+//固定尺寸内存池节点的分配，ENABLE_HUGE_PAGE下从大页slab中切取
+#ifdef ENABLE_HUGE_PAGE
+#define POOL_NODE_ALLOC(__size__) huge_page::node_alloc(__size__)
+#define POOL_NODE_FREE(__p__, __size__) huge_page::node_free(__p__, __size__)
+#define POOL_BLOCK_ALLOC(__size__) huge_page::block_alloc(__size__)
+#define POOL_BLOCK_FREE(__p__, __size__) huge_page::block_free(__p__, __size__)
+#else
+#define POOL_NODE_ALLOC(__size__) malloc(__size__)
+#define POOL_NODE_FREE(__p__, __size__) free(__p__)
+#define POOL_BLOCK_ALLOC(__size__) malloc(__size__)
+#define POOL_BLOCK_FREE(__p__, __size__) free(__p__)
+#endif
 
 struct null_mutex
 {
@@ -186,7 +202,7 @@ struct mem_alloc_mt : protected MUTEX, public mem_alloc_face
 			_nodeCount--;
 			node_space* t = pIt;
 			pIt = pIt->_buff._link;
-			free(t);
+			POOL_NODE_FREE(t, sizeof(node_space));
 		}
 		assert(0 == _nodeCount);
 	}
@@ -212,7 +228,7 @@ struct mem_alloc_mt : protected MUTEX, public mem_alloc_face
 			}
 			MUTEX::unlock();
 		}
-		node_space* p = (node_space*)malloc(sizeof(node_space));
+		node_space* p = (node_space*)POOL_NODE_ALLOC(sizeof(node_space));
 		p->set_head();
 		return p->get_ptr();
 	}
@@ -233,7 +249,7 @@ struct mem_alloc_mt : protected MUTEX, public mem_alloc_face
 				return;
 			}
 		}
-		free(space);
+		POOL_NODE_FREE(space, sizeof(node_space));
 	}
 
 	size_t alloc_size() const
@@ -295,7 +311,8 @@ struct mem_alloc_mt2 : protected MUTEX, public mem_alloc_face
 		_freeNumber = 0;
 		_pool = NULL;
 		static_assert(sizeof(node_space) % sizeof(void*) == 0, "");
-		_pblock = (node_space*)malloc(sizeof(node_space) * poolSize);
+		_pblockCount = poolSize;
+		_pblock = (node_space*)POOL_BLOCK_ALLOC(sizeof(node_space) * poolSize);
 		for (size_t i = 0; i < poolSize; i++)
 		{
 			node_space* t = _pool;
@@ -317,10 +334,10 @@ struct mem_alloc_mt2 : protected MUTEX, public mem_alloc_face
 			pIt = pIt->_buff._link;
 			if (t < _pblock || t >= _pblock + _poolMaxSize)
 			{
-				free(t);
+				POOL_NODE_FREE(t, sizeof(node_space));
 			}
 		}
-		free(_pblock);
+		POOL_BLOCK_FREE(_pblock, sizeof(node_space) * _pblockCount);
 		assert(0 == _nodeCount);
 	}
 
@@ -345,7 +362,7 @@ struct mem_alloc_mt2 : protected MUTEX, public mem_alloc_face
 			}
 			MUTEX::unlock();
 		}
-		node_space* p = (node_space*)malloc(sizeof(node_space));
+		node_space* p = (node_space*)POOL_NODE_ALLOC(sizeof(node_space));
 		p->set_head();
 		return p->get_ptr();
 	}
@@ -366,7 +383,7 @@ struct mem_alloc_mt2 : protected MUTEX, public mem_alloc_face
 				return;
 			}
 		}
-		free(space);
+		POOL_NODE_FREE(space, sizeof(node_space));
 	}
 
 	size_t alloc_size() const
@@ -381,6 +398,7 @@ struct mem_alloc_mt2 : protected MUTEX, public mem_alloc_face
 
 	node_space* _pblock;
 	node_space* _pool;
+	size_t _pblockCount;
 };
 
 struct ReuMemMt_
@@ -551,7 +569,7 @@ struct MemTlsNode_
 		{
 			node_space* t = _pool;
 			_pool = _pool->_buff._link;
-			free(t);
+			POOL_NODE_FREE(t, sizeof(node_space));
 		}
 	}
 
@@ -573,7 +591,7 @@ struct MemTlsNode_
 				return fixedSpace->get_ptr();
 			}
 		}
-		node_space* p = (node_space*)malloc(sizeof(node_space));
+		node_space* p = (node_space*)POOL_NODE_ALLOC(sizeof(node_space));
 		p->set_head();
 		return p->get_ptr();
 	}
@@ -593,7 +611,7 @@ struct MemTlsNode_
 				return;
 			}
 		}
-		free(space);
+		POOL_NODE_FREE(space, sizeof(node_space));
 	}
 
 	node_space* _pool;
@@ -715,7 +733,7 @@ struct mem_alloc_tls: public mem_alloc_base
 		{
 			return ((alloc_type*)tlsSpace[TLS_INDEX])->allocate();
 		}
-		node_space* p = (node_space*)malloc(sizeof(node_space));
+		node_space* p = (node_space*)POOL_NODE_ALLOC(sizeof(node_space));
 		p->set_head();
 		return p->get_ptr();
 	}
@@ -730,7 +748,7 @@ struct mem_alloc_tls: public mem_alloc_base
 		}
 		else
 		{
-			free(node_space::get_node(p));
+			POOL_NODE_FREE(node_space::get_node(p), sizeof(node_space));
 		}
 	}
 
@@ -45,6 +45,38 @@ public:
 		END_CHECK_EXCEPTION;
 	}
 
+	/*!
+	@brief 插入到第pos个元素之前(pos为0时同push_front，为size()时同push_back)
+	*/
+	template <typename... Args>
+	void insert(size_t pos, Args&&... args)
+	{
+		assert(pos <= _size);
+		if (0 == pos)
+		{
+			push_front(std::forward<Args>(args)...);
+		}
+		else if (_size == pos)
+		{
+			push_back(std::forward<Args>(args)...);
+		}
+		else
+		{
+			BEGIN_CHECK_EXCEPTION;
+			node* newNode = as_ptype<node>(_alloc.allocate());
+			new(newNode->_data)T(std::forward<Args>(args)...);
+			node* prev = _head;
+			while (--pos)
+			{
+				prev = prev->_next;
+			}
+			newNode->_next = prev->_next;
+			prev->_next = newNode;
+			_size++;
+			END_CHECK_EXCEPTION;
+		}
+	}
+
 	T& front()
 	{
 		assert(_size && _head);
@@ -580,6 +612,26 @@ public:
 		_index = i;
 		_size++;
 	}
+
+	/*!
+	@brief 插入到距队首第pos个元素之前，队首的pos个元素依次前移一位
+	*/
+	template <typename Arg>
+	void insert(size_t pos, Arg&& arg)
+	{
+		assert(!full() && pos <= _size);
+		size_t dst = _index + _size;
+		for (; pos; pos--)
+		{
+			node& dstNode = _buffer[(dst < _maxSize) ? dst : (dst - _maxSize)];
+			dst--;
+			node& srcNode = _buffer[(dst < _maxSize) ? dst : (dst - _maxSize)];
+			dstNode.set(std::move(srcNode.get()));
+			srcNode.destroy();
+		}
+		_buffer[(dst < _maxSize) ? dst : (dst - _maxSize)].set(std::forward<Arg>(arg));
+		_size++;
+	}
 private:
 	size_t _maxSize;
 	size_t _size;
@@ -646,6 +698,13 @@ public:
 		assert(!full());
 		_size++;
 	}
+
+	template <typename... Args>
+	void insert(size_t pos, Args&&...)
+	{
+		assert(!full() && pos <= _size);
+		_size++;
+	}
 private:
 	size_t _maxSize;
 	size_t _size;
@@ -53,6 +53,63 @@ struct autoActorStackMng
 	_shared_mutex _mutex;
 };
 
+#ifdef ENABLE_ACTOR_PROFILE
+//运行中的Actor在让出时每隔多久(us)向汇总表提交一次增量统计
+#ifndef ACTOR_PROFILE_COMMIT_US
+#define ACTOR_PROFILE_COMMIT_US 1000000
+#endif
+
+struct actorProfileMng
+{
+	struct profile_tick
+	{
+		unsigned long long _run = 0;
+		unsigned long long _ready = 0;
+		unsigned long long _block = 0;
+		size_t _yieldCount = 0;
+		size_t _actorCount = 0;
+	};
+
+	actorProfileMng()
+		:_commitTicks(0), _generation(1), _beginTick(cpu_tick()), _beginUs(get_tick_us()) {}
+
+	/*!
+	@brief 提交增量统计，gen不是当前代(首次提交或之后清空过)时计入Actor数，返回当前代
+	*/
+	size_t commit(size_t key, unsigned long long run, unsigned long long ready, unsigned long long block, size_t yieldCount, size_t gen)
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		profile_tick& pt = _table[key];
+		pt._run += run;
+		pt._ready += ready;
+		pt._block += block;
+		pt._yieldCount += yieldCount;
+		if (gen != _generation)
+		{
+			pt._actorCount++;
+		}
+		_commitTicks.store((unsigned long long)(tick_per_us() * ACTOR_PROFILE_COMMIT_US), std::memory_order_relaxed);
+		return _generation;
+	}
+
+	//用运行以来的cpu_tick与微秒时钟计算换算比例
+	double tick_per_us()
+	{
+		const long long us = get_tick_us() - _beginUs;
+		const double r = (double)(cpu_tick() - _beginTick) / (double)(us > 0 ? us : 1);
+		return r > 0 ? r : 1;
+	}
+
+	std::map<size_t, profile_tick> _table;
+	std::mutex _mutex;
+	std::atomic<unsigned long long> _commitTicks;///<ACTOR_PROFILE_COMMIT_US换算的tick，首次提交前为0
+	size_t _generation;///<reset_profile后加一
+	const unsigned long long _beginTick;
+	const long long _beginUs;
+};
+static actorProfileMng* s_actorProfileMng = NULL;
+#endif
+
 struct shared_initer 
 {
 	std::recursive_mutex* _traceMutex = NULL;
@@ -61,6 +118,7 @@ struct shared_initer
 static shared_initer s_shared_initer;
 static bool s_isSharedIniter = false;
 static autoActorStackMng* s_autoActorStackMng = NULL;
+static mem_alloc_base* s_actorColdAlloc = NULL;
 mem_alloc_base* shared_bool::_sharedBoolAlloc = NULL;
 std::recursive_mutex* TraceMutex_::_mutex = NULL;
 std::atomic<my_actor::id>* my_actor::_actorIDCount = NULL;
@@ -83,10 +141,14 @@ void my_actor::install()
 		bind_qt_run_base::install();
 #endif
 #ifdef ENABLE_CHECK_LOST
-		s_checkLostObjAlloc = make_shared_space_alloc<CheckLost_, mem_alloc_tls<CHECK_LOST_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](CheckLost_*){});
+		s_checkLostObjAlloc = new mem_alloc_tls<CHECK_LOST_ALLOC_INDEX, CheckLost_>(MEM_POOL_LENGTH);
 		s_checkPumpLostObjAlloc = make_shared_space_alloc<CheckPumpLost_, mem_alloc_tls<CHECK_PUMP_LOST_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](CheckPumpLost_*){});
 #endif
 		s_autoActorStackMng = new autoActorStackMng;
+		s_actorColdAlloc = new mem_alloc_tls<ACTOR_COLD_ALLOC_INDEX, my_actor::ActorCold_>(MEM_POOL_LENGTH);
+#ifdef ENABLE_ACTOR_PROFILE
+		s_actorProfileMng = new actorProfileMng;
+#endif
 		shared_bool::_sharedBoolAlloc = make_shared_space_alloc<bool, mem_alloc_tls<SHARED_BOOL_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](bool*){});
 		my_actor::_actorIDCount = new std::atomic<my_actor::id>(0);
 		s_shared_initer._actorIDCount = my_actor::_actorIDCount;
@@ -112,10 +174,14 @@ void my_actor::install(const shared_initer* initer)
 		bind_qt_run_base::install();
 #endif
 #ifdef ENABLE_CHECK_LOST
-		s_checkLostObjAlloc = make_shared_space_alloc<CheckLost_, mem_alloc_tls<CHECK_LOST_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](CheckLost_*){});
+		s_checkLostObjAlloc = new mem_alloc_tls<CHECK_LOST_ALLOC_INDEX, CheckLost_>(MEM_POOL_LENGTH);
 		s_checkPumpLostObjAlloc = make_shared_space_alloc<CheckPumpLost_, mem_alloc_tls<CHECK_PUMP_LOST_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](CheckPumpLost_*){});
 #endif
 		s_autoActorStackMng = new autoActorStackMng;
+		s_actorColdAlloc = new mem_alloc_tls<ACTOR_COLD_ALLOC_INDEX, my_actor::ActorCold_>(MEM_POOL_LENGTH);
+#ifdef ENABLE_ACTOR_PROFILE
+		s_actorProfileMng = new actorProfileMng;
+#endif
 		shared_bool::_sharedBoolAlloc = make_shared_space_alloc<bool, mem_alloc_tls<SHARED_BOOL_ALLOC_INDEX, void>>(MEM_POOL_LENGTH, [](bool*){});
 		my_actor::_actorIDCount = initer->_actorIDCount;
 		s_shared_initer._actorIDCount = initer->_actorIDCount;
@@ -141,6 +207,12 @@ void my_actor::uninstall()
 		my_actor::msg_pool_status::_msgTypeMapAll = NULL;
 		delete s_autoActorStackMng;
 		s_autoActorStackMng = NULL;
+		delete s_actorColdAlloc;
+		s_actorColdAlloc = NULL;
+#ifdef ENABLE_ACTOR_PROFILE
+		delete s_actorProfileMng;
+		s_actorProfileMng = NULL;
+#endif
 #ifdef ENABLE_CHECK_LOST
 		delete s_checkLostObjAlloc;
 		s_checkLostObjAlloc = NULL;
@@ -171,6 +243,7 @@ const shared_initer* my_actor::get_initer()
 void my_actor::tls_init()
 {
 	shared_bool::_sharedBoolAlloc->tls_init();
+	s_actorColdAlloc->tls_init();
 #ifdef ENABLE_CHECK_LOST
 	s_checkLostObjAlloc->tls_init();
 	s_checkPumpLostObjAlloc->tls_init();
@@ -183,6 +256,7 @@ void my_actor::tls_uninit()
 	s_checkPumpLostObjAlloc->tls_uninit();
 	s_checkLostObjAlloc->tls_uninit();
 #endif
+	s_actorColdAlloc->tls_uninit();
 	shared_bool::_sharedBoolAlloc->tls_uninit();
 }
 
@@ -257,24 +331,137 @@ shared_bool shared_bool::new_(bool b)
 
 //////////////////////////////////////////////////////////////////////////
 #ifdef ENABLE_CHECK_LOST
-CheckLost_::CheckLost_(const shared_strand& strand, msg_handle_base* msgHandle)
-:_strand(strand), _handle(msgHandle), _closed(msgHandle->_closed) {}
+CheckLost_::CheckLost_(const actor_handle& hostActor, msg_handle_base* msgHandle)
+:_strand(hostActor->self_strand()), _hostActor(hostActor), _closed(msgHandle->_closed), _handle(msgHandle), _localCount(1), _merged(false), _sharedCount(0) {}
 
 CheckLost_::~CheckLost_()
 {
-	if (!_closed)
+}
+
+//_sharedCount低两位的标记，计数每次增减4
+#define CHECK_LOST_MERGED 1
+#define CHECK_LOST_QUEUED 2
+#define CHECK_LOST_ONE 4
+
+static inline intptr_t check_lost_count(intptr_t v)
+{
+	return (v & ~(intptr_t)(CHECK_LOST_ONE - 1)) / CHECK_LOST_ONE;
+}
+
+bool CheckLost_::add_ref()
+{
+	//_merged只在所属strand中读写
+	if (_strand->running_in_this_thread() && !_merged)
 	{
-		auto& handle_ = _handle;
-		_strand->try_tick(std::bind([handle_](const shared_bool& closed)
+		_localCount++;
+		return false;
+	}
+	_sharedCount.fetch_add(CHECK_LOST_ONE, std::memory_order_relaxed);
+	return true;
+}
+
+void CheckLost_::release(bool shared)
+{
+	//_merged只在所属strand中读写
+	if (!shared && _strand->running_in_this_thread() && !_merged)
+	{
+		release_local();
+	}
+	else
+	{
+		release_shared();
+	}
+}
+
+void CheckLost_::release_local()
+{
+	assert(_strand->running_in_this_thread());
+	assert(!_merged && _localCount);
+	if (0 == --_localCount)
+	{
+		_merged = true;
+		const intptr_t old = _sharedCount.fetch_or(CHECK_LOST_MERGED, std::memory_order_acq_rel);
+		assert(check_lost_count(old) >= 0);
+		//有待执行的合并任务时由它收尾
+		if (0 == check_lost_count(old) && !(old & CHECK_LOST_QUEUED))
 		{
-			if (!closed)
-			{
-				handle_->lost_msg();
-			}
-		}, std::move(_closed)));
+			lost();
+		}
+	}
+}
+
+void CheckLost_::release_shared()
+{
+	intptr_t old = _sharedCount.load(std::memory_order_relaxed);
+	intptr_t next;
+	do
+	{
+		next = old - CHECK_LOST_ONE;
+		//未合并时strand内的引用在其它线程释放会让计数为负，第一次为负时请求合并
+		if (!(old & (CHECK_LOST_MERGED | CHECK_LOST_QUEUED)) && check_lost_count(next) < 0)
+		{
+			next |= CHECK_LOST_QUEUED;
+		}
+	} while (!_sharedCount.compare_exchange_weak(old, next, std::memory_order_acq_rel, std::memory_order_relaxed));
+	if ((next & CHECK_LOST_QUEUED) && !(old & CHECK_LOST_QUEUED))
+	{
+		//合并任务执行前对象不会被释放
+		_strand->post(std::bind([](CheckLost_* this_)
+		{
+			this_->merge_queued();
+		}, this));
+	}
+	else if ((old & CHECK_LOST_MERGED) && !(old & CHECK_LOST_QUEUED) && 0 == check_lost_count(next))
+	{
+		//已合并，最后一个引用
+		lost();
+	}
+}
+
+void CheckLost_::merge_queued()
+{
+	assert(_strand->running_in_this_thread());
+	intptr_t old;
+	if (!_merged)
+	{
+		//把strand内的计数并入_sharedCount，同时置合并标记、清待合并标记
+		_merged = true;
+		const intptr_t local = (intptr_t)_localCount;
+		_localCount = 0;
+		old = _sharedCount.fetch_add(local * CHECK_LOST_ONE + CHECK_LOST_MERGED - CHECK_LOST_QUEUED, std::memory_order_acq_rel);
+		old += local * CHECK_LOST_ONE;
+	}
+	else
+	{
+		old = _sharedCount.fetch_and(~(intptr_t)CHECK_LOST_QUEUED, std::memory_order_acq_rel);
+	}
+	assert(check_lost_count(old) >= 0);
+	if (0 == check_lost_count(old))
+	{
+		lost();
 	}
 }
 
+void CheckLost_::lost()
+{
+	if (_closed)
+	{
+		this->~CheckLost_();
+		s_checkLostObjAlloc->deallocate(this);
+		return;
+	}
+	//Actor可能已经迁移，不能用计数所属的_strand
+	ActorFunc_::actor_try_tick(_hostActor.get(), std::bind([](CheckLost_* this_)
+	{
+		if (!this_->_closed)
+		{
+			this_->_handle->lost_msg();
+		}
+		this_->~CheckLost_();
+		s_checkLostObjAlloc->deallocate(this_);
+	}, this));
+}
+
 //////////////////////////////////////////////////////////////////////////
 CheckPumpLost_::CheckPumpLost_(const actor_handle& hostActor, MsgPoolBase_* pool)
 :_hostActor(hostActor), _pool(pool) {}
@@ -300,10 +487,10 @@ child_handle::child_handle(actor_handle&& actor)
 :_actor(std::move(actor)), _started(false), _quited(false)
 {
 	my_actor* parent = _actor->_parentActor.get();
-	parent->_childActorList.push_front(_actor);
-	_actorIt = parent->_childActorList.begin();
-	_actor->_quitCallback.push_front(parent->make_trig_notifer_to_self(_quiteAth));
-	_athIt = _actor->_quitCallback.begin();
+	parent->link_child(_actor.get());
+	std::list<std::function<void()> >& quitCallback = _actor->cold()._quitCallback;
+	quitCallback.push_front(parent->make_trig_notifer_to_self(_quiteAth));
+	_athIt = quitCallback.begin();
 }
 
 child_handle::child_handle()
@@ -323,16 +510,16 @@ void child_handle::operator =(child_handle&& s)
 		assert(!s._actor->_started);
 		_actor = s._actor;
 		_quited = s._quited;
-		_actorIt = s._actorIt;
 		s._actor.reset();
 		s._started = false;
 		s._quited = true;
 		_started = false;
 		_quited = false;
-		_actor->_quitCallback.erase(s._athIt);
+		std::list<std::function<void()> >& quitCallback = _actor->_cold->_quitCallback;
+		quitCallback.erase(s._athIt);
 		parent->close_trig_notifer(s._quiteAth);
-		_actor->_quitCallback.push_front(parent->make_trig_notifer_to_self(_quiteAth));
-		_athIt = _actor->_quitCallback.begin();
+		quitCallback.push_front(parent->make_trig_notifer_to_self(_quiteAth));
+		_athIt = quitCallback.begin();
 	}
 }
 
@@ -381,7 +568,7 @@ void child_handle::peel()
 		my_actor* parent = _actor->_parentActor.get();
 		assert(parent->_strand->running_in_this_thread());
 		assert(parent->_inActor);
-		parent->_childActorList.erase(_actorIt);
+		parent->unlink_child(_actor.get());
 		_actor.reset();
 		_started = false;
 		_quited = true;
@@ -437,6 +624,7 @@ void msg_handle_base::lost_msg()
 		if (_waiting && _checkLost)
 		{
 			_waiting = false;
+			_selectSign.woken();
 			ActorFunc_::pull_yield(_hostActor);
 		}
 	}
@@ -552,7 +740,7 @@ void MsgPoolVoid_::push_msg(const actor_handle& hostActor)
 {
 	if (_strand->running_in_this_thread())
 	{
-		send_msg(ActorFunc_::shared_from_this(hostActor.get()));
+		send_msg(actor_handle(hostActor));
 	}
 	else
 	{
@@ -563,6 +751,22 @@ void MsgPoolVoid_::push_msg(const actor_handle& hostActor)
 	}
 }
 
+void MsgPoolVoid_::push_msg_urgent(const actor_handle& hostActor)
+{
+	//无参消息之间没有先后之分，只需跨strand时走紧急队列
+	if (_strand->running_in_this_thread())
+	{
+		send_msg(actor_handle(hostActor));
+	}
+	else
+	{
+		_strand->post_urgent(std::bind([](actor_handle& hostActor, const std::shared_ptr<MsgPoolVoid_>& sharedThis)
+		{
+			sharedThis->send_msg(std::move(hostActor));
+		}, hostActor, _weakThis.lock()));
+	}
+}
+
 void MsgPoolVoid_::_lost_msg(actor_handle&& hostActor)
 {
 	if (_waiting)
@@ -640,7 +844,7 @@ bool MsgPoolVoid_::pump_handler::empty()
 void MsgPoolVoid_::pump_handler::pump_msg(unsigned char pumpID, actor_handle&& hostActor)
 {
 	assert(_msgPump == _thisPool->_msgPump);
-	if (!_thisPool->_waiting)//ϴȡϢʱȡ˵ȴʱȡûϢ
+	if (!_thisPool->_waiting)//上次取消息超时后取消了等待，此时取还没消息
 	{
 		if (pumpID == _thisPool->_sendCount)
 		{
@@ -666,7 +870,7 @@ void MsgPoolVoid_::pump_handler::pump_msg(unsigned char pumpID, actor_handle&& h
 			}
 		}
 		else
-		{//ϴϢûȡȡʵмѾpostȥ
+		{//上次消息没取到，重新取，但实际中间已经post出去了
 			assert(!_thisPool->_waiting);
 			assert(pumpID + 1 == _thisPool->_sendCount);
 		}
@@ -707,7 +911,7 @@ bool MsgPoolVoid_::pump_handler::try_pump(my_actor* host, unsigned char pumpID,
 				}
 			}
 			else
-			{//ϴϢûȡȡʵмѾpostȥ
+			{//上次消息没取到，重新取，但实际中间已经post出去了
 				assert(!thisPool_->_waiting);
 				assert(pumpID + 1 == thisPool_->_sendCount);
 				wait = true;
@@ -841,6 +1045,7 @@ void MsgPumpVoid_::clear()
 		assert(_waiting);
 		_waiting = false;
 		_dstRec = NULL;
+		_selectSign.woken();
 		ActorFunc_::pull_yield(_hostActor);
 	}
 }
@@ -903,6 +1108,7 @@ void MsgPumpVoid_::receiver()
 				*_dstRec = true;
 				_dstRec = NULL;
 			}
+			_selectSign.woken();
 			ActorFunc_::pull_yield(_hostActor);
 		}
 		else
@@ -922,6 +1128,7 @@ void MsgPumpVoid_::_lost_msg()
 		_waiting = false;
 		_checkDis = false;
 		_dstRec = NULL;
+		_selectSign.woken();
 		ActorFunc_::pull_yield(_hostActor);
 	}
 }
@@ -1321,7 +1528,7 @@ my_actor::quit_guard::~quit_guard() __disable_noexcept
 {
 	if (_locked)
 	{
-		//ڴ׳ force_quit_exception 쳣
+		//可能在此析构函数内抛出 force_quit_exception 异常
 		_self->unlock_quit();
 	}
 }
@@ -1404,11 +1611,11 @@ public:
 			assert(_actor._inActor);
 			assert(!_actor._lockQuit);
 			assert(!_actor._lockSuspend);
-			assert(_actor._childActorList.empty());
-			assert(_actor._beginQuitExec.empty());
+			assert(!_actor._childHead);
+			assert(!_actor._cold || _actor._cold->_beginQuitExec.empty());
 		}
 		catch (my_actor::force_quit_exception&)
-		{//Actorǿ˳쳣
+		{//捕获Actor被强制退出异常
 			assert(!_actor._inActor);
 			_actor._inActor = true;
 		}
@@ -1462,27 +1669,38 @@ public:
 		clear_function(_actor._mainFunc);
 		assert(_actor._timerStateCompleted);
 		_actor._quited = true;
-		_actor._msgPoolStatus.clear(&_actor);//yield now
+		if (_actor._cold)
+		{
+			_actor._cold->_msgPoolStatus.clear(&_actor);//yield now
+		}
 		_actor._inActor = false;
 	}
 
 	void exit_notify()
 	{
 		DEBUG_OPERATION(size_t yc = _actor.yield_count());
+#ifdef ENABLE_ACTOR_PROFILE
+		_actor.profile_commit();
+#endif
 		_actor._exited = true;
-		while (!_actor._suspendResumeQueue.empty())
+		if (_actor._cold)
 		{
-			if (_actor._suspendResumeQueue.front()._h)
+			my_actor::ActorCold_* const cold = _actor._cold;
+			while (cold->_suspendHead)
 			{
-				CHECK_EXCEPTION(_actor._suspendResumeQueue.front()._h);
+				my_actor::suspend_resume_option* const opt = _actor.pop_suspend_option();
+				if (opt->_h)
+				{
+					CHECK_EXCEPTION(opt->_h);
+				}
+				delete opt;
+			}
+			while (!cold->_quitCallback.empty())
+			{
+				assert(cold->_quitCallback.front());
+				CHECK_EXCEPTION(cold->_quitCallback.front());
+				cold->_quitCallback.pop_front();
 			}
-			_actor._suspendResumeQueue.pop_front();
-		}
-		while (!_actor._quitCallback.empty())
-		{
-			assert(_actor._quitCallback.front());
-			CHECK_EXCEPTION(_actor._quitCallback.front());
-			_actor._quitCallback.pop_front();
 		}
 		assert(_actor.yield_count() == yc);
 	}
@@ -1512,11 +1730,11 @@ public:
 		context_yield::context_info* const info = _actor._actorPull->_coroInfo;
 		const size_t cleanSize = clean_size(info);
 		_actor._usingStackSize = std::max(_actor._usingStackSize, info->stackSize + info->reserveSize - cleanSize);
-		//¼ʵĵջռ
+		//记录本次实际消耗的栈空间
 		s_autoActorStackMng->update_stack_size(_actor._actorKey, _actor._usingStackSize);
 		if (!_actor._afterExitCleanStack && cleanSize < info->reserveSize - MEM_PAGE_SIZE)
 		{
-			//ͷڴ棬ַռ
+			//释放物理内存，保留地址空间
 			char* const sb = (char*)info->stackTop - info->stackSize - info->reserveSize;
 			VirtualFree(sb + cleanSize - MEM_PAGE_SIZE, info->reserveSize - cleanSize, MEM_DECOMMIT);
 			DWORD oldPro = 0;
@@ -1530,7 +1748,7 @@ public:
 		{
 			actor_handler(actorPush);
 			if (_actor._checkStack)
-			{//ʵջײ鿴жٸPAGEPAGE_GUARDʧ˶ջԤռ
+			{//从实际栈底查看有多少个PAGE的PAGE_GUARD标记消失和用了多少栈预留空间
 				_actor.run_in_safe_stack_after_quited([this]
 				{
 					check_stack();
@@ -1558,7 +1776,7 @@ public:
 		{
 			actor_handler(actorPush);
 			if (_actor._checkStack)
-			{//ʵջײ鿴жٸPAGEPAGE_GUARDʧ˶ջԤռ
+			{//从实际栈底查看有多少个PAGE的PAGE_GUARD标记消失和用了多少栈预留空间
 				_actor.run_in_safe_stack_after_quited([this]
 				{
 					check_stack();
@@ -1698,13 +1916,17 @@ public:
 	void check_stack()
 	{
 		context_yield::context_info* const info = _actor._actorPull->_coroInfo;
+		if (info->hugePage)
+		{
+			return;//大页栈一经触碰整页驻留，mincore不能反映实际用量，也不能释放部分物理页
+		}
 		const size_t cleanSize = clean_size(info);
 		_actor._usingStackSize = std::max(_actor._usingStackSize, info->stackSize + info->reserveSize - cleanSize);
-		//¼ʵĵջռ
+		//记录本次实际消耗的栈空间
 		s_autoActorStackMng->update_stack_size(_actor._actorKey, _actor._usingStackSize);
 		if (!_actor._afterExitCleanStack && cleanSize < info->reserveSize)
 		{
-			//ͷڴ棬ַռ
+			//释放物理内存，保留地址空间
 			char* const sb = (char*)info->stackTop - info->stackSize - info->reserveSize;
 			madvise(sb + cleanSize, info->reserveSize - cleanSize, MADV_DONTNEED);
 		}
@@ -1760,10 +1982,11 @@ public:
 				char* const violationAddr = (char*)((size_t)fault_address & (0 - MEM_PAGE_SIZE));
 				size_t const ts = info->stackSize + info->reserveSize;
 				char* const sb = (char*)info->stackTop - ts;
-				if (violationAddr >= sb && violationAddr < info->stackTop)
+				char* const guard = info->hugePage ? sb - MEM_PAGE_SIZE : sb;//大页栈的哨兵页在映射之下
+				if (violationAddr >= guard && violationAddr < info->stackTop)
 				{
-					//ջڱ
-					assert(violationAddr == sb);
+					//触碰栈哨兵
+					assert(violationAddr == guard);
 					std::wcout << "actor stack overflow";
 					std::wcout << ", stack base " << (void*)sb;
 					std::wcout << ", stack length " << ts;
@@ -1855,8 +2078,11 @@ my_actor::my_actor()
 	_lockSuspend = 0;
 	_yieldCount = 0;
 	_lastYield = -1;
-	_childOverCount = 0;
-	_childSuspendResumeCount = 0;
+	_cold = NULL;
+	_currStrand = NULL;
+	_childHead = NULL;
+	_childPrev = NULL;
+	_childNext = NULL;
 	_returnCode = 0;
 	_usingStackSize = 0;
 	_trigSignMask = 0;
@@ -1864,6 +2090,22 @@ my_actor::my_actor()
 	_timerStateCount = 0;
 	_timerStateTime = 0;
 	_timerStateStampEnd = 0;
+#ifdef ENABLE_ACTOR_PROFILE
+	_profRunTick = 0;
+	_profReadyTick = 0;
+	_profBlockTick = 0;
+	_profStopTick = 0;
+	_profWakeTick = 0;
+	_profNestedTick = 0;
+	_profYieldCount = 0;
+	_profCommitRun = 0;
+	_profCommitReady = 0;
+	_profCommitBlock = 0;
+	_profCommitTick = 0;
+	_profCommitYield = 0;
+	_profCommitGen = 0;
+	_profReadyYield = false;
+#endif
 }
 
 my_actor::my_actor(const my_actor&)
@@ -1881,13 +2123,19 @@ my_actor::~my_actor()
 	assert(!_holdSuspended);
 	assert(!_waitingQuit);
 	assert(!_mainFunc);
-	assert(!_childOverCount);
 	assert(!_lockQuit);
-	assert(!_childSuspendResumeCount);
-	assert(_suspendResumeQueue.empty());
-	assert(_beginQuitExec.empty());
-	assert(_quitCallback.empty());
-	assert(_childActorList.empty());
+	assert(!_childHead);
+	if (_cold)
+	{
+		assert(!_cold->_childOverCount);
+		assert(!_cold->_childSuspendResumeCount);
+		assert(!_cold->_suspendHead);
+		assert(_cold->_beginQuitExec.empty());
+		assert(_cold->_quitCallback.empty());
+		_cold->~ActorCold_();
+		s_actorColdAlloc->deallocate(_cold);
+		_cold = NULL;
+	}
 
 #ifdef PRINT_ACTOR_STACK
 	context_yield::context_info* const info = _actorPull->_coroInfo;
@@ -1915,6 +2163,7 @@ actor_handle my_actor::create(shared_strand actorStrand, main_func mainFunc, siz
 	actor_handle newActor(new(pull->_space)my_actor(), [](my_actor* p){p->~my_actor(); }, actor_ref_count_alloc<void>(pull));
 	newActor->_weakThis = newActor;
 	newActor->_strand = std::move(actorStrand);
+	newActor->_currStrand = newActor->_strand.get();
 	newActor->_mainFunc = std::move(mainFunc);
 	newActor->_actorPull = pull;
 #ifdef PRINT_ACTOR_STACK
@@ -1964,6 +2213,7 @@ actor_handle my_actor::create(shared_strand actorStrand, AutoStackActorFace_&& w
 	actor_handle newActor(new(pull->_space)my_actor(), [](my_actor* p){p->~my_actor(); }, actor_ref_count_alloc<void>(pull));
 	newActor->_weakThis = newActor;
 	newActor->_strand = std::move(actorStrand);
+	newActor->_currStrand = newActor->_strand.get();
 	newActor->_checkStack = checkStack;
 	wrapActor.swap(newActor->_mainFunc);
 	newActor->_actorKey = wrapActor.key();
@@ -2336,6 +2586,9 @@ void my_actor::yield()
 	{
 		shared_this->run_one();
 	}, shared_from_this()));
+#ifdef ENABLE_ACTOR_PROFILE
+	_profReadyYield = true;
+#endif
 	push_yield();
 }
 
@@ -2356,6 +2609,9 @@ void my_actor::tick_yield()
 	{
 		shared_this->run_one();
 	}, shared_from_this()));
+#ifdef ENABLE_ACTOR_PROFILE
+	_profReadyYield = true;
+#endif
 	push_yield();
 	unlock_quit();
 }
@@ -2369,27 +2625,129 @@ void my_actor::try_tick_yield()
 	_lastYield = _yieldCount;
 }
 
+void my_actor::migrate(const shared_strand& dst)
+{
+	assert_enter();
+	assert(dst && &dst->get_io_engine() == &_strand->get_io_engine());
+	assert(!_childHead);
+	assert(_timerStateCompleted);
+	assert(!_cold || _cold->_msgPoolStatus._msgTypeMap.empty());
+	if (dst == _strand)
+	{
+		return;
+	}
+	//切换到下一个任务后才更换strand，保证新旧strand不会同时执行本Actor
+	_strand->post(std::bind([](const actor_handle& shared_this, shared_strand& dst)
+	{
+		my_actor* const self = shared_this.get();
+		//其它线程可能刚读到旧的_currStrand，旧strand保留到Actor析构；投递到旧strand的任务由wrap_forward_handler转投
+		std::list<shared_strand>& oldStrands = self->cold()._oldStrands;
+		if (oldStrands.end() == std::find(oldStrands.begin(), oldStrands.end(), self->_strand))
+		{
+			oldStrands.push_back(self->_strand);
+		}
+		self->_strand = std::move(dst);
+		self->_currStrand.store(self->_strand.get(), std::memory_order_release);
+		self->_strand->post(std::bind([](const actor_handle& shared_this)
+		{
+			shared_this->run_one();
+		}, shared_this));
+	}, shared_from_this(), dst));
+	push_yield();
+}
+
 const actor_handle& my_actor::parent_actor()
 {
 	return _parentActor;
 }
 
-const std::list<actor_handle>& my_actor::children()
+std::vector<actor_handle> my_actor::children()
 {
-	return _childActorList;
+	std::vector<actor_handle> res;
+	for (my_actor* child = _childHead; child; child = child->_childNext)
+	{
+		res.push_back(child->shared_from_this());
+	}
+	return res;
 }
 
 my_actor::quit_iterator my_actor::regist_quit_executor(std::function<void()> quitHandler)
 {
 	assert_enter();
-	_beginQuitExec.push_front(std::move(quitHandler));//עִ
-	return _beginQuitExec.begin();
+	std::list<std::function<void()> >& beginQuitExec = cold()._beginQuitExec;
+	beginQuitExec.push_front(std::move(quitHandler));//后注册的先执行
+	return beginQuitExec.begin();
 }
 
 void my_actor::cancel_quit_executor(const quit_iterator& qh)
 {
 	assert_enter();
-	_beginQuitExec.erase(qh);
+	_cold->_beginQuitExec.erase(qh);
+}
+
+my_actor::ActorCold_& my_actor::cold()
+{
+	if (!_cold)
+	{
+		_cold = new(s_actorColdAlloc->allocate())ActorCold_();
+	}
+	return *_cold;
+}
+
+void my_actor::push_suspend_option(suspend_resume_option* opt)
+{
+	ActorCold_& cold_ = cold();
+	if (cold_._suspendTail)
+	{
+		cold_._suspendTail->_next = opt;
+	}
+	else
+	{
+		cold_._suspendHead = opt;
+	}
+	cold_._suspendTail = opt;
+}
+
+my_actor::suspend_resume_option* my_actor::pop_suspend_option()
+{
+	assert(_cold && _cold->_suspendHead);
+	suspend_resume_option* const opt = _cold->_suspendHead;
+	_cold->_suspendHead = opt->_next;
+	if (!_cold->_suspendHead)
+	{
+		_cold->_suspendTail = NULL;
+	}
+	return opt;
+}
+
+void my_actor::link_child(my_actor* child)
+{
+	assert(!child->_childPrev && !child->_childNext);
+	child->_childNext = _childHead;
+	if (_childHead)
+	{
+		_childHead->_childPrev = child;
+	}
+	_childHead = child;
+}
+
+void my_actor::unlink_child(my_actor* child)
+{
+	if (child->_childPrev)
+	{
+		child->_childPrev->_childNext = child->_childNext;
+	}
+	else
+	{
+		assert(_childHead == child);
+		_childHead = child->_childNext;
+	}
+	if (child->_childNext)
+	{
+		child->_childNext->_childPrev = child->_childPrev;
+	}
+	child->_childPrev = NULL;
+	child->_childNext = NULL;
 }
 
 void my_actor::cancel_delay_trig()
@@ -2400,7 +2758,7 @@ void my_actor::cancel_delay_trig()
 
 void my_actor::tick_handler(bool* sign)
 {
-	if (_strand->running_in_this_thread())
+	if (curr_strand()->running_in_this_thread())
 	{
 		if (!_quited)
 		{
@@ -2409,13 +2767,13 @@ void my_actor::tick_handler(bool* sign)
 	}
 	else
 	{
-		_strand->post(wrap_trig_run_one(shared_from_this(), sign));
+		actor_post(wrap_trig_run_one(shared_from_this(), sign));
 	}
 }
 
 void my_actor::tick_handler(shared_bool& closed, bool* sign)
 {
-	if (_strand->running_in_this_thread())
+	if (curr_strand()->running_in_this_thread())
 	{
 		if (!_quited && !closed)
 		{
@@ -2424,7 +2782,7 @@ void my_actor::tick_handler(shared_bool& closed, bool* sign)
 	}
 	else
 	{
-		_strand->post(wrap_check_trig_run_one(closed, shared_from_this(), sign));
+		actor_post(wrap_check_trig_run_one(closed, shared_from_this(), sign));
 	}
 }
 
@@ -2516,7 +2874,7 @@ void my_actor::reset_yield()
 
 void my_actor::run()
 {
-	_strand->try_tick(std::bind([](const actor_handle& shared_this)
+	actor_try_tick(std::bind([](const actor_handle& shared_this)
 	{
 		my_actor* const self = shared_this.get();
 		if (!self->_quited && !self->_started)
@@ -2542,14 +2900,14 @@ void my_actor::assert_enter()
 
 void my_actor::force_quit(std::function<void()> h)
 {
-	_strand->try_tick(std::bind([](actor_handle& shared_this, std::function<void()>& h)
+	actor_try_tick(std::bind([](actor_handle& shared_this, std::function<void()>& h)
 	{
 		my_actor* const self = shared_this.get();
 		if (!self->_quited)
 		{
 			if (h)
 			{
-				self->_quitCallback.push_back(std::move(h));
+				self->cold()._quitCallback.push_back(std::move(h));
 			}
 			if (!self->_lockQuit)
 			{
@@ -2560,22 +2918,24 @@ void my_actor::force_quit(std::function<void()> h)
 				self->_holdPull = false;
 				self->_lockSuspend = 0;
 				self->cancel_timer();
-				if (!self->_childActorList.empty())
+				if (self->_childHead)
 				{
-					assert(!self->_childOverCount);
+					ActorCold_& cold = self->cold();
+					assert(!cold._childOverCount);
 					do
 					{
-						self->_childOverCount++;
-						self->_childActorList.front()->force_quit(self->_strand->wrap_once(std::bind([](actor_handle& shared_this)
+						my_actor* const child = self->_childHead;
+						self->unlink_child(child);
+						cold._childOverCount++;
+						child->force_quit(self->_strand->wrap_once(std::bind([](actor_handle& shared_this)
 						{
 							my_actor* const self = shared_this.get();
-							if (0 == --self->_childOverCount)
+							if (0 == --self->_cold->_childOverCount)
 							{
 								self->pull_yield();
 							}
 						}, shared_this)));
-						self->_childActorList.pop_front();
-					} while (!self->_childActorList.empty());
+					} while (self->_childHead);
 				}
 				else
 				{
@@ -2600,7 +2960,7 @@ void my_actor::force_quit(std::function<void()> h)
 			}
 			else
 			{
-				self->_quitCallback.push_back(std::move(h));
+				self->cold()._quitCallback.push_back(std::move(h));
 			}
 		}
 	}, shared_from_this(), std::move(h)));
@@ -2632,7 +2992,7 @@ bool my_actor::in_actor()
 
 bool my_actor::running_in_actor_strand()
 {
-	return _strand->running_in_this_thread();
+	return curr_strand()->running_in_this_thread();
 }
 
 bool my_actor::quit_msg()
@@ -2672,8 +3032,8 @@ void my_actor::unlock_suspend()
 	if (0 == --_lockSuspend && _holdSuspended)
 	{
 		_holdSuspended = false;
-		assert(!_suspendResumeQueue.empty());
-		if (_suspendResumeQueue.front()._isSuspend)
+		assert(_cold && _cold->_suspendHead);
+		if (_cold->_suspendHead->_isSuspend)
 		{
 			begin_suspend();
 		} 
@@ -2705,13 +3065,13 @@ void my_actor::after_exit_clean_stack()
 
 void my_actor::suspend(std::function<void()> h)
 {
-	_strand->try_tick(std::bind([](actor_handle& shared_this, std::function<void()>& h)
+	actor_try_tick(std::bind([](actor_handle& shared_this, std::function<void()>& h)
 	{
 		my_actor* const self = shared_this.get();
 		if (!self->_quited)
 		{
-			bool queueEmpty = self->_suspendResumeQueue.empty();
-			self->_suspendResumeQueue.push_back(suspend_resume_option(true, std::move(h)));
+			bool queueEmpty = !self->_cold || !self->_cold->_suspendHead;
+			self->push_suspend_option(new suspend_resume_option(true, std::move(h)));
 			if (!self->_lockSuspend)
 			{
 				if (queueEmpty)
@@ -2735,16 +3095,16 @@ void my_actor::begin_suspend()
 {
 	suspend_timer();
 	_suspended = true;
-	if (!_childActorList.empty())
+	if (_childHead)
 	{
-		assert(0 == _childSuspendResumeCount);
-		for (actor_handle& childActor : _childActorList)
+		assert(0 == _cold->_childSuspendResumeCount);
+		for (my_actor* child = _childHead; child; child = child->_childNext)
 		{
-			_childSuspendResumeCount++;
-			childActor->suspend(_strand->wrap_once(std::bind([](actor_handle& shared_this)
+			_cold->_childSuspendResumeCount++;
+			child->suspend(_strand->wrap_once(std::bind([](actor_handle& shared_this)
 			{
 				my_actor* const self = shared_this.get();
-				if (0 == --self->_childSuspendResumeCount)
+				if (0 == --self->_cold->_childSuspendResumeCount)
 				{
 					self->child_suspend_then();
 				}
@@ -2760,15 +3120,15 @@ void my_actor::begin_suspend()
 void my_actor::child_suspend_then()
 {
 	assert(_strand->running_in_this_thread());
-	suspend_resume_option opt = std::move(_suspendResumeQueue.front());
-	_suspendResumeQueue.pop_front();
-	if (opt._h)
+	suspend_resume_option* const opt = pop_suspend_option();
+	if (opt->_h)
 	{
-		CHECK_EXCEPTION(opt._h);
+		CHECK_EXCEPTION(opt->_h);
 	}
-	if (!_suspendResumeQueue.empty())
+	delete opt;
+	if (_cold->_suspendHead)
 	{
-		if (_suspendResumeQueue.front()._isSuspend)
+		if (_cold->_suspendHead->_isSuspend)
 		{
 			begin_suspend();
 		}
@@ -2781,13 +3141,13 @@ void my_actor::child_suspend_then()
 
 void my_actor::resume(std::function<void()> h)
 {
-	_strand->try_tick(std::bind([](const actor_handle& shared_this, std::function<void()>& h)
+	actor_try_tick(std::bind([](const actor_handle& shared_this, std::function<void()>& h)
 	{
 		my_actor* const self = shared_this.get();
 		if (!self->_quited)
 		{
-			bool queueEmpty = self->_suspendResumeQueue.empty();
-			self->_suspendResumeQueue.push_back(suspend_resume_option(false, std::move(h)));
+			bool queueEmpty = !self->_cold || !self->_cold->_suspendHead;
+			self->push_suspend_option(new suspend_resume_option(false, std::move(h)));
 			if (!self->_lockSuspend)
 			{
 				if (queueEmpty)
@@ -2809,16 +3169,16 @@ void my_actor::resume(std::function<void()> h)
 
 void my_actor::begin_resume()
 {
-	if (!_childActorList.empty())
+	if (_childHead)
 	{
-		assert(0 == _childSuspendResumeCount);
-		for (actor_handle& childActor : _childActorList)
+		assert(0 == _cold->_childSuspendResumeCount);
+		for (my_actor* child = _childHead; child; child = child->_childNext)
 		{
-			_childSuspendResumeCount++;
-			childActor->resume(_strand->wrap_once(std::bind([](actor_handle& shared_this)
+			_cold->_childSuspendResumeCount++;
+			child->resume(_strand->wrap_once(std::bind([](actor_handle& shared_this)
 			{
 				my_actor* const self = shared_this.get();
-				if (0 == --self->_childSuspendResumeCount)
+				if (0 == --self->_cold->_childSuspendResumeCount)
 				{
 					self->child_resume_then();
 				}
@@ -2834,15 +3194,15 @@ void my_actor::begin_resume()
 void my_actor::child_resume_then()
 {
 	assert(_strand->running_in_this_thread());
-	suspend_resume_option opt = std::move(_suspendResumeQueue.front());
-	_suspendResumeQueue.pop_front();
-	if (opt._h)
+	suspend_resume_option* const opt = pop_suspend_option();
+	if (opt->_h)
 	{
-		CHECK_EXCEPTION(opt._h);
+		CHECK_EXCEPTION(opt->_h);
 	}
-	if (!_suspendResumeQueue.empty())
+	delete opt;
+	if (_cold->_suspendHead)
 	{
-		if (_suspendResumeQueue.front()._isSuspend)
+		if (_cold->_suspendHead->_isSuspend)
 		{
 			begin_suspend();
 		}
@@ -2865,7 +3225,7 @@ void my_actor::child_resume_then()
 
 void my_actor::switch_pause_play(std::function<void(bool)> h)
 {
-	_strand->try_tick(std::bind([](const actor_handle& shared_this, std::function<void(bool)>& h)
+	actor_try_tick(std::bind([](const actor_handle& shared_this, std::function<void(bool)>& h)
 	{
 		assert(shared_this->_strand->running_in_this_thread());
 		if (!shared_this->_quited)
@@ -2911,7 +3271,7 @@ void my_actor::switch_pause_play(std::function<void(bool)> h)
 void my_actor::notify_trig_sign(int id)
 {
 	assert(id >= 0 && id < 8 * (int)sizeof(void*));
-	if (_strand->running_in_this_thread())
+	if (curr_strand()->running_in_this_thread())
 	{
 		if (!_quited)
 		{
@@ -2926,7 +3286,7 @@ void my_actor::notify_trig_sign(int id)
 	}
 	else
 	{
-		_strand->post(std::bind([id](const actor_handle& shared_this)
+		actor_post(std::bind([id](const actor_handle& shared_this)
 		{
 			my_actor* const self = shared_this.get();
 			if (!self->_quited)
@@ -2953,11 +3313,12 @@ void my_actor::reset_trig_sign(int id)
 
 void my_actor::outside_wait_quit()
 {
-	assert(!_strand->in_this_ios());
+	assert(!curr_strand()->in_this_ios());
 	std::mutex mutex;
 	std::condition_variable conVar;
 	std::unique_lock<std::mutex> ul(mutex);
-	_strand->post([&]
+	//等待期间调用者持有本Actor，转投时不会析构
+	actor_post([&]
 	{
 		assert(_strand->running_in_this_thread());
 		if (_exited)
@@ -2967,7 +3328,7 @@ void my_actor::outside_wait_quit()
 		}
 		else
 		{
-			_quitCallback.push_back([&]()
+			cold()._quitCallback.push_back([&]()
 			{
 				std::lock_guard<std::mutex> lg(mutex);
 				conVar.notify_one();
@@ -2979,7 +3340,7 @@ void my_actor::outside_wait_quit()
 
 void my_actor::append_quit_notify(std::function<void()> h)
 {
-	if (_strand->running_in_this_thread())
+	if (curr_strand()->running_in_this_thread())
 	{
 		if (_exited)
 		{
@@ -2987,12 +3348,12 @@ void my_actor::append_quit_notify(std::function<void()> h)
 		}
 		else
 		{
-			_quitCallback.push_back(std::move(h));
+			cold()._quitCallback.push_back(std::move(h));
 		}
 	}
 	else
 	{
-		_strand->post(std::bind([](const actor_handle& shared_this, std::function<void()>& h)
+		actor_post(std::bind([](const actor_handle& shared_this, std::function<void()>& h)
 		{
 			my_actor* const self = shared_this.get();
 			if (self->_exited)
@@ -3001,7 +3362,7 @@ void my_actor::append_quit_notify(std::function<void()> h)
 			}
 			else
 			{
-				self->_quitCallback.push_back(std::move(h));
+				self->cold()._quitCallback.push_back(std::move(h));
 			}
 		}, shared_from_this(), std::move(h)));
 	}
@@ -3009,7 +3370,7 @@ void my_actor::append_quit_notify(std::function<void()> h)
 
 void my_actor::append_quit_executor(std::function<void()> h)
 {
-	if (_strand->running_in_this_thread())
+	if (curr_strand()->running_in_this_thread())
 	{
 		if (_exited)
 		{
@@ -3017,12 +3378,12 @@ void my_actor::append_quit_executor(std::function<void()> h)
 		}
 		else
 		{
-			_quitCallback.push_front(std::move(h));
+			cold()._quitCallback.push_front(std::move(h));
 		}
 	}
 	else
 	{
-		_strand->post(std::bind([](const actor_handle& shared_this, std::function<void()>& h)
+		actor_post(std::bind([](const actor_handle& shared_this, std::function<void()>& h)
 		{
 			my_actor* const self = shared_this.get();
 			if (self->_exited)
@@ -3031,7 +3392,7 @@ void my_actor::append_quit_executor(std::function<void()> h)
 			}
 			else
 			{
-				self->_quitCallback.push_front(std::move(h));
+				self->cold()._quitCallback.push_front(std::move(h));
 			}
 		}, shared_from_this(), std::move(h)));
 	}
@@ -3193,7 +3554,19 @@ void my_actor::run_one()
 
 void my_actor::pull_yield_tls()
 {
-#if ((__linux__ && (defined ENABLE_DUMP_STACK || (defined CHECK_SELF))) || (WIN32 && (_WIN32_WINNT < 0x0502) && (defined CHECK_SELF)))
+#ifdef ENABLE_ACTOR_PROFILE
+	const unsigned long long beginTick = cpu_tick();
+	profile_resume(beginTick);
+	//同线程嵌套运行(在另一个Actor中直接唤醒本Actor)时，记下外层Actor，外层扣除这段时间
+	void** const profTls = io_engine::getTlsValueBuff();
+	my_actor* const outer = profTls ? (my_actor*)profTls[ACTOR_PROFILE_TLS_INDEX] : NULL;
+	if (profTls)
+	{
+		profTls[ACTOR_PROFILE_TLS_INDEX] = this;
+	}
+	_profNestedTick = 0;
+#endif
+#if ((__linux__ && (defined ENABLE_DUMP_STACK || (defined CHECK_SELF) || (defined ENABLE_STACK_SAMPLING))) || (WIN32 && (_WIN32_WINNT < 0x0502) && (defined CHECK_SELF)))
 	void*& tlsVal = io_engine::getTlsValueRef(ACTOR_TLS_INDEX);
 	void* old = tlsVal;
 	tlsVal = this;
@@ -3202,6 +3575,142 @@ void my_actor::pull_yield_tls()
 #else
 	_actorPull->yield();
 #endif
+#ifdef ENABLE_ACTOR_PROFILE
+	_profStopTick = cpu_tick();
+	const unsigned long long runTick = _profStopTick - beginTick;
+	_profRunTick += runTick > _profNestedTick ? runTick - _profNestedTick : 0;
+	_profYieldCount++;
+	if (_profStopTick - _profCommitTick >= s_actorProfileMng->_commitTicks.load(std::memory_order_relaxed))
+	{
+		profile_commit();//长期运行的Actor也定期出现在汇总统计中，不用等到退出
+	}
+	if (profTls)
+	{
+		profTls[ACTOR_PROFILE_TLS_INDEX] = outer;
+		if (outer)
+		{
+			outer->_profNestedTick += runTick;
+		}
+	}
+#endif
+}
+
+#ifdef ENABLE_ACTOR_PROFILE
+void my_actor::profile_resume(unsigned long long tick)
+{
+	if (_profStopTick)
+	{
+		if (_profReadyYield)
+		{
+			_profReadyTick += tick - _profStopTick;
+		}
+		else if (_profWakeTick > _profStopTick && _profWakeTick < tick)
+		{
+			//从其它strand唤醒，唤醒之前算阻塞，唤醒之后算等待调度
+			_profBlockTick += _profWakeTick - _profStopTick;
+			_profReadyTick += tick - _profWakeTick;
+		}
+		else
+		{
+			_profBlockTick += tick - _profStopTick;
+		}
+	}
+	_profReadyYield = false;
+	_profWakeTick = 0;
+}
+
+void my_actor::profile_commit()
+{
+	_profCommitGen = s_actorProfileMng->commit(_actorKey, _profRunTick - _profCommitRun, _profReadyTick - _profCommitReady,
+		_profBlockTick - _profCommitBlock, _profYieldCount - _profCommitYield, _profCommitGen);
+	_profCommitRun = _profRunTick;
+	_profCommitReady = _profReadyTick;
+	_profCommitBlock = _profBlockTick;
+	_profCommitYield = _profYieldCount;
+	_profCommitTick = cpu_tick();
+}
+
+my_actor::profile_info my_actor::self_profile()
+{
+	const double tickPerUs = s_actorProfileMng->tick_per_us();
+	profile_info res;
+	res.runTime = (long long)(_profRunTick / tickPerUs);
+	res.readyTime = (long long)(_profReadyTick / tickPerUs);
+	res.blockTime = (long long)(_profBlockTick / tickPerUs);
+	res.yieldCount = _profYieldCount;
+	res.actorCount = 1;
+	return res;
+}
+
+std::vector<std::pair<size_t, my_actor::profile_info> > my_actor::profile_table()
+{
+	const double tickPerUs = s_actorProfileMng->tick_per_us();
+	std::vector<std::pair<size_t, profile_info> > res;
+	std::lock_guard<std::mutex> lg(s_actorProfileMng->_mutex);
+	res.reserve(s_actorProfileMng->_table.size());
+	for (auto& ele : s_actorProfileMng->_table)
+	{
+		profile_info pi;
+		pi.runTime = (long long)(ele.second._run / tickPerUs);
+		pi.readyTime = (long long)(ele.second._ready / tickPerUs);
+		pi.blockTime = (long long)(ele.second._block / tickPerUs);
+		pi.yieldCount = ele.second._yieldCount;
+		pi.actorCount = ele.second._actorCount;
+		res.push_back(std::make_pair(ele.first, pi));
+	}
+	return res;
+}
+
+std::string my_actor::profile_folded()
+{
+	std::string res;
+	char line[128];
+	for (auto& ele : profile_table())
+	{
+		sprintf(line, "actor_%llx;run %lld\n", (unsigned long long)ele.first, ele.second.runTime);
+		res += line;
+		sprintf(line, "actor_%llx;ready %lld\n", (unsigned long long)ele.first, ele.second.readyTime);
+		res += line;
+		sprintf(line, "actor_%llx;block %lld\n", (unsigned long long)ele.first, ele.second.blockTime);
+		res += line;
+	}
+	return res;
+}
+
+std::string my_actor::profile_csv()
+{
+	std::string res("key,actors,yields,run_us,ready_us,block_us\n");
+	char line[160];
+	for (auto& ele : profile_table())
+	{
+		sprintf(line, "%llx,%llu,%llu,%lld,%lld,%lld\n", (unsigned long long)ele.first, (unsigned long long)ele.second.actorCount, (unsigned long long)ele.second.yieldCount,
+			ele.second.runTime, ele.second.readyTime, ele.second.blockTime);
+		res += line;
+	}
+	return res;
+}
+
+void my_actor::reset_profile()
+{
+	std::lock_guard<std::mutex> lg(s_actorProfileMng->_mutex);
+	s_actorProfileMng->_table.clear();
+	s_actorProfileMng->_generation++;
+}
+#endif
+
+void my_actor::set_stack_rss_budget(size_t bytes)
+{
+	ContextPool_::set_rss_budget(bytes);
+}
+
+void my_actor::set_stack_clear_cycle(int clearSec, int deleteSec)
+{
+	ContextPool_::set_clear_cycle(clearSec, deleteSec);
+}
+
+ContextPool_::stack_stats my_actor::stack_pool_stats()
+{
+	return ContextPool_::stats();
 }
 
 void my_actor::pull_yield()
@@ -3239,11 +3748,14 @@ void my_actor::push_yield()
 	else
 	{
 		assert(!_lockQuit);
-		assert(!_childOverCount);
-		while (!_beginQuitExec.empty())
+		if (_cold)
 		{
-			CHECK_EXCEPTION(_beginQuitExec.front());
-			_beginQuitExec.pop_front();
+			assert(!_cold->_childOverCount);
+			while (!_cold->_beginQuitExec.empty())
+			{
+				CHECK_EXCEPTION(_cold->_beginQuitExec.front());
+				_cold->_beginQuitExec.pop_front();
+			}
 		}
 		throw force_quit_exception();
 	}
@@ -3298,7 +3810,7 @@ void my_actor::suspend_timer()
 		if (!_timerStateCompleted)
 		{
 			_strand->actor_timer()->cancel(_timerStateHandle);
-			_timerStateStampEnd = get_tick_us();
+			_timerStateStampEnd = time_source::tsc_us();
 			long long tt = _timerStateHandle._beginStamp + _timerStateTime;
 			if (_timerStateStampEnd > tt)
 			{
@@ -3338,7 +3850,7 @@ my_actor* my_actor::self_actor()
 {
 #if (WIN32 && (defined CHECK_SELF) && (_WIN32_WINNT >= 0x0502))
 	return (my_actor*)::FlsGetValue(ContextPool_::coro_pull_interface::_actorFlsIndex);
-#elif ((__linux__ && (defined ENABLE_DUMP_STACK || (defined CHECK_SELF))) || (WIN32 && (defined CHECK_SELF)))
+#elif ((__linux__ && (defined ENABLE_DUMP_STACK || (defined CHECK_SELF) || (defined ENABLE_STACK_SAMPLING))) || (WIN32 && (defined CHECK_SELF)))
 	void** buff = io_engine::getTlsValueBuff();
 	if (buff)
 	{
@@ -3357,6 +3869,22 @@ void my_actor::check_self()
 #endif
 }
 
+#if (__linux__ && ENABLE_STACK_SAMPLING)
+bool my_actor::sample_current(size_t& key, char*& stackBase, char*& stackTop)
+{
+	my_actor* const self = self_actor();
+	if (!self || !self->_inActor || !self->_actorPull)
+	{
+		return false;
+	}
+	context_yield::context_info* const info = self->_actorPull->_coroInfo;
+	key = self->_actorKey;
+	stackTop = (char*)info->stackTop;
+	stackBase = stackTop - (info->stackSize + info->reserveSize);
+	return true;
+}
+#endif
+
 void my_actor::als_set(void* val)
 {
 	_alsVal = val;
@@ -3518,6 +4046,12 @@ const shared_strand& ActorFunc_::self_strand(my_actor* host)
 	return host->self_strand();
 }
 
+bool ActorFunc_::running_in_actor_strand(my_actor* host)
+{
+	assert(host);
+	return host->running_in_actor_strand();
+}
+
 void ActorFunc_::pull_yield(my_actor* host)
 {
 	assert(host);
@@ -3561,13 +4095,10 @@ void ActorFunc_::cancel_timer(my_actor* host)
 }
 
 #ifdef ENABLE_CHECK_LOST
-std::shared_ptr<CheckLost_> ActorFunc_::new_check_lost(const shared_strand& strand, msg_handle_base* msgHandle)
+CheckLostRef_ ActorFunc_::new_check_lost(const actor_handle& hostActor, msg_handle_base* msgHandle)
 {
-	void* space = s_checkLostObjAlloc->allocate();
-	return std::shared_ptr<CheckLost_>(new(space)CheckLost_(strand, msgHandle), [](CheckLost_* p)
-	{
-		p->~CheckLost_();
-	}, ref_count_alloc2<CheckLost_>(space, s_checkLostObjAlloc));
+	assert(hostActor->self_strand()->running_in_this_thread());
+	return CheckLostRef_(new(s_checkLostObjAlloc->allocate())CheckLost_(hostActor, msgHandle));
 }
 
 std::shared_ptr<CheckPumpLost_> ActorFunc_::new_check_pump_lost(const actor_handle& hostActor, MsgPoolBase_* pool)
@@ -20,21 +20,21 @@
 #include "generator.h"
 
 class my_actor;
-typedef std::shared_ptr<my_actor> actor_handle;//Actor
+typedef std::shared_ptr<my_actor> actor_handle;//Actor句柄
 
 typedef ContextPool_::coro_push_interface actor_push_type;
 typedef ContextPool_::coro_pull_interface actor_pull_type;
 
-//˺л
+//此函数会上下文切换
 #define __yield_interrupt
 
 #if (_DEBUG || DEBUG)
 
-// ڼActorڵõĺǷ񴥷ǿ˳
+// 用于检测在Actor内调用的函数是否触发了强制退出
 #define BEGIN_CHECK_FORCE_QUIT try {
 #define END_CHECK_FORCE_QUIT } catch (my_actor::force_quit_exception&) {assert(false);}
 
-//actorǿ˳
+//用于锁定actor不强制退出
 #define LOCK_QUIT(__self__) __self__->lock_quit(); try {
 #define UNLOCK_QUIT(__self__) } catch (...) { assert (false); } __self__->unlock_quit();
 
@@ -48,10 +48,10 @@ typedef ContextPool_::coro_pull_interface actor_pull_type;
 
 #endif
 
-//װmsg_handle, trig_handleر¼
+//包装msg_handle, trig_handle关闭事件
 #define wrap_close_msg_handle(__handle__) [&__handle__]{__handle__.close(); }
 
-//ʼmy_actor
+//初始化my_actor框架
 #define init_my_actor(...)\
 	my_actor::install(__VA_ARGS__); \
 	BREAK_OF_SCOPE_EXEC(my_actor::uninstall());
@@ -62,6 +62,8 @@ struct shared_initer;
 template <typename... ARGS>
 class msg_pump_handle;
 class CheckLost_;
+class MutexBlock_;
+class CheckLostRef_;
 class CheckPumpLost_;
 class msg_handle_base;
 class MsgPoolBase_;
@@ -73,6 +75,11 @@ struct ActorFunc_
 	static actor_handle shared_from_this(my_actor* host);
 	static const actor_handle& parent_actor(my_actor* host);
 	static const shared_strand& self_strand(my_actor* host);
+	static bool running_in_actor_strand(my_actor* host);
+	template <typename H>
+	static void actor_post(my_actor* host, H&& h);
+	template <typename H>
+	static void actor_try_tick(my_actor* host, H&& h);
 	static void pull_yield(my_actor* host);
 	static void push_yield(my_actor* host);
 	static void pull_yield_after_quited(my_actor* host);
@@ -93,7 +100,7 @@ struct ActorFunc_
 	template <typename DST, typename SRC>
 	static void _trig_handler2(my_actor* host, shared_bool& closed, bool* sign, DST& dstRec, SRC&& args);
 #ifdef ENABLE_CHECK_LOST
-	static std::shared_ptr<CheckLost_> new_check_lost(const shared_strand& strand, msg_handle_base* msgHandle);
+	static CheckLostRef_ new_check_lost(const actor_handle& hostActor, msg_handle_base* msgHandle);
 	static std::shared_ptr<CheckPumpLost_> new_check_pump_lost(const actor_handle& hostActor, MsgPoolBase_* pool);
 	static std::shared_ptr<CheckPumpLost_> new_check_pump_lost(actor_handle&& hostActor, MsgPoolBase_* pool);
 #endif
@@ -101,27 +108,111 @@ struct ActorFunc_
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief ֪ͨʧ
+@brief 通知句柄丢失
 */
 struct ntf_lost_exception {};
 
 /*!
-@brief ϢñϿ
+@brief 消息泵被断开
 */
 struct pump_disconnected_exception { };
 
 #ifdef ENABLE_CHECK_LOST
+/*!
+@brief 通知句柄丢失检测的引用计数(有偏计数)，所有引用都释放后通知msg_handle丢失；
+在所属strand中增减非原子的_localCount，其它线程增减原子的有符号_sharedCount(低两位为合并/待合并标记)，
+strand内的引用在其它线程释放时直接减_sharedCount，减为负数时投递一次合并任务到所属strand；
+_localCount归零或合并任务执行时把_localCount并入_sharedCount，此后全部走_sharedCount；
+所属strand固定为创建时Actor所在的strand，Actor迁移后丢失通知转到Actor当前所在的strand执行
+*/
 class CheckLost_
 {
 	friend ActorFunc_;
-	FRIEND_SHARED_PTR(CheckLost_);
+	friend CheckLostRef_;
 private:
-	CheckLost_(const shared_strand& strand, msg_handle_base* msgHandle);
+	CheckLost_(const actor_handle& hostActor, msg_handle_base* msgHandle);
 	~CheckLost_();
+private:
+	/*!
+	@brief 增加一个引用，返回是否计入_sharedCount
+	*/
+	bool add_ref();
+	void release(bool shared);
+	void release_local();
+	void release_shared();
+	void merge_queued();
+	void lost();
 private:
 	shared_strand _strand;
+	actor_handle _hostActor;
 	shared_bool _closed;
 	msg_handle_base* _handle;
+	size_t _localCount;
+	bool _merged;
+	std::atomic<intptr_t> _sharedCount;
+};
+
+/*!
+@brief CheckLost_的引用句柄，记录自己计入了哪个计数，
+在所属strand中复制/释放不产生原子操作，在其它strand中释放时只做一次原子减
+*/
+class CheckLostRef_
+{
+	friend ActorFunc_;
+public:
+	CheckLostRef_()
+		:_ptr(NULL), _shared(false) {}
+
+	CheckLostRef_(const CheckLostRef_& s)
+		:_ptr(s._ptr), _shared(s._ptr ? s._ptr->add_ref() : false) {}
+
+	CheckLostRef_(CheckLostRef_&& s)
+		:_ptr(s._ptr), _shared(s._shared)
+	{
+		s._ptr = NULL;
+	}
+
+	~CheckLostRef_()
+	{
+		reset();
+	}
+
+	void operator =(const CheckLostRef_& s)
+	{
+		if (this != &s)
+		{
+			reset();
+			_ptr = s._ptr;
+			_shared = _ptr ? _ptr->add_ref() : false;
+		}
+	}
+
+	void operator =(CheckLostRef_&& s)
+	{
+		if (this != &s)
+		{
+			reset();
+			_ptr = s._ptr;
+			_shared = s._shared;
+			s._ptr = NULL;
+		}
+	}
+
+	void reset()
+	{
+		if (_ptr)
+		{
+			CheckLost_* const ptr = _ptr;
+			_ptr = NULL;
+			ptr->release(_shared);
+		}
+	}
+private:
+	explicit CheckLostRef_(CheckLost_* ptr)
+		:_ptr(ptr), _shared(false) {}
+private:
+	CheckLost_* _ptr;
+	bool _shared;
 };
 
 class CheckPumpLost_
@@ -224,6 +315,45 @@ class MsgNotiferBase_;
 
 struct select_msg_block_force_quit {};
 
+/*!
+@brief select单轮就绪块下标表，同步检测到的就绪块和等待期间异步送达的块都记录在这里
+*/
+struct SelectWake_
+{
+	SelectWake_(size_t* readyList)
+	:_readyList(readyList), _readyCount(0) {}
+
+	size_t* const _readyList;
+	size_t _readyCount;
+};
+
+/*!
+@brief 句柄参与select等待时的登记，向等待目标写入后、唤醒Actor前把块下标记入SelectWake_(都在Actor的strand中)
+*/
+struct SelectWakeSign_
+{
+	SelectWakeSign_()
+	:_wake(NULL), _index(0) {}
+
+	void arm(SelectWake_* wake, size_t index)
+	{
+		_wake = wake;
+		_index = index;
+	}
+
+	void woken()
+	{
+		if (_wake)
+		{
+			_wake->_readyList[_wake->_readyCount++] = _index;
+			_wake = NULL;
+		}
+	}
+
+	SelectWake_* _wake;
+	size_t _index;
+};
+
 enum pump_check_state
 {
 	pump_connected = 0,
@@ -247,6 +377,7 @@ class select_block_pump_check_lost;
 class msg_handle_base
 {
 	friend CheckLost_;
+	friend MutexBlock_;
 protected:
 	msg_handle_base();
 	virtual ~msg_handle_base(){}
@@ -265,6 +396,7 @@ protected:
 	my_actor* _hostActor;
 	shared_bool _closed;
 	DEBUG_OPERATION(shared_strand _strand);
+	SelectWakeSign_ _selectSign;
 	bool _waiting : 1;
 	bool _losted : 1;
 	bool _checkLost : 1;
@@ -309,7 +441,7 @@ protected:
 #ifdef ENABLE_CHECK_LOST
 		if (checkLost)
 		{
-			_autoCheckLost = ActorFunc_::new_check_lost(ActorFunc_::self_strand(_hostActor.get()), msgHandle);
+			_autoCheckLost = ActorFunc_::new_check_lost(_hostActor, msgHandle);
 		}
 #else
 		assert(!checkLost);
@@ -324,13 +456,13 @@ public:
 		if (!_closed)
 		{
 			typedef std::tuple<TYPE_PIPE(ARGS)...> args_tuple;
-			if (ActorFunc_::self_strand(_hostActor.get())->running_in_this_thread())
+			if (ActorFunc_::running_in_actor_strand(_hostActor.get()))
 			{
 				_msgHandle->push_msg(args_tuple(std::forward<Args>(args)...));
 			}
 			else
 			{
-				ActorFunc_::self_strand(_hostActor.get())->post(std::bind([](actor_handle& hostActor, MsgHandle* msgHandle, shared_bool& closed, args_tuple& args)
+				ActorFunc_::actor_post(_hostActor.get(), std::bind([](actor_handle& hostActor, MsgHandle* msgHandle, shared_bool& closed, args_tuple& args)
 				{
 					if (!closed)
 					{
@@ -347,13 +479,13 @@ public:
 		assert(!empty());
 		if (!_closed)
 		{
-			if (ActorFunc_::self_strand(_hostActor.get())->running_in_this_thread())
+			if (ActorFunc_::running_in_actor_strand(_hostActor.get()))
 			{
 				_msgHandle->push_msg();
 			}
 			else
 			{
-				ActorFunc_::self_strand(_hostActor.get())->post(std::bind([](actor_handle& hostActor, MsgHandle* msgHandle, shared_bool& closed)
+				ActorFunc_::actor_post(_hostActor.get(), std::bind([](actor_handle& hostActor, MsgHandle* msgHandle, shared_bool& closed)
 				{
 					if (!closed)
 					{
@@ -440,7 +572,7 @@ private:
 	actor_handle _hostActor;
 	shared_bool _closed;
 #ifdef ENABLE_CHECK_LOST
-	std::shared_ptr<CheckLost_> _autoCheckLost;
+	CheckLostRef_ _autoCheckLost;
 #endif
 };
 
@@ -542,6 +674,7 @@ private:
 				assert(_dstRec);
 				_dstRec->move_from(std::move(msg));
 				_dstRec = NULL;
+				Parent::_selectSign.woken();
 				ActorFunc_::pull_yield(Parent::_hostActor);
 				return;
 			}
@@ -643,6 +776,7 @@ private:
 					*_dstRec = true;
 					_dstRec = NULL;
 				}
+				Parent::_selectSign.woken();
 				ActorFunc_::pull_yield(Parent::_hostActor);
 				return;
 			}
@@ -763,6 +897,7 @@ private:
 				assert(_dstRec);
 				_dstRec->move_from(std::move(msg));
 				_dstRec = NULL;
+				Parent::_selectSign.woken();
 				ActorFunc_::pull_yield(Parent::_hostActor);
 				return;
 			}
@@ -880,6 +1015,7 @@ private:
 					*_dstRec = true;
 					_dstRec = NULL;
 				}
+				Parent::_selectSign.woken();
 				ActorFunc_::pull_yield(Parent::_hostActor);
 				return;
 			}
@@ -974,10 +1110,12 @@ class post_actor_msg;
 class MsgPumpBase_
 {
 	friend my_actor;
+	friend MutexBlock_;
 public:
 	virtual ~MsgPumpBase_() {}
 protected:
 	my_actor* _hostActor;
+	SelectWakeSign_ _selectSign;
 };
 
 template <typename... ARGS>
@@ -1045,12 +1183,13 @@ private:
 				{
 					_waiting = false;
 					_checkDis = false;
+					Parent::_selectSign.woken();
 					ActorFunc_::pull_yield(_hostActor);
 				}
-				//read_msgʱ
+				//read_msg时
 			}
 			else
-			{//pump_msgʱŽܵϢ
+			{//pump_msg超时结束后才接受到消息
 				assert(!_waiting);
 				_losted = false;
 				_hasMsg = true;
@@ -1068,6 +1207,7 @@ private:
 			_waiting = false;
 			_checkDis = false;
 			_dstRec = NULL;
+			Parent::_selectSign.woken();
 			ActorFunc_::pull_yield(_hostActor);
 		}
 	}
@@ -1240,6 +1380,7 @@ private:
 			assert(_waiting);
 			_waiting = false;
 			_dstRec = NULL;
+			Parent::_selectSign.woken();
 			ActorFunc_::pull_yield(_hostActor);
 		}
 	}
@@ -1406,14 +1547,14 @@ class MsgPool_ : public MsgPoolBase_
 		{
 			assert(_msgPump == _thisPool->_msgPump);
 			auto& msgBuff = _thisPool->_msgBuff;
-			if (!_thisPool->_waiting)//ϴȡϢʱȡ˵ȴʱȡûϢ
+			if (!_thisPool->_waiting)//上次取消息超时后取消了等待，此时取还没消息
 			{
 				if (pumpID == _thisPool->_sendCount)
 				{
 					if (!msgBuff.empty())
 					{
 						msg_pck mt_ = std::move(msgBuff.front());
-						msgBuff.pop_front();
+						_thisPool->pop_msg();
 						_thisPool->_sendCount++;
 #ifdef ENABLE_CHECK_LOST
 						if (!mt_._isMsg)
@@ -1432,7 +1573,7 @@ class MsgPool_ : public MsgPoolBase_
 					}
 				}
 				else
-				{//ϴϢûȡȡʵмѾpostȥ
+				{//上次消息没取到，重新取，但实际中间已经post出去了
 					assert(!_thisPool->_waiting);
 					assert(pumpID + 1 == _thisPool->_sendCount);
 				}
@@ -1477,7 +1618,7 @@ class MsgPool_ : public MsgPoolBase_
 #ifdef ENABLE_CHECK_LOST
 							if (!msgBuff.front()._isMsg)
 							{
-								msgBuff.pop_front();
+								thisPool_->pop_msg();
 								losted = true;
 								ok = true;
 							} 
@@ -1485,13 +1626,13 @@ class MsgPool_ : public MsgPoolBase_
 #endif
 							{
 								dst.move_from(std::move(msgBuff.front().get()));
-								msgBuff.pop_front();
+								thisPool_->pop_msg();
 								ok = true;
 							}
 						}
 					}
 					else
-					{//ϴϢûȡȡʵмѾpostȥ
+					{//上次消息没取到，重新取，但实际中间已经post出去了
 						assert(!thisPool_->_waiting);
 						assert(pumpID + 1 == thisPool_->_sendCount);
 						wait = true;
@@ -1597,9 +1738,19 @@ private:
 		res->_waiting = false;
 		res->_closed = false;
 		res->_sendCount = 0;
+		res->_urgentCount = 0;
 		return res;
 	}
 
+	void pop_msg()
+	{
+		_msgBuff.pop_front();
+		if (_urgentCount)
+		{
+			_urgentCount--;
+		}
+	}
+
 	void send_msg(msg_type&& mt, actor_handle&& hostActor)
 	{
 		if (_closed) return;
@@ -1625,7 +1776,9 @@ private:
 
 		if (_strand->running_in_this_thread())
 		{
-			send_msg(std::move(mt), ActorFunc_::shared_from_this(hostActor.get()));
+			//同一strand中，等待中的接收Actor会在当前调用栈直接切换进去，不经过strand队列；
+			//复制一份Actor引用保证切换期间接收Actor不被释放
+			send_msg(std::move(mt), actor_handle(hostActor));
 		}
 		else
 		{
@@ -1636,6 +1789,62 @@ private:
 		}
 	}
 
+	void push_msgs(std::vector<msg_type>&& msgs, const actor_handle& hostActor)
+	{
+		if (_closed) return;
+
+		if (_strand->running_in_this_thread())
+		{
+			for (msg_type& mt : msgs)
+			{
+				send_msg(std::move(mt), actor_handle(hostActor));
+			}
+		}
+		else
+		{
+			//整批消息只投递一次
+			_strand->post(std::bind([](actor_handle& hostActor, const std::shared_ptr<MsgPool_>& sharedThis, std::vector<msg_type>& msgs)
+			{
+				for (msg_type& mt : msgs)
+				{
+					sharedThis->send_msg(std::move(mt), actor_handle(hostActor));
+				}
+			}, hostActor, _weakThis.lock(), std::move(msgs)));
+		}
+	}
+
+	void send_urgent_msg(msg_type&& mt, actor_handle&& hostActor)
+	{
+		if (_closed) return;
+
+		if (_waiting)
+		{
+			send_msg(std::move(mt), std::move(hostActor));
+		}
+		else
+		{
+			//排在已缓存的紧急消息之后、普通消息之前
+			_msgBuff.insert(_urgentCount++, std::move(mt));
+		}
+	}
+
+	void push_msg_urgent(msg_type&& mt, const actor_handle& hostActor)
+	{
+		if (_closed) return;
+
+		if (_strand->running_in_this_thread())
+		{
+			send_urgent_msg(std::move(mt), actor_handle(hostActor));
+		}
+		else
+		{
+			_strand->post_urgent(std::bind([](actor_handle& hostActor, const std::shared_ptr<MsgPool_>& sharedThis, msg_type& msg)
+			{
+				sharedThis->send_urgent_msg(std::move(msg), std::move(hostActor));
+			}, hostActor, _weakThis.lock(), std::move(mt)));
+		}
+	}
+
 	void _lost_msg(actor_handle&& hostActor)
 	{
 		if (_closed) return;
@@ -1703,12 +1912,17 @@ private:
 		{
 			_msgBuff.push_front(msg_pck());
 		}
+		if (_urgentCount)
+		{
+			_urgentCount++;
+		}
 	}
 private:
 	std::weak_ptr<MsgPool_> _weakThis;
 	shared_strand _strand;
 	std::shared_ptr<msg_pump_type> _msgPump;
 	msg_queue<msg_pck> _msgBuff;
+	size_t _urgentCount;///<_msgBuff队首的紧急消息数
 	unsigned char _sendCount;
 	bool _waiting : 1;
 	bool _closed : 1;
@@ -1768,6 +1982,7 @@ protected:
 protected:
 	void send_msg(actor_handle&& hostActor);
 	void push_msg(const actor_handle& hostActor);
+	void push_msg_urgent(const actor_handle& hostActor);
 	void lost_msg(actor_handle&& hostActor);
 	void _lost_msg(actor_handle&& hostActor);
 	pump_handler connect_pump(const std::shared_ptr<msg_pump_type>& msgPump);
@@ -2044,6 +2259,37 @@ public:
 		_msgPool->push_msg(_hostActor);
 	}
 
+	/*!
+	@brief 以高优先级投递，跨strand时走紧急队列，在接收方排在所有普通消息之前
+	*/
+	template <typename... Args>
+	void post_urgent(Args&&... args) const
+	{
+		static_assert(sizeof...(ARGS) == sizeof...(Args), "");
+		assert(!empty());
+		_msgPool->push_msg_urgent(std::tuple<TYPE_PIPE(ARGS)...>(std::forward<Args>(args)...), _hostActor);
+	}
+
+	void post_urgent() const
+	{
+		static_assert(sizeof...(ARGS) == 0, "");
+		assert(!empty());
+		_msgPool->push_msg_urgent(_hostActor);
+	}
+
+	/*!
+	@brief 批量投递，跨strand时整批只投递一次
+	*/
+	void post_batch(std::vector<std::tuple<TYPE_PIPE(ARGS)...>>&& msgs) const
+	{
+		static_assert(sizeof...(ARGS) != 0, "");
+		assert(!empty());
+		if (!msgs.empty())
+		{
+			_msgPool->push_msgs(std::move(msgs), _hostActor);
+		}
+	}
+
 	std::function<void(ARGS...)> case_func() const
 	{
 		return std::function<void(ARGS...)>(*this);
@@ -2057,7 +2303,7 @@ public:
 	void clear()
 	{
 #ifdef ENABLE_CHECK_LOST
-		_autoCheckLost.reset();//_msgPool.reset()
+		_autoCheckLost.reset();//必须在_msgPool.reset()上面
 #endif
 		_hostActor.reset();
 		_msgPool.reset();
@@ -2076,7 +2322,7 @@ private:
 	actor_handle _hostActor;
 	std::shared_ptr<msg_pool_type> _msgPool;
 #ifdef ENABLE_CHECK_LOST
-	std::shared_ptr<CheckPumpLost_> _autoCheckLost;//_msgPool
+	std::shared_ptr<CheckPumpLost_> _autoCheckLost;//必须在_msgPool下面
 #endif
 };
 //////////////////////////////////////////////////////////////////////////
@@ -2091,16 +2337,27 @@ private:
 	virtual size_t snap_id() = 0;
 	virtual long long host_id() = 0;
 	virtual void check_lost() = 0;
+	virtual void select_arm(SelectWake_* wake, size_t index) {}
 protected:
 	MutexBlock_() {}
 	long long actor_id(my_actor* host);
+
+	static void arm_handle(msg_handle_base& handle, SelectWake_* wake, size_t index)
+	{
+		handle._selectSign.arm(wake, index);
+	}
+
+	static void arm_handle(MsgPumpBase_* pump, SelectWake_* wake, size_t index)
+	{
+		pump->_selectSign.arm(wake, index);
+	}
 	NONE_COPY(MutexBlock_);
 };
 
 #define __MUTEX_BLOCK_HANDLER_WRAP(__dst__, __src__, __host__)  FUNCTION_ALLOCATOR(__dst__, __src__, (reusable_alloc<>(ActorFunc_::reu_mem(__host__))))
 
 /*!
-@brief msg_handleϢִп
+@brief msg_handle消息互斥执行块
 */
 template <typename... ARGS>
 class select_block_msg : public MutexBlock_
@@ -2163,6 +2420,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -2170,7 +2432,7 @@ private:
 };
 
 /*!
-@brief trig_handleϢִп
+@brief trig_handle消息互斥执行块
 */
 template <typename... ARGS>
 class select_block_trig : public MutexBlock_
@@ -2233,6 +2495,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -2240,7 +2507,7 @@ private:
 };
 
 /*!
-@brief msg_pumpϢִп
+@brief msg_pump消息互斥执行块
 */
 template <typename... ARGS>
 class select_block_pump : public MutexBlock_
@@ -2316,6 +2583,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle.get()->_hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle.get(), wake, index);
+	}
 private:
 	pump_handle _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -2382,6 +2654,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool()> _handler;
@@ -2448,6 +2725,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool()> _handler;
@@ -2527,6 +2809,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle.get()->_hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle.get(), wake, index);
+	}
 private:
 	pump_handle _msgHandle;
 	std::function<bool()> _handler;
@@ -2702,6 +2989,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle.get()->_hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle.get(), wake, index);
+	}
 private:
 	pump_handle _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -2832,6 +3124,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle.get()->_hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle.get(), wake, index);
+	}
 private:
 	pump_handle _msgHandle;
 	std::function<bool()> _handler;
@@ -2847,7 +3144,7 @@ private:
 #ifdef ENABLE_CHECK_LOST
 
 /*!
-@brief msg_handleϢִп飬֪ͨʧ
+@brief msg_handle消息互斥执行块，带通知句柄丢失处理
 */
 template <typename... ARGS>
 class select_block_msg_check_lost : public MutexBlock_
@@ -2930,6 +3227,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -2940,7 +3242,7 @@ private:
 };
 
 /*!
-@brief trig_handleϢִп飬֪ͨʧ
+@brief trig_handle消息互斥执行块，带通知句柄丢失处理
 */
 template <typename... ARGS>
 class select_block_trig_check_lost : public MutexBlock_
@@ -3023,6 +3325,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -3033,7 +3340,7 @@ private:
 };
 
 /*!
-@brief msg_pumpϢִп飬֪ͨʧ
+@brief msg_pump消息互斥执行块，带通知句柄丢失处理
 */
 template <typename... ARGS>
 class select_block_pump_check_lost : public MutexBlock_
@@ -3128,6 +3435,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle.get()->_hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle.get(), wake, index);
+	}
 private:
 	pump_handle _msgHandle;
 	std::function<bool(ARGS...)> _handler;
@@ -3217,6 +3529,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool()> _handler;
@@ -3306,6 +3623,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle._hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle, wake, index);
+	}
 private:
 	MsgHandle& _msgHandle;
 	std::function<bool()> _handler;
@@ -3407,6 +3729,11 @@ private:
 	{
 		return MutexBlock_::actor_id(_msgHandle.get()->_hostActor);
 	}
+
+	void select_arm(SelectWake_* wake, size_t index)
+	{
+		MutexBlock_::arm_handle(_msgHandle.get(), wake, index);
+	}
 private:
 	pump_handle _msgHandle;
 	std::function<bool()> _handler;
@@ -3612,7 +3939,7 @@ template <typename... TYPES>
 class sync_cb_handler {};
 
 /*!
-@brief 첽ص(ԶδֻеһЧ)Ϊص룬صԶصһִ
+@brief 异步回调器(可以多次触发，但只有第一次有效)，作为回调函数参数传入，回调后，自动返回到下一行语句继续执行
 */
 template <typename... ARGS, typename... OUTS>
 class callback_handler<types_pck<ARGS...>, types_pck<OUTS...>> : public TrigOnceBase_
@@ -3691,7 +4018,7 @@ private:
 	bool _hasTm;
 };
 /*!
-@brief 첽ص(ٴԶδֻеһЧ)Ϊص룬صԶصһִ
+@brief 异步回调器(可以少传参数，可以多次触发，但只有第一次有效)，作为回调函数参数传入，回调后，自动返回到下一行语句继续执行
 */
 template <typename... ARGS, typename... OUTS>
 class same_callback_handler<types_pck<ARGS...>, types_pck<OUTS...>> : public TrigOnceBase_
@@ -3772,7 +4099,7 @@ private:
 };
 
 /*!
-@brief ASIO첽ص(ֻܴһ)Ϊص룬صԶصһִ
+@brief ASIO异步回调器(只能触发一次)，作为回调函数参数传入，回调后，自动返回到下一行语句继续执行
 */
 template <typename... ARGS, typename... OUTS>
 class asio_callback_handler<types_pck<ARGS...>, types_pck<OUTS...>> : public TrigOnceBase_
@@ -3850,7 +4177,7 @@ private:
 };
 
 /*!
-@brief ASIO첽ص(ٴֻܴһ)Ϊص룬صԶصһִ
+@brief ASIO异步回调器(可以少传参数，只能触发一次)，作为回调函数参数传入，回调后，自动返回到下一行语句继续执行
 */
 template <typename... ARGS, typename... OUTS>
 class asio_same_callback_handler<types_pck<ARGS...>, types_pck<OUTS...>> : public TrigOnceBase_
@@ -3930,7 +4257,7 @@ private:
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief 첽ص(HandlerڻصڲֱִУܴ̰߳ȫ)Ϊص룬صԶصһִ
+@brief 异步回调器(Handler将在回调内部直接执行，可能触发线程安全问题)，作为回调函数参数传入，回调后，自动返回到下一行语句继续执行
 */
 template <typename Handler, typename R>
 class on_callback_handler : public TrigOnceBase_
@@ -3999,7 +4326,7 @@ private:
 };
 
 /*!
-@brief ͬص뷵ֵ
+@brief 同步回调传入返回值
 */
 template <typename R>
 struct sync_result
@@ -4048,7 +4375,7 @@ struct sync_result
 };
 
 /*!
-@brief ͬصΪص룬صԶصһִ
+@brief 同步回调器，作为回调函数参数传入，回调后，自动返回到下一行语句继续执行
 */
 template <typename R, typename... ARGS, typename... OUTS>
 class sync_cb_handler<R, types_pck<ARGS...>, types_pck<OUTS...>> : public TrigOnceBase_
@@ -4275,7 +4602,7 @@ private:
 };
 
 /*!
-@brief װһhandler뵱ǰios޹ص߳ͬ
+@brief 包装一个handler到与当前ios无关的线程中同步调用
 */
 template <typename R, typename Handler>
 wrapped_sync_handler<R, Handler> wrap_sync(sync_result<R>& res, Handler&& handler)
@@ -4291,7 +4618,7 @@ wrapped_sync_handler2<R, Handler> wrap_sync2(sync_result<R>& res, Handler&& hand
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief Actor
+@brief 子Actor句柄
 */
 class child_handle
 {
@@ -4313,7 +4640,6 @@ private:
 private:
 	actor_handle _actor;
 	trig_handle<> _quiteAth;
-	std::list<actor_handle>::iterator _actorIt;
 	std::list<std::function<void()> >::iterator _athIt;
 	bool _started : 1;
 	bool _quited : 1;
@@ -4410,7 +4736,7 @@ struct AutoStackAgent_
 
 #else
 
-//Զջռ
+//自动栈空间控制
 #define auto_stack(...) AutoStack_(__VA_ARGS__, __COUNTER__)*
 #define auto_stack_msg_agent(...) AutoStackAgent_(__VA_ARGS__, __COUNTER__)*
 #define auto_stack_ AutoStack_(0, __COUNTER__)*
@@ -4421,7 +4747,7 @@ struct AutoStackAgent_
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief Actor
+@brief Actor对象
 */
 class my_actor : public ActorTimerFace_
 {
@@ -4429,12 +4755,12 @@ class my_actor : public ActorTimerFace_
 	{
 		template <typename Handler>
 		suspend_resume_option(bool isSuspend, Handler&& h)
-			:_isSuspend(isSuspend), _h(std::forward<Handler>(h)) {}
+			:_isSuspend(isSuspend), _next(NULL), _h(std::forward<Handler>(h)) {}
 
 		bool _isSuspend;
+		suspend_resume_option* _next;
 		std::function<void()> _h;
 		NONE_COPY(suspend_resume_option);
-		RVALUE_CONSTRUCT2(suspend_resume_option, _isSuspend, _h);
 	};
 
 	struct msg_pool_status
@@ -4592,6 +4918,25 @@ class my_actor : public ActorTimerFace_
 		static msg_map_shared_alloc<id_key, std::shared_ptr<pck_base> >::shared_node_alloc* _msgTypeMapAll;
 	};
 
+	/*!
+	@brief Actor不常用的数据，第一次用到时才分配，不占用Actor栈上的对象空间
+	*/
+	struct ActorCold_
+	{
+		ActorCold_()
+			:_suspendHead(NULL), _suspendTail(NULL), _childOverCount(0), _childSuspendResumeCount(0) {}
+
+		msg_pool_status _msgPoolStatus;///<消息池列表
+		std::list<std::function<void()> > _quitCallback;///<Actor结束后的回调函数
+		std::list<std::function<void()> > _beginQuitExec;///<Actor准备退出时调用的函数，后注册的先执行
+		suspend_resume_option* _suspendHead;///<挂起/恢复操作队列
+		suspend_resume_option* _suspendTail;
+		size_t _childOverCount;///<子Actor退出时计数
+		size_t _childSuspendResumeCount;///<子Actor挂起/恢复计数
+		std::list<shared_strand> _oldStrands;///<迁移前所在的strand，保留到Actor析构，其它线程读到的旧_currStrand一直有效
+		NONE_COPY(ActorCold_);
+	};
+
 	template <typename DST, typename ARG>
 	struct async_invoke_handler
 	{
@@ -4653,12 +4998,21 @@ class my_actor : public ActorTimerFace_
 	{
 		template <typename ActorHandle>
 		wrap_trig_run_one(ActorHandle&& self, bool* sign)
-			:_lockSelf(std::forward<ActorHandle>(self)), _sign(sign) {}
+			:_lockSelf(std::forward<ActorHandle>(self)), _sign(sign)
+		{
+#ifdef ENABLE_ACTOR_PROFILE
+			//可能在其它线程构造，唤醒时刻先记在自己身上，到strand中执行时再交给Actor
+			_wakeTick = cpu_tick();
+#endif
+		}
 
 		void operator()()
 		{
 			if (!_lockSelf->_quited)
 			{
+#ifdef ENABLE_ACTOR_PROFILE
+				_lockSelf->_profWakeTick = _wakeTick;
+#endif
 				run_one(_lockSelf.get(), _sign);
 			}
 		}
@@ -4677,16 +5031,27 @@ class my_actor : public ActorTimerFace_
 		}
 
 		wrap_trig_run_one(const wrap_trig_run_one& s)
-			:_lockSelf(s._lockSelf), _sign(s._sign) {}
+			:_lockSelf(s._lockSelf), _sign(s._sign)
+		{
+#ifdef ENABLE_ACTOR_PROFILE
+			_wakeTick = s._wakeTick;
+#endif
+		}
 
 		wrap_trig_run_one(wrap_trig_run_one&& s)
 			:_lockSelf(std::move(s._lockSelf)), _sign(s._sign)
 		{
+#ifdef ENABLE_ACTOR_PROFILE
+			_wakeTick = s._wakeTick;
+#endif
 			s._sign = NULL;
 		}
 
 		actor_handle _lockSelf;
 		bool* _sign;
+#ifdef ENABLE_ACTOR_PROFILE
+		unsigned long long _wakeTick;
+#endif
 	private:
 		void operator =(const wrap_trig_run_one&) = delete;
 	};
@@ -4695,12 +5060,20 @@ class my_actor : public ActorTimerFace_
 	{
 		template <typename ActorHandle>
 		wrap_check_trig_run_one(shared_bool& closed, ActorHandle&& self, bool* sign)
-			:_closed(closed), _lockSelf(std::forward<ActorHandle>(self)), _sign(sign) {}
+			:_closed(closed), _lockSelf(std::forward<ActorHandle>(self)), _sign(sign)
+		{
+#ifdef ENABLE_ACTOR_PROFILE
+			_wakeTick = cpu_tick();
+#endif
+		}
 
 		void operator()()
 		{
 			if (!_lockSelf->_quited && !_closed)
 			{
+#ifdef ENABLE_ACTOR_PROFILE
+				_lockSelf->_profWakeTick = _wakeTick;
+#endif
 				run_one(_lockSelf.get(), _closed, _sign);
 			}
 		}
@@ -4720,21 +5093,68 @@ class my_actor : public ActorTimerFace_
 		}
 
 		wrap_check_trig_run_one(const wrap_check_trig_run_one& s)
-			:_closed(s._closed), _lockSelf(s._lockSelf), _sign(s._sign) {}
+			:_closed(s._closed), _lockSelf(s._lockSelf), _sign(s._sign)
+		{
+#ifdef ENABLE_ACTOR_PROFILE
+			_wakeTick = s._wakeTick;
+#endif
+		}
 
 		wrap_check_trig_run_one(wrap_check_trig_run_one&& s)
 			:_closed(std::move(s._closed)), _lockSelf(std::move(s._lockSelf)), _sign(s._sign)
 		{
+#ifdef ENABLE_ACTOR_PROFILE
+			_wakeTick = s._wakeTick;
+#endif
 			s._sign = NULL;
 		}
 
 		shared_bool _closed;
 		actor_handle _lockSelf;
 		bool* _sign;
+#ifdef ENABLE_ACTOR_PROFILE
+		unsigned long long _wakeTick;
+#endif
 	private:
 		void operator =(const wrap_check_trig_run_one&) = delete;
 	};
 
+	/*!
+	@brief 其它线程投递给Actor的任务，执行时Actor已经迁移到别的strand就转投过去；
+	Handler必须持有actor_handle，保证转投期间Actor不析构
+	*/
+	template <typename Handler>
+	struct wrap_forward_handler
+	{
+		template <typename H>
+		wrap_forward_handler(my_actor* self, H&& h)
+			:_self(self), _handler(std::forward<H>(h)) {}
+
+		wrap_forward_handler(const wrap_forward_handler& s)
+			:_self(s._self), _handler(s._handler) {}
+
+		wrap_forward_handler(wrap_forward_handler&& s)
+			:_self(s._self), _handler(std::move(s._handler)) {}
+
+		void operator()()
+		{
+			boost_strand* const strand = _self->curr_strand();
+			if (strand->running_in_this_thread())
+			{
+				_handler();
+			}
+			else
+			{
+				strand->post(std::move(*this));
+			}
+		}
+
+		my_actor* _self;
+		Handler _handler;
+	private:
+		void operator =(const wrap_forward_handler&) = delete;
+	};
+
 	struct wrap_timer_handler_face
 	{
 		virtual void invoke() = 0;
@@ -4785,7 +5205,7 @@ class my_actor : public ActorTimerFace_
 	friend ActorFunc_;
 public:
 	/*!
-	@brief {}һΧǰActorǿ˳ڼ䱻𣬽޷ȴ˳
+	@brief 在{}一定范围内锁定当前Actor不被强制退出，如果锁定期间被挂起，将无法等待其退出
 	*/
 	class quit_guard
 	{
@@ -4801,7 +5221,7 @@ public:
 	};
 
 	/*!
-	@brief {}һΧǰActor
+	@brief 在{}一定范围内锁定当前Actor不被挂起
 	*/
 	class suspend_guard
 	{
@@ -4817,17 +5237,17 @@ public:
 	};
 
 	/*!
-	@brief Actorǿ˳쳣
+	@brief Actor被强制退出的异常类型
 	*/
 	struct force_quit_exception { };
 
 	/*!
-	@brief ջռľ쳣
+	@brief 栈空间耗尽异常
 	*/
 	struct stack_exhaustion_exception { };
 
 	/*!
-	@brief Actorں
+	@brief Actor入口函数体
 	*/
 	typedef std::function<void(my_actor*)> main_func;
 
@@ -4835,6 +5255,20 @@ public:
 	@brief actor id
 	*/
 	typedef long long id;
+
+#ifdef ENABLE_ACTOR_PROFILE
+	/*!
+	@brief Actor运行统计(微秒)
+	*/
+	struct profile_info
+	{
+		long long runTime;///<在strand中运行的时间
+		long long readyTime;///<可运行但等待strand调度的时间
+		long long blockTime;///<阻塞在消息/定时器等上的时间
+		size_t yieldCount;///<切换次数
+		size_t actorCount;///<统计的Actor个数
+	};
+#endif
 private:
 	my_actor();
 	my_actor(const my_actor&);
@@ -4842,10 +5276,10 @@ private:
 	~my_actor();
 public:
 	/*!
-	@brief һActor
-	@param actorStrand Actorstrand
-	@param mainFunc Actorִ
-	@param stackSize ActorջСĬ64kֽڣ4kС4k1M
+	@brief 创建一个Actor
+	@param actorStrand Actor所依赖的strand
+	@param mainFunc Actor执行入口
+	@param stackSize Actor栈大小，默认64k字节，必须是4k的整数倍，最小4k，最大1M
 	*/
 	static actor_handle create(shared_strand actorStrand, main_func mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
 	static actor_handle create(shared_strand actorStrand, AutoStackActorFace_&& wrapActor);
@@ -4854,7 +5288,7 @@ public:
 	static actor_handle create_and_notify(SharedStrand&& actorStrand, MainFunc&& mainFunc, NotifyFunc&& notifyFunc, size_t stackSize = DEFAULT_STACKSIZE)
 	{
 		actor_handle newActor = create(std::forward<SharedStrand>(actorStrand), std::forward<MainFunc>(mainFunc), stackSize);
-		newActor->_quitCallback.push_back(std::forward<NotifyFunc>(notifyFunc));
+		newActor->cold()._quitCallback.push_back(std::forward<NotifyFunc>(notifyFunc));
 		return newActor;
 	}
 
@@ -4862,16 +5296,16 @@ public:
 	static actor_handle create_and_notify(SharedStrand&& actorStrand, AutoStackActorFace_&& wrapActor, NotifyFunc&& notifyFunc)
 	{
 		actor_handle newActor = create(std::forward<SharedStrand>(actorStrand), std::move(wrapActor));
-		newActor->_quitCallback.push_back(std::forward<NotifyFunc>(notifyFunc));
+		newActor->cold()._quitCallback.push_back(std::forward<NotifyFunc>(notifyFunc));
 		return newActor;
 	}
 public:
 	/*!
-	@brief һActorActorֹʱActorҲֹActorȫ˳󣬸ActorŽ
-	@param actorStrand Actorstrand
-	@param mainFunc Actorں
-	@param stackSize ActorջС4k1MB
-	@return Actor
+	@brief 创建一个子Actor，父Actor终止时，子Actor也终止（在子Actor都完全退出后，父Actor才结束）
+	@param actorStrand 子Actor依赖的strand
+	@param mainFunc 子Actor入口函数
+	@param stackSize Actor栈大小，4k的整数倍（最大1MB）
+	@return 子Actor句柄
 	*/
 	child_handle create_child(shared_strand actorStrand, main_func mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
 	child_handle create_child(main_func mainFunc, size_t stackSize = DEFAULT_STACKSIZE);
@@ -4879,7 +5313,7 @@ public:
 	child_handle create_child(AutoStackActorFace_&& wrapActor);
 
 	/*!
-	@brief ʼActorֻܵһ
+	@brief 开始运行子Actor，只能调用一次
 	*/
 	void child_run(child_handle& actorHandle);
 
@@ -4892,7 +5326,7 @@ public:
 	}
 
 	/*!
-	@brief ʼһActorֻܵһ
+	@brief 开始运行一组子Actor，只能调用一次
 	*/
 	void children_run(std::list<child_handle::ptr>& actorHandles);
 	void children_run(std::list<child_handle>& actorHandles);
@@ -4918,7 +5352,7 @@ public:
 	}
 
 	/*!
-	@brief ǿֹһActor
+	@brief 强制终止一个子Actor
 	*/
 	__yield_interrupt void child_force_quit(child_handle& actorHandle);
 
@@ -4931,7 +5365,7 @@ public:
 	}
 
 	/*!
-	@brief ǿֹһActor
+	@brief 强制终止一组Actor
 	*/
 	__yield_interrupt void children_force_quit(std::list<child_handle::ptr>& actorHandles);
 	__yield_interrupt void children_force_quit(std::list<child_handle>& actorHandles);
@@ -4983,8 +5417,8 @@ public:
 	}
 
 	/*!
-	@brief ȴһActorɺ󷵻
-	@return ˳ķtruefalse
+	@brief 等待一个子Actor完成后返回
+	@return 正常退出的返回true，否则false
 	*/
 	__yield_interrupt void child_wait_quit(child_handle& actorHandle);
 
@@ -4999,8 +5433,8 @@ public:
 	__yield_interrupt bool timed_child_wait_quit(int ms, child_handle& actorHandle);
 
 	/*!
-	@brief ȴһActorɺ󷵻
-	@return ˳ķtruefalse
+	@brief 等待一组子Actor完成后返回
+	@return 都正常退出的返回true，否则false
 	*/
 	__yield_interrupt void children_wait_quit(std::list<child_handle::ptr>& actorHandles);
 	__yield_interrupt void children_wait_quit(std::list<child_handle>& actorHandles);
@@ -5028,7 +5462,7 @@ public:
 	}
 
 	/*!
-	@brief Actor
+	@brief 挂起子Actor
 	*/
 	__yield_interrupt void child_suspend(child_handle& actorHandle);
 
@@ -5043,7 +5477,7 @@ public:
 	}
 
 	/*!
-	@brief һActor
+	@brief 挂起一组子Actor
 	*/
 	__yield_interrupt void children_suspend(std::list<child_handle::ptr>& actorHandles);
 	__yield_interrupt void children_suspend(std::list<child_handle>& actorHandles);
@@ -5091,7 +5525,7 @@ public:
 	}
 
 	/*!
-	@brief ָActor
+	@brief 恢复子Actor
 	*/
 	__yield_interrupt void child_resume(child_handle& actorHandle);
 
@@ -5106,7 +5540,7 @@ public:
 	}
 
 	/*!
-	@brief ָһActor
+	@brief 恢复一组子Actor
 	*/
 	__yield_interrupt void children_resume(std::list<child_handle::ptr>& actorHandles);
 	__yield_interrupt void children_resume(std::list<child_handle>& actorHandles);
@@ -5154,13 +5588,13 @@ public:
 	}
 
 	/*!
-	@brief һActorActorִɺ󷵻
+	@brief 创建另一个Actor，Actor执行完成后返回
 	*/
 	__yield_interrupt void run_child_complete(shared_strand actorStrand, const main_func& h, size_t stackSize = DEFAULT_STACKSIZE);
 	__yield_interrupt void run_child_complete(const main_func& h, size_t stackSize = DEFAULT_STACKSIZE);
 
 	/*!
-	@brief һgenerator壬ɺ󷵻
+	@brief 运行一个generator函数体，完成后返回
 	*/
 	template <typename Handler>
 	__yield_interrupt void run_generator(shared_strand actorStrand, Handler&& h)
@@ -5181,8 +5615,8 @@ public:
 	}
 
 	/*!
-	@brief ʱȴ
-	@param ms/us ȴʱ䣬0ʱʱActorִУֱ´α
+	@brief 延时等待
+	@param ms/us 等待时间，等于0时暂时放弃Actor执行，直到下次被调度器触发
 	*/
 	__yield_interrupt void sleep(int ms);
 	__yield_interrupt void sleep_guard(int ms);
@@ -5190,7 +5624,7 @@ public:
 	__yield_interrupt void usleep_guard(long long us);
 
 	/*!
-	@brief Ծʱsleep
+	@brief 以绝对时间sleep
 	*/
 	__yield_interrupt void dead_sleep(long long ms);
 	__yield_interrupt void dead_sleep_guard(long long ms);
@@ -5198,51 +5632,59 @@ public:
 	__yield_interrupt void dead_usleep_guard(long long us);
 
 	/*!
-	@brief жϵǰʱƬȵ´α(ΪActorǷռʽȣռʱƬϳ߼ʱʵʹyieldָʱƬ)
+	@brief 中断当前时间片，等到下次被调度(因为Actor是非抢占式调度，当有占用时间片较长的逻辑时，适当使用yield分割时间片)
 	*/
 	__yield_interrupt void yield();
 
 	/*!
-	@brief yieldǰyieldϴtry_yieldû䣬yieldһ
+	@brief 尝试yield，如果当前yield计数和上次try_yield没变，就yield一次
 	*/
 	__yield_interrupt void try_yield();
 
 	/*!
-	@brief ˳жʱƬ
+	@brief 锁定退出后，中断时间片
 	*/
 	__yield_interrupt void tick_yield();
 
 	/*!
-	@brief yield_guardǰyieldϴtry_yieldû䣬yield_guardһ
+	@brief 尝试yield_guard，如果当前yield计数和上次try_yield没变，就yield_guard一次
 	*/
 	__yield_interrupt void try_tick_yield();
 
 	/*!
-	@brief ȡActor
+	@brief 中断当前时间片，然后迁移到另一个strand上继续运行(同一个io_engine)；
+	迁移时不能有子Actor、消息泵和未完成的定时，迁移期间不应有其它Actor对本Actor进行退出/挂起等控制，
+	Actor只通过channel/msg_buffer等与其它Actor通信时满足这些条件；
+	迁移完成时原子发布新strand，之后投递到旧strand的通知/退出/丢失检测等任务会转投到新strand
+	*/
+	__yield_interrupt void migrate(const shared_strand& dst);
+
+	/*!
+	@brief 获取父Actor
 	*/
 	const actor_handle& parent_actor();
 
 	/*!
-	@brief ȡActor
+	@brief 获取子Actor(复制一份当前子Actor列表)
 	*/
-	const std::list<actor_handle>& children();
+	std::vector<actor_handle> children();
 public:
 	typedef std::list<std::function<void()> >::iterator quit_iterator;
 
 	/*!
-	@brief עһԴͷźǿ׼˳Actorʱִ
+	@brief 注册一个资源释放函数，在强制准备退出Actor时执行
 	*/
 	quit_iterator regist_quit_executor(std::function<void()> quitHandler);
 
 	/*!
-	@brief עԴͷź
+	@brief 注销资源释放函数
 	*/
 	void cancel_quit_executor(const quit_iterator& qh);
 public:
 	/*!
-	@brief ʹڲʱʱĳڴ֮ǰܶε
-	@param ms ʱ()
-	@param handler 
+	@brief 使用内部定时器延时触发某个函数，在触发完成之前不能多次调用
+	@param ms 触发延时(毫秒)
+	@param handler 触发函数
 	*/
 	template <typename Handler>
 	void delay_trig(int ms, Handler&& handler)
@@ -5259,9 +5701,9 @@ public:
 	}
 
 	/*!
-	@brief ʹڲʱھʱ䴥ĳڴ֮ǰܶε
-	@param us ʱ(΢)
-	@param handler 
+	@brief 使用内部定时器在绝对时间触发某个函数，在触发完成之前不能多次调用
+	@param us 触发时间(微秒)
+	@param handler 触发函数
 	*/
 	template <typename Handler>
 	void deadline_trig(long long us, Handler&& handler)
@@ -5271,12 +5713,12 @@ public:
 	}
 
 	/*!
-	@brief ȡڲʱ
+	@brief 取消内部定时器触发
 	*/
 	void cancel_delay_trig();
 public:
 	/*!
-	@brief һ첽shared_strandִУǺ͵ǰһshared_strandֱִУquit_guardʹ÷ֹʧЧɺ󷵻
+	@brief 发送一个异步函数到shared_strand中执行（如果是和当前一样的shared_strand直接执行），配合quit_guard使用防止引用失效，完成后返回
 	*/
 	template <typename H>
 	__yield_interrupt void send(const shared_strand& exeStrand, H&& h)
@@ -5326,7 +5768,7 @@ public:
 	}
 
 	/*!
-	@brief ǰ"ϵͳ߳"ջ׳һɺ󷵻أĶջߵĺ
+	@brief 往当前"系统线程"堆栈中抛出一个任务，完成后返回，（用于消耗堆栈高的函数）
 	*/
 	template <typename H>
 	__yield_interrupt void run_in_thread_stack(H&& h)
@@ -5357,7 +5799,7 @@ public:
 	}
 
 	/*!
-	@brief лһռջһ治ܽл
+	@brief 切换到一个大空间栈内运行一个任务，里面不能进行切换操作
 	*/
 	template <typename H>
 	void run_in_safe_stack(H&& h)
@@ -5368,8 +5810,8 @@ public:
 	}
 
 	/*!
-	@brief ǿƽһ͵һshared_strandִУĳAPIкܶεĶջãǰActorջôл̶߳ջֱִУ
-	quit_guardʹ÷ֹʧЧɺ󷵻
+	@brief 强制将一个函数发送到一个shared_strand中执行（比如某个API会进行很多层次的堆栈调用，而当前Actor堆栈不够，可以用此切换到线程堆栈中直接执行），
+	配合quit_guard使用防止引用失效，完成后返回
 	*/
 	template <typename H>
 	__yield_interrupt void async_send(const shared_strand& exeStrand, H&& h)
@@ -5489,7 +5931,7 @@ private:
 	}
 public:
 	/*!
-	@brief һ첽첽صɺ󷵻
+	@brief 调用一个异步函数，异步回调完成后返回
 	*/
 	template <typename... Outs, typename Func>
 	__yield_interrupt void trig(Outs&... dargs, Func&& h)
@@ -5527,7 +5969,7 @@ public:
 	}
 
 	/*!
-	@brief һ첽첽صɺ󷵻أ֮ǿ˳
+	@brief 调用一个异步函数，异步回调完成后返回，之间锁定强制退出
 	*/
 	template <typename... Outs, typename Func>
 	__yield_interrupt void trig_guard(Outs&... dargs, Func&& h)
@@ -5577,18 +6019,41 @@ private:
 	void tick_handler(bool* sign);
 	void tick_handler(shared_bool& closed, bool* sign);
 
+	/*!
+	@brief Actor当前所在的strand，可在其它线程读取
+	*/
+	boost_strand* curr_strand()
+	{
+		return _currStrand.load(std::memory_order_acquire);
+	}
+
+	/*!
+	@brief 从其它线程投递任务到Actor当前所在的strand，Actor迁移后转投到新strand
+	*/
+	template <typename Handler>
+	void actor_post(Handler&& h)
+	{
+		curr_strand()->post(wrap_forward_handler<RM_CREF(Handler)>(this, std::forward<Handler>(h)));
+	}
+
+	template <typename Handler>
+	void actor_try_tick(Handler&& h)
+	{
+		curr_strand()->try_tick(wrap_forward_handler<RM_CREF(Handler)>(this, std::forward<Handler>(h)));
+	}
+
 	template <typename DST, typename SRC>
 	void _trig_handler(bool* sign, DST& dstRec, SRC&& args)
 	{
 		assert(!_quited);
 		same_copy_tuple_to_tuple(dstRec, std::forward<SRC>(args));
-		if (_strand->running_in_this_thread())
+		if (curr_strand()->running_in_this_thread())
 		{
 			wrap_trig_run_one::run_one(this, sign);
 		}
 		else
 		{
-			_strand->post(std::bind([sign](actor_handle& shared_this)
+			actor_post(std::bind([sign](actor_handle& shared_this)
 			{
 				wrap_trig_run_one::run_one(shared_this.get(), sign);
 			}, shared_from_this()));
@@ -5598,7 +6063,7 @@ private:
 	template <typename DST, typename SRC>
 	void _trig_handler2(shared_bool& closed, bool* sign, DST& dstRec, SRC&& args)
 	{
-		if (_strand->running_in_this_thread())
+		if (curr_strand()->running_in_this_thread())
 		{
 			if (!_quited && !closed)
 			{
@@ -5608,7 +6073,7 @@ private:
 		}
 		else
 		{
-			_strand->post(std::bind([sign](actor_handle& shared_this, shared_bool& closed, DST& dstRec, SRC& args)
+			actor_post(std::bind([sign](actor_handle& shared_this, shared_bool& closed, DST& dstRec, SRC& args)
 			{
 				if (!shared_this->_quited && !closed)
 				{
@@ -5681,7 +6146,7 @@ private:
 	}
 public:
 	/*!
-	@brief һϢ֪ͨ
+	@brief 创建一个消息通知函数
 	*/
 	template <typename... Args>
 	msg_notifer<Args...> make_msg_notifer_to_self(msg_handle<Args...>& amh, bool checkLost = false)
@@ -5690,7 +6155,7 @@ public:
 	}
 
 	/*!
-	@brief һϢ֪ͨbuddyActor
+	@brief 创建一个消息通知函数到buddyActor
 	*/
 	template <typename... Args>
 	msg_notifer<Args...> make_msg_notifer_to(const actor_handle& buddyActor, msg_handle<Args...>& amh, bool checkLost = false)
@@ -5714,14 +6179,14 @@ public:
 	}
 
 	/*!
-	@brief رϢ֪ͨ
+	@brief 关闭消息通知句柄
 	*/
 	void close_msg_notifer(msg_handle_base& amh);
 
 	/*!
-	@brief ϢȡϢ
-	@param ms ʱʱ
-	@return ʱɷfalseɹȡϢtrue
+	@brief 从消息句柄中提取消息
+	@param ms 超时时间
+	@return 超时完成返回false，成功提取消息返回true
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt bool timed_wait_msg(int ms, msg_handle<Args...>& amh, Outs&... res)
@@ -5829,7 +6294,7 @@ public:
 	}
 
 	/*!
-	@brief ϢȡϢ
+	@brief 从消息句柄中提取消息
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt void wait_msg(msg_handle<Args...>& amh, Outs&... res)
@@ -5855,7 +6320,7 @@ public:
 	}
 
 	/*!
-	@brief ȴԵһϢ
+	@brief 等待并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt void wait_ignore_msg(msg_handle<Args...>& amh)
@@ -5864,7 +6329,7 @@ public:
 	}
 
 	/*!
-	@brief ԵԵһϢ
+	@brief 尝试弹出并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt bool try_wait_ignore_msg(msg_handle<Args...>& amh)
@@ -5873,7 +6338,7 @@ public:
 	}
 
 	/*!
-	@brief һʱڳԵԵһϢ
+	@brief 在一定时间内尝试弹出并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt bool timed_wait_ignore_msg(int ms, msg_handle<Args...>& amh)
@@ -5889,7 +6354,7 @@ private:
 	}
 public:
 	/*!
-	@brief Ļص(ԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_context_as_type(...))
+	@brief 创建上下文回调函数(可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_context_as_type(...))
 	*/
 	template <typename... Args, typename... Outs>
 	callback_handler<types_pck<Args...>, types_pck<Outs...>> make_context_as_type(Outs&... outs)
@@ -5900,7 +6365,7 @@ public:
 	}
 
 	/*!
-	@brief Ļص(ԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_context(...))
+	@brief 创建上下文回调函数(可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_context(...))
 	*/
 	template <typename... Outs>
 	callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_context(Outs&... outs)
@@ -5910,7 +6375,7 @@ public:
 	}
 
 	/*!
-	@brief ʱĻص(ԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_timed_context(...))
+	@brief 创建带超时的上下文回调函数(可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_timed_context(...))
 	*/
 	template <typename... Outs>
 	callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_timed_context(int ms, bool& overtime, Outs&... outs)
@@ -5926,7 +6391,7 @@ public:
 	}
 
 	/*!
-	@brief ʱĻص(ԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_timed_context(...))
+	@brief 创建带超时的上下文回调函数(可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_timed_context(...))
 	*/
 	template <typename TimedHandler, typename... Outs>
 	callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_timed_context(int ms, TimedHandler&& th, Outs&... outs)
@@ -5937,7 +6402,7 @@ public:
 	}
 
 	/*!
-	@brief Ļص(ٴԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_context_as_type(...))
+	@brief 创建上下文回调函数(可以少传参数，可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_context_as_type(...))
 	*/
 	template <typename... Args, typename... Outs>
 	same_callback_handler<types_pck<Args...>, types_pck<Outs...>> make_same_context_as_type(Outs&... outs)
@@ -5948,7 +6413,7 @@ public:
 	}
 
 	/*!
-	@brief Ļص(ٴԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_context(...))
+	@brief 创建上下文回调函数(可以少传参数，可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_context(...))
 	*/
 	template <typename... Outs>
 	same_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_same_context(Outs&... outs)
@@ -5958,7 +6423,7 @@ public:
 	}
 
 	/*!
-	@brief ʱĻص(ٴԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_timed_context(...))
+	@brief 创建带超时的上下文回调函数(可以少传参数，可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_timed_context(...))
 	*/
 	template <typename... Outs>
 	same_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_timed_same_context(int ms, bool& overtime, Outs&... outs)
@@ -5974,7 +6439,7 @@ public:
 	}
 
 	/*!
-	@brief ʱĻص(ٴԶδֻеһЧ)ֱΪصʹãasync_func(..., Handler self->make_timed_context(...))
+	@brief 创建带超时的上下文回调函数(可以少传参数，可以多次触发，但只有第一次有效)，直接作为回调函数使用，async_func(..., Handler self->make_timed_context(...))
 	*/
 	template <typename TimedHandler, typename... Outs>
 	same_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_timed_same_context(int ms, TimedHandler&& th, Outs&... outs)
@@ -5985,7 +6450,7 @@ public:
 	}
 
 	/*!
-	@brief ASIOĻص(ֻܴһ)ֱΪصʹãasync_func(..., Handler self->make_asio_context_as_type(...))
+	@brief 创建ASIO库上下文回调函数(只能触发一次)，直接作为回调函数使用，async_func(..., Handler self->make_asio_context_as_type(...))
 	*/
 	template <typename... Args, typename... Outs>
 	asio_callback_handler<types_pck<Args...>, types_pck<Outs...>> make_asio_context_as_type(Outs&... outs)
@@ -5996,7 +6461,7 @@ public:
 	}
 
 	/*!
-	@brief ASIOĻص(ֻܴһ)ֱΪصʹãasync_func(..., Handler self->make_asio_context(...))
+	@brief 创建ASIO库上下文回调函数(只能触发一次)，直接作为回调函数使用，async_func(..., Handler self->make_asio_context(...))
 	*/
 	template <typename... Outs>
 	asio_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_asio_context(Outs&... outs)
@@ -6006,7 +6471,7 @@ public:
 	}
 
 	/*!
-	@brief ʱASIOĻص(ֻܴһ)ֱΪصʹãasync_func(..., Handler self->make_asio_timed_context(...))
+	@brief 创建带超时的ASIO库上下文回调函数(只能触发一次)，直接作为回调函数使用，async_func(..., Handler self->make_asio_timed_context(...))
 	*/
 	template <typename TimedHandler, typename... Outs>
 	asio_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_asio_timed_context(int ms, TimedHandler&& th, Outs&... outs)
@@ -6017,7 +6482,7 @@ public:
 	}
 
 	/*!
-	@brief ASIOĻص(ٴֻܴһ)ֱΪصʹãasync_func(..., Handler self->make_asio_context_as_type(...))
+	@brief 创建ASIO库上下文回调函数(可以少传参数，只能触发一次)，直接作为回调函数使用，async_func(..., Handler self->make_asio_context_as_type(...))
 	*/
 	template <typename... Args, typename... Outs>
 	asio_same_callback_handler<types_pck<Args...>, types_pck<Outs...>> make_asio_same_context_as_type(Outs&... outs)
@@ -6028,7 +6493,7 @@ public:
 	}
 
 	/*!
-	@brief ASIOĻص(ٴֻܴһ)ֱΪصʹãasync_func(..., Handler self->make_asio_context(...))
+	@brief 创建ASIO库上下文回调函数(可以少传参数，只能触发一次)，直接作为回调函数使用，async_func(..., Handler self->make_asio_context(...))
 	*/
 	template <typename... Outs>
 	asio_same_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_asio_same_context(Outs&... outs)
@@ -6038,7 +6503,7 @@ public:
 	}
 
 	/*!
-	@brief ʱASIOĻص(ٴֻܴһ)ֱΪصʹãasync_func(..., Handler self->make_asio_timed_context(...))
+	@brief 创建带超时的ASIO库上下文回调函数(可以少传参数，只能触发一次)，直接作为回调函数使用，async_func(..., Handler self->make_asio_timed_context(...))
 	*/
 	template <typename TimedHandler, typename... Outs>
 	asio_same_callback_handler<types_pck<typename check_stack_obj_type<Outs>::type...>, types_pck<Outs...>> make_asio_timed_same_context(int ms, TimedHandler&& th, Outs&... outs)
@@ -6049,7 +6514,7 @@ public:
 	}
 
 	/*!
-	@brief Ļص(HandlerڻصڲֱִУܴ̰߳ȫ)ֱΪصʹãasync_func(..., Handler self->make_on_context(...))
+	@brief 创建上下文回调函数(Handler将在回调内部直接执行，可能触发线程安全问题)，直接作为回调函数使用，async_func(..., Handler self->make_on_context(...))
 	*/
 	template <typename R = void, typename Handler>
 	on_callback_handler<Handler, R> make_on_callback_context(Handler&& handler)
@@ -6059,7 +6524,7 @@ public:
 	}
 
 	/*!
-	@brief ͬĻصֱΪصʹãasync_func(..., Handler self->make_sync_context(sync_result, ...))
+	@brief 创建同步上下文回调函数，直接作为回调函数使用，async_func(..., Handler self->make_sync_context(sync_result, ...))
 	*/
 	template <typename R = void, typename... Args, typename... Outs>
 	sync_cb_handler<R, types_pck<Args...>, types_pck<Outs...>> make_sync_context_as_type(sync_result<R>& res, Outs&... outs)
@@ -6077,7 +6542,7 @@ public:
 	}
 
 	/*!
-	@brief һϢֻһδЧ
+	@brief 创建一个消息触发函数，只有一次触发有效
 	*/
 	template <typename... Args>
 	trig_notifer<Args...> make_trig_notifer_to_self(trig_handle<Args...>& ath, bool checkLost = false)
@@ -6086,7 +6551,7 @@ public:
 	}
 
 	/*!
-	@brief һϢbuddyActorֻһδЧ
+	@brief 创建一个消息触发函数到buddyActor，只有一次触发有效
 	*/
 	template <typename... Args>
 	trig_notifer<Args...> make_trig_notifer_to(const actor_handle& buddyActor, trig_handle<Args...>& ath, bool checkLost = false)
@@ -6110,14 +6575,14 @@ public:
 	}
 
 	/*!
-	@brief رϢ
+	@brief 关闭消息触发句柄
 	*/
 	void close_trig_notifer(msg_handle_base& ath);
 
 	/*!
-	@brief ӴȡϢ
-	@param ms ʱʱ
-	@return ʱɷfalseɹȡϢtrue
+	@brief 从触发句柄中提取消息
+	@param ms 超时时间
+	@return 超时完成返回false，成功提取消息返回true
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt bool timed_wait_trig(int ms, trig_handle<Args...>& ath, Outs&... res)
@@ -6226,7 +6691,7 @@ public:
 	}
 
 	/*!
-	@brief ӴȡϢ
+	@brief 从触发句柄中提取消息
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt void wait_trig(trig_handle<Args...>& ath, Outs&... res)
@@ -6252,7 +6717,7 @@ public:
 	}
 
 	/*!
-	@brief ȴԵһϢ
+	@brief 等待并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt void wait_ignore_trig(trig_handle<Args...>& ath)
@@ -6261,7 +6726,7 @@ public:
 	}
 
 	/*!
-	@brief ԵԵһϢ
+	@brief 尝试弹出并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt bool try_wait_ignore_trig(trig_handle<Args...>& ath)
@@ -6270,7 +6735,7 @@ public:
 	}
 
 	/*!
-	@brief һʱڳԵԵһϢ
+	@brief 在一定时间内尝试弹出并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt bool timed_wait_ignore_trig(int ms, trig_handle<Args...>& ath)
@@ -6280,12 +6745,12 @@ public:
 	}
 
 	/*!
-	@brief ȴϢ
+	@brief 等待触发消息
 	*/
 	__yield_interrupt void wait_trig_sign(int id);
 
 	/*!
-	@brief ʱȴϢ
+	@brief 超时等待触发消息
 	*/
 	__yield_interrupt bool timed_wait_trig_sign(int ms, int id);
 
@@ -6327,7 +6792,7 @@ public:
 	}
 
 	/*!
-	@brief ԵȴϢ
+	@brief 尝试等待触发消息
 	*/
 	bool try_wait_trig_sign(int id);
 private:
@@ -6338,7 +6803,7 @@ private:
 	}
 private:
 	/*!
-	@brief ѰҳģƥϢ
+	@brief 寻找出与模板参数类型匹配的消息池
 	*/
 	template <typename... Args>
 	static std::shared_ptr<msg_pool_status::pck<Args...> > msg_pool_pck(const int id, my_actor* const host, const bool make = true)
@@ -6348,7 +6813,7 @@ private:
 		msg_pool_status::id_key typeID(type_hash<Args...>::hash_code(), id);
 		if (make)
 		{
-			auto& res = host->_msgPoolStatus._msgTypeMap.insert(make_pair(typeID, std::shared_ptr<pck_type>())).first->second;
+			auto& res = host->cold()._msgPoolStatus._msgTypeMap.insert(make_pair(typeID, std::shared_ptr<pck_type>())).first->second;
 			if (!res)
 			{
 				res = std::make_shared<pck_type>(host);
@@ -6356,8 +6821,12 @@ private:
 			assert(std::dynamic_pointer_cast<pck_type>(res));
 			return std::static_pointer_cast<pck_type>(res);
 		}
-		auto it = host->_msgPoolStatus._msgTypeMap.find(typeID);
-		if (it != host->_msgPoolStatus._msgTypeMap.end())
+		if (!host->_cold)
+		{
+			return std::shared_ptr<pck_type>();
+		}
+		auto it = host->_cold->_msgPoolStatus._msgTypeMap.find(typeID);
+		if (it != host->_cold->_msgPoolStatus._msgTypeMap.end())
 		{
 			assert(std::dynamic_pointer_cast<pck_type>(it->second));
 			return std::static_pointer_cast<pck_type>(it->second);
@@ -6399,7 +6868,7 @@ private:
 	}
 
 	/*!
-	@brief Ϣ
+	@brief 清除消息代理链
 	*/
 	template <typename... Args>
 	static void clear_msg_list(my_actor* const host, const std::shared_ptr<msg_pool_status::pck<Args...>>& msgPck)
@@ -6429,7 +6898,7 @@ private:
 	}
 
 	/*!
-	@brief Ϣ
+	@brief 更新消息代理链
 	*/
 	template <typename... Args>
 	void update_msg_list(const std::shared_ptr<msg_pool_status::pck<Args...>>& msgPck, const std::shared_ptr<MsgPool_<Args...>>& newPool)
@@ -6483,7 +6952,7 @@ private:
 	}
 private:
 	/*!
-	@brief ѱActorϢɻActor
+	@brief 把本Actor内消息由伙伴Actor代理处理
 	*/
 	template <typename... Args>
 	__yield_interrupt bool msg_agent_to(const int id, const actor_handle& childActor)
@@ -6570,8 +7039,8 @@ public:
 	}
 public:
 	/*!
-	@brief ϢָһضActorȥ
-	@return شϢActor
+	@brief 把消息指定到一个特定Actor函数体去处理
+	@return 返回处理该消息的子Actor句柄
 	*/
 	template <typename... Args, typename Handler>
 	__yield_interrupt child_handle msg_agent_to_actor(const int id, const shared_strand& strand, bool autoRun, Handler&& agentActor, size_t stackSize = DEFAULT_STACKSIZE)
@@ -6645,7 +7114,7 @@ public:
 	}
 public:
 	/*!
-	@brief ϿϢ
+	@brief 断开伙伴代理该消息
 	*/
 	template <typename... Args>
 	__yield_interrupt void msg_agent_off(const int id = 0)
@@ -6674,7 +7143,7 @@ public:
 	}
 
 	/*!
-	@brief Ϣ֮ܵǰconnect_msg_notiferص֪ͨʧЧرconnect_msg_pump߱connect_msg_notifer¿ʼ
+	@brief 重置消息管道，之前该类型下connect_msg_notifer到本地的通知句柄将永久失效，本地必须重新connect_msg_pump，发送者必须重新connect_msg_notifer才能重新开始
 	*/
 	template <typename... Args>
 	__yield_interrupt bool reset_msg_pipe(const int id = 0)
@@ -6683,8 +7152,12 @@ public:
 		assert(id >= 0 && id < 256);
 		typedef msg_pool_status::pck<Args...> pck_type;
 		msg_pool_status::id_key typeID(type_hash<Args...>::hash_code(), id);
-		auto it = _msgPoolStatus._msgTypeMap.find(typeID);
-		if (_msgPoolStatus._msgTypeMap.end() != it)
+		if (!_cold)
+		{
+			return false;
+		}
+		auto it = _cold->_msgPoolStatus._msgTypeMap.find(typeID);
+		if (_cold->_msgPoolStatus._msgTypeMap.end() != it)
 		{
 			lock_suspend();
 			lock_quit();
@@ -6695,7 +7168,7 @@ public:
 			clear_msg_list<Args...>(this, msgPck);
 			msgPck->_msgPool = msgPool;
 			msgPck->clear();
-			_msgPoolStatus._msgTypeMap.erase(it);
+			_cold->_msgPoolStatus._msgTypeMap.erase(it);
 			msgPck->unlock(this);
 			unlock_quit();
 			unlock_suspend();
@@ -6705,13 +7178,13 @@ public:
 	}
 public:
 	/*!
-	@brief Ϣ֪ͨһActorActorActorActor
-	@param strand Ϣ
-	@param id ͬϢid
-	@param makeNew false ϢǸϢͳɹʧܣtrue ǿƴµ֪֮ͨǰ֪ͨʹʧЧ
-	@param fixedSize Ϣڴس
-	@warning  makeNew = false ҸýڵΪĴʧ
-	@return Ϣ֪ͨ
+	@brief 连接消息通知到一个伙伴Actor，该Actor必须是子Actor或根Actor
+	@param strand 消息调度器
+	@param id 相同类型消息id
+	@param makeNew false 如果该消息是个根消息就成功，否则失败；true 强制创建新的通知，之前的通知和代理将失效
+	@param fixedSize 消息队列内存池长度
+	@warning 如果 makeNew = false 且该节点为父的代理，将创建失败
+	@return 消息通知函数
 	*/
 	template <typename... Args>
 	__yield_interrupt post_actor_msg<Args...> connect_msg_notifer_to(const shared_strand& strand, const int id, const actor_handle& buddyActor, bool chekcLost = false, bool makeNew = false, size_t fixedSize = 16)
@@ -6775,7 +7248,7 @@ public:
 			buddyPck->_isHead = true;
 			buddyPck->unlock(this);
 			if (msgPck->_next == buddyPck)
-			{//֮ǰĴȡ
+			{//之前的代理将被取消
 				msgPck->_next.reset();
 				if (msgPck->_msgPump)
 				{
@@ -6894,13 +7367,13 @@ public:
 	}
 
 	/*!
-	@brief Ϣ֪ͨԼActor
-	@param strand Ϣ
-	@param id ͬϢid
-	@param makeNew false ڷ֮ǰ򴴽µ֪ͨtrue ǿƴµ֪֮ͨǰĽʧЧҶϿbuddyActorĹ
-	@param fixedSize Ϣڴس
-	@warning ýڵΪĴôʧ
-	@return Ϣ֪ͨ
+	@brief 连接消息通知到自己的Actor
+	@param strand 消息调度器
+	@param id 相同类型消息id
+	@param makeNew false 如果存在返回之前，否则创建新的通知；true 强制创建新的通知，之前的将失效，且断开与buddyActor的关联
+	@param fixedSize 消息队列内存池长度
+	@warning 如果该节点为父的代理，那么将创建失败
+	@return 消息通知函数
 	*/
 	template <typename... Args>
 	__yield_interrupt post_actor_msg<Args...> connect_msg_notifer_to_self(const shared_strand& strand, const int id, bool chekcLost = false, bool makeNew = false, size_t fixedSize = 16)
@@ -6927,11 +7400,11 @@ public:
 	}
 
 	/*!
-	@brief һϢ֪ͨڸActorios޹߳ʹãڸActor run() ֮ǰ
-	@param strand Ϣ
-	@param id ͬϢid
-	@param fixedSize Ϣڴس
-	@return Ϣ֪ͨ
+	@brief 创建一个消息通知函数，在该Actor所依赖的ios无关线程中使用，且在该Actor调用 run() 之前
+	@param strand 消息调度器
+	@param id 相同类型消息id
+	@param fixedSize 消息队列内存池长度
+	@return 消息通知函数
 	*/
 	template <typename... Args>
 	post_actor_msg<Args...> connect_msg_notifer(const shared_strand& strand, const int id, bool chekcLost = false, size_t fixedSize = 16)
@@ -7023,8 +7496,8 @@ public:
 	//////////////////////////////////////////////////////////////////////////
 
 	/*!
-	@brief ϢõϢ
-	@return Ϣþ
+	@brief 连接消息泵到消息池
+	@return 返回消息泵句柄
 	*/
 	template <typename... Args>
 	__yield_interrupt msg_pump_handle<Args...> connect_msg_pump(const int id = 0, bool checkLost = false)
@@ -7221,10 +7694,10 @@ private:
 public:
 
 	/*!
-	@brief ϢȡϢ
-	@param ms ʱʱ
-	@param checkDis Ƿ񱻶ϿӣǾ׳ pump_disconnected_exception 쳣
-	@return ʱɷfalseɹȡϢtrue
+	@brief 从消息泵中提取消息
+	@param ms 超时时间
+	@param checkDis 检测是否被断开连接，是就抛出 pump_disconnected_exception 异常
+	@return 超时完成返回false，成功取到消息返回true
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt bool timed_pump_msg(int ms, bool checkDis, const msg_pump_handle<Args...>& pump, Outs&... res)
@@ -7357,7 +7830,7 @@ public:
 	}
 
 	/*!
-	@brief ԴϢȡϢ
+	@brief 尝试从消息泵中提取消息
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt bool try_pump_msg(bool checkDis, const msg_pump_handle<Args...>& pump, Outs&... res)
@@ -7397,7 +7870,7 @@ public:
 	}
 
 	/*!
-	@brief ϢȡϢ
+	@brief 从消息泵中提取消息
 	*/
 	template <typename... Args, typename... Outs>
 	__yield_interrupt void pump_msg(bool checkDis, const msg_pump_handle<Args...>& pump, Outs&... res)
@@ -7443,7 +7916,7 @@ public:
 	}
 
 	/*!
-	@brief ȡǰϢ׼ȷ
+	@brief 获取当前消息准确数
 	*/
 	template <typename... Args>
 	__yield_interrupt size_t pump_length(const msg_pump_handle<Args...>& pump)
@@ -7453,7 +7926,7 @@ public:
 	}
 
 	/*!
-	@brief ȡǰϢ
+	@brief 获取当前消息大概数
 	*/
 	template <typename... Args>
 	size_t pump_snap_length(const msg_pump_handle<Args...>& pump)
@@ -7463,7 +7936,7 @@ public:
 	}
 
 	/*!
-	@brief ʱȴ֪ͨ
+	@brief 超时等待通知句柄连接
 	*/
 	template <typename... Args>
 	__yield_interrupt bool timed_wait_connect(int ms, msg_pump_handle<Args...>& pump)
@@ -7472,7 +7945,7 @@ public:
 	}
 
 	/*!
-	@brief ȴ֪ͨ
+	@brief 等待通知句柄连接
 	*/
 	template <typename... Args>
 	__yield_interrupt void wait_connect(msg_pump_handle<Args...>& pump)
@@ -7481,7 +7954,7 @@ public:
 	}
 
 	/*!
-	@brief һʱڳԵԵһϢ
+	@brief 在一定时间内尝试弹出并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt bool timed_pump_ignore_msg(int ms, bool checkDis, const msg_pump_handle<Args...>& pump)
@@ -7497,7 +7970,7 @@ public:
 	}
 
 	/*!
-	@brief ԵԵһϢ
+	@brief 尝试弹出并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt bool try_pump_ignore_msg(bool checkDis, const msg_pump_handle<Args...>& pump)
@@ -7513,7 +7986,7 @@ public:
 	}
 
 	/*!
-	@brief ȴԵһϢ
+	@brief 等待并忽略掉一个消息
 	*/
 	template <typename... Args>
 	__yield_interrupt void pump_ignore_msg(bool checkDis, const msg_pump_handle<Args...>& pump)
@@ -7540,7 +8013,7 @@ private:
 	}
 public:
 	/*!
-	@brief ѯǰϢ˭
+	@brief 查询当前消息由谁代理
 	*/
 	template <typename... Args>
 	__yield_interrupt actor_handle msg_agent_handle(const int id, const actor_handle& buddyActor)
@@ -7619,48 +8092,75 @@ public:
 		return msg_agent_handle<Args...>(id, shared_from_this());
 	}
 private:
-	static bool _select_ready(MutexBlock_** const mbs, const size_t N)
+	/*!
+	@brief select单轮检测结果，记录本轮检测过(可能处于等待状态)的块区间和就绪块下标，
+	等待期间异步送达的块由句柄在唤醒前追加到就绪表，go_run只遍历就绪表，cancel/check_lost只遍历检测过的块
+	*/
+	struct SelectReady_ : public SelectWake_
+	{
+		SelectReady_(size_t* readyList)
+		:SelectWake_(readyList), _begin(0), _count(0) {}
+
+		size_t _begin;
+		size_t _count;
+	};
+
+	static bool _select_ready(SelectReady_& rs, MutexBlock_** const mbs, const size_t N)
 	{
-		bool r = false;
+		rs._readyCount = 0;
+		rs._begin = 0;
+		rs._count = N;
 		for (size_t i = 0; i < N; i++)
 		{
-			r |= mbs[i]->ready();
+			mbs[i]->select_arm(&rs, i);
+			if (mbs[i]->ready())
+			{
+				rs._readyList[rs._readyCount++] = i;
+			}
 		}
-		return r;
+		return 0 != rs._readyCount;
 	}
 
-	static bool _select_ready2(const size_t st, MutexBlock_** const mbs, const size_t N)
+	static bool _select_ready2(SelectReady_& rs, const size_t st, MutexBlock_** const mbs, const size_t N)
 	{
 		assert(st < N);
+		rs._readyCount = 0;
+		rs._begin = st;
+		rs._count = 0;
 		size_t i = st;
-		while (!mbs[i]->ready())
+		do
 		{
-			i = (i + 1) % N;
-			if (st == i)
+			rs._count++;
+			mbs[i]->select_arm(&rs, i);
+			if (mbs[i]->ready())
 			{
-				return false;
+				rs._readyList[rs._readyCount++] = i;
+				return true;
 			}
-		}
-		return true;
+			i = N - 1 != i ? i + 1 : 0;
+		} while (st != i);
+		return false;
 	}
 
-	static void _select_cancel(MutexBlock_** const mbs, const size_t N)
+	static void _select_cancel(SelectReady_& rs, MutexBlock_** const mbs, const size_t N)
 	{
-		for (size_t i = 0; i < N; i++)
+		for (size_t k = 0, i = rs._begin; k < rs._count; k++)
 		{
 			mbs[i]->cancel();
+			mbs[i]->select_arm(NULL, 0);
+			i = N - 1 != i ? i + 1 : 0;
 		}
 	}
 
-	static bool _select_go(MutexBlock_** const mbs, const size_t N)
+	static bool _select_go(SelectReady_& rs, MutexBlock_** const mbs)
 	{
 		try
 		{
 			bool isQuit = false;
-			for (size_t i = 0; i < N; i++)
+			for (size_t k = 0; k < rs._readyCount; k++)
 			{
 				bool isRun = false;
-				isQuit |= mbs[i]->go_run(isRun);
+				isQuit |= mbs[rs._readyList[k]]->go_run(isRun);
 			}
 			return isQuit;
 		}
@@ -7671,25 +8171,26 @@ private:
 		DEBUG_OPERATION(catch (...) { assert(false); } return true;)
 	}
 
-	static void _select_check_lost(MutexBlock_** const mbs, const size_t N)
+	static void _select_check_lost(SelectReady_& rs, MutexBlock_** const mbs, const size_t N)
 	{
 #ifdef ENABLE_CHECK_LOST
-		for (size_t i = 0; i < N; i++)
+		for (size_t k = 0, i = rs._begin; k < rs._count; k++)
 		{
 			mbs[i]->check_lost();
+			i = N - 1 != i ? i + 1 : 0;
 		}
 #endif
 	}
 
-	static bool _select_go_count(size_t& runCount, MutexBlock_** const mbs, const size_t N)
+	static bool _select_go_count(size_t& runCount, SelectReady_& rs, MutexBlock_** const mbs)
 	{
 		try
 		{
 			bool isQuit = false;
-			for (size_t i = 0; i < N; i++)
+			for (size_t k = 0; k < rs._readyCount; k++)
 			{
 				bool isRun = false;
-				isQuit |= mbs[i]->go_run(isRun);
+				isQuit |= mbs[rs._readyList[k]]->go_run(isRun);
 				if (isRun)
 				{
 					runCount++;
@@ -7730,12 +8231,12 @@ private:
 	}
 
 	template <typename Ready>
-	__yield_interrupt void _select_msg_blocks(Ready&& mutexReady, MutexBlock_** const mbList, const size_t N)
+	__yield_interrupt void _select_msg_blocks(Ready&& mutexReady, SelectReady_& rs, MutexBlock_** const mbList, const size_t N)
 	{
 		lock_quit();
-		DEBUG_OPERATION(_check_host_id(this, mbList, N));//жϾǲǶԼ
-		assert(_cmp_snap_id(mbList, N));//жûظ
-		BREAK_OF_SCOPE_EXEC(_select_cancel(mbList, N));
+		DEBUG_OPERATION(_check_host_id(this, mbList, N));//判断句柄是不是都是自己的
+		assert(_cmp_snap_id(mbList, N));//判断有没有重复参数
+		BREAK_OF_SCOPE_EXEC(_select_cancel(rs, mbList, N));
 		do
 		{
 			DEBUG_OPERATION(auto nt = yield_count());
@@ -7743,26 +8244,26 @@ private:
 			{
 				assert(yield_count() == nt);
 				unlock_quit();
-				_select_check_lost(mbList, N);
+				_select_check_lost(rs, mbList, N);
 				push_yield();
-				_select_check_lost(mbList, N);
+				_select_check_lost(rs, mbList, N);
 				lock_quit();
 				DEBUG_OPERATION(nt = yield_count());
 			}
-			_select_cancel(mbList, N);
+			_select_cancel(rs, mbList, N);
 			assert(yield_count() == nt);
-		} while (!_select_go(mbList, N));
+		} while (!_select_go(rs, mbList));
 		unlock_quit();
 	}
 
 	template <typename Ready>
-	__yield_interrupt size_t _timed_select_msg_blocks(const int ms, Ready&& mutexReady, MutexBlock_** const mbList, const size_t N)
+	__yield_interrupt size_t _timed_select_msg_blocks(const int ms, Ready&& mutexReady, SelectReady_& rs, MutexBlock_** const mbList, const size_t N)
 	{
 		lock_quit();
 		size_t runCount = 0;
-		DEBUG_OPERATION(_check_host_id(this, mbList, N));//жϾǲǶԼ
-		assert(_cmp_snap_id(mbList, N));//жûظ
-		BREAK_OF_SCOPE_EXEC(_select_cancel(mbList, N));
+		DEBUG_OPERATION(_check_host_id(this, mbList, N));//判断句柄是不是都是自己的
+		assert(_cmp_snap_id(mbList, N));//判断有没有重复参数
+		BREAK_OF_SCOPE_EXEC(_select_cancel(rs, mbList, N));
 		do
 		{
 			DEBUG_OPERATION(auto nt = yield_count());
@@ -7770,7 +8271,7 @@ private:
 			{
 				assert(yield_count() == nt);
 				unlock_quit();
-				_select_check_lost(mbList, N);
+				_select_check_lost(rs, mbList, N);
 				if (ms >= 0)
 				{
 					bool overtime = false;
@@ -7780,30 +8281,33 @@ private:
 						pull_yield();
 					});
 					push_yield();
-					if (overtime)
+					if (!overtime)
+					{
+						cancel_delay_trig();
+					}
+					else if (!rs._readyCount)
 					{
 						lock_quit();
 						break;
 					}
-					cancel_delay_trig();
 				}
 				else
 				{
 					push_yield();
 				}
-				_select_check_lost(mbList, N);
+				_select_check_lost(rs, mbList, N);
 				lock_quit();
 				DEBUG_OPERATION(nt = yield_count());
 			}
-			_select_cancel(mbList, N);
+			_select_cancel(rs, mbList, N);
 			assert(yield_count() == nt);
-		} while (!_select_go_count(runCount, mbList, N));
+		} while (!_select_go_count(runCount, rs, mbList));
 		unlock_quit();
 		return runCount;
 	}
 public:
 	/*!
-	@brief selectϢִп飨ÿмȡ
+	@brief 运行select消息执行块（阻塞），每次有几个取几个
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt void select_msg_blocks_many(MutexBlocks&&... mbs)
@@ -7811,14 +8315,16 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		_select_msg_blocks([&]()->bool
 		{
-			return _select_ready(mbList, N);
-		}, mbList, N);
+			return _select_ready(rs, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief selectϢִп飨ÿδͷʼֻȡһϢ
+	@brief 运行select消息执行块（阻塞），每次从头开始优先只取一条消息
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt void select_msg_blocks_safe(MutexBlocks&&... mbs)
@@ -7826,14 +8332,16 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		_select_msg_blocks([&]()->bool
 		{
-			return _select_ready2(0, mbList, N);
-		}, mbList, N);
+			return _select_ready2(rs, 0, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief selectϢִп飨ÿʼֻȡһϢ
+	@brief 运行select消息执行块（阻塞），每次依次往后开始优先只取一条消息
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt void select_msg_blocks_rotation(MutexBlocks&&... mbs)
@@ -7841,16 +8349,18 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		size_t i = -1;
 		_select_msg_blocks([&]()->bool
 		{
 			i = N - 1 != i ? i + 1 : 0;
-			return _select_ready2(i, mbList, N);
-		}, mbList, N);
+			return _select_ready2(rs, i, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief selectϢִп飨ȼÿֻȡһϢ
+	@brief 运行select消息执行块（阻塞，带优先级），每次只取一条消息
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt void select_msg_blocks_priority(MutexBlocks&&... mbs)
@@ -7858,6 +8368,8 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		const size_t m = 2 * N + 1;
 		const size_t cmax = N* (N + 1) / 2;
 		size_t ct = 0;
@@ -7865,12 +8377,12 @@ public:
 		{
 			ct = cmax != ct ? ct + 1 : 1;
 			const size_t i = (m + 1 - (size_t)std::sqrt(m * m - 8 * ct)) / 2 - 1;
-			return _select_ready2(i, mbList, N);
-		}, mbList, N);
+			return _select_ready2(rs, i, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief ʱȴselectϢִп飨ÿмȡ
+	@brief 超时等待运行select消息执行块（阻塞），每次有几个取几个
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt size_t timed_select_msg_blocks_many(const int ms, MutexBlocks&&... mbs)
@@ -7878,14 +8390,16 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		return _timed_select_msg_blocks(ms, [&]()->bool
 		{
-			return _select_ready(mbList, N);
-		}, mbList, N);
+			return _select_ready(rs, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief ʱȴselectϢִп飨ÿδͷʼֻȡһϢ
+	@brief 超时等待运行select消息执行块（阻塞），每次从头开始优先只取一条消息
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt size_t timed_select_msg_blocks_safe(const int ms, MutexBlocks&&... mbs)
@@ -7893,14 +8407,16 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		return _timed_select_msg_blocks(ms, [&]()->bool
 		{
-			return _select_ready2(0, mbList, N);
-		}, mbList, N);
+			return _select_ready2(rs, 0, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief ʱȴselectϢִп飨ÿʼֻȡһϢ
+	@brief 超时等待运行select消息执行块（阻塞），每次依次往后开始优先只取一条消息
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt size_t timed_select_msg_blocks_rotation(const int ms, MutexBlocks&&... mbs)
@@ -7908,16 +8424,18 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		size_t i = -1;
 		return _timed_select_msg_blocks(ms, [&]()->bool
 		{
 			i = N - 1 != i ? i + 1 : 0;
-			return _select_ready2(i, mbList, N);
-		}, mbList, N);
+			return _select_ready2(rs, i, mbList, N);
+		}, rs, mbList, N);
 	}
 
 	/*!
-	@brief ʱȴselectϢִп飨ȼÿֻȡһϢ
+	@brief 超时等待运行select消息执行块（阻塞，带优先级），每次只取一条消息
 	*/
 	template <typename... MutexBlocks>
 	__yield_interrupt size_t timed_select_msg_blocks_priority(const int ms, MutexBlocks&&... mbs)
@@ -7925,6 +8443,8 @@ public:
 		const size_t N = sizeof...(MutexBlocks);
 		static_assert(N > 0, "");
 		MutexBlock_* mbList[N] = { &mbs... };
+		size_t readyList[N];
+		SelectReady_ rs(readyList);
 		const size_t m = 2 * N + 1;
 		const size_t cmax = N* (N + 1) / 2;
 		size_t ct = 0;
@@ -7932,237 +8452,288 @@ public:
 		{
 			ct = cmax != ct ? ct + 1 : 1;
 			const size_t i = (m + 1 - (size_t)std::sqrt(m * m - 8 * ct)) / 2 - 1;
-			return _select_ready2(i, mbList, N);
-		}, mbList, N);
+			return _select_ready2(rs, i, mbList, N);
+		}, rs, mbList, N);
 	}
 public:
 	/*!
-	@brief ȡǰĸActor
+	@brief 获取当前代码运行在哪个Actor下
 	*/
 	static my_actor* self_actor();
 
+#if (__linux__ && ENABLE_STACK_SAMPLING)
 	/*!
-	@brief ⵱ǰǷڸActor
+	@brief 当前线程正在运行的Actor的key和栈范围，供采样信号处理函数使用
+	@return 当前不在Actor中返回false
+	*/
+	static bool sample_current(size_t& key, char*& stackBase, char*& stackTop);
+#endif
+
+	/*!
+	@brief 检测当前是否在该Actor内运行
 	*/
 	void check_self();
 
 	/*!
-	@brief ԵǰµActorջǷȫ
+	@brief 测试当前下的Actor栈是否安全
 	*/
 	void check_stack();
 
 	/*!
-	@brief actorֲ洢
+	@brief 设置actor局部存储
 	*/
 	void als_set(void* val);
 
 	/*!
-	@brief ȡactorֲ洢
+	@brief 获取actor局部存储
 	*/
 	void* als_get();
 
 	/*!
-	@brief ȡǰActorʣలȫջռ
+	@brief 获取当前Actor剩余安全栈空间
 	*/
 	size_t stack_idle_space();
 
 	/*!
-	@brief ȡǰActor
+	@brief 获取当前Actor调度器，Actor会迁移(migrate)时只能在它所在的strand中调用
 	*/
 	const shared_strand& self_strand();
 
 	/*!
-	@brief ȡǰʱ
+	@brief 获取当前调度器定时器
 	*/
 	overlap_timer* over_timer();
 
 	/*!
-	@brief ȡio_service
+	@brief 获取io_service调度器
 	*/
 	boost::asio::io_service& self_io_service();
 
 	/*!
-	@brief ȡio_engine
+	@brief 获取io_engine调度器
 	*/
 	io_engine& self_io_engine();
 
 	/*!
-	@brief رָ
+	@brief 返回本对象的智能指针
 	*/
 	actor_handle shared_from_this();
 
 	/*!
-	@brief һ첽ʱ
+	@brief 创建一个异步定时器
 	*/
 	async_timer make_timer();
 
 	/*!
-	@brief ȡǰActorID
+	@brief 获取当前ActorID号
 	*/
 	id self_id();
 
 	/*!
-	@brief ǰActorִԤkey
+	@brief 当前Actor执行体预设的key
 	*/
 	size_t self_key();
 
 	/*!
-	@brief ǰActorʹõreusable_mem
+	@brief 当前Actor使用的reusable_mem
 	*/
 	reusable_mem& self_reusable();
 
 	/*!
-	@brief ˳
+	@brief 设置退出码
 	*/
 	void return_code(size_t cd);
 
 	/*!
-	@brief ȡ˳
+	@brief 获取退出码
 	*/
 	size_t return_code();
 
 	/*!
-	@brief Actor˳󣬻ȡջĴС
+	@brief Actor退出后，获取栈消耗大小
 	*/
 	size_t using_stack_size();
 
 	/*!
-	@brief ActorջС
+	@brief Actor栈大小
 	*/
 	size_t stack_size();
 
 	/*!
-	@brief ActorջܴС
+	@brief Actor栈总大小
 	*/
 	size_t stack_total_size();
 
 	/*!
-	@brief ȡActorл
+	@brief 获取Actor切换计数
 	*/
 	size_t yield_count();
 
 	/*!
-	@brief Actorл
+	@brief Actor切换计数清零
 	*/
 	void reset_yield();
 
+#ifdef ENABLE_ACTOR_PROFILE
+	/*!
+	@brief 获取当前Actor运行统计
+	*/
+	profile_info self_profile();
+
+	/*!
+	@brief 按Actor执行体key(self_key)汇总的Actor运行统计，运行中的Actor在让出时每ACTOR_PROFILE_COMMIT_US提交一次增量，
+	退出时提交剩余部分
+	*/
+	static std::vector<std::pair<size_t, profile_info> > profile_table();
+
+	/*!
+	@brief 以flame graph折叠栈格式导出汇总统计，每行"actor_key;run|ready|block 微秒"
+	*/
+	static std::string profile_folded();
+
+	/*!
+	@brief 以CSV格式导出汇总统计
+	*/
+	static std::string profile_csv();
+
+	/*!
+	@brief 清空汇总统计
+	*/
+	static void reset_profile();
+#endif
+
+	/*!
+	@brief 设置进程驻留内存(RSS)预算(字节)，超出后立即按最久未用顺序释放空闲Actor栈的物理页，仍超出则解除空闲栈映射；0表示不限制
+	*/
+	static void set_stack_rss_budget(size_t bytes);
+
+	/*!
+	@brief 设置空闲Actor栈惰性释放物理页(MADV_FREE)、解除映射的空闲时长(秒)，默认CONTEXT_MIN_CLEAR_CYCLE/CONTEXT_MIN_DELETE_CYCLE
+	*/
+	static void set_stack_clear_cycle(int clearSec, int deleteSec);
+
 	/*!
-	@brief ʼнõActor
+	@brief Actor栈池统计
+	*/
+	static ContextPool_::stack_stats stack_pool_stats();
+
+	/*!
+	@brief 开始运行建立好的Actor
 	*/
 	void run();
 
 	/*!
-	@brief ǿ˳ActorãпܻԴй©ɺص
+	@brief 强制退出该Actor，不可滥用，有可能会造成资源泄漏，完成后回调
 	*/
 	void force_quit(std::function<void()> h = std::function<void()>());
 
 	/*!
-	@brief ActorǷѾʼ
+	@brief Actor是否已经开始运行
 	*/
 	bool is_started();
 
 	/*!
-	@brief ActorǷѾ˳
+	@brief Actor是否已经退出
 	*/
 	bool is_exited();
 
 	/*!
-	@brief Ƿǿ˳Actorȷ˳ã
+	@brief 是否是强制退出（在Actor确认退出后调用）
 	*/
 	bool is_force();
 
 	/*!
-	@brief ǷActor
+	@brief 是否在Actor中
 	*/
 	bool in_actor();
 
 	/*!
-	@brief ǷڸActorͬһstrand
+	@brief 是否在该Actor当前所在的strand中运行，可在任意线程调用
 	*/
 	bool running_in_actor_strand();
 
 	/*!
-	@brief lock_quitǷյ˳Ϣ
+	@brief lock_quit后检测是否收到退出消息
 	*/
 	bool quit_msg();
 
 	/*!
-	@brief ǰActorʱǿ˳
+	@brief 锁定当前Actor，暂时不让强制退出
 	*/
 	void lock_quit();
 
 	/*!
-	@brief ˳
+	@brief 解除退出锁定
 	*/
 	void unlock_quit();
 
 	/*!
-	@brief ǰActorʱù
+	@brief 锁定当前Actor，暂时不让挂起
 	*/
 	void lock_suspend();
 
 	/*!
-	@brief 
+	@brief 解除挂起锁定
 	*/
 	void unlock_suspend();
 
 	/*!
-	@brief Ƿ˳
+	@brief 是否锁定了退出
 	*/
 	bool is_locked_quit();
 
 	/*!
-	@brief Ƿ˹
+	@brief 是否锁定了挂起
 	*/
 	bool is_locked_suspend();
 
 	/*!
-	@brief Actorͷջڴ
+	@brief Actor结束后释放栈内存
 	*/
 	void after_exit_clean_stack();
 
 	/*!
-	@brief ͣActor
+	@brief 暂停Actor
 	*/
 	void suspend(std::function<void()> h = std::function<void()>());
 
 	/*!
-	@brief ָͣActor
+	@brief 恢复已暂停Actor
 	*/
 	void resume(std::function<void()> h = std::function<void()>());
 
 	/*!
-	@brief ֪ͨ0 <= id < 32,64
+	@brief 触发通知，0 <= id < 32,64
 	*/
 	void notify_trig_sign(int id);
 
 	/*!
-	@brief ô
+	@brief 重置触发标记
 	*/
 	void reset_trig_sign(int id);
 
 	/*!
-	@brief л/ǹ״̬
+	@brief 切换挂起/非挂起状态
 	*/
 	void switch_pause_play(std::function<void(bool)> h = std::function<void(bool)>());
 
 	/*!
-	@brief ȴActor˳Actorios޹߳ʹ
+	@brief 等待Actor退出，在Actor所依赖的ios无关线程中使用
 	*/
 	void outside_wait_quit();
 
 	/*!
-	@brief һActor֪ͨ
+	@brief 添加一个Actor结束通知
 	*/
 	void append_quit_notify(std::function<void()> h = std::function<void()>());
 
 	/*!
-	@brief һActorʱstrandִеĺӵִ
+	@brief 添加一个Actor结束时在strand中执行的函数，后添加的先执行
 	*/
 	void append_quit_executor(std::function<void()> h = std::function<void()>());
 
 	/*!
-	@brief һActor
+	@brief 启动一堆Actor
 	*/
 	void actors_start_run(const std::list<actor_handle>& anotherActors);
 
@@ -8177,12 +8748,12 @@ public:
 	}
 
 	/*!
-	@brief ǿ˳һActorҵȴ
+	@brief 强制退出另一个Actor，并且等待完成
 	*/
 	__yield_interrupt void actor_force_quit(const actor_handle& anotherActor);
 
 	/*!
-	@brief ǿ˳һActorҵȴ
+	@brief 强制退出一堆Actor，并且等待完成
 	*/
 	__yield_interrupt void actors_force_quit(const std::list<actor_handle>& anotherActors);
 
@@ -8204,12 +8775,12 @@ public:
 	}
 
 	/*!
-	@brief ȴһActor󷵻
+	@brief 等待另一个Actor结束后返回
 	*/
 	__yield_interrupt void actor_wait_quit(const actor_handle& anotherActor);
 
 	/*!
-	@brief ȴһActor󷵻
+	@brief 等待一堆Actor结束后返回
 	*/
 	__yield_interrupt void actors_wait_quit(const std::list<actor_handle>& anotherActors);
 
@@ -8226,12 +8797,12 @@ public:
 	__yield_interrupt bool timed_actor_wait_quit(int ms, const actor_handle& anotherActor);
 
 	/*!
-	@brief һActorȴActorúŷ
+	@brief 挂起另一个Actor，等待其所有子Actor都调用后才返回
 	*/
 	__yield_interrupt void actor_suspend(const actor_handle& anotherActor);
 
 	/*!
-	@brief һActorȴActorúŷ
+	@brief 挂起一堆Actor，等待其所有子Actor都调用后才返回
 	*/
 	__yield_interrupt void actors_suspend(const std::list<actor_handle>& anotherActors);
 
@@ -8255,12 +8826,12 @@ public:
 	}
 
 	/*!
-	@brief ָһActorȴActorúŷ
+	@brief 恢复另一个Actor，等待其所有子Actor都调用后才返回
 	*/
 	__yield_interrupt void actor_resume(const actor_handle& anotherActor);
 
 	/*!
-	@brief ָһActorȴActorúŷ
+	@brief 恢复一堆Actor，等待其所有子Actor都调用后才返回
 	*/
 	__yield_interrupt void actors_resume(const std::list<actor_handle>& anotherActors);
 
@@ -8284,14 +8855,14 @@ public:
 	}
 
 	/*!
-	@brief һActorй/ָ״̬л
-	@return ѹ𷵻truefalse
+	@brief 对另一个Actor进行挂起/恢复状态切换
+	@return 都已挂起返回true，否则false
 	*/
 	__yield_interrupt bool actor_switch(const actor_handle& anotherActor);
 
 	/*!
-	@brief һActorй/ָ״̬л
-	@return ѹ𷵻truefalse
+	@brief 对一堆Actor进行挂起/恢复状态切换
+	@return 都已挂起返回true，否则false
 	*/
 	__yield_interrupt bool actors_switch(const std::list<actor_handle>& anotherActors);
 
@@ -8319,14 +8890,14 @@ public:
 	void assert_enter();
 
 	/*!
-	@brief װmy_actor
+	@brief 安装my_actor框架
 	*/
 	static void install();
 	static void install(const shared_initer*);
 	static const shared_initer* get_initer();
 
 	/*!
-	@brief жmy_actor
+	@brief 卸载my_actor框架
 	*/
 	static void uninstall();
 
@@ -8369,71 +8940,96 @@ private:
 	void begin_resume();
 	void child_suspend_then();
 	void child_resume_then();
+	ActorCold_& cold();
+	void push_suspend_option(suspend_resume_option* opt);
+	suspend_resume_option* pop_suspend_option();
+	void link_child(my_actor* child);
+	void unlink_child(my_actor* child);
 	void run_one();
 	void pull_yield_tls();
 	void pull_yield();
 	void pull_yield_after_quited();
 	void push_yield();
 	void push_yield_after_quited();
+#ifdef ENABLE_ACTOR_PROFILE
+	void profile_resume(unsigned long long tick);
+	void profile_commit();
+#endif
 #if (__linux__ && ENABLE_DUMP_STACK)
 	static void dump_segmentation_fault(void* sp, size_t length);
 	static void undump_segmentation_fault();
 #endif
 public:
 #ifdef PRINT_ACTOR_STACK
-	std::list<stack_line_info> _createStack;///<ǰActorʱĵöջ
+	std::list<stack_line_info> _createStack;///<当前Actor创建时的调用堆栈
 #endif
 private:
-	std::weak_ptr<my_actor> _weakThis;
-	shared_strand _strand;///<Actor
-	id _selfID;///<ActorID
-	void* _alsVal;///<actorֲ洢
-	actor_pull_type* _actorPull;///<Actorжϵָ
-	actor_push_type* _actorPush;///<Actorжϵ
-	wrap_timer_handler_face* _timerStateCb;///<ʱص
-	size_t _actorKey;///<ActorģȫΨһkey
-	size_t _lockQuit;///<ǰActorǰյ˳Ϣʱˣȵ˳
-	size_t _lockSuspend;///ǰActorĹǰյϢʱ𣬵ȵ
-	size_t _yieldCount;///<yield
-	size_t _lastYield;///<¼ϴtry_yieldļ
-	size_t _childOverCount;///<Actor˳ʱ
-	size_t _childSuspendResumeCount;///<Actor/ָ
-	size_t _returnCode;///<˳
-	size_t _usingStackSize;///<ջ
-	size_t _trigSignMask;///<Ϣ
-	size_t _waitingTrigMask;///<ȴϢ
-	long long _timerStateTime;///<ǰʱʱ
-	long long _timerStateStampEnd;///<ʱʱ
-	msg_pool_status _msgPoolStatus;///<Ϣб
-	actor_handle _parentActor;///<ActorActor󣬸Actor
-	ActorTimer_::timer_handle _timerStateHandle;///<ʱ
-	reusable_mem _reuMem;///<ʱڴ
-	main_func _mainFunc;///<Actor
-	std::list<suspend_resume_option> _suspendResumeQueue;///</ָ
-	std::list<std::function<void()> > _quitCallback;///<ActorĻص
-	std::list<std::function<void()> > _beginQuitExec;///<Actor׼˳ʱõĺעִ
-	std::list<actor_handle> _childActorList;///<ActorϣActor˳󣬸Actor˳
-	int _timerStateCount;///<ʱ
-	bool _timerStateSuspend : 1;///<ʱǷ
-	bool _timerStateCompleted : 1;///<ʱǷ
-	bool _inActor : 1;///<ǰActorڲִб
-	bool _started : 1;///<Ѿʼеı
-	bool _quited : 1;///<_mainFuncѾִ
-	bool _exited : 1;///<ȫ˳
-	bool _suspended : 1;///<Actor
-	bool _isForce : 1;///<Ƿǿ˳ıǣɹforce_quit
-	bool _holdPull : 1;///<ǰActorⲿ׼Actor
-	bool _holdQuited : 1;///<ǰActorյ˳Ϣ
-	bool _holdSuspended : 1;///<ָû
-	bool _checkStack : 1;///<Ƿջռ
-	bool _waitingQuit : 1;///<ȴ˳
-	bool _afterExitCleanStack : 1;///<ջ
+	//每次切换/定时/消息都会访问的数据放在对象开头
+	shared_strand _strand;///<Actor调度器，只在所在strand中读写
+	std::atomic<boost_strand*> _currStrand;///<Actor当前所在的strand，迁移时原子更新，供其它线程读取
+	actor_pull_type* _actorPull;///<Actor中断点恢复
+	actor_push_type* _actorPush;///<Actor中断点
+	wrap_timer_handler_face* _timerStateCb;///<定时器触发回调
+	size_t _yieldCount;///<yield计数
+	size_t _lastYield;///<记录上次try_yield的计数
+	size_t _trigSignMask;///<触发消息标记
+	size_t _waitingTrigMask;///<等待触发消息标记
+	size_t _lockQuit;///<锁定当前Actor，如果当前接收到退出消息，暂时不退，等到解锁后退出
+	size_t _lockSuspend;///锁定当前Actor的挂起操作，如果当前接收到挂起消息，暂时不挂起，等到解锁后挂起
+	long long _timerStateTime;///<当前定时时间
+	long long _timerStateStampEnd;///<定时结束时间
+	int _timerStateCount;///<定时器计数
+	bool _timerStateSuspend : 1;///<定时器是否挂起
+	bool _timerStateCompleted : 1;///<定时器是否完成
+	bool _inActor : 1;///<当前正在Actor内部执行标记
+	bool _started : 1;///<已经开始运行的标记
+	bool _quited : 1;///<_mainFunc已经不再执行
+	bool _exited : 1;///<完全退出
+	bool _suspended : 1;///<Actor挂起标记
+	bool _isForce : 1;///<是否是强制退出的标记，成功调用了force_quit
+	bool _holdPull : 1;///<当前Actor挂起，有外部触发准备进入Actor标记
+	bool _holdQuited : 1;///<当前Actor被锁定后，收到退出消息
+	bool _holdSuspended : 1;///<挂起恢复操作没挂起标记
+	bool _checkStack : 1;///<是否检测栈空间
+	bool _waitingQuit : 1;///<等待退出标记
+	bool _afterExitCleanStack : 1;///<结束后清栈
 #ifdef PRINT_ACTOR_STACK
 public:
-	bool _checkStackFree : 1;///<Ƿջ
+	bool _checkStackFree : 1;///<是否检测堆栈过多
 private:
 #endif
-	static std::atomic<my_actor::id>* _actorIDCount;///<ID
+	ActorTimer_::timer_handle _timerStateHandle;///<定时器句柄
+	reusable_mem _reuMem;///<定时器内存管理
+	std::weak_ptr<my_actor> _weakThis;
+#ifdef ENABLE_ACTOR_PROFILE
+	unsigned long long _profRunTick;///<运行累计tick
+	unsigned long long _profReadyTick;///<就绪等待累计tick
+	unsigned long long _profBlockTick;///<阻塞累计tick
+	unsigned long long _profStopTick;///<上次让出时的tick
+	unsigned long long _profWakeTick;///<被外部唤醒时的tick
+	unsigned long long _profNestedTick;///<本次运行中同线程嵌套运行其它Actor的tick，不计入自己的运行时间
+	unsigned long long _profCommitRun;///<已提交到汇总统计的运行tick
+	unsigned long long _profCommitReady;///<已提交的就绪等待tick
+	unsigned long long _profCommitBlock;///<已提交的阻塞tick
+	unsigned long long _profCommitTick;///<上次提交时的tick
+	size_t _profYieldCount;///<切换次数
+	size_t _profCommitYield;///<已提交的切换次数
+	size_t _profCommitGen;///<上次提交时汇总统计的代数
+	bool _profReadyYield;///<本次让出是主动yield，让出后立即可运行
+#endif
+	//不常用的数据
+	ActorCold_* _cold;///<子Actor计数、挂起/恢复队列、退出回调、消息类型表
+	my_actor* _childHead;///<子Actor链表，子Actor都退出后，父Actor才能退出
+	my_actor* _childPrev;///<在父Actor子链表中的前一个
+	my_actor* _childNext;///<在父Actor子链表中的后一个
+	actor_handle _parentActor;///<父Actor，子Actor都析构后，父Actor才能析构
+	main_func _mainFunc;///<Actor入口
+	void* _alsVal;///<actor局部存储
+	id _selfID;///<ActorID
+	size_t _actorKey;///<该Actor处理模块的全局唯一key
+	size_t _returnCode;///<退出码
+	size_t _usingStackSize;///<栈消耗
+	static std::atomic<my_actor::id>* _actorIDCount;///<ID计数
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -8531,6 +9127,20 @@ void ActorFunc_::delay_trig(my_actor* host, int ms, H&& h)
 	host->delay_trig(ms, std::forward<H>(h));
 }
 
+template <typename H>
+void ActorFunc_::actor_post(my_actor* host, H&& h)
+{
+	assert(host);
+	host->actor_post(std::forward<H>(h));
+}
+
+template <typename H>
+void ActorFunc_::actor_try_tick(my_actor* host, H&& h)
+{
+	assert(host);
+	host->actor_try_tick(std::forward<H>(h));
+}
+
 template <typename DST, typename SRC>
 void ActorFunc_::_trig_handler(my_actor* host, bool* sign, DST& dstRec, SRC&& args)
 {
@@ -0,0 +1,208 @@
+#ifndef __PARALLEL_H
+#define __PARALLEL_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include "my_actor.h"
+#include "stack_object.h"
+#include "time_source.h"
+
+//一个工作任务连续执行多久(us)后重新投递，让出io线程给其它任务
+#ifndef PARALLEL_SLICE_US
+#define PARALLEL_SLICE_US 2000
+#endif
+
+/*!
+@brief 把[begin, end)按grain切块，在io_engine线程上以无栈任务并行执行；
+工作任务数不超过调度器线程数，每个工作任务从共享计数器上领取下一块(动态负载均衡)，
+全部块完成后在最后完成块的线程上调用done
+*/
+template <typename Index, typename ChunkFunc, typename Done>
+struct ParallelChunks_
+{
+	ParallelChunks_(Index begin, Index end, Index grain, ChunkFunc&& chunkFn, Done&& done)
+		:_begin(begin), _end(end), _grain(grain), _chunkFn(std::forward<ChunkFunc>(chunkFn)), _done(std::forward<Done>(done))
+	{
+		_chunks = (size_t)((end - begin + grain - 1) / grain);
+		_next = 0;
+		_remain = _chunks;
+	}
+
+	static void start(io_engine& ios, const std::shared_ptr<ParallelChunks_>& state)
+	{
+		const size_t shards = std::max((size_t)1, ios.shardCount());
+		const size_t workers = std::min(state->_chunks, std::max((size_t)1, ios.ioThreads()));
+		for (size_t i = 0; i < workers; i++)
+		{
+			post_worker(ios.shardService(i % shards), state);
+		}
+	}
+
+	static void post_worker(boost::asio::io_service& ios, const std::shared_ptr<ParallelChunks_>& state)
+	{
+		ios.post(std::bind([&ios](std::shared_ptr<ParallelChunks_>& state)
+		{
+			state->work(ios, state);
+		}, state));
+	}
+
+	void work(boost::asio::io_service& ios, const std::shared_ptr<ParallelChunks_>& state)
+	{
+		const long long beginUs = time_source::tsc_us();
+		size_t c;
+		while ((c = _next++) < _chunks)
+		{
+			const Index b = _begin + (Index)c * _grain;
+			const Index e = _end - b > _grain ? b + _grain : _end;
+			CHECK_EXCEPTION(_chunkFn, c, b, e);
+			if (1 == _remain--)
+			{
+				CHECK_EXCEPTION(_done);
+				return;
+			}
+			if (time_source::tsc_us() - beginUs >= PARALLEL_SLICE_US)
+			{
+				post_worker(ios, state);
+				return;
+			}
+		}
+	}
+
+	const Index _begin;
+	const Index _end;
+	const Index _grain;
+	size_t _chunks;
+	std::atomic<size_t> _next;
+	std::atomic<size_t> _remain;
+	ChunkFunc _chunkFn;
+	Done _done;
+};
+
+/*!
+@brief map_reduce全部块完成后，从init开始按块顺序归约各块结果(init只参与这一次)
+*/
+template <typename T, typename Reduce, typename Done>
+struct MapReduceDone_
+{
+	void operator()()
+	{
+		std::vector<stack_obj<T>>& partials = *_partials;
+		T res = _reduceFn(_init, partials[0].get());
+		for (size_t i = 1; i < partials.size(); i++)
+		{
+			res = _reduceFn(res, partials[i].get());
+		}
+		_done(res);
+	}
+
+	std::shared_ptr<std::vector<stack_obj<T>>> _partials;
+	T _init;
+	Reduce _reduceFn;
+	Done _done;
+};
+
+/*!
+@brief 异步并行执行fn(i)，i属于[begin, end)，完成后调用done()(在某个io线程中)；
+可直接用于generator，例如 co_await async_parallel_for(ios, 0, n, 64, fn, co_async);
+*/
+template <typename Index, typename Func, typename Done>
+void async_parallel_for(io_engine& ios, Index begin, Index end, Index grain, Func&& fn, Done&& done)
+{
+	assert(grain > 0);
+	if (!(begin < end))
+	{
+		done();
+		return;
+	}
+	auto chunkFn = [fn](size_t, Index b, Index e)
+	{
+		for (Index i = b; i < e; i++)
+		{
+			fn(i);
+		}
+	};
+	typedef ParallelChunks_<Index, decltype(chunkFn), RM_CREF(Done)> state_type;
+	state_type::start(ios, std::make_shared<state_type>(begin, end, grain, std::move(chunkFn), std::forward<Done>(done)));
+}
+
+/*!
+@brief 异步并行map_reduce，每块内部从第一个映射值开始依次归约，全部完成后从init开始按块顺序归约，结果传给done(res)；
+T不需要默认构造，init只参与一次归约；
+可直接用于generator，例如 co_await async_map_reduce(ios, 0, n, 64, 0, mapFn, reduceFn, co_async_result(res));
+*/
+template <typename Index, typename T, typename Map, typename Reduce, typename Done>
+void async_map_reduce(io_engine& ios, Index begin, Index end, Index grain, const T& init, Map&& mapFn, Reduce&& reduceFn, Done&& done)
+{
+	assert(grain > 0);
+	if (!(begin < end))
+	{
+		T res = init;
+		done(res);
+		return;
+	}
+	std::shared_ptr<std::vector<stack_obj<T>>> partials = std::make_shared<std::vector<stack_obj<T>>>((size_t)((end - begin + grain - 1) / grain));
+	auto chunkFn = [partials, mapFn, reduceFn](size_t c, Index b, Index e)
+	{
+		stack_obj<T>& partial = (*partials)[c];
+		partial.create(mapFn(b));
+		for (Index i = b + 1; i < e; i++)
+		{
+			partial.get() = reduceFn(partial.get(), mapFn(i));
+		}
+	};
+	typedef MapReduceDone_<T, RM_CREF(Reduce), RM_CREF(Done)> done_type;
+	done_type reduceDone = { partials, init, reduceFn, std::forward<Done>(done) };
+	typedef ParallelChunks_<Index, decltype(chunkFn), done_type> state_type;
+	state_type::start(ios, std::make_shared<state_type>(begin, end, grain, std::move(chunkFn), std::move(reduceDone)));
+}
+
+/*!
+@brief 在Actor中并行执行fn(i)，i属于[begin, end)，全部完成后返回(期间锁定强制退出)
+*/
+template <typename Index, typename Func>
+__yield_interrupt void parallel_for(my_actor* self, Index begin, Index end, Index grain, Func&& fn)
+{
+	if (!(begin < end))
+	{
+		return;
+	}
+	self->trig_guard([&](trig_once_notifer<>&& ntf)
+	{
+		async_parallel_for(self->self_io_engine(), begin, end, grain, [&fn](Index i)
+		{
+			fn(i);
+		}, std::move(ntf));
+	});
+}
+
+/*!
+@brief 在Actor中并行map_reduce，全部完成后返回归约结果(期间锁定强制退出)
+*/
+template <typename Index, typename T, typename Map, typename Reduce>
+__yield_interrupt T map_reduce(my_actor* self, Index begin, Index end, Index grain, const T& init, Map&& mapFn, Reduce&& reduceFn)
+{
+	if (!(begin < end))
+	{
+		return init;
+	}
+	stack_obj<T> res;//T不一定能默认构造，由归约结果构造
+	self->trig_guard([&](trig_once_notifer<>&& ntf)
+	{
+		async_map_reduce(self->self_io_engine(), begin, end, grain, init, [&mapFn](Index i)
+		{
+			return mapFn(i);
+		}, [&reduceFn](const T& a, const T& b)->T
+		{
+			return reduceFn(a, b);
+		}, std::bind([&res](trig_once_notifer<>& ntf, T& r)
+		{
+			res.create(std::move(r));
+			ntf();
+		}, std::move(ntf), std::placeholders::_1));
+	});
+	return std::move(res.get());
+}
+
+#endif
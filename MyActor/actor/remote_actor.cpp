@@ -0,0 +1,543 @@
+#include "remote_actor.h"
+#include <deque>
+
+//线路上的控制记录
+#define REMOTE_HELLO_TYPE 0xFFFFFFFF
+#define REMOTE_CREDIT_TYPE 0xFFFFFFFE
+//只在本地投递给发送Actor的唤醒/关闭通知
+#define REMOTE_WAKE_TYPE 0xFFFFFFFD
+#define REMOTE_CLOSE_TYPE 0xFFFFFFFC
+
+//握手帧上限
+#define REMOTE_HELLO_MAX 4096
+
+/*!
+@brief 帧头，之后是_count条记录
+*/
+struct RemoteFrameHead_
+{
+	unsigned _bytes;///<帧头之后的字节数
+	unsigned _count;///<记录数
+};
+
+/*!
+@brief 记录头，之后是目标端点名和消息体
+*/
+struct RemoteRecordHead_
+{
+	unsigned _type;
+	unsigned _bodyBytes;
+	unsigned _dstBytes;
+};
+
+/*!
+@brief 一次读取中发往同一端点的消息，合并成一次post_batch
+*/
+struct RemoteBatch_
+{
+	std::string _dst;
+	post_actor_msg<remote_msg> _post;
+	std::vector<std::tuple<remote_msg>> _msgs;
+	size_t _bytes;
+};
+
+static size_t record_cost(const remote_msg& msg)
+{
+	return sizeof(RemoteRecordHead_) + msg.dst.size() + msg.body.size();
+}
+
+static void append_record(std::string& frame, unsigned type, const std::string& dst, const char* body, size_t bodyBytes)
+{
+	RemoteRecordHead_ head = { type, (unsigned)bodyBytes, (unsigned)dst.size() };
+	frame.append((const char*)&head, sizeof(head));
+	frame.append(dst);
+	frame.append(body, bodyBytes);
+}
+
+static void seal_frame(std::string& frame, unsigned count)
+{
+	RemoteFrameHead_ head = { (unsigned)(frame.size() - sizeof(RemoteFrameHead_)), count };
+	memcpy(&frame[0], &head, sizeof(head));
+}
+
+static void post_control(const remote_node::peer_handle& peer, unsigned type)
+{
+	remote_msg msg;
+	msg.type = type;
+	peer->_out(std::move(msg));
+}
+
+/*!
+@brief 一批消息的额度，最后一个引用它的remote_msg析构时记入来源连接的已处理字节，
+攒够REMOTE_CREDIT_BYTES/4时唤醒连接Actor归还给对端
+*/
+struct RemoteCredit_
+{
+	RemoteCredit_(const remote_node::peer_handle& peer, size_t bytes)
+		:_peer(peer), _bytes(bytes) {}
+
+	~RemoteCredit_()
+	{
+		consume(_peer, _bytes);
+	}
+
+	static void consume(const remote_node::peer_handle& peer, size_t bytes)
+	{
+		const size_t old = peer->_consumed.fetch_add(bytes, std::memory_order_relaxed);
+		if (old < REMOTE_CREDIT_BYTES / 4 && old + bytes >= REMOTE_CREDIT_BYTES / 4)
+		{
+			post_control(peer, REMOTE_WAKE_TYPE);
+		}
+	}
+
+	remote_node::peer_handle _peer;
+	const size_t _bytes;
+	NONE_COPY(RemoteCredit_);
+};
+
+remote_node::remote_node(io_engine& ios, const std::string& name)
+:_ios(ios), _name(name)
+{
+}
+
+remote_node::~remote_node()
+{
+	assert(_conns.empty() && !_acceptActor);
+}
+
+void remote_node::bind(my_actor* self, const std::string& name)
+{
+	post_actor_msg<remote_msg> ntf = self->connect_msg_notifer_to_self<remote_msg>();
+	std::lock_guard<std::mutex> lg(_mutex);
+	_endpoints[name] = std::move(ntf);
+}
+
+void remote_node::unbind(const std::string& name)
+{
+	std::lock_guard<std::mutex> lg(_mutex);
+	_endpoints.erase(name);
+}
+
+tcp_socket::result remote_node::listen(const char* ip, unsigned short port)
+{
+	assert(!_acceptor);
+	std::shared_ptr<tcp_acceptor> acc = std::make_shared<tcp_acceptor>(_ios);
+	tcp_socket::result res = acc->open(ip, port);
+	if (!res.ok)
+	{
+		return res;
+	}
+	_acceptor = acc;
+	_acceptActor = my_actor::create(boost_strand::create(_ios), [this, acc](my_actor* self)
+	{
+		while (true)
+		{
+			std::shared_ptr<tcp_socket> sck = std::make_shared<tcp_socket>(_ios);
+			if (!acc->accept(self, *sck).ok)
+			{
+				sck->close();
+				break;
+			}
+			start_connection(sck, std::function<void(const peer_handle&)>());
+		}
+	});
+	_acceptActor->run();
+	return res;
+}
+
+remote_node::peer_handle remote_node::connect(my_actor* host, const char* ip, unsigned short port)
+{
+	std::shared_ptr<tcp_socket> sck = std::make_shared<tcp_socket>(_ios);
+	if (!sck->connect(host, ip, port).ok)
+	{
+		sck->close();
+		return peer_handle();
+	}
+	my_actor::quit_guard qg(host);
+	return host->trig<peer_handle>([&](trig_once_notifer<peer_handle>&& ntf)
+	{
+		start_connection(sck, std::move(ntf));
+	});
+}
+
+remote_node::peer_handle remote_node::find_peer(const std::string& name)
+{
+	std::lock_guard<std::mutex> lg(_mutex);
+	auto it = _peers.find(name);
+	return _peers.end() != it ? it->second : peer_handle();
+}
+
+void remote_node::stop(my_actor* host)
+{
+	if (_acceptActor)
+	{
+		std::shared_ptr<tcp_acceptor> acc = _acceptor;
+		_acceptActor->self_strand()->post([acc]
+		{
+			acc->close();
+		});
+		host->actor_wait_quit(_acceptActor);
+		_acceptActor.reset();
+		_acceptor.reset();
+	}
+	std::vector<std::pair<actor_handle, std::shared_ptr<tcp_socket>>> conns;
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		conns = _conns;
+	}
+	for (auto& conn : conns)
+	{
+		std::shared_ptr<tcp_socket> sck = conn.second;
+		conn.first->self_strand()->post([sck]
+		{
+			sck->close();
+		});
+	}
+	for (auto& conn : conns)
+	{
+		host->actor_wait_quit(conn.first);
+	}
+	std::lock_guard<std::mutex> lg(_mutex);
+	assert(_conns.empty());
+	_peers.clear();
+}
+
+const std::string& remote_node::name() const
+{
+	return _name;
+}
+
+bool remote_node::send(const peer_handle& peer, const std::string& dst, unsigned type, std::string&& body)
+{
+	assert(type < REMOTE_RESERVED_TYPE);
+	//给同帧的额度归还记录留出位置
+	if (!peer || peer->_closed || sizeof(RemoteRecordHead_) * 2 + sizeof(unsigned) + dst.size() + body.size() > REMOTE_MAX_FRAME)
+	{
+		return false;
+	}
+	remote_msg msg;
+	msg.dst = dst;
+	msg.type = type;
+	msg.body = std::move(body);
+	peer->_out(std::move(msg));
+	return true;
+}
+
+void remote_node::start_connection(const std::shared_ptr<tcp_socket>& sck, const std::function<void(const peer_handle&)>& onReady)
+{
+	actor_handle conn = my_actor::create(boost_strand::create(_ios), [this, sck, onReady](my_actor* self)
+	{
+		connection(self, sck, onReady);
+	});
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		_conns.push_back(std::make_pair(conn, sck));
+	}
+	conn->run();
+}
+
+void remote_node::connection(my_actor* self, const std::shared_ptr<tcp_socket>& sck, const std::function<void(const peer_handle&)>& onReady)
+{
+	sck->no_delay();
+	peer_handle peer = std::make_shared<RemotePeer_>();
+	peer->_consumed = 0;
+	peer->_closed = false;
+	peer->_socket = sck;
+	peer->_out = self->connect_msg_notifer_to_self<remote_msg>();
+	msg_pump_handle<remote_msg> outPump = self->connect_msg_pump<remote_msg>();
+	//握手，互相发送节点名
+	std::string frame(sizeof(RemoteFrameHead_), '\0');
+	append_record(frame, REMOTE_HELLO_TYPE, std::string(), _name.data(), _name.size());
+	seal_frame(frame, 1);
+	RemoteFrameHead_ fh = { 0, 0 };
+	bool ok = sck->write(self, frame.data(), frame.size()).ok && sck->read(self, &fh, sizeof(fh)).ok
+		&& 1 == fh._count && fh._bytes >= sizeof(RemoteRecordHead_) && fh._bytes <= REMOTE_HELLO_MAX;
+	if (ok)
+	{
+		std::vector<char> hello(fh._bytes);
+		RemoteRecordHead_ rh;
+		ok = sck->read(self, &hello.front(), hello.size()).ok;
+		memcpy(&rh, &hello.front(), sizeof(rh));
+		ok = ok && REMOTE_HELLO_TYPE == rh._type && 0 == rh._dstBytes && sizeof(rh) + rh._bodyBytes == hello.size();
+		if (ok)
+		{
+			peer->_name.assign(&hello.front() + sizeof(rh), rh._bodyBytes);
+		}
+	}
+	if (!ok)
+	{
+		peer->_closed = true;
+		sck->close();
+		unregister(sck.get(), peer_handle());
+		if (onReady)
+		{
+			onReady(peer_handle());
+		}
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lg(_mutex);
+		_peers[peer->_name] = peer;
+	}
+	if (onReady)
+	{
+		onReady(peer);
+	}
+	//读写两个Actor在同一个strand上，共享额度状态不需要同步
+	long long credit = REMOTE_CREDIT_BYTES;
+	size_t grant = 0;
+	child_handle rd = self->create_child(self->self_strand(), [&](my_actor* self)
+	{
+		reader(self, peer, credit);
+	});
+	self->child_run(rd);
+	std::deque<remote_msg> stalled;
+	size_t stalledBytes = 0;
+	bool closed = false;
+	auto take = [&](remote_msg& msg)
+	{
+		if (REMOTE_CLOSE_TYPE == msg.type)
+		{
+			closed = true;
+		}
+		else if (REMOTE_WAKE_TYPE != msg.type)
+		{
+			stalledBytes += record_cost(msg);
+			stalled.push_back(std::move(msg));
+		}
+	};
+	//额度不足时等待归还；对端攒够CREDIT/4才归还，所以只剩未归还的零头在途时允许发送超过额度的单条消息
+	auto blocked = [&]()->bool
+	{
+		return stalled.empty() || ((long long)record_cost(stalled.front()) > credit && credit <= REMOTE_CREDIT_BYTES - REMOTE_CREDIT_BYTES / 4);
+	};
+	while (!closed)
+	{
+		if (!grant && blocked())
+		{
+			remote_msg msg = self->pump_msg(outPump);
+			take(msg);
+		}
+		remote_msg msg;
+		while (!closed && stalledBytes < REMOTE_BATCH_BYTES && self->try_pump_msg(outPump, msg))
+		{
+			take(msg);
+		}
+		if (peer->_consumed.load(std::memory_order_relaxed) >= REMOTE_CREDIT_BYTES / 4)
+		{
+			grant += peer->_consumed.exchange(0, std::memory_order_relaxed);
+		}
+		frame.resize(sizeof(RemoteFrameHead_));
+		unsigned count = 0;
+		if (grant)
+		{
+			const unsigned g = (unsigned)grant;
+			append_record(frame, REMOTE_CREDIT_TYPE, std::string(), (const char*)&g, sizeof(g));
+			grant = 0;
+			count++;
+		}
+		while (!blocked() && frame.size() < REMOTE_BATCH_BYTES)
+		{
+			remote_msg& front = stalled.front();
+			const size_t cost = record_cost(front);
+			if (frame.size() + cost > sizeof(RemoteFrameHead_) + REMOTE_MAX_FRAME)
+			{
+				break;
+			}
+			append_record(frame, front.type, front.dst, front.body.data(), front.body.size());
+			credit -= (long long)cost;
+			stalledBytes -= cost;
+			stalled.pop_front();
+			count++;
+		}
+		if (count)
+		{
+			seal_frame(frame, count);
+			if (!sck->write(self, frame.data(), frame.size()).ok)
+			{
+				break;
+			}
+		}
+	}
+	peer->_closed = true;
+	sck->close();
+	self->child_wait_quit(rd);
+	unregister(sck.get(), peer);
+}
+
+void remote_node::reader(my_actor* self, const peer_handle& peer, long long& credit)
+{
+	tcp_socket* const sck = peer->_socket.get();
+	std::vector<char> buff(REMOTE_READ_BYTES);
+	std::vector<RemoteBatch_> batches;
+	size_t begin = 0, end = 0;
+	bool ok = true;
+	while (ok)
+	{
+		tcp_socket::result res = sck->read_some(self, &buff[end], buff.size() - end);
+		if (!res.ok)
+		{
+			break;
+		}
+		end += res.s;
+		const long long oldCredit = credit;
+		size_t need = sizeof(RemoteFrameHead_);
+		while (end - begin >= sizeof(RemoteFrameHead_))
+		{
+			RemoteFrameHead_ fh;
+			memcpy(&fh, &buff[begin], sizeof(fh));
+			if (fh._bytes > REMOTE_MAX_FRAME)
+			{
+				ok = false;
+				break;
+			}
+			need = sizeof(fh) + fh._bytes;
+			if (end - begin < need)
+			{
+				break;
+			}
+			if (!dispatch(peer, &buff[begin + sizeof(fh)], fh._bytes, fh._count, batches, credit))
+			{
+				ok = false;
+				break;
+			}
+			begin += need;
+			need = sizeof(RemoteFrameHead_);
+		}
+		//本次读到的各帧按端点合并投递，整批共享一份额度，端点处理完后归还
+		for (RemoteBatch_& batch : batches)
+		{
+			if (!batch._msgs.empty() && !batch._post.empty())
+			{
+				std::shared_ptr<RemoteCredit_> cr = std::make_shared<RemoteCredit_>(peer, batch._bytes);
+				for (std::tuple<remote_msg>& msg : batch._msgs)
+				{
+					std::get<0>(msg)._credit = cr;
+				}
+				cr.reset();
+				batch._post.post_batch(std::move(batch._msgs));
+			}
+			else if (batch._bytes)
+			{
+				//没有端点接收的消息直接算作已处理
+				RemoteCredit_::consume(peer, batch._bytes);
+			}
+		}
+		batches.clear();
+		if (begin == end)
+		{
+			begin = end = 0;
+		}
+		else if (buff.size() - begin < need)
+		{
+			//剩余半帧移到缓冲头部，帧比缓冲大时扩大缓冲
+			memmove(&buff[0], &buff[begin], end - begin);
+			end -= begin;
+			begin = 0;
+			if (buff.size() < need)
+			{
+				buff.resize(need);
+			}
+		}
+		if (oldCredit != credit)
+		{
+			post_control(peer, REMOTE_WAKE_TYPE);
+		}
+	}
+	post_control(peer, REMOTE_CLOSE_TYPE);
+}
+
+bool remote_node::dispatch(const peer_handle& peer, const char* data, size_t length, size_t count, std::vector<RemoteBatch_>& batches, long long& credit)
+{
+	const char* p = data;
+	const char* const e = data + length;
+	size_t last = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		RemoteRecordHead_ rh;
+		if ((size_t)(e - p) < sizeof(rh))
+		{
+			return false;
+		}
+		memcpy(&rh, p, sizeof(rh));
+		p += sizeof(rh);
+		if ((size_t)(e - p) < (size_t)rh._dstBytes + rh._bodyBytes)
+		{
+			return false;
+		}
+		const char* const dst = p;
+		const char* const body = p + rh._dstBytes;
+		p = body + rh._bodyBytes;
+		if (REMOTE_CREDIT_TYPE == rh._type)
+		{
+			unsigned g = 0;
+			if (sizeof(g) != rh._bodyBytes)
+			{
+				return false;
+			}
+			memcpy(&g, body, sizeof(g));
+			credit += g;
+		}
+		else if (rh._type < REMOTE_RESERVED_TYPE)
+		{
+			//连续发往同一端点时不再查找
+			if (last >= batches.size() || batches[last]._dst.size() != rh._dstBytes || memcmp(batches[last]._dst.data(), dst, rh._dstBytes))
+			{
+				for (last = 0; last < batches.size(); last++)
+				{
+					if (batches[last]._dst.size() == rh._dstBytes && !memcmp(batches[last]._dst.data(), dst, rh._dstBytes))
+					{
+						break;
+					}
+				}
+				if (last == batches.size())
+				{
+					batches.push_back(RemoteBatch_());
+					RemoteBatch_& batch = batches.back();
+					batch._bytes = 0;
+					batch._dst.assign(dst, rh._dstBytes);
+					std::lock_guard<std::mutex> lg(_mutex);
+					auto it = _endpoints.find(batch._dst);
+					if (_endpoints.end() != it)
+					{
+						batch._post = it->second;
+					}
+				}
+			}
+			RemoteBatch_& batch = batches[last];
+			if (!batch._post.empty())
+			{
+				batch._msgs.push_back(std::tuple<remote_msg>());
+				remote_msg& msg = std::get<0>(batch._msgs.back());
+				msg.from = peer;
+				msg.dst = batch._dst;
+				msg.type = rh._type;
+				msg.body.assign(body, rh._bodyBytes);
+			}
+			batch._bytes += sizeof(rh) + rh._dstBytes + rh._bodyBytes;
+		}
+	}
+	return p == e;
+}
+
+void remote_node::unregister(tcp_socket* sck, const peer_handle& peer)
+{
+	std::lock_guard<std::mutex> lg(_mutex);
+	for (size_t i = 0; i < _conns.size(); i++)
+	{
+		if (_conns[i].second.get() == sck)
+		{
+			_conns[i] = std::move(_conns.back());
+			_conns.pop_back();
+			break;
+		}
+	}
+	if (peer)
+	{
+		auto it = _peers.find(peer->_name);
+		if (_peers.end() != it && it->second == peer)
+		{
+			_peers.erase(it);
+		}
+	}
+}
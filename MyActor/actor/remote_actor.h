@@ -0,0 +1,273 @@
+#ifndef __REMOTE_ACTOR_H
+#define __REMOTE_ACTOR_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <type_traits>
+#include <string.h>
+#include "my_actor.h"
+#include "actor_socket.h"
+
+//一帧最多合并的消息字节数
+#ifndef REMOTE_BATCH_BYTES
+#define REMOTE_BATCH_BYTES (64*1024)
+#endif
+
+//每个连接的发送额度(字节)，对端端点取走并处理完消息(remote_msg析构)后归还
+#ifndef REMOTE_CREDIT_BYTES
+#define REMOTE_CREDIT_BYTES (4*1024*1024)
+#endif
+
+//一帧(帧头之后)的字节数上限，超过的帧视为协议错误并断开连接，超过的单条消息send失败
+#ifndef REMOTE_MAX_FRAME
+#define REMOTE_MAX_FRAME (64*1024*1024)
+#endif
+
+//接收缓冲初始字节数，遇到更大的帧时扩大
+#ifndef REMOTE_READ_BYTES
+#define REMOTE_READ_BYTES (256*1024)
+#endif
+
+//用户消息类型必须小于此值，以上保留给内部控制记录
+#define REMOTE_RESERVED_TYPE 0xFFFFFF00
+
+struct RemotePeer_;
+struct RemoteBatch_;
+struct RemoteCredit_;
+struct remote_msg;
+class remote_node;
+
+/*!
+@brief 消息参数的序列化方法，默认按内存复制可平凡复制类型(两端须为相同架构)，
+其它类型特化remote_serializer<T>提供write/read
+*/
+template <typename T>
+struct remote_serializer
+{
+	static_assert(std::is_trivially_copyable<T>::value, "specialize remote_serializer for this type");
+
+	static void write(std::string& out, const T& v)
+	{
+		out.append((const char*)&v, sizeof(T));
+	}
+
+	static bool read(const char*& p, const char* end, T& v)
+	{
+		if ((size_t)(end - p) < sizeof(T))
+		{
+			return false;
+		}
+		memcpy(&v, p, sizeof(T));
+		p += sizeof(T);
+		return true;
+	}
+};
+
+template <>
+struct remote_serializer<std::string>
+{
+	static void write(std::string& out, const std::string& v)
+	{
+		const unsigned len = (unsigned)v.size();
+		out.append((const char*)&len, sizeof(len));
+		out.append(v);
+	}
+
+	static bool read(const char*& p, const char* end, std::string& v)
+	{
+		unsigned len = 0;
+		if (!remote_serializer<unsigned>::read(p, end, len) || (size_t)(end - p) < len)
+		{
+			return false;
+		}
+		v.assign(p, len);
+		p += len;
+		return true;
+	}
+};
+
+template <typename T>
+struct remote_serializer<std::vector<T>>
+{
+	static void write(std::string& out, const std::vector<T>& v)
+	{
+		const unsigned len = (unsigned)v.size();
+		out.append((const char*)&len, sizeof(len));
+		for (const T& ele : v)
+		{
+			remote_serializer<T>::write(out, ele);
+		}
+	}
+
+	static bool read(const char*& p, const char* end, std::vector<T>& v)
+	{
+		unsigned len = 0;
+		//每个元素至少占一个字节，先按剩余长度检查，防止用伪造的长度分配内存
+		if (!remote_serializer<unsigned>::read(p, end, len) || (size_t)(end - p) < len)
+		{
+			return false;
+		}
+		v.resize(len);
+		for (T& ele : v)
+		{
+			if (!remote_serializer<T>::read(p, end, ele))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+inline void remote_pack(std::string&) {}
+
+/*!
+@brief 依次序列化参数，追加到out
+*/
+template <typename First, typename... Rest>
+void remote_pack(std::string& out, const First& first, const Rest&... rest)
+{
+	remote_serializer<First>::write(out, first);
+	remote_pack(out, rest...);
+}
+
+inline bool remote_unpack_(const char*& p, const char* end)
+{
+	return p == end;
+}
+
+template <typename First, typename... Rest>
+bool remote_unpack_(const char*& p, const char* end, First& first, Rest&... rest)
+{
+	return remote_serializer<First>::read(p, end, first) && remote_unpack_(p, end, rest...);
+}
+
+/*!
+@brief 远端发来的消息，端点Actor用 self->connect_msg_pump<remote_msg>() 接收
+*/
+struct remote_msg
+{
+	std::shared_ptr<RemotePeer_> from;///<来源连接，可直接用于回复
+	std::string dst;///<目标端点名
+	unsigned type;///<消息类型
+	std::string body;///<序列化后的消息体
+
+	/*!
+	@brief 按remote_pack的顺序反序列化消息体，长度或格式不符返回false
+	*/
+	template <typename... ARGS>
+	bool unpack(ARGS&... args) const
+	{
+		const char* p = body.data();
+		return remote_unpack_(p, p + body.size(), args...);
+	}
+private:
+	friend remote_node;
+	std::shared_ptr<RemoteCredit_> _credit;///<同一批投递的消息共享，全部析构后向来源连接归还额度
+};
+
+/*!
+@brief 到某个远端节点的连接，由remote_node管理
+*/
+struct RemotePeer_
+{
+	std::string _name;
+	post_actor_msg<remote_msg> _out;///<投递到该连接的发送Actor
+	std::shared_ptr<tcp_socket> _socket;
+	std::atomic<size_t> _consumed;///<本地端点已处理完、尚未归还给对端的字节数
+	std::atomic<bool> _closed;
+};
+
+/*!
+@brief 跨进程的远程Actor节点；本地Actor以名字登记为端点，远端按(连接, 端点名)发送消息；
+每个连接一个连接Actor：发送方向把投递来的消息合并成不超过REMOTE_BATCH_BYTES的帧，一次write发出，
+接收方向一次read_some读入尽可能多的帧，逐条投递给本地端点；
+按字节计算发送额度，对端端点处理完消息(最后一个引用该批消息的remote_msg析构)后才归还额度，
+额度用完时消息在本地排队，防止快发送方压垮慢接收方；端点长期持有remote_msg会一直占用额度
+*/
+class remote_node
+{
+public:
+	typedef std::shared_ptr<RemotePeer_> peer_handle;
+public:
+	/*!
+	@param name 本节点名，握手时发给对端
+	*/
+	remote_node(io_engine& ios, const std::string& name);
+	~remote_node();
+public:
+	/*!
+	@brief 把调用的Actor登记为端点，之后用 self->connect_msg_pump<remote_msg>() 接收
+	*/
+	__yield_interrupt void bind(my_actor* self, const std::string& name);
+
+	/*!
+	@brief 注销端点
+	*/
+	void unbind(const std::string& name);
+
+	/*!
+	@brief 侦听远端节点连接
+	*/
+	tcp_socket::result listen(const char* ip, unsigned short port);
+
+	/*!
+	@brief 连接远端节点，握手完成后返回连接，失败返回空
+	*/
+	__yield_interrupt peer_handle connect(my_actor* host, const char* ip, unsigned short port);
+
+	/*!
+	@brief 按远端节点名查找已建立的连接
+	*/
+	peer_handle find_peer(const std::string& name);
+
+	/*!
+	@brief 关闭侦听器和全部连接，等待连接Actor退出
+	*/
+	__yield_interrupt void stop(my_actor* host);
+
+	/*!
+	@brief 本节点名
+	*/
+	const std::string& name() const;
+
+	/*!
+	@brief 发送消息到远端端点(可在任意线程调用)，连接已断开或消息超过REMOTE_MAX_FRAME时返回false
+	@param type 消息类型，必须小于REMOTE_RESERVED_TYPE
+	*/
+	static bool send(const peer_handle& peer, const std::string& dst, unsigned type, std::string&& body);
+
+	/*!
+	@brief 用remote_pack序列化参数后发送
+	*/
+	template <typename... ARGS>
+	static bool send_msg(const peer_handle& peer, const std::string& dst, unsigned type, const ARGS&... args)
+	{
+		std::string body;
+		remote_pack(body, args...);
+		return send(peer, dst, type, std::move(body));
+	}
+private:
+	void start_connection(const std::shared_ptr<tcp_socket>& sck, const std::function<void(const peer_handle&)>& onReady);
+	void connection(my_actor* self, const std::shared_ptr<tcp_socket>& sck, const std::function<void(const peer_handle&)>& onReady);
+	void reader(my_actor* self, const peer_handle& peer, long long& credit);
+	bool dispatch(const peer_handle& peer, const char* data, size_t length, size_t count, std::vector<RemoteBatch_>& batches, long long& credit);
+	void unregister(tcp_socket* sck, const peer_handle& peer);
+private:
+	io_engine& _ios;
+	const std::string _name;
+	std::mutex _mutex;
+	std::map<std::string, post_actor_msg<remote_msg>> _endpoints;
+	std::map<std::string, peer_handle> _peers;
+	std::vector<std::pair<actor_handle, std::shared_ptr<tcp_socket>>> _conns;
+	std::shared_ptr<tcp_acceptor> _acceptor;
+	actor_handle _acceptActor;
+	NONE_COPY(remote_node);
+};
+
+#endif
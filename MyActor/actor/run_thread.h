@@ -10,7 +10,7 @@
 #endif
 
 /*!
-@brief ̶߳
+@brief 线程对象
 */
 class run_thread
 {
@@ -107,7 +107,7 @@ private:
 };
 
 /*!
-@brief ֲ߳̾洢
+@brief 线程局部存储
 */
 struct tls_space
 {
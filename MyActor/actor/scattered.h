@@ -150,7 +150,7 @@ struct MakeBreakOfScope2_
 	}
 };
 
-//˳ʱԶlambda
+//作用域退出时自动调用lambda
 #define BREAK_OF_SCOPE_NAME(__name__, __handler__) \
 	auto BOND_NAME(__raiiHandler, __name__) = [&]__handler__; \
 	BreakOfScope_<decltype(BOND_NAME(__raiiHandler, __name__))> BOND_NAME(__raiiCall, __name__)(BOND_NAME(__raiiHandler, __name__))
@@ -159,28 +159,28 @@ struct MakeBreakOfScope2_
 #define BREAK_OF_SCOPE_EXEC(...) BREAK_OF_SCOPE({ option_pck(__VA_ARGS__) });
 #define break_of_scope_call auto BOND_COUNT(__raiiCall) = MakeBreakOfScope2_()-
 
-//Actorڶʱĳ
+//在Actor作用域内定时触发某个操作
 #define HEARTBEAT_TRACE_NAME(__name__, __self__, __ms__, __handler__)\
 	overlap_timer::timer_handle __name__; \
 	__self__->self_strand()->over_timer()->interval(__ms__, __name__, [&]__handler__); \
 	BREAK_OF_SCOPE_NAME(BOND_NAME(__heartbeatHandler_, __name__), { __self__->self_strand()->over_timer()->cancel(__name__); });
 
-//Actorڶʱĳ
+//在Actor作用域内定时触发某个操作
 #define HEARTBEAT_TRACE(__self__, __ms__, __handler__) HEARTBEAT_TRACE_NAME(BOND_COUNT(__heartbeatTimer), __self__, __ms__, __handler__)
 #define HEARTBEAT_EXEC(__self__, __ms__, ...) HEARTBEAT_TRACE(__self__, __ms__, { option_pck(__VA_ARGS__) });
 
-//Actorʱĳ
+//在Actor作用域内延时触发某个操作
 #define DELAY_TRACE_NAME(__name__, __self__, __ms__, __handler__)\
 	async_timer __name__ = __self__->self_strand()->make_timer(); \
 	auto BOND_NAME(__delayHandler_, __name__) = [&]__handler__; \
 	__name__->timeout(__ms__, wrap_ref_handler(BOND_NAME(__delayHandler_, __name__))); \
 	BREAK_OF_SCOPE_NAME(BOND_NAME(__delayHandler_, __name__), { __name__->cancel(); });
 
-//Actorʱĳ
+//在Actor作用域内延时触发某个操作
 #define DELAY_TRACE(__self__, __ms__, __handler__) DELAY_TRACE_NAME(BOND_COUNT(__delayTimer), __self__, __ms__, __handler__)
 #define DELAY_EXEC(__self__, __ms__, ...)  DELAY_TRACE(__self__, __ms__, { option_pck(__VA_ARGS__) });
 
-//Actorʱĳ
+//在Actor作用域内延时触发某个操作
 #define SELF_DELAY_TRACE(__self__, __ms__, __handler__)\
 	auto BOND_LINE(__selfDelayHandler_) = [&]__handler__; \
 	__self__->delay_trig(__ms__, wrap_ref_handler(BOND_LINE(__selfDelayHandler_))); \
@@ -216,10 +216,10 @@ class ActorTimerFace_
 
 #endif
 
-//ڴ߽
+//内存边界对齐
 #define MEM_ALIGN(__o, __a) (((__o) + ((__a)-1)) & (0-(__a)))
 
-//ö󿽱
+//禁用对象拷贝
 #define NONE_COPY(__T__) \
 	private:\
 	__T__(const __T__&) = delete; \
@@ -303,7 +303,7 @@ if (__catched) {
 #define end_CODE_CUT() });}
 
 /*!
-@brief ڲϢʱʹ
+@brief 这个类在测试消息传递时使用
 */
 struct move_test
 {
@@ -331,7 +331,7 @@ struct move_test
 };
 
 /*!
-@brief κλص
+@brief 接受任何回调参数，但不处理
 */
 struct any_handler
 {
@@ -340,7 +340,7 @@ struct any_handler
 };
 
 /*!
-@brief κδֵ
+@brief 接受任何传值，但不处理
 */
 struct any_accept
 {
@@ -351,7 +351,7 @@ struct any_accept
 #define debug_mark {int __mark=0;}
 
 /*!
-@brief ָת
+@brief 指针类型转换
 */
 template <typename Type>
 Type* as_ptype(void* p)
@@ -361,7 +361,7 @@ Type* as_ptype(void* p)
 }
 
 /*!
-@brief ָת
+@brief 任意指针类型转对象引用
 */
 template <typename Type>
 Type& as_ref(void* p)
@@ -370,7 +370,7 @@ Type& as_ref(void* p)
 }
 
 /*!
-@brief ø߾ʱ
+@brief 启用高精度时钟
 */
 void enable_high_resolution();
 
@@ -401,7 +401,7 @@ unsigned long long cpu_tick();
 #endif
 
 /*!
-@brief ͣ""һ͵hash_codeԱtypeid(type).hash_code()
+@brief 根据类型，"计算"一个类型的hash_code，对比typeid(type).hash_code()
 */
 template <typename... Types>
 struct type_hash
@@ -437,7 +437,7 @@ struct type_hash<>
 };
 
 /*!
-@brief ̶Ԫظ
+@brief 固定数组元素个数
 */
 template <typename T, size_t N>
 size_t fixed_array_length(T(&)[N])
@@ -446,7 +446,7 @@ size_t fixed_array_length(T(&)[N])
 }
 
 /*!
-@brief ̶Ԫֽ
+@brief 固定数组元素字节数
 */
 template <typename T, size_t N>
 size_t fixed_array_bytes(T(&)[N])
@@ -455,7 +455,7 @@ size_t fixed_array_bytes(T(&)[N])
 }
 
 /*!
-@brief ̶Ԫֽ
+@brief 固定数组元素字节数
 */
 template <typename T, size_t N>
 size_t fixed_array_bytes(T(&)[N], size_t max_bytes)
@@ -464,7 +464,7 @@ size_t fixed_array_bytes(T(&)[N], size_t max_bytes)
 }
 
 /*!
-@brief std::function
+@brief 清空std::function
 */
 template <typename R, typename... Args>
 inline void clear_function(std::function<R(Args...)>& f)
@@ -491,7 +491,7 @@ struct ForwardCopy_<const T&>
 };
 
 /*!
-@brief ֵһݣֵ
+@brief 将左值复制一份，右值不动
 */
 template <typename T>
 auto forward_copy(T&& p)->typename ForwardCopy_<T>::type
@@ -1,14 +1,20 @@
 #include "shared_strand.h"
 #include "actor_timer.h"
 #include "async_timer.h"
+#include "time_source.h"
 
 #define NEXT_TICK_SPACE_SIZE (sizeof(void*)*8)
 
 boost_strand::boost_strand()
-:_ioEngine(NULL), _strand(NULL), _actorTimer(NULL)
+:_ioEngine(NULL), _strand(NULL), _actorTimer(NULL), _overTimer(NULL), _shard(NULL), _shardIndex(0)
 #ifdef ENABLE_NEXT_TICK
 ,_thisRoundCount(0)
+,_busyStamp(0)
+,_busyUs(0)
+,_handlerCount(0)
+,_maxRound(0)
 ,_reuMemAlloc(NULL)
+,_urgentCount(0)
 #endif //ENABLE_NEXT_TICK
 #if (ENABLE_QT_ACTOR && ENABLE_UV_ACTOR)
 ,_strandChoose(strand_default)
@@ -26,6 +32,7 @@ boost_strand::~boost_strand()
 #ifdef ENABLE_NEXT_TICK
 	assert(_frontTickQueue.empty());
 	assert(_backTickQueue.empty());
+	assert(_urgentQueue.empty());
 	assert(!_strand || (ready_empty() && waiting_empty()));
 	delete _nextTickAlloc[0];
 	delete _nextTickAlloc[1];
@@ -39,24 +46,47 @@ boost_strand::~boost_strand()
 
 shared_strand boost_strand::create(io_engine& ioEngine)
 {
+	return create(ioEngine, ioEngine.pickShard());
+}
+
+shared_strand boost_strand::create(io_engine& ioEngine, size_t shard)
+{
+	assert(!ioEngine._shardNum || shard < ioEngine._shardNum);
+	shard = shard < ioEngine._shardNum ? shard : 0;
 	shared_strand res = ioEngine._strandPool->pick();
 	res->_weakThis = res;
 	if (!res->_ioEngine)
 	{
 		res->_ioEngine = &ioEngine;
-		res->_strand = new strand_type(ioEngine);
 #ifdef ENABLE_NEXT_TICK
 		res->_reuMemAlloc = new reusable_mem();
 		res->_nextTickAlloc[0] = new mem_alloc2<char[NEXT_TICK_SPACE_SIZE]>(ioEngine._poolSize);
 		res->_nextTickAlloc[1] = new mem_alloc2<char[NEXT_TICK_SPACE_SIZE * 2]>(ioEngine._poolSize / 2);
 		res->_nextTickAlloc[2] = new mem_alloc2<char[NEXT_TICK_SPACE_SIZE * 4]>(ioEngine._poolSize / 4);
 #endif
-		res->_actorTimer = new ActorTimer_(res);
-		res->_overTimer = new overlap_timer(res);
+		res->bind_shard(shard);
+	}
+	else if (res->_shardIndex != shard || res->_shard != (ioEngine._shardNum ? ioEngine._shards[shard] : NULL))
+	{
+		//池中的strand绑定在其它分片上，重新绑定
+		res->bind_shard(shard);
 	}
 	return res;
 }
 
+void boost_strand::bind_shard(size_t shard)
+{
+	assert(!_strand || !safe_is_running());
+	delete _actorTimer;
+	delete _overTimer;
+	delete _strand;
+	_shard = _ioEngine->_shardNum ? _ioEngine->_shards[shard] : NULL;
+	_shardIndex = shard;
+	_strand = new strand_type(_ioEngine->shardService(_shardIndex));
+	_actorTimer = new ActorTimer_(_weakThis.lock());
+	_overTimer = new overlap_timer(_weakThis.lock());
+}
+
 std::vector<shared_strand> boost_strand::create_multi(size_t n, io_engine& ioEngine)
 {
 	assert(0 != n);
@@ -100,7 +130,7 @@ void boost_strand::create_multi(std::list<shared_strand>& res, size_t n, io_engi
 shared_strand boost_strand::clone()
 {
 	assert(_ioEngine);
-	return create(*_ioEngine);
+	return create(*_ioEngine, _shardIndex);
 }
 
 bool boost_strand::in_this_ios()
@@ -112,7 +142,7 @@ bool boost_strand::in_this_ios()
 bool boost_strand::sync_safe()
 {
 	assert(_ioEngine);
-	return 1 == _ioEngine->ioThreads();
+	return 1 == _ioEngine->ioThreads() && !_ioEngine->isElastic();
 }
 
 bool boost_strand::running_in_this_thread()
@@ -165,7 +195,12 @@ io_engine& boost_strand::get_io_engine()
 boost::asio::io_service& boost_strand::get_io_service()
 {
 	assert(_ioEngine);
-	return *_ioEngine;
+	return _ioEngine->shardService(_shardIndex);
+}
+
+size_t boost_strand::shard_index()
+{
+	return _shardIndex;
 }
 
 ActorTimer_* boost_strand::actor_timer()
@@ -178,6 +213,21 @@ overlap_timer* boost_strand::over_timer()
 	return _overTimer;
 }
 
+boost_strand::load_info boost_strand::load_stats()
+{
+	load_info res;
+#ifdef ENABLE_NEXT_TICK
+	res.busyUs = _busyUs.load(std::memory_order_relaxed);
+	res.handlers = _handlerCount.load(std::memory_order_relaxed);
+	res.maxRound = _maxRound.exchange(0, std::memory_order_relaxed);
+#else
+	res.busyUs = 0;
+	res.handlers = 0;
+	res.maxRound = 0;
+#endif
+	return res;
+}
+
 std::shared_ptr<AsyncTimer_> boost_strand::make_timer()
 {
 	std::shared_ptr<AsyncTimer_> res = std::make_shared<AsyncTimer_>(_actorTimer);
@@ -207,10 +257,24 @@ void boost_strand::run_tick_front()
 {
 	if (_thisRoundCount)
 	{
+		if (0 == _thisRoundCount % TIME_COARSE_BATCH)
+		{
+			//一直不空的strand在轮中也要能被观察到
+			add_busy(time_source::refresh_coarse());
+			if (_thisRoundCount > _maxRound.load(std::memory_order_relaxed))
+			{
+				_maxRound.store(_thisRoundCount, std::memory_order_relaxed);
+			}
+		}
 		return;
 	}
+	_busyStamp = time_source::refresh_coarse();
 	while (!_frontTickQueue.empty())
 	{
+		if (_urgentCount)
+		{
+			run_urgent();//紧急任务插在排队的tick之间执行，不等整个队列执行完
+		}
 		wrap_next_tick_face* const tick = static_cast<wrap_next_tick_face*>(_frontTickQueue.pop_front());
 		const size_t spaceSize = tick->invoke();
 		switch (MEM_ALIGN(spaceSize, NEXT_TICK_SPACE_SIZE) / NEXT_TICK_SPACE_SIZE)
@@ -232,8 +296,18 @@ void boost_strand::run_tick_back()
 	}
 	size_t tickCount = _thisRoundCount;
 	_thisRoundCount = 0;
+	add_busy(time_source::tsc_us());
+	_handlerCount.store(_handlerCount.load(std::memory_order_relaxed) + tickCount, std::memory_order_relaxed);
+	if (tickCount > _maxRound.load(std::memory_order_relaxed))
+	{
+		_maxRound.store(tickCount, std::memory_order_relaxed);
+	}
 	while (!_backTickQueue.empty() && tickCount--)
 	{
+		if (_urgentCount)
+		{
+			run_urgent();
+		}
 		wrap_next_tick_face* const tick = static_cast<wrap_next_tick_face*>(_backTickQueue.pop_front());
 		const size_t spaceSize = tick->invoke();
 		switch (MEM_ALIGN(spaceSize, NEXT_TICK_SPACE_SIZE) / NEXT_TICK_SPACE_SIZE)
@@ -254,6 +328,54 @@ void boost_strand::run_tick_back()
 	}
 }
 
+void boost_strand::add_busy(long long ct)
+{
+	//只有本strand写，读端只需要最终一致
+	if (ct > _busyStamp)
+	{
+		_busyUs.store(_busyUs.load(std::memory_order_relaxed) + (ct - _busyStamp), std::memory_order_relaxed);
+		_busyStamp = ct;
+	}
+}
+
+void boost_strand::push_urgent(wrap_urgent_face* handler)
+{
+	_urgentMutex.lock();
+	_urgentQueue.push_back(handler);
+	const bool wake = 0 == _urgentCount++;
+	_urgentMutex.unlock();
+	if (wake)
+	{
+		//strand忙碌时由下一个普通任务执行前带出，空闲时由这个空任务唤醒
+		post(any_handler());
+	}
+}
+
+void boost_strand::run_urgent()
+{
+	op_queue urgents;
+	size_t remain;
+	{
+		std::lock_guard<std::mutex> lg(_urgentMutex);
+		size_t n = 0;
+		for (; n < STRAND_URGENT_BATCH && !_urgentQueue.empty(); n++)
+		{
+			urgents.push_back(_urgentQueue.pop_front());
+		}
+		remain = _urgentCount -= n;
+	}
+	while (!urgents.empty())
+	{
+		wrap_urgent_face* const urgent = static_cast<wrap_urgent_face*>(urgents.pop_front());
+		urgent->invoke();
+		_urgentAlloc.deallocate(urgent);
+	}
+	if (remain)
+	{
+		post(any_handler());
+	}
+}
+
 void* boost_strand::alloc_space(size_t size)
 {
 	switch (MEM_ALIGN(size, NEXT_TICK_SPACE_SIZE) / NEXT_TICK_SPACE_SIZE)
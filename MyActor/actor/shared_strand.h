@@ -24,6 +24,11 @@ class overlap_timer;
 class boost_strand;
 typedef std::shared_ptr<boost_strand> shared_strand;
 
+//strand每执行一个普通任务前最多先执行的紧急任务数，防止普通任务被饿死
+#ifndef STRAND_URGENT_BATCH
+#define STRAND_URGENT_BATCH 16
+#endif
+
 #ifdef ENABLE_NEXT_TICK
 
 #define RUN_HANDLER handler_capture<Handler>(handler, this)
@@ -54,6 +59,12 @@ else\
 	dispatch_choose(std::forward<Handler>(handler)); \
 };
 
+#define SHARD_POST()\
+if (_shard && shard_post<Handler>(handler))\
+{\
+	return;\
+}
+
 #ifdef ENABLE_NEXT_TICK
 
 #define APPEND_TICK()\
@@ -102,6 +113,10 @@ class boost_strand
 
 		void operator ()()
 		{
+			if (_strand->_urgentCount)
+			{
+				_strand->run_urgent();
+			}
 			_strand->run_tick_front();
 			CHECK_EXCEPTION(_handler);
 			_strand->run_tick_back();
@@ -156,6 +171,29 @@ class boost_strand
 		handler_type _handler;
 		NONE_COPY(wrap_next_tick_handler);
 	};
+
+	struct wrap_urgent_face : public op_queue::face
+	{
+		virtual void invoke() = 0;
+	};
+
+	template <typename Handler>
+	struct wrap_urgent_handler : public wrap_urgent_face
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		wrap_urgent_handler(Handler& handler)
+			:_handler(std::forward<Handler>(handler)) {}
+
+		void invoke()
+		{
+			CHECK_EXCEPTION(_handler);
+			this->~wrap_urgent_handler();
+		}
+
+		handler_type _handler;
+		NONE_COPY(wrap_urgent_handler);
+	};
 #endif //ENABLE_NEXT_TICK
 
 	template <typename Handler, typename Callback>
@@ -205,6 +243,30 @@ class boost_strand
 		COPY_CONSTRUCT2(wrap_async_invoke_void, _handler, _callback);
 	};
 
+	template <typename Handler>
+	struct wrap_shard_handler : public ShardOp_
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		wrap_shard_handler(Handler& handler, shared_strand&& strand)
+			:_strand(std::move(strand)), _handler(std::forward<Handler>(handler)) {}
+
+		void invoke()
+		{
+			boost_strand* const strand = _strand.get();
+#ifdef ENABLE_NEXT_TICK
+			strand->_strand->dispatch(handler_capture<handler_type>(_handler, strand));
+#else
+			strand->_strand->dispatch(std::move(_handler));
+#endif
+			delete this;
+		}
+
+		shared_strand _strand;
+		handler_type _handler;
+		NONE_COPY(wrap_shard_handler);
+	};
+
 	friend my_actor;
 	friend generator;
 	friend overlap_timer;
@@ -227,14 +289,19 @@ protected:
 #endif
 public:
 	static shared_strand create(io_engine& ioEngine);
+
+	/*!
+	@brief 创建一个绑定到指定分片的strand(io_engine以runShard运行时有效，否则等同于create(ioEngine))
+	*/
+	static shared_strand create(io_engine& ioEngine, size_t shard);
 	static std::vector<shared_strand> create_multi(size_t n, io_engine& ioEngine);
 	static void create_multi(shared_strand* res, size_t n, io_engine& ioEngine);
 	static void create_multi(std::vector<shared_strand>& res, size_t n, io_engine& ioEngine);
 	static void create_multi(std::list<shared_strand>& res, size_t n, io_engine& ioEngine);
 public:
 	/*!
-	@brief ڱstrandеֱִУӵеȴִ
-	@param handler ú
+	@brief 如果在本strand中调用则直接执行，否则添加到队列中等待执行
+	@param handler 被调用函数
 	*/
 	template <typename Handler>
 	void distribute(Handler&& handler)
@@ -250,11 +317,12 @@ public:
 	}
 
 	/*!
-	@brief ǰstrandûֱִУӵеȴִ
+	@brief 如果当前strand没任务就直接执行，否则添加到队列中等待执行
 	*/
 	template <typename Handler>
 	void dispatch(Handler&&  handler)
 	{
+		SHARD_POST();
 #if (ENABLE_QT_ACTOR || ENABLE_UV_ACTOR)
 		CHOOSE_DISPATCH();
 #else
@@ -263,11 +331,12 @@ public:
 	}
 
 	/*!
-	@brief һ strand 
+	@brief 添加一个任务到 strand 队列
 	*/
 	template <typename Handler>
 	void post(Handler&& handler)
 	{
+		SHARD_POST();
 #if (ENABLE_QT_ACTOR || ENABLE_UV_ACTOR)
 		CHOOSE_POST();
 #else
@@ -276,13 +345,47 @@ public:
 	}
 
 	/*!
-	@brief һ tick 
+	@brief 添加一个任务到紧急队列，strand每执行一个普通任务前先执行紧急任务(每次最多STRAND_URGENT_BATCH个)，
+	忙碌的strand上紧急任务不用排在已投递的普通任务之后(未定义ENABLE_NEXT_TICK时等同于post)
+	*/
+	template <typename Handler>
+	void post_urgent(Handler&& handler)
+	{
+#ifdef ENABLE_NEXT_TICK
+		if (_strand)
+		{
+			typedef wrap_urgent_handler<Handler> wrap_urgent_type;
+			push_urgent(new(_urgentAlloc.allocate(sizeof(wrap_urgent_type)))wrap_urgent_type(handler));
+			return;
+		}
+#endif //ENABLE_NEXT_TICK
+		post(std::forward<Handler>(handler));
+	}
+
+	/*!
+	@brief 如果在本strand中调用则直接执行，否则添加到紧急队列
+	*/
+	template <typename Handler>
+	void dispatch_urgent(Handler&& handler)
+	{
+		if (running_in_this_thread())
+		{
+			CHECK_EXCEPTION(handler);
+		}
+		else
+		{
+			post_urgent(std::forward<Handler>(handler));
+		}
+	}
+
+	/*!
+	@brief 添加一个任务到 tick 队列
 	*/
 	template <typename Handler>
 	void next_tick(Handler&& handler)
 	{
 		assert(running_in_this_thread());
-		assert(is_running());//, strandûʼһpostѾͶtick
+		assert(is_running());//错误, strand还没开始第一个post就已经再投递tick
 #if (ENABLE_QT_ACTOR || ENABLE_UV_ACTOR)
 		CHOOSE_TICK();
 #else
@@ -291,7 +394,7 @@ public:
 	}
 
 	/*!
-	@brief һ boost_tick 
+	@brief 尝试添加一个任务到 boost_tick 队列
 	*/
 	template <typename Handler>
 	void try_tick(Handler&& handler)
@@ -309,7 +412,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװdispatchУڲͬstrandϢ
+	@brief 把被调用函数包装到dispatch中，用于不同strand间消息传递
 	*/
 	template <typename Handler>
 	wrapped_dispatch_handler<boost_strand, Handler> wrap_asio(Handler&& handler)
@@ -318,7 +421,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװdispatchУڲͬstrandϢݣúǿƱֵãֻܵһ
+	@brief 把被调用函数包装到dispatch中，用于不同strand间消息传递，调用后参数将强制被右值引用，且只能调用一次
 	*/
 	template <typename Handler>
 	wrapped_dispatch_handler<boost_strand, Handler, true> wrap_asio_once(Handler&& handler)
@@ -327,7 +430,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװdistributeУڲͬstrandϢ
+	@brief 把被调用函数包装到distribute中，用于不同strand间消息传递
 	*/
 	template <typename Handler>
 	wrapped_distribute_handler<boost_strand, Handler> wrap(Handler&& handler)
@@ -336,7 +439,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװdistributeУڲͬstrandϢݣúǿƱֵãֻܵһ
+	@brief 把被调用函数包装到distribute中，用于不同strand间消息传递，调用后参数将强制被右值引用，且只能调用一次
 	*/
 	template <typename Handler>
 	wrapped_distribute_handler<boost_strand, Handler, true> wrap_once(Handler&& handler)
@@ -345,7 +448,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװpost
+	@brief 把被调用函数包装到post中
 	*/
 	template <typename Handler>
 	wrapped_post_handler<boost_strand, Handler> wrap_post(Handler&& handler)
@@ -354,7 +457,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװpostУúǿƱֵãֻܵһ
+	@brief 把被调用函数包装到post中，调用后参数将强制被右值引用，且只能调用一次
 	*/
 	template <typename Handler>
 	wrapped_post_handler<boost_strand, Handler, true> wrap_post_once(Handler&& handler)
@@ -363,7 +466,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװtick
+	@brief 把被调用函数包装到tick中
 	*/
 	template <typename Handler>
 	wrapped_next_tick_handler<boost_strand, Handler> wrap_next_tick(Handler&& handler)
@@ -372,7 +475,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװtickУúǿƱֵãֻܵһ
+	@brief 把被调用函数包装到tick中，调用后参数将强制被右值引用，且只能调用一次
 	*/
 	template <typename Handler>
 	wrapped_next_tick_handler<boost_strand, Handler, true> wrap_next_tick_once(Handler&& handler)
@@ -381,7 +484,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװtick
+	@brief 把被调用函数包装到tick中
 	*/
 	template <typename Handler>
 	wrapped_try_tick_handler<boost_strand, Handler> wrap_try_tick(Handler&& handler)
@@ -390,7 +493,7 @@ public:
 	}
 
 	/*!
-	@brief ѱúװtickУúǿƱֵãֻܵһ
+	@brief 把被调用函数包装到tick中，调用后参数将强制被右值引用，且只能调用一次
 	*/
 	template <typename Handler>
 	wrapped_try_tick_handler<boost_strand, Handler, true> wrap_try_tick_once(Handler&& handler)
@@ -399,74 +502,94 @@ public:
 	}
 
 	/*!
-	@brief һͬһiosstrand
+	@brief 复制一个依赖同一个ios的strand
 	*/
 	shared_strand clone();
 
 	/*!
-	@brief Ƿiosִ߳
-	@return true , false 
+	@brief 检查是否在所依赖ios线程中执行
+	@return true 在, false 不在
 	*/
 	virtual bool in_this_ios();
 
 	/*!
-	@brief ⵱ǰiosǷǵ߳
+	@brief 检测当前依赖的ios是否是单线程
 	*/
 	virtual bool sync_safe();
 
 	/*!
-	@brief ios߳
+	@brief 依赖的ios调度器运行线程数
 	*/
 	size_t io_threads();
 
 	/*!
-	@brief ջֻеǰstrand
+	@brief 调用栈里只有当前strand
 	*/
 	virtual bool only_self();
 
 	/*!
-	@brief жǷڱstrand
+	@brief 判断是否在本strand中运行
 	*/
 	virtual bool running_in_this_thread();
 
 	/*!
-	@brief ǰǷΪ(㵱ǰ)
-	@param checkTick Ƿtick
+	@brief 当前任务队列是否为空(不算当前)
+	@param checkTick 是否计算tick任务
 	*/
 	bool empty(bool checkTick = true);
 
 	/*!
-	@brief Ƿ
+	@brief 是否在运行
 	*/
 	virtual bool is_running();
 
 	/*!
-	@brief Ƿ
+	@brief 是否在运行
 	*/
 	bool safe_is_running();
 
 	/*!
-	@brief ȡǰ
+	@brief 获取当前调度器代理
 	*/
 	io_engine& get_io_engine();
 
 	/*!
-	@brief ȡǰ
+	@brief 获取当前调度器(分片模式下为所绑定分片的io_service)
 	*/
 	boost::asio::io_service& get_io_service();
 
 	/*!
-	@brief һʱ
+	@brief 所绑定的分片索引
+	*/
+	size_t shard_index();
+
+	/*!
+	@brief strand负载统计(未定义ENABLE_NEXT_TICK时全为0)，可在任意线程读取
+	*/
+	struct load_info
+	{
+		long long busyUs;///<累计执行任务的时间
+		size_t handlers;///<累计执行的任务数
+		size_t maxRound;///<上次读取以来最长的一轮(队列不空连续执行的任务数)，用于估计队列积压
+	};
+
+	/*!
+	@brief 读取负载统计，maxRound读取后清零
+	*/
+	load_info load_stats();
+
+	/*!
+	@brief 创建一个定时器
 	*/
 	std::shared_ptr<AsyncTimer_> make_timer();
 
 	/*!
-	@brief ȡصʱ
+	@brief 获取重叠定时器
 	*/
 	overlap_timer* over_timer();
 private:
 	/*!
-	@brief ȡActorʱ
+	@brief 获取Actor定时器
 	*/
 	ActorTimer_* actor_timer();
 #ifdef ENABLE_QT_ACTOR
@@ -523,6 +646,23 @@ private:
 	}
 #endif
 	void* alloc_space(size_t size);
+
+	/*!
+	@brief 从其它分片线程投递时，经过分片间环形队列转发
+	*/
+	template <typename Handler>
+	bool shard_post(Handler& handler)
+	{
+		IoShard_* const curr = io_engine::tlsShard();
+		if (curr && curr != _shard && &curr->_engine == _ioEngine)
+		{
+			_shard->push(curr->_index, new wrap_shard_handler<Handler>(handler, _weakThis.lock()));
+			return true;
+		}
+		return false;
+	}
+
+	void bind_shard(size_t shard);
 protected:
 #ifdef ENABLE_NEXT_TICK
 	bool ready_empty();
@@ -530,11 +670,22 @@ protected:
 	void push_next_tick(wrap_next_tick_face* handler);
 	void run_tick_front();
 	void run_tick_back();
+	void push_urgent(wrap_urgent_face* handler);
+	void run_urgent();
+	void add_busy(long long ct);
 	size_t _thisRoundCount;
+	long long _busyStamp;
+	std::atomic<long long> _busyUs;
+	std::atomic<size_t> _handlerCount;
+	std::atomic<size_t> _maxRound;
 	reusable_mem* _reuMemAlloc;
 	mem_alloc_base* _nextTickAlloc[3];
 	op_queue _backTickQueue;
 	op_queue _frontTickQueue;
+	op_queue _urgentQueue;
+	reusable_mem_mt<> _urgentAlloc;///<紧急任务在其它线程投递，单独用带锁的分配器
+	std::mutex _urgentMutex;
+	std::atomic<size_t> _urgentCount;
 #endif //ENABLE_NEXT_TICK
 protected:
 #if (ENABLE_QT_ACTOR && ENABLE_UV_ACTOR)
@@ -545,12 +696,14 @@ protected:
 	overlap_timer* _overTimer;
 	io_engine* _ioEngine;
 	strand_type* _strand;
+	IoShard_* _shard;
+	size_t _shardIndex;
 	std::weak_ptr<boost_strand> _weakThis;
 	NONE_COPY(boost_strand);
 public:
 	/*!
-	@brief һstrandеĳֱִɺŷ
-	@warning ˺пʹֻstrandios޹߳е
+	@brief 在一个strand中调用某个函数，直到这个函数被执行完成后才返回
+	@warning 此函数有可能使整个程序陷入死锁，只能在与strand所依赖的ios无关线程中调用
 	*/
 	template <typename H>
 	void syncInvoke(H&& h)
@@ -572,7 +725,7 @@ public:
 	}
 
 	/*!
-	@brief ͬϣֵ
+	@brief 同上，带返回值
 	*/
 	template <typename R, typename H>
 	R syncInvoke(H&& h)
@@ -600,8 +753,8 @@ public:
 	}
 
 	/*!
-	@brief strandеĳֵȻͨһصѷֵ
-	@param cb ĺ
+	@brief 在strand中调用某个带返回值函数，然后通过一个回调函数把返回值传出
+	@param cb 传出参数的函数
 	*/
 	template <typename Handler, typename Callback>
 	void asyncInvoke(Handler&& h, Callback&& cb)
@@ -623,5 +776,6 @@ public:
 #undef CHOOSE_POST_FRONT
 #undef CHOOSE_DISPATCH_FRONT
 #undef APPEND_TICK
+#undef SHARD_POST
 
 #endif
\ No newline at end of file
@@ -0,0 +1,787 @@
+#include "shm_link.h"
+
+#ifdef __linux__
+#include <atomic>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/eventfd.h>
+
+#define SHM_LINK_MAGIC 0x4B4E4C53
+#define SHM_PAD_TAG ((unsigned)-1)
+#define SHM_RECORD_ALIGN(__n__) (((__n__) + 7) & ~(size_t)7)
+
+/*!
+@brief 一个方向的环形缓冲控制块，头尾各占一个缓存行，避免两个进程互相踩缓存行
+*/
+struct ShmRing_
+{
+	alignas(64) std::atomic<unsigned long long> _tail;///<生产者写入位置
+	alignas(64) std::atomic<unsigned long long> _head;///<消费者读取位置
+	alignas(64) std::atomic<unsigned> _producerWaiting;///<生产者在等待空间
+	std::atomic<unsigned> _consumerWaiting;///<消费者在等待消息
+};
+
+/*!
+@brief 共享内存头，之后依次是两个方向的数据区；
+_rings[0]为侦听端发往连接端，_rings[1]为连接端发往侦听端
+*/
+struct ShmHeader_
+{
+	unsigned _magic;
+	unsigned long long _ringBytes;
+	alignas(64) ShmRing_ _rings[2];
+};
+
+/*!
+@brief 消息记录头，记录按8字节对齐，不跨越缓冲尾部(尾部放不下时写一条填充记录)
+*/
+struct ShmRecord_
+{
+	unsigned _length;
+	unsigned _tag;
+};
+
+/*!
+@brief 握手时随memfd和两个eventfd一起发送
+*/
+struct ShmHello_
+{
+	unsigned _magic;
+	unsigned long long _ringBytes;
+};
+
+shm_link::PostOp_::PostOp_(size_t length, unsigned tag, std::atomic<size_t>& postBytes)
+:_postBytes(postBytes)
+{
+	LinkOp_::_buff = this + 1;
+	LinkOp_::_length = length;
+	LinkOp_::_tag = tag;
+	LinkOp_::_next = NULL;
+}
+
+shm_link::PostOp_::~PostOp_() __disable_noexcept
+{
+	_postBytes -= sizeof(PostOp_) + LinkOp_::_length;
+}
+
+void* shm_link::PostOp_::operator new(size_t size, size_t length)
+{
+	assert(sizeof(PostOp_) == size);
+	return ::operator new(size + length + 1);
+}
+
+void shm_link::PostOp_::operator delete(void* p)
+{
+	::operator delete(p);
+}
+
+void shm_link::PostOp_::invoke(const result& res)
+{
+}
+
+shm_link::shm_link(const shared_strand& strand)
+:_strand(strand), _sock(NULL), _bellDesc(NULL), _peerBell(-1), _segment(NULL), _segmentSize(0), _in(NULL), _out(NULL),
+_inData(NULL), _outData(NULL), _ringBytes(0), _inHead(0), _inTailCache(0), _outTail(0), _outHeadCache(0), _postBytes(0), _armed(false), _peerClosed(false)
+{
+	_sendQueue._head = _sendQueue._tail = NULL;
+	_recvQueue._head = _recvQueue._tail = NULL;
+}
+
+shm_link::~shm_link()
+{
+	assert(!_sendQueue._head && !_recvQueue._head);
+	_release();
+}
+
+std::shared_ptr<shm_link> shm_link::create(const shared_strand& strand)
+{
+	std::shared_ptr<shm_link> res(new shm_link(strand));
+	res->_weakThis = res;
+	return res;
+}
+
+shm_link::result shm_link::connect(my_actor* host, const char* path)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_connect(path, std::move(h));
+	});
+}
+
+shm_link::result shm_link::send(my_actor* host, const void* buff, size_t length, unsigned tag)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_send(buff, length, tag, std::move(h));
+	});
+}
+
+shm_link::result shm_link::receive(my_actor* host, void* buff, size_t length)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<result>([&](trig_once_notifer<result>&& h)
+	{
+		async_receive(buff, length, std::move(h));
+	});
+}
+
+shm_link::result shm_link::try_send(const void* buff, size_t length, unsigned tag)
+{
+	assert(_strand->running_in_this_thread());
+	assert(SHM_PAD_TAG != tag);
+	const int code = _send_error(length);
+	if (code)
+	{
+		return result{ 0, tag, code, false };
+	}
+	if (_sendQueue._head || !_ring_push(buff, length, tag))
+	{
+		return result{ 0, tag, boost::asio::error::would_block, false };
+	}
+	return result{ length, tag, 0, true };
+}
+
+shm_link::result shm_link::try_receive(void* buff, size_t length)
+{
+	assert(_strand->running_in_this_thread());
+	if (!_segment)
+	{
+		return result{ 0, 0, boost::asio::error::not_connected, false };
+	}
+	ShmRecord_* const rec = _recvQueue._head ? NULL : _ring_front();
+	if (!rec)
+	{
+		return result{ 0, 0, _peerClosed && !_recvQueue._head ? (int)boost::asio::error::eof : (int)boost::asio::error::would_block, false };
+	}
+	if (rec->_length > length)
+	{
+		return result{ rec->_length, rec->_tag, boost::asio::error::message_size, false };
+	}
+	result res = { rec->_length, rec->_tag, 0, true };
+	memcpy(buff, rec + 1, rec->_length);
+	_ring_pop(rec);
+	return res;
+}
+
+void shm_link::close()
+{
+	_strand->distribute(std::bind([](const std::shared_ptr<shm_link>& link)
+	{
+		link->_close();
+	}, _weakThis.lock()));
+}
+
+bool shm_link::is_open() const
+{
+	return _segment && !_peerClosed;
+}
+
+size_t shm_link::max_msg_size() const
+{
+	return _ringBytes ? _ringBytes / 2 - sizeof(ShmRecord_) : 0;
+}
+
+const shared_strand& shm_link::self_strand() const
+{
+	return _strand;
+}
+
+bool shm_link::would_block(const result& res)
+{
+	return boost::asio::error::would_block == res.code;
+}
+
+int shm_link::_send_error(size_t length)
+{
+	if (!_segment)
+	{
+		return boost::asio::error::not_connected;
+	}
+	if (_peerClosed)
+	{
+		return boost::asio::error::connection_reset;
+	}
+	if (length > max_msg_size())
+	{
+		return boost::asio::error::message_size;
+	}
+	return 0;
+}
+
+void shm_link::_send_op(LinkOp_* op)
+{
+	if (!_strand->running_in_this_thread())
+	{
+		_strand->post(std::bind([](const std::shared_ptr<shm_link>& link, LinkOp_* op)
+		{
+			link->_send_op(op);
+		}, _weakThis.lock(), op));
+		return;
+	}
+	const int code = _send_error(op->_length);
+	if (code || (!_sendQueue._head && _ring_push(op->_buff, op->_length, op->_tag)))
+	{
+		op->invoke(result{ code ? 0 : op->_length, op->_tag, code, !code });
+		delete op;
+		return;
+	}
+	if (_sendQueue._tail)
+	{
+		_sendQueue._tail->_next = op;
+	}
+	else
+	{
+		_sendQueue._head = op;
+	}
+	_sendQueue._tail = op;
+	_flush();
+}
+
+void shm_link::_receive_op(LinkOp_* op)
+{
+	if (!_strand->running_in_this_thread())
+	{
+		_strand->post(std::bind([](const std::shared_ptr<shm_link>& link, LinkOp_* op)
+		{
+			link->_receive_op(op);
+		}, _weakThis.lock(), op));
+		return;
+	}
+	if (_recvQueue._tail)
+	{
+		_recvQueue._tail->_next = op;
+	}
+	else
+	{
+		_recvQueue._head = op;
+	}
+	_recvQueue._tail = op;
+	if (_segment)
+	{
+		_flush();
+	}
+	else
+	{
+		_fail_queue(_recvQueue, boost::asio::error::not_connected);
+	}
+}
+
+void shm_link::_connect(const char* path, LinkOp_* op)
+{
+	std::shared_ptr<shm_link> sharedThis = _weakThis.lock();
+	_strand->distribute(std::bind([sharedThis, op](std::string& path)
+	{
+		shm_link* const this_ = sharedThis.get();
+		if (this_->_sock || this_->_segment)
+		{
+			op->invoke(result{ 0, 0, boost::asio::error::already_connected, false });
+			delete op;
+			return;
+		}
+		this_->_sock = new boost::asio::local::stream_protocol::socket(this_->_strand->get_io_service());
+		this_->_sock->async_connect(boost::asio::local::stream_protocol::endpoint(path), this_->_strand->wrap_asio_once([sharedThis, op](const boost::system::error_code& ec)
+		{
+			if (ec || !sharedThis->_sock)
+			{
+				sharedThis->_handshake_done(op, ec ? ec.value() : (int)boost::asio::error::operation_aborted);
+				return;
+			}
+			//等待侦听端发来共享内存
+			sharedThis->_sock->async_wait(boost::asio::socket_base::wait_read, sharedThis->_strand->wrap_asio_once([sharedThis, op](const boost::system::error_code& ec)
+			{
+				sharedThis->_handshake_done(op, ec ? ec.value() : sharedThis->_connected());
+			}));
+		}));
+	}, std::string(path)));
+}
+
+int shm_link::_accepted(size_t ringBytes)
+{
+	if (!_sock)
+	{
+		return boost::asio::error::operation_aborted;
+	}
+	size_t bytes = 4096;
+	while (bytes < ringBytes)
+	{
+		bytes <<= 1;
+	}
+	int fds[3] = { memfd_create("shm_link", MFD_CLOEXEC), eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC), eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC) };
+	int code = 0;
+	if (fds[0] < 0 || fds[1] < 0 || fds[2] < 0 || ftruncate(fds[0], sizeof(ShmHeader_) + 2 * bytes))
+	{
+		code = errno;
+	}
+	else if (!(code = _map(fds[0], bytes, 0, fds[1], fds[2])))
+	{
+		//两个eventfd已交给_bellDesc/_peerBell
+		ShmHello_ hello = { SHM_LINK_MAGIC, bytes };
+		struct iovec iov = { &hello, sizeof(hello) };
+		char control[CMSG_SPACE(sizeof(fds))];
+		memset(control, 0, sizeof(control));
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = sizeof(control);
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+		memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+		ssize_t n;
+		while ((n = ::sendmsg(_sock->native_handle(), &msg, MSG_NOSIGNAL)) < 0 && EINTR == errno) {}
+		code = sizeof(hello) == n ? 0 : (n < 0 ? errno : (int)boost::asio::error::connection_aborted);
+		fds[1] = fds[2] = -1;
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		if (fds[i] >= 0)
+		{
+			::close(fds[i]);
+		}
+	}
+	return code;
+}
+
+int shm_link::_connected()
+{
+	if (!_sock)
+	{
+		return boost::asio::error::operation_aborted;
+	}
+	ShmHello_ hello = { 0, 0 };
+	int fds[3] = { -1, -1, -1 };
+	struct iovec iov = { &hello, sizeof(hello) };
+	char control[CMSG_SPACE(sizeof(fds))];
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov = &iov;
+	msg.msg_iovlen = 1;
+	msg.msg_control = control;
+	msg.msg_controllen = sizeof(control);
+	ssize_t n;
+	while ((n = ::recvmsg(_sock->native_handle(), &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC)) < 0 && EINTR == errno) {}
+	if (n < 0)
+	{
+		return errno;
+	}
+	for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg))
+	{
+		if (SOL_SOCKET == cmsg->cmsg_level && SCM_RIGHTS == cmsg->cmsg_type && CMSG_LEN(sizeof(fds)) == cmsg->cmsg_len)
+		{
+			memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+		}
+	}
+	int code = 0;
+	if (sizeof(hello) != n || SHM_LINK_MAGIC != hello._magic || fds[0] < 0 || fds[1] < 0 || fds[2] < 0)
+	{
+		code = 0 == n ? (int)boost::asio::error::eof : (int)boost::asio::error::invalid_argument;
+	}
+	else if (!(code = _map(fds[0], (size_t)hello._ringBytes, 1, fds[2], fds[1])))
+	{
+		fds[1] = fds[2] = -1;
+	}
+	for (int i = 0; i < 3; i++)
+	{
+		if (fds[i] >= 0)
+		{
+			::close(fds[i]);
+		}
+	}
+	return code;
+}
+
+int shm_link::_map(int memFd, size_t ringBytes, int side, int bell, int peerBell)
+{
+	const size_t segmentSize = sizeof(ShmHeader_) + 2 * ringBytes;
+	char* const segment = (char*)mmap(NULL, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, memFd, 0);
+	if (MAP_FAILED == (void*)segment)
+	{
+		return errno;
+	}
+	ShmHeader_* const header = (ShmHeader_*)segment;
+	if (0 == side)
+	{
+		header->_magic = SHM_LINK_MAGIC;
+		header->_ringBytes = ringBytes;
+	}
+	else if (SHM_LINK_MAGIC != header->_magic || ringBytes != header->_ringBytes)
+	{
+		munmap(segment, segmentSize);
+		return boost::asio::error::invalid_argument;
+	}
+	_segment = segment;
+	_segmentSize = segmentSize;
+	_ringBytes = ringBytes;
+	_in = &header->_rings[1 - side];
+	_out = &header->_rings[side];
+	_inData = segment + sizeof(ShmHeader_) + (1 - side) * ringBytes;
+	_outData = segment + sizeof(ShmHeader_) + side * ringBytes;
+	_inHead = _inTailCache = _in->_head.load(std::memory_order_relaxed);
+	_outTail = _outHeadCache = _out->_tail.load(std::memory_order_relaxed);
+	_bellDesc = new boost::asio::posix::stream_descriptor(_strand->get_io_service(), bell);
+	_peerBell = peerBell;
+	return 0;
+}
+
+void shm_link::_handshake_done(LinkOp_* op, int code)
+{
+	if (code)
+	{
+		_release();
+	}
+	else
+	{
+		_watch_peer();
+	}
+	op->invoke(result{ 0, 0, code, !code });
+	delete op;
+}
+
+void shm_link::_flush()
+{
+	assert(_strand->running_in_this_thread());
+	while (_segment)
+	{
+		while (_sendQueue._head && _ring_push(_sendQueue._head->_buff, _sendQueue._head->_length, _sendQueue._head->_tag))
+		{
+			LinkOp_* const op = _sendQueue._head;
+			_sendQueue._head = op->_next;
+			if (!_sendQueue._head)
+			{
+				_sendQueue._tail = NULL;
+			}
+			op->invoke(result{ op->_length, op->_tag, 0, true });
+			delete op;
+		}
+		ShmRecord_* rec;
+		while (_recvQueue._head && (rec = _ring_front()))
+		{
+			LinkOp_* const op = _recvQueue._head;
+			_recvQueue._head = op->_next;
+			if (!_recvQueue._head)
+			{
+				_recvQueue._tail = NULL;
+			}
+			result res = { rec->_length, rec->_tag, 0, true };
+			if (rec->_length > op->_length)
+			{
+				res.code = boost::asio::error::message_size;
+				res.ok = false;
+			}
+			else
+			{
+				memcpy(op->_buff, rec + 1, rec->_length);
+				_ring_pop(rec);
+			}
+			op->invoke(res);
+			delete op;
+		}
+		if (!_segment)
+		{
+			return;
+		}
+		if (_peerClosed)
+		{
+			//对端已退出，剩下的消息已经取完
+			_fail_queue(_sendQueue, boost::asio::error::connection_reset);
+			_fail_queue(_recvQueue, boost::asio::error::eof);
+			return;
+		}
+		if (!_sendQueue._head && !_recvQueue._head)
+		{
+			_out->_producerWaiting.store(0, std::memory_order_relaxed);
+			_in->_consumerWaiting.store(0, std::memory_order_relaxed);
+			return;
+		}
+		//先置等待标志再复查，对端在复查之后推进的必然看到标志并唤醒
+		if (_sendQueue._head)
+		{
+			_out->_producerWaiting.store(1, std::memory_order_relaxed);
+		}
+		if (_recvQueue._head)
+		{
+			_in->_consumerWaiting.store(1, std::memory_order_relaxed);
+		}
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		bool ready = false;
+		for (int i = 0; i <= SHM_LINK_SPIN && !ready; i++)
+		{
+			ready = (_sendQueue._head && _can_push(_sendQueue._head->_length)) || (_recvQueue._head && !_ring_empty());
+		}
+		if (!ready)
+		{
+			_arm();
+			return;
+		}
+	}
+}
+
+void shm_link::_arm()
+{
+	if (_armed || !_bellDesc)
+	{
+		return;
+	}
+	_armed = true;
+	std::shared_ptr<shm_link> sharedThis = _weakThis.lock();
+	_bellDesc->async_read_some(boost::asio::null_buffers(), _strand->wrap_asio_once([sharedThis](const boost::system::error_code& ec, size_t)
+	{
+		shm_link* const this_ = sharedThis.get();
+		this_->_armed = false;
+		if (!ec && this_->_bellDesc)
+		{
+			unsigned long long bellCount = 0;
+			while (::read(this_->_bellDesc->native_handle(), &bellCount, sizeof(bellCount)) < 0 && EINTR == errno) {}
+			this_->_flush();
+		}
+	}));
+}
+
+void shm_link::_watch_peer()
+{
+	std::shared_ptr<shm_link> sharedThis = _weakThis.lock();
+	_sock->async_wait(boost::asio::socket_base::wait_read, _strand->wrap_asio_once([sharedThis](const boost::system::error_code& ec)
+	{
+		shm_link* const this_ = sharedThis.get();
+		if (ec || !this_->_sock)
+		{
+			return;
+		}
+		char c;
+		const ssize_t n = ::recv(this_->_sock->native_handle(), &c, 1, MSG_DONTWAIT);
+		if (n < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno))
+		{
+			this_->_watch_peer();
+			return;
+		}
+		this_->_peerClosed = true;
+		this_->_flush();
+	}));
+}
+
+void shm_link::_fail_queue(OpQueue_& queue, int code)
+{
+	while (queue._head)
+	{
+		LinkOp_* const op = queue._head;
+		queue._head = op->_next;
+		if (!queue._head)
+		{
+			queue._tail = NULL;
+		}
+		op->invoke(result{ 0, op->_tag, code, false });
+		delete op;
+	}
+}
+
+void shm_link::_close()
+{
+	_release();
+	_fail_queue(_sendQueue, boost::asio::error::operation_aborted);
+	_fail_queue(_recvQueue, boost::asio::error::operation_aborted);
+}
+
+void shm_link::_release()
+{
+	boost::system::error_code ec;
+	if (_sock)
+	{
+		_sock->close(ec);
+		delete _sock;
+		_sock = NULL;
+	}
+	if (_bellDesc)
+	{
+		_bellDesc->close(ec);
+		delete _bellDesc;
+		_bellDesc = NULL;
+	}
+	if (_peerBell >= 0)
+	{
+		::close(_peerBell);
+		_peerBell = -1;
+	}
+	if (_segment)
+	{
+		munmap(_segment, _segmentSize);
+		_segment = NULL;
+		_segmentSize = 0;
+	}
+	_in = _out = NULL;
+	_inData = _outData = NULL;
+	_armed = false;
+}
+
+bool shm_link::_ring_push(const void* buff, size_t length, unsigned tag)
+{
+	const size_t need = SHM_RECORD_ALIGN(sizeof(ShmRecord_) + length);
+	size_t pos = (size_t)(_outTail & (_ringBytes - 1));
+	const size_t contig = _ringBytes - pos;
+	const size_t total = need > contig ? contig + need : need;
+	if (_ringBytes - (size_t)(_outTail - _outHeadCache) < total)
+	{
+		_outHeadCache = _out->_head.load(std::memory_order_acquire);
+		if (_ringBytes - (size_t)(_outTail - _outHeadCache) < total)
+		{
+			return false;
+		}
+	}
+	if (need > contig)
+	{
+		ShmRecord_* const pad = (ShmRecord_*)(_outData + pos);
+		pad->_length = (unsigned)contig;
+		pad->_tag = SHM_PAD_TAG;
+		_outTail += contig;
+		pos = 0;
+	}
+	ShmRecord_* const rec = (ShmRecord_*)(_outData + pos);
+	rec->_length = (unsigned)length;
+	rec->_tag = tag;
+	memcpy(rec + 1, buff, length);
+	_outTail += need;
+	_out->_tail.store(_outTail, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_out->_consumerWaiting.load(std::memory_order_relaxed) && _out->_consumerWaiting.exchange(0))
+	{
+		_ring_bell();
+	}
+	return true;
+}
+
+ShmRecord_* shm_link::_ring_front()
+{
+	while (true)
+	{
+		if (_inHead == _inTailCache)
+		{
+			_inTailCache = _in->_tail.load(std::memory_order_acquire);
+			if (_inHead == _inTailCache)
+			{
+				return NULL;
+			}
+		}
+		ShmRecord_* const rec = (ShmRecord_*)(_inData + (size_t)(_inHead & (_ringBytes - 1)));
+		if (SHM_PAD_TAG != rec->_tag)
+		{
+			return rec;
+		}
+		_inHead += rec->_length;
+	}
+}
+
+void shm_link::_ring_pop(ShmRecord_* rec)
+{
+	_inHead += SHM_RECORD_ALIGN(sizeof(ShmRecord_) + rec->_length);
+	_in->_head.store(_inHead, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_in->_producerWaiting.load(std::memory_order_relaxed) && _in->_producerWaiting.exchange(0))
+	{
+		_ring_bell();
+	}
+}
+
+bool shm_link::_can_push(size_t length)
+{
+	const size_t need = SHM_RECORD_ALIGN(sizeof(ShmRecord_) + length);
+	const size_t contig = _ringBytes - (size_t)(_outTail & (_ringBytes - 1));
+	const size_t total = need > contig ? contig + need : need;
+	_outHeadCache = _out->_head.load(std::memory_order_acquire);
+	return _ringBytes - (size_t)(_outTail - _outHeadCache) >= total;
+}
+
+bool shm_link::_ring_empty()
+{
+	_inTailCache = _in->_tail.load(std::memory_order_acquire);
+	return _inHead == _inTailCache;
+}
+
+void shm_link::_ring_bell()
+{
+	const unsigned long long one = 1;
+	while (::write(_peerBell, &one, sizeof(one)) < 0 && EINTR == errno) {}
+}
+//////////////////////////////////////////////////////////////////////////
+
+shm_acceptor::shm_acceptor(io_engine& ios)
+:_acceptor(ios)
+{
+}
+
+shm_acceptor::~shm_acceptor()
+{
+	close();
+}
+
+shm_link::result shm_acceptor::open(const char* path)
+{
+	close();
+	::unlink(path);
+	boost::system::error_code ec;
+	_acceptor.open(boost::asio::local::stream_protocol(), ec);
+	if (!ec)
+	{
+		_acceptor.bind(boost::asio::local::stream_protocol::endpoint(path), ec);
+	}
+	if (!ec)
+	{
+		_acceptor.listen(boost::asio::socket_base::max_connections, ec);
+	}
+	if (ec)
+	{
+		boost::system::error_code ec2;
+		_acceptor.close(ec2);
+		return shm_link::result{ 0, 0, ec.value(), false };
+	}
+	_path = path;
+	return shm_link::result{ 0, 0, 0, true };
+}
+
+void shm_acceptor::close()
+{
+	if (_acceptor.is_open())
+	{
+		boost::system::error_code ec;
+		_acceptor.close(ec);
+	}
+	if (!_path.empty())
+	{
+		::unlink(_path.c_str());
+		_path.clear();
+	}
+}
+
+shm_link::result shm_acceptor::accept(my_actor* host, const std::shared_ptr<shm_link>& link, size_t ringBytes)
+{
+	my_actor::quit_guard qg(host);
+	return host->trig<shm_link::result>([&](trig_once_notifer<shm_link::result>&& h)
+	{
+		async_accept(link, ringBytes, std::move(h));
+	});
+}
+
+void shm_acceptor::_accept(const std::shared_ptr<shm_link>& link, size_t ringBytes, shm_link::LinkOp_* op)
+{
+	std::shared_ptr<shm_link> sharedLink = link;
+	link->_strand->distribute([this, sharedLink, ringBytes, op]()
+	{
+		if (sharedLink->_sock || sharedLink->_segment)
+		{
+			op->invoke(shm_link::result{ 0, 0, boost::asio::error::already_connected, false });
+			delete op;
+			return;
+		}
+		sharedLink->_sock = new boost::asio::local::stream_protocol::socket(sharedLink->_strand->get_io_service());
+		_acceptor.async_accept(*sharedLink->_sock, sharedLink->_strand->wrap_asio_once([sharedLink, ringBytes, op](const boost::system::error_code& ec)
+		{
+			sharedLink->_handshake_done(op, ec ? ec.value() : sharedLink->_accepted(ringBytes));
+		}));
+	});
+}
+#endif
@@ -0,0 +1,454 @@
+#ifndef __SHM_LINK_H
+#define __SHM_LINK_H
+
+#ifdef __linux__
+#include <memory>
+#include <atomic>
+#include <type_traits>
+#include <string.h>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include "my_actor.h"
+
+//默认每个方向的环形缓冲字节数(2的幂)，单条消息不能超过其一半
+#ifndef SHM_RING_BYTES
+#define SHM_RING_BYTES (1024*1024)
+#endif
+
+//睡眠等待eventfd前在共享内存上自旋复查的次数
+#ifndef SHM_LINK_SPIN
+#define SHM_LINK_SPIN 0
+#endif
+
+//post_msg在本地排队的字节上限(含操作本身)，超过时投递失败
+#ifndef SHM_POST_QUEUE_BYTES
+#define SHM_POST_QUEUE_BYTES SHM_RING_BYTES
+#endif
+
+struct ShmRing_;
+struct ShmRecord_;
+class shm_acceptor;
+
+/*!
+@brief 打包/解包可平凡复制的消息参数，不做序列化
+*/
+template <typename... ARGS>
+struct ShmMsgPack_;
+
+template <>
+struct ShmMsgPack_<>
+{
+	enum { size = 0 };
+
+	static void pack(char*) {}
+	static void unpack(const char*) {}
+};
+
+template <typename First, typename... Rest>
+struct ShmMsgPack_<First, Rest...>
+{
+	static_assert(std::is_trivially_copyable<First>::value, "shm message must be trivially copyable");
+	enum { size = sizeof(First) + ShmMsgPack_<Rest...>::size };
+
+	static void pack(char* p, const First& first, const Rest&... rest)
+	{
+		memcpy(p, &first, sizeof(First));
+		ShmMsgPack_<Rest...>::pack(p + sizeof(First), rest...);
+	}
+
+	static void unpack(const char* p, First& first, Rest&... rest)
+	{
+		memcpy(&first, p, sizeof(First));
+		ShmMsgPack_<Rest...>::unpack(p + sizeof(First), rest...);
+	}
+};
+
+template <typename... ARGS>
+class shm_post_msg;
+
+/*!
+@brief 同一主机上进程间的双向消息通道(linux)；
+共享内存(memfd)中每个方向一个单生产者单消费者环形缓冲，消息按记录整体收发，不需要分帧；
+只有对端在等待时才用eventfd唤醒，eventfd接入所属strand的reactor；
+memfd和eventfd在unix域套接字握手时传递，该套接字之后只用来感知对端退出；
+本进程内的多个发送者由所属strand串行化，所有完成回调都在所属strand中执行
+*/
+class shm_link
+{
+	friend shm_acceptor;
+public:
+	struct result
+	{
+		size_t s;///<消息字节数
+		unsigned tag;///<消息标签
+		int code;///<错误码
+		bool ok;///<是否成功
+	};
+private:
+	struct LinkOp_
+	{
+		virtual ~LinkOp_() __disable_noexcept {}
+		virtual void invoke(const result& res) = 0;
+
+		void* _buff;
+		size_t _length;
+		unsigned _tag;
+		LinkOp_* _next;
+	};
+
+	template <typename Handler>
+	struct link_op : public LinkOp_
+	{
+		typedef RM_CREF(Handler) handler_type;
+
+		link_op(const void* buff, size_t length, unsigned tag, Handler& handler)
+			:_handler(std::forward<Handler>(handler))
+		{
+			LinkOp_::_buff = (void*)buff;
+			LinkOp_::_length = length;
+			LinkOp_::_tag = tag;
+			LinkOp_::_next = NULL;
+		}
+
+		void invoke(const result& res)
+		{
+			_handler(res);
+		}
+
+		handler_type _handler;
+		NONE_COPY(link_op);
+	};
+
+	/*!
+	@brief 投递的消息，数据紧跟在操作之后一次分配，不关心结果；析构时归还排队字节数
+	*/
+	struct PostOp_ : public LinkOp_
+	{
+		PostOp_(size_t length, unsigned tag, std::atomic<size_t>& postBytes);
+		~PostOp_() __disable_noexcept;
+		void invoke(const result& res);
+		static void* operator new(size_t size, size_t length);
+		static void operator delete(void* p);
+
+		std::atomic<size_t>& _postBytes;
+		NONE_COPY(PostOp_);
+	};
+
+	struct OpQueue_
+	{
+		LinkOp_* _head;
+		LinkOp_* _tail;
+	};
+private:
+	shm_link(const shared_strand& strand);
+public:
+	~shm_link();
+	static std::shared_ptr<shm_link> create(const shared_strand& strand);
+public:
+	/*!
+	@brief 连接到shm_acceptor侦听的unix域套接字路径，握手后取得共享内存
+	*/
+	result connect(my_actor* host, const char* path);
+
+	/*!
+	@brief 发送一条消息，缓冲区满时等待对端取走
+	@param tag 消息标签，原样交给对端(不能为-1)
+	*/
+	result send(my_actor* host, const void* buff, size_t length, unsigned tag = 0);
+
+	/*!
+	@brief 接收一条消息，没有消息时等待；缓冲区不足时返回message_size，s为该消息长度，消息保留
+	*/
+	result receive(my_actor* host, void* buff, size_t length);
+
+	/*!
+	@brief 以可平凡复制的参数直接发送一条消息
+	*/
+	template <typename... ARGS>
+	result send_msg(my_actor* host, unsigned tag, const ARGS&... args)
+	{
+		char buff[ShmMsgPack_<ARGS...>::size + 1];
+		ShmMsgPack_<ARGS...>::pack(buff, args...);
+		return send(host, buff, ShmMsgPack_<ARGS...>::size, tag);
+	}
+
+	/*!
+	@brief 接收一条send_msg/shm_post_msg发出的消息，长度不符时返回message_size
+	*/
+	template <typename... ARGS>
+	result receive_msg(my_actor* host, ARGS&... args)
+	{
+		char buff[ShmMsgPack_<ARGS...>::size + 1];
+		result res = receive(host, buff, ShmMsgPack_<ARGS...>::size);
+		if (res.ok)
+		{
+			if (ShmMsgPack_<ARGS...>::size != res.s)
+			{
+				res.code = boost::asio::error::message_size;
+				res.ok = false;
+			}
+			else
+			{
+				ShmMsgPack_<ARGS...>::unpack(buff, args...);
+			}
+		}
+		return res;
+	}
+
+	/*!
+	@brief 投递一条消息，不等待结果，缓冲区满时在本地排队，保持发送顺序；
+	排队字节数超过SHM_POST_QUEUE_BYTES时不排队，code为would_block，由调用者稍后重试或改用send_msg
+	@return 已写入缓冲区或已排队时ok为true
+	*/
+	template <typename... ARGS>
+	result post_msg(unsigned tag, const ARGS&... args)
+	{
+		if (_strand->running_in_this_thread())
+		{
+			char buff[ShmMsgPack_<ARGS...>::size + 1];
+			ShmMsgPack_<ARGS...>::pack(buff, args...);
+			result res = try_send(buff, ShmMsgPack_<ARGS...>::size, tag);
+			if (!would_block(res))
+			{
+				return res;
+			}
+		}
+		const size_t opBytes = sizeof(PostOp_) + ShmMsgPack_<ARGS...>::size;
+		if (_postBytes.fetch_add(opBytes) + opBytes > SHM_POST_QUEUE_BYTES)
+		{
+			_postBytes -= opBytes;
+			return result{ 0, tag, boost::asio::error::would_block, false };
+		}
+		PostOp_* op = new(ShmMsgPack_<ARGS...>::size) PostOp_(ShmMsgPack_<ARGS...>::size, tag, _postBytes);
+		ShmMsgPack_<ARGS...>::pack((char*)op->_buff, args...);
+		_send_op(op);
+		return result{ ShmMsgPack_<ARGS...>::size, tag, 0, true };
+	}
+
+	/*!
+	@brief 创建一个远程投递句柄，用法同post_actor_msg
+	*/
+	template <typename... ARGS>
+	shm_post_msg<ARGS...> make_post_msg(unsigned tag = 0);
+
+	/*!
+	@brief 在所属strand中非阻塞尝试发送/接收，失败时code为would_block
+	*/
+	result try_send(const void* buff, size_t length, unsigned tag = 0);
+	result try_receive(void* buff, size_t length);
+
+	/*!
+	@brief 异步模式下发送一条消息，完成前buff必须有效；在所属strand中直接完成时返回true
+	*/
+	template <typename Handler>
+	bool async_send(const void* buff, size_t length, unsigned tag, Handler&& handler)
+	{
+		if (_strand->running_in_this_thread())
+		{
+			result res = try_send(buff, length, tag);
+			if (res.ok || !would_block(res))
+			{
+				handler(res);
+				return true;
+			}
+		}
+		_send_op(new link_op<Handler>(buff, length, tag, handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下接收一条消息；在所属strand中直接完成时返回true
+	*/
+	template <typename Handler>
+	bool async_receive(void* buff, size_t length, Handler&& handler)
+	{
+		if (_strand->running_in_this_thread())
+		{
+			result res = try_receive(buff, length);
+			if (res.ok || !would_block(res))
+			{
+				handler(res);
+				return true;
+			}
+		}
+		_receive_op(new link_op<Handler>(buff, length, 0, handler));
+		return false;
+	}
+
+	/*!
+	@brief 异步模式下连接
+	*/
+	template <typename Handler>
+	void async_connect(const char* path, Handler&& handler)
+	{
+		_connect(path, new link_op<Handler>(NULL, 0, 0, handler));
+	}
+
+	/*!
+	@brief 关闭通道，未完成的操作以operation_aborted结束，对端随后收到connection_reset；
+	连接后必须调用，关闭后不能再次连接
+	*/
+	void close();
+
+	/*!
+	@brief 是否已建立连接
+	*/
+	bool is_open() const;
+
+	/*!
+	@brief 单条消息最大字节数
+	*/
+	size_t max_msg_size() const;
+
+	/*!
+	@brief 所属strand
+	*/
+	const shared_strand& self_strand() const;
+
+	/*!
+	@brief try操作失败是否是因为暂时不可用
+	*/
+	static bool would_block(const result& res);
+private:
+	void _send_op(LinkOp_* op);
+	void _receive_op(LinkOp_* op);
+	void _connect(const char* path, LinkOp_* op);
+	int _accepted(size_t ringBytes);
+	int _connected();
+	int _map(int memFd, size_t ringBytes, int side, int bell, int peerBell);
+	void _handshake_done(LinkOp_* op, int code);
+	int _send_error(size_t length);
+	void _flush();
+	void _arm();
+	void _watch_peer();
+	void _fail_queue(OpQueue_& queue, int code);
+	void _close();
+	void _release();
+	bool _ring_push(const void* buff, size_t length, unsigned tag);
+	ShmRecord_* _ring_front();
+	void _ring_pop(ShmRecord_* rec);
+	bool _can_push(size_t length);
+	bool _ring_empty();
+	void _ring_bell();
+private:
+	shared_strand _strand;
+	std::weak_ptr<shm_link> _weakThis;
+	boost::asio::local::stream_protocol::socket* _sock;
+	boost::asio::posix::stream_descriptor* _bellDesc;///<本端eventfd，对端在本端等待时写入
+	int _peerBell;///<对端eventfd
+	char* _segment;
+	size_t _segmentSize;
+	ShmRing_* _in;
+	ShmRing_* _out;
+	char* _inData;
+	char* _outData;
+	size_t _ringBytes;
+	unsigned long long _inHead;
+	unsigned long long _inTailCache;
+	unsigned long long _outTail;
+	unsigned long long _outHeadCache;
+	OpQueue_ _sendQueue;
+	OpQueue_ _recvQueue;
+	std::atomic<size_t> _postBytes;///<post_msg排队中的字节数
+	bool _armed;
+	bool _peerClosed;
+	NONE_COPY(shm_link);
+};
+
+/*!
+@brief 共享内存通道侦听器，每接受一个连接创建一块共享内存交给对端
+*/
+class shm_acceptor
+{
+public:
+	shm_acceptor(io_engine& ios);
+	~shm_acceptor();
+public:
+	/*!
+	@brief 在unix域套接字路径上侦听(已存在的路径先删除)
+	*/
+	shm_link::result open(const char* path);
+
+	/*!
+	@brief 关闭侦听器并删除路径
+	*/
+	void close();
+
+	/*!
+	@brief 接受一个连接，link必须未连接
+	@param ringBytes 每个方向的缓冲字节数，向上取整到2的幂
+	*/
+	shm_link::result accept(my_actor* host, const std::shared_ptr<shm_link>& link, size_t ringBytes = SHM_RING_BYTES);
+
+	/*!
+	@brief 异步模式下接受一个连接，完成回调在link的strand中执行
+	*/
+	template <typename Handler>
+	void async_accept(const std::shared_ptr<shm_link>& link, size_t ringBytes, Handler&& handler)
+	{
+		_accept(link, ringBytes, new shm_link::link_op<Handler>(NULL, 0, 0, handler));
+	}
+private:
+	void _accept(const std::shared_ptr<shm_link>& link, size_t ringBytes, shm_link::LinkOp_* op);
+private:
+	boost::asio::local::stream_protocol::acceptor _acceptor;
+	std::string _path;
+	NONE_COPY(shm_acceptor);
+};
+
+/*!
+@brief 远程投递句柄，把可平凡复制的参数作为一条消息投递到shm_link对端，用法同post_actor_msg
+*/
+template <typename... ARGS>
+class shm_post_msg
+{
+public:
+	shm_post_msg()
+		:_tag(0) {}
+
+	shm_post_msg(const std::shared_ptr<shm_link>& link, unsigned tag)
+		:_link(link), _tag(tag) {}
+public:
+	/*!
+	@brief 投递失败(排队已满)时返回的code为would_block
+	*/
+	shm_link::result operator()(const ARGS&... args) const
+	{
+		assert(!empty());
+		return _link->post_msg(_tag, args...);
+	}
+
+	bool empty() const
+	{
+		return !_link;
+	}
+
+	void clear()
+	{
+		_link.reset();
+	}
+
+	operator bool() const
+	{
+		return !empty();
+	}
+private:
+	std::shared_ptr<shm_link> _link;
+	unsigned _tag;
+};
+
+template <typename... ARGS>
+shm_post_msg<ARGS...> shm_link::make_post_msg(unsigned tag)
+{
+	return shm_post_msg<ARGS...>(_weakThis.lock(), tag);
+}
+
+//generator中收发消息，__link__ 为 std::shared_ptr<shm_link>，__res__ 为 shm_link::result
+#define co_shm_send(__link__, __buff__, __len__, __tag__, __res__) co_await (__link__)->async_send(__buff__, __len__, __tag__, co_async_result(__res__))
+#define co_shm_receive(__link__, __buff__, __len__, __res__) co_await (__link__)->async_receive(__buff__, __len__, co_async_result(__res__))
+#define co_shm_connect(__link__, __path__, __res__) co_await (__link__)->async_connect(__path__, co_async_result(__res__))
+#define co_shm_accept(__acceptor__, __link__, __ringBytes__, __res__) co_await (__acceptor__).async_accept(__link__, __ringBytes__, co_async_result(__res__))
+
+#endif
+
+#endif
@@ -4,7 +4,7 @@
 #include "scattered.h"
 
 /*!
-@brief ջϷһʱռڹʱ
+@brief 在栈上分配一段临时空间用于构造临时对象
 */
 template <typename Type = void, bool AutoDestroy = true>
 class stack_obj
@@ -25,7 +25,7 @@ private:
 	void operator delete(void*){};
 public:
 	/*!
-	@brief һʱ
+	@brief 构造一个临时对象
 	*/
 	template <typename... Args>
 	void create(Args&&... args)
@@ -55,7 +55,7 @@ public:
 	}
 
 	/*!
-	@brief ʱ
+	@brief 销毁临时对象
 	*/
 	void destroy()
 	{
@@ -78,7 +78,7 @@ public:
 	}
 
 	/*!
-	@brief øʱ󷽷
+	@brief 调用该临时对象方法
 	*/
 	RM_REF(Type)* operator -> ()
 	{
@@ -119,7 +119,7 @@ private:
 	void operator delete(void*){};
 public:
 	/*!
-	@brief һʱ
+	@brief 构造一个临时对象
 	*/
 	template <typename... Args>
 	void create(Args&&... args)
@@ -141,7 +141,7 @@ public:
 	}
 
 	/*!
-	@brief ʱ
+	@brief 销毁临时对象
 	*/
 	void destroy()
 	{
@@ -165,7 +165,7 @@ public:
 	}
 
 	/*!
-	@brief øʱ󷽷
+	@brief 调用该临时对象方法
 	*/
 	RM_REF(Type)* operator -> ()
 	{
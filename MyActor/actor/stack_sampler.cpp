@@ -0,0 +1,369 @@
+#include "stack_sampler.h"
+
+#if (__linux__ && ENABLE_STACK_SAMPLING)
+#include "my_actor.h"
+#include "io_engine.h"
+#include "check_actor_stack.h"
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <vector>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <ucontext.h>
+#include <sys/time.h>
+#include <cxxabi.h>
+
+//信号处理函数使用的备用栈，避免在Actor栈上压入信号帧
+#define STACK_SAMPLE_ALTSTACK (16 * 1024)
+
+namespace stack_sampler
+{
+	struct Sample_
+	{
+		size_t _key;
+		size_t _depth;
+		bool _inActor;
+		void* _ips[STACK_SAMPLE_DEPTH];
+	};
+
+	/*!
+	@brief 单个io线程的样本缓冲，信号处理函数写，汇总线程读(单生产者单消费者)
+	*/
+	struct SampleRing_
+	{
+		std::atomic<size_t> _head;
+		std::atomic<size_t> _tail;
+		std::atomic<size_t> _dropped;
+		char* _threadStackBase;
+		char* _threadStackTop;
+		bool _ownAltStack;
+		Sample_ _samples[STACK_SAMPLE_RING];
+		char _altStack[STACK_SAMPLE_ALTSTACK];
+	};
+
+	static std::mutex s_mutex;
+	static std::vector<SampleRing_*> s_rings;
+	static std::map<std::vector<size_t>, size_t> s_table;
+	static std::map<void*, std::string> s_symbols;
+	static size_t s_samples = 0;
+	static size_t s_actorSamples = 0;
+	static size_t s_dropped = 0;
+	static std::atomic<size_t> s_lost(0);
+	static bool s_running = false;
+
+	static size_t unwind(void* ip, void** fp, char* lo, char* hi, void** ips)
+	{
+		size_t n = 0;
+		ips[n++] = ip;
+		while (n < STACK_SAMPLE_DEPTH && (char*)fp >= lo && (char*)(fp + 2) <= hi && 0 == ((size_t)fp & (sizeof(void*) - 1)))
+		{
+			void* const ret = fp[1];
+			void** const next = (void**)fp[0];
+			if (!ret)
+			{
+				break;
+			}
+			ips[n++] = ret;
+			if (next <= fp)
+			{
+				break;
+			}
+			fp = next;
+		}
+		return n;
+	}
+
+	static void on_sigprof(int, siginfo_t*, void* ptr)
+	{
+		const int savedErrno = errno;
+		void** const tls = io_engine::getTlsValueBuff();
+		SampleRing_* const ring = tls ? (SampleRing_*)tls[STACK_SAMPLE_TLS_INDEX] : NULL;
+		if (!ring)
+		{
+			s_lost.fetch_add(1, std::memory_order_relaxed);
+			errno = savedErrno;
+			return;
+		}
+		const size_t head = ring->_head.load(std::memory_order_relaxed);
+		if (head - ring->_tail.load(std::memory_order_acquire) >= STACK_SAMPLE_RING)
+		{
+			ring->_dropped.fetch_add(1, std::memory_order_relaxed);
+			errno = savedErrno;
+			return;
+		}
+		ucontext_t* const ucontext = (ucontext_t*)ptr;
+#ifdef __x86_64__
+		void* const ip = (void*)ucontext->uc_mcontext.gregs[REG_RIP];
+		void** const bp = (void**)ucontext->uc_mcontext.gregs[REG_RBP];
+		char* const sp = (char*)ucontext->uc_mcontext.gregs[REG_RSP];
+#elif __i386__
+		void* const ip = (void*)ucontext->uc_mcontext.gregs[REG_EIP];
+		void** const bp = (void**)ucontext->uc_mcontext.gregs[REG_EBP];
+		char* const sp = (char*)ucontext->uc_mcontext.gregs[REG_ESP];
+#elif __aarch64__
+		//aarch64帧记录同样是{上一帧fp, lr}，x29为帧指针
+		void* const ip = (void*)ucontext->uc_mcontext.pc;
+		void** const bp = (void**)ucontext->uc_mcontext.regs[29];
+		char* const sp = (char*)ucontext->uc_mcontext.sp;
+#else
+#error "stack_sampler: unsupported architecture"
+#endif
+		Sample_& sample = ring->_samples[head % STACK_SAMPLE_RING];
+		char* stackBase = NULL;
+		char* stackTop = NULL;
+		sample._inActor = my_actor::sample_current(sample._key, stackBase, stackTop) && sp >= stackBase && sp < stackTop;
+		if (!sample._inActor)
+		{
+			sample._key = 0;
+			stackBase = ring->_threadStackBase;
+			stackTop = ring->_threadStackTop;
+		}
+		if (sp >= stackBase && sp < stackTop)
+		{
+			//帧指针只可能在[sp, 栈顶)之间，每次解引用都限制在这个范围内，rbp是垃圾值时也不会越界
+			sample._depth = unwind(ip, bp, sp, stackTop, sample._ips);
+		}
+		else
+		{
+			//sp不在已知的栈上(如切换到安全栈中执行)，不回溯，只记录PC
+			sample._ips[0] = ip;
+			sample._depth = 1;
+		}
+		ring->_head.store(head + 1, std::memory_order_release);
+		errno = savedErrno;
+	}
+
+	static void drain(SampleRing_* ring)
+	{
+		const size_t head = ring->_head.load(std::memory_order_acquire);
+		size_t tail = ring->_tail.load(std::memory_order_relaxed);
+		std::vector<size_t> key;
+		for (; tail != head; tail++)
+		{
+			const Sample_& sample = ring->_samples[tail % STACK_SAMPLE_RING];
+			key.clear();
+			key.push_back(sample._inActor ? 1 : 0);
+			key.push_back(sample._key);
+			for (size_t i = sample._depth; i > 0; i--)
+			{
+				key.push_back((size_t)sample._ips[i - 1]);
+			}
+			s_table[key]++;
+			s_samples++;
+			s_actorSamples += sample._inActor ? 1 : 0;
+		}
+		ring->_tail.store(tail, std::memory_order_release);
+		s_dropped += ring->_dropped.exchange(0, std::memory_order_relaxed);
+	}
+
+	static const std::string& symbol_name(void* ip)
+	{
+		auto it = s_symbols.find(ip);
+		if (s_symbols.end() != it)
+		{
+			return it->second;
+		}
+		std::string name;
+		Dl_info dlinfo;
+		if (dladdr(ip, &dlinfo) && dlinfo.dli_sname)
+		{
+			int status = -1;
+			char* const demangled = abi::__cxa_demangle(dlinfo.dli_sname, NULL, NULL, &status);
+			name = 0 == status && demangled ? demangled : dlinfo.dli_sname;
+			free(demangled);
+		}
+		else
+		{
+			char buff[24];
+			snprintf(buff, sizeof(buff), "%p", ip);
+			name = buff;
+		}
+		//折叠栈格式中';'是帧分隔符
+		for (char& c : name)
+		{
+			c = ';' == c ? ':' : c;
+		}
+		return s_symbols.insert(std::make_pair(ip, std::move(name))).first->second;
+	}
+
+	bool start(int hz)
+	{
+		assert(hz > 0 && hz <= 1000000);
+		std::lock_guard<std::mutex> lg(s_mutex);
+		if (s_running)
+		{
+			return true;
+		}
+		struct sigaction sigAction;
+		memset(&sigAction, 0, sizeof(sigAction));
+		sigemptyset(&sigAction.sa_mask);
+		sigAction.sa_flags = SA_SIGINFO | SA_RESTART | SA_ONSTACK;
+		sigAction.sa_sigaction = on_sigprof;
+		if (sigaction(SIGPROF, &sigAction, NULL))
+		{
+			return false;
+		}
+		struct itimerval timer;
+		timer.it_interval.tv_sec = 0;
+		timer.it_interval.tv_usec = 1000000 / hz;
+		timer.it_value = timer.it_interval;
+		if (setitimer(ITIMER_PROF, &timer, NULL))
+		{
+			signal(SIGPROF, SIG_IGN);
+			return false;
+		}
+		s_running = true;
+		return true;
+	}
+
+	void stop()
+	{
+		std::lock_guard<std::mutex> lg(s_mutex);
+		if (!s_running)
+		{
+			return;
+		}
+		struct itimerval timer;
+		memset(&timer, 0, sizeof(timer));
+		setitimer(ITIMER_PROF, &timer, NULL);
+		//可能还有未送达的SIGPROF，默认处理方式会结束进程
+		signal(SIGPROF, SIG_IGN);
+		s_running = false;
+	}
+
+	std::string folded()
+	{
+		std::lock_guard<std::mutex> lg(s_mutex);
+		for (SampleRing_* ring : s_rings)
+		{
+			drain(ring);
+		}
+		std::string res;
+		char head[48];
+		for (auto& ele : s_table)
+		{
+			const std::vector<size_t>& key = ele.first;
+			if (key[0])
+			{
+				snprintf(head, sizeof(head), "actor_%llx", (unsigned long long)key[1]);
+				res += head;
+			}
+			else
+			{
+				res += "thread";
+			}
+			for (size_t i = 2; i < key.size(); i++)
+			{
+				res += ';';
+				res += symbol_name((void*)key[i]);
+			}
+			snprintf(head, sizeof(head), " %llu\n", (unsigned long long)ele.second);
+			res += head;
+		}
+		return res;
+	}
+
+	void reset()
+	{
+		std::lock_guard<std::mutex> lg(s_mutex);
+		for (SampleRing_* ring : s_rings)
+		{
+			drain(ring);
+		}
+		s_table.clear();
+		s_samples = 0;
+		s_actorSamples = 0;
+		s_dropped = 0;
+		s_lost = 0;
+	}
+
+	stats_info stats()
+	{
+		std::lock_guard<std::mutex> lg(s_mutex);
+		stats_info res;
+		res.samples = s_samples;
+		res.actorSamples = s_actorSamples;
+		res.dropped = s_dropped;
+		res.lost = s_lost;
+		return res;
+	}
+
+	void thread_attach()
+	{
+		SampleRing_* const ring = new SampleRing_;
+		ring->_head = 0;
+		ring->_tail = 0;
+		ring->_dropped = 0;
+		ring->_threadStackBase = NULL;
+		ring->_threadStackTop = NULL;
+		ring->_ownAltStack = false;
+		pthread_attr_t attr;
+		if (!pthread_getattr_np(pthread_self(), &attr))
+		{
+			void* stackAddr = NULL;
+			size_t stackSize = 0;
+			if (!pthread_attr_getstack(&attr, &stackAddr, &stackSize))
+			{
+				ring->_threadStackBase = (char*)stackAddr;
+				ring->_threadStackTop = (char*)stackAddr + stackSize;
+			}
+			pthread_attr_destroy(&attr);
+		}
+		stack_t oldStack;
+		if (!sigaltstack(NULL, &oldStack) && (oldStack.ss_flags & SS_DISABLE))
+		{
+			stack_t altStack;
+			altStack.ss_sp = ring->_altStack;
+			altStack.ss_size = sizeof(ring->_altStack);
+			altStack.ss_flags = 0;
+			ring->_ownAltStack = !sigaltstack(&altStack, NULL);
+		}
+		{
+			std::lock_guard<std::mutex> lg(s_mutex);
+			s_rings.push_back(ring);
+		}
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		io_engine::getTlsValueBuff()[STACK_SAMPLE_TLS_INDEX] = ring;
+	}
+
+	void thread_detach()
+	{
+		void** const tls = io_engine::getTlsValueBuff();
+		SampleRing_* const ring = (SampleRing_*)tls[STACK_SAMPLE_TLS_INDEX];
+		if (!ring)
+		{
+			return;
+		}
+		//先摘除，之后的信号不再写这个缓冲
+		tls[STACK_SAMPLE_TLS_INDEX] = NULL;
+		std::atomic_signal_fence(std::memory_order_seq_cst);
+		if (ring->_ownAltStack)
+		{
+			stack_t altStack;
+			memset(&altStack, 0, sizeof(altStack));
+			altStack.ss_flags = SS_DISABLE;
+			sigaltstack(&altStack, NULL);
+		}
+		{
+			std::lock_guard<std::mutex> lg(s_mutex);
+			drain(ring);
+			for (size_t i = 0; i < s_rings.size(); i++)
+			{
+				if (ring == s_rings[i])
+				{
+					s_rings[i] = s_rings.back();
+					s_rings.pop_back();
+					break;
+				}
+			}
+		}
+		delete ring;
+	}
+}
+#endif
@@ -0,0 +1,69 @@
+#ifndef __STACK_SAMPLER_H
+#define __STACK_SAMPLER_H
+
+#include <string>
+#include <stddef.h>
+
+//每个样本最多记录的栈帧数
+#ifndef STACK_SAMPLE_DEPTH
+#define STACK_SAMPLE_DEPTH 32
+#endif
+
+//每个io线程的样本环形缓冲长度，写满后丢弃新样本
+#ifndef STACK_SAMPLE_RING
+#define STACK_SAMPLE_RING 512
+#endif
+
+#if (__linux__ && ENABLE_STACK_SAMPLING)
+/*!
+@brief 采样式栈剖析器(Linux x86/x86_64/aarch64，需定义ENABLE_STACK_SAMPLING，并用-fno-omit-frame-pointer编译)；
+SIGPROF按进程CPU时间触发，信号处理函数在被打断的io线程上记录当前Actor的key和帧指针回溯的调用栈，
+回溯限定在Actor栈(或线程栈)范围内，样本写入该线程的无锁环形缓冲；
+generator是无栈协程，运行在io线程栈上，其样本归入"thread"
+*/
+namespace stack_sampler
+{
+	struct stats_info
+	{
+		size_t samples;///<已汇总的样本数
+		size_t actorSamples;///<其中落在Actor中的样本数
+		size_t dropped;///<缓冲写满丢弃的样本数
+		size_t lost;///<落在非io线程上的样本数
+	};
+
+	/*!
+	@brief 开始采样
+	@param hz 每秒采样次数(按进程CPU时间)
+	*/
+	bool start(int hz = 1000);
+
+	/*!
+	@brief 停止采样
+	*/
+	void stop();
+
+	/*!
+	@brief 汇总各线程缓冲中的样本，以flame graph折叠栈格式导出，
+	每行"actor_key;最外层函数;...;最内层函数 样本数"，不在Actor中的样本以"thread"开头
+	*/
+	std::string folded();
+
+	/*!
+	@brief 清空已汇总的样本
+	*/
+	void reset();
+
+	/*!
+	@brief 采样统计
+	*/
+	stats_info stats();
+
+	/*!
+	@brief io线程启动/退出时登记样本缓冲(由io_engine调用)
+	*/
+	void thread_attach();
+	void thread_detach();
+}
+#endif
+
+#endif
@@ -0,0 +1,256 @@
+#include "strand_balancer.h"
+#include "time_source.h"
+#include <map>
+
+strand_balancer::strand_balancer(const std::vector<shared_strand>& strands)
+:_strands(strands), _states(strands.size()), _lastSampleUs(time_source::tsc_us()), _migrations(0), _stopped(false)
+{
+	assert(!_strands.empty());
+	for (size_t i = 0; i < _strands.size(); i++)
+	{
+		assert(&_strands[i]->get_io_engine() == &_strands[0]->get_io_engine());
+		StrandState_& st = _states[i];
+		st._lastBusyUs = _strands[i]->load_stats().busyUs;
+		st._movedUs = 0;
+		st._busy = 0;
+		st._backlog = 0;
+		st._weight = 0;
+		st._members = 0;
+	}
+}
+
+strand_balancer::~strand_balancer()
+{
+	assert(_members.empty());
+}
+
+strand_balancer::member_handle strand_balancer::enroll(my_actor* self, size_t affinity)
+{
+	assert(self->running_in_actor_strand());
+	member_handle mh = std::make_shared<BalanceMember_>();
+	mh->_actorID = self->self_id();
+	mh->_affinity = affinity;
+	mh->_strandIndex = -1;
+	mh->_lastYield = self->yield_count();
+	mh->_weight = 0;
+	mh->_movedUs = 0;
+	mh->_yieldCount = mh->_lastYield;
+	mh->_target = 0;
+	for (size_t i = 0; i < _strands.size(); i++)
+	{
+		if (_strands[i] == self->self_strand())
+		{
+			mh->_strandIndex = i;
+			break;
+		}
+	}
+	assert((size_t)-1 != mh->_strandIndex);
+	std::lock_guard<std::mutex> lg(_mutex);
+	_members.push_back(mh);
+	return mh;
+}
+
+void strand_balancer::leave(const member_handle& mh)
+{
+	std::lock_guard<std::mutex> lg(_mutex);
+	for (size_t i = 0; i < _members.size(); i++)
+	{
+		if (_members[i] == mh)
+		{
+			_members[i] = std::move(_members.back());
+			_members.pop_back();
+			break;
+		}
+	}
+}
+
+bool strand_balancer::balance_point(my_actor* self, const member_handle& mh)
+{
+	mh->_yieldCount.store(self->yield_count(), std::memory_order_relaxed);
+	if (!mh->_target.load(std::memory_order_relaxed))
+	{
+		return false;
+	}
+	const size_t target = mh->_target.exchange(0, std::memory_order_acquire);
+	if (!target)
+	{
+		return false;
+	}
+	self->migrate(_strands[target - 1]);
+	{
+		//迁移完成后才更新所在strand，之前的采样仍把它算在原strand上
+		std::lock_guard<std::mutex> lg(_mutex);
+		mh->_strandIndex = target - 1;
+	}
+	_migrations++;
+	return true;
+}
+
+void strand_balancer::set_policy(const policy_func& policy)
+{
+	std::lock_guard<std::mutex> lg(_mutex);
+	_policy = policy;
+}
+
+void strand_balancer::rebalance()
+{
+	const long long now = time_source::tsc_us();
+	std::lock_guard<std::mutex> lg(_mutex);
+	sample(now);
+	plan(now);
+}
+
+void strand_balancer::sample(long long now)
+{
+	const long long dt = now - _lastSampleUs;
+	if (dt <= 0)
+	{
+		return;
+	}
+	_lastSampleUs = now;
+	for (size_t i = 0; i < _strands.size(); i++)
+	{
+		StrandState_& st = _states[i];
+		const boost_strand::load_info li = _strands[i]->load_stats();
+		const double busy = std::min(1.0, (double)(li.busyUs - st._lastBusyUs) / (double)dt);
+		st._lastBusyUs = li.busyUs;
+		//指数平滑，单次突发不触发迁移
+		st._busy = (st._busy + busy) / 2;
+		st._backlog = li.maxRound;
+		st._weight = 0;
+		st._members = 0;
+	}
+	for (member_handle& mh : _members)
+	{
+		const size_t yc = mh->_yieldCount.load(std::memory_order_relaxed);
+		mh->_weight = yc - mh->_lastYield;
+		mh->_lastYield = yc;
+		_states[mh->_strandIndex]._weight += mh->_weight;
+		_states[mh->_strandIndex]._members++;
+	}
+}
+
+bool strand_balancer::plan(long long now)
+{
+	size_t hot = -1, cold = -1;
+	for (size_t i = 0; i < _states.size(); i++)
+	{
+		const StrandState_& st = _states[i];
+		if (now - st._movedUs < (long long)STRAND_BALANCE_COOLDOWN_MS * 1000)
+		{
+			continue;
+		}
+		const bool overload = st._busy * 100 >= STRAND_BALANCE_HIGH || st._backlog >= STRAND_BALANCE_BACKLOG;
+		if (overload && st._members > 1 && ((size_t)-1 == hot || st._busy > _states[hot]._busy))
+		{
+			hot = i;
+		}
+		if ((size_t)-1 == cold || st._busy < _states[cold]._busy)
+		{
+			cold = i;
+		}
+	}
+	if ((size_t)-1 == hot || (size_t)-1 == cold || hot == cold || !_states[hot]._weight)
+	{
+		return false;
+	}
+	StrandState_& hotSt = _states[hot];
+	StrandState_& coldSt = _states[cold];
+	const double gap = hotSt._busy - coldSt._busy;
+	if (gap * 100 < STRAND_BALANCE_GAP)
+	{
+		return false;
+	}
+	//按亲和组汇总过载strand上的Actor活跃度(yield次数)，换算成负载
+	std::map<size_t, size_t> groups;
+	for (member_handle& mh : _members)
+	{
+		const size_t key = (size_t)-1 == mh->_affinity ? (size_t)mh->_actorID : mh->_affinity;
+		auto it = groups.insert(std::make_pair(key, (size_t)0)).first;
+		if ((size_t)-1 == it->second)
+		{
+			continue;
+		}
+		if (mh->_target.load(std::memory_order_relaxed) || now - mh->_movedUs < (long long)STRAND_BALANCE_DWELL_MS * 1000)
+		{
+			//组内有Actor不能迁移，整组不动
+			it->second = -1;
+		}
+		else if (hot == mh->_strandIndex)
+		{
+			it->second += mh->_weight;
+		}
+	}
+	//迁移后冷热不能反转，只选负载不超过差距一半的组里最大的
+	size_t bestKey = -1;
+	double bestLoad = 0;
+	for (auto& group : groups)
+	{
+		if ((size_t)-1 == group.second || !group.second)
+		{
+			continue;
+		}
+		const double load = hotSt._busy * (double)group.second / (double)hotSt._weight;
+		if (load <= gap / 2 && load > bestLoad)
+		{
+			bestKey = group.first;
+			bestLoad = load;
+		}
+	}
+	if ((size_t)-1 == bestKey || (_policy && !_policy(bestKey, hot, cold)))
+	{
+		return false;
+	}
+	for (member_handle& mh : _members)
+	{
+		const size_t key = (size_t)-1 == mh->_affinity ? (size_t)mh->_actorID : mh->_affinity;
+		if (key == bestKey && cold != mh->_strandIndex)
+		{
+			_states[mh->_strandIndex]._movedUs = now;
+			mh->_movedUs = now;
+			mh->_target.store(cold + 1, std::memory_order_release);
+		}
+	}
+	hotSt._busy -= bestLoad;
+	coldSt._busy += bestLoad;
+	coldSt._movedUs = now;
+	return true;
+}
+
+void strand_balancer::run(my_actor* host)
+{
+	_stopped = false;
+	while (!_stopped)
+	{
+		host->sleep(STRAND_BALANCE_PERIOD_MS);
+		rebalance();
+	}
+}
+
+void strand_balancer::stop()
+{
+	_stopped = true;
+}
+
+const std::vector<shared_strand>& strand_balancer::strands() const
+{
+	return _strands;
+}
+
+std::vector<strand_balancer::strand_load> strand_balancer::loads()
+{
+	std::lock_guard<std::mutex> lg(_mutex);
+	std::vector<strand_load> res(_states.size());
+	for (size_t i = 0; i < _states.size(); i++)
+	{
+		res[i].busy = _states[i]._busy;
+		res[i].backlog = _states[i]._backlog;
+		res[i].members = _states[i]._members;
+	}
+	return res;
+}
+
+size_t strand_balancer::migrations() const
+{
+	return _migrations;
+}
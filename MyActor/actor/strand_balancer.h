@@ -0,0 +1,164 @@
+#ifndef __STRAND_BALANCER_H
+#define __STRAND_BALANCER_H
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <functional>
+#include "my_actor.h"
+
+//采样周期(ms)
+#ifndef STRAND_BALANCE_PERIOD_MS
+#define STRAND_BALANCE_PERIOD_MS 100
+#endif
+
+//strand忙碌比例(%)达到此值，或队列积压达到STRAND_BALANCE_BACKLOG时视为过载
+#ifndef STRAND_BALANCE_HIGH
+#define STRAND_BALANCE_HIGH 80
+#endif
+
+#ifndef STRAND_BALANCE_BACKLOG
+#define STRAND_BALANCE_BACKLOG 256
+#endif
+
+//最忙与最闲strand的忙碌比例(%)至少相差多少才迁移
+#ifndef STRAND_BALANCE_GAP
+#define STRAND_BALANCE_GAP 30
+#endif
+
+//发生迁移的strand多久(ms)内不再参与迁移
+#ifndef STRAND_BALANCE_COOLDOWN_MS
+#define STRAND_BALANCE_COOLDOWN_MS 500
+#endif
+
+//Actor迁移后至少停留多久(ms)才能再次迁移
+#ifndef STRAND_BALANCE_DWELL_MS
+#define STRAND_BALANCE_DWELL_MS 2000
+#endif
+
+/*!
+@brief 可迁移Actor的登记信息，由strand_balancer::enroll返回
+*/
+struct BalanceMember_
+{
+	my_actor::id _actorID;
+	size_t _affinity;
+	size_t _strandIndex;
+	size_t _lastYield;
+	size_t _weight;
+	long long _movedUs;
+	std::atomic<size_t> _yieldCount;
+	std::atomic<size_t> _target;
+};
+
+/*!
+@brief strand负载均衡器(可选)，周期采样一组strand的忙碌时间和队列积压，
+把登记为可迁移的Actor从过载strand迁移到空闲strand；
+每次最多迁移一个亲和组，迁移量不超过两者差距的一半，并且有冷却和驻留时间，防止来回迁移；
+Actor只在自己调用balance_point时才真正迁移(my_actor::migrate)，迁移条件见my_actor::migrate
+*/
+class strand_balancer
+{
+public:
+	typedef std::shared_ptr<BalanceMember_> member_handle;
+
+	/*!
+	@brief 迁移策略，返回false放弃本次迁移
+	@param affinity 被迁移的亲和组
+	@param from/to strand序号
+	*/
+	typedef std::function<bool(size_t affinity, size_t from, size_t to)> policy_func;
+
+	/*!
+	@brief 某个strand当前的负载估计
+	*/
+	struct strand_load
+	{
+		double busy;///<忙碌比例(0~1)
+		size_t backlog;///<最近一个采样周期内的最长一轮
+		size_t members;///<其上的可迁移Actor数
+	};
+public:
+	/*!
+	@param strands 参与均衡的strand(必须属于同一个io_engine)
+	*/
+	strand_balancer(const std::vector<shared_strand>& strands);
+	~strand_balancer();
+public:
+	/*!
+	@brief 在Actor中登记自己为可迁移Actor，必须运行在参与均衡的strand上
+	@param affinity 亲和组，同组的Actor总是一起迁移，-1表示不分组
+	*/
+	member_handle enroll(my_actor* self, size_t affinity = -1);
+
+	/*!
+	@brief 注销，Actor退出前调用
+	*/
+	void leave(const member_handle& mh);
+
+	/*!
+	@brief 迁移点，Actor在不持有strand相关资源的位置调用；有迁移计划时迁移到目标strand并返回true
+	*/
+	__yield_interrupt bool balance_point(my_actor* self, const member_handle& mh);
+
+	/*!
+	@brief 设置迁移策略
+	*/
+	void set_policy(const policy_func& policy);
+
+	/*!
+	@brief 采样一次并制定迁移计划，可在任意线程调用
+	*/
+	void rebalance();
+
+	/*!
+	@brief 在Actor中每STRAND_BALANCE_PERIOD_MS执行一次rebalance，直到stop
+	*/
+	__yield_interrupt void run(my_actor* host);
+
+	/*!
+	@brief 停止run
+	*/
+	void stop();
+
+	/*!
+	@brief 参与均衡的strand
+	*/
+	const std::vector<shared_strand>& strands() const;
+
+	/*!
+	@brief 最近一次采样的负载
+	*/
+	std::vector<strand_load> loads();
+
+	/*!
+	@brief 累计迁移的Actor数
+	*/
+	size_t migrations() const;
+private:
+	struct StrandState_
+	{
+		long long _lastBusyUs;
+		long long _movedUs;
+		double _busy;
+		size_t _backlog;
+		size_t _weight;
+		size_t _members;
+	};
+
+	void sample(long long now);
+	bool plan(long long now);
+private:
+	const std::vector<shared_strand> _strands;
+	std::vector<StrandState_> _states;
+	std::vector<member_handle> _members;
+	policy_func _policy;
+	long long _lastSampleUs;
+	std::atomic<size_t> _migrations;
+	std::atomic<bool> _stopped;
+	std::mutex _mutex;
+	NONE_COPY(strand_balancer);
+};
+
+#endif
@@ -57,7 +57,7 @@ namespace boost
 }
 //////////////////////////////////////////////////////////////////////////
 
-StrandEx_::StrandEx_(io_engine& ios)
+StrandEx_::StrandEx_(boost::asio::io_service& ios)
 : _service(boost::asio::use_service<boost::asio::detail::strand_service>(ios)),
 _impl(new boost::asio::detail::strand_service::strand_impl()) {}
 
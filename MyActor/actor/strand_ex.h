@@ -9,13 +9,13 @@ class io_engine;
 class boost_strand;
 
 /*!
-@brief ޸ı׼boost strandimpl_Ϊռ
+@brief 修改标准boost strand，impl_改为独占
 */
 class StrandEx_
 {
 	friend boost_strand;
 private:
-	StrandEx_(io_engine& ios);
+	StrandEx_(boost::asio::io_service& ios);
 	~StrandEx_();
 
 	bool running_in_this_thread() const;
@@ -0,0 +1,218 @@
+#include "time_source.h"
+#include "scattered.h"
+#include "io_engine.h"
+#include "check_actor_stack.h"
+#include <atomic>
+#include <mutex>
+#ifdef _MSC_VER
+#include <intrin.h>
+#elif (defined __x86_64__) || (defined __i386__)
+#include <cpuid.h>
+#endif
+
+namespace time_source
+{
+	static bool check_invariant_tsc()
+	{
+#if (defined _MSC_VER) && ((defined _M_X64) || (defined _M_IX86))
+		int info[4] = { 0 };
+		__cpuid(info, 0x80000000);
+		if ((unsigned)info[0] < 0x80000007)
+		{
+			return false;
+		}
+		__cpuid(info, 0x80000007);
+		return 0 != (info[3] & (1 << 8));
+#elif (defined __GNUG__) && ((defined __x86_64__) || (defined __i386__))
+		unsigned a = 0, b = 0, c = 0, d = 0;
+		if (!__get_cpuid(0x80000000, &a, &b, &c, &d) || a < 0x80000007)
+		{
+			return false;
+		}
+		__get_cpuid(0x80000007, &a, &b, &c, &d);
+		return 0 != (d & (1 << 8));
+#else
+		return false;
+#endif
+	}
+
+	/*!
+	@brief TSC时钟，用一个锚点(anchorTick, anchorUs)和换算比例表示；
+	读端用序列号无锁读取锚点，到达nextTick的线程负责用CLOCK_MONOTONIC重新校准
+	*/
+	struct TscClock_
+	{
+		TscClock_()
+			:_invariant(check_invariant_tsc()), _seq(0), _anchorTick(0), _anchorUs(0), _usPerTick(0), _nextTick(0)
+		{
+			_baseTick = cpu_tick();
+			_baseUs = get_tick_us();
+		}
+
+		long long now()
+		{
+			if (!_invariant)
+			{
+				return get_tick_us();
+			}
+			unsigned long long tick, anchorTick, nextTick;
+			long long anchorUs;
+			double usPerTick;
+			while (true)
+			{
+				const size_t seq = _seq.load(std::memory_order_acquire);
+				if (seq & 1)
+				{
+					continue;
+				}
+				anchorTick = _anchorTick.load(std::memory_order_relaxed);
+				anchorUs = _anchorUs.load(std::memory_order_relaxed);
+				usPerTick = _usPerTick.load(std::memory_order_relaxed);
+				nextTick = _nextTick.load(std::memory_order_relaxed);
+				//tick在锚点之后读取，避免锚点被其它线程推进到tick之后
+				tick = cpu_tick();
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if (seq == _seq.load(std::memory_order_relaxed))
+				{
+					break;
+				}
+			}
+			const long long dt = (long long)(tick - anchorTick);
+			if (dt < 0 || tick >= nextTick)
+			{
+				return resync(tick, anchorTick, anchorUs, usPerTick);
+			}
+			return anchorUs + (long long)((double)dt * usPerTick);
+		}
+
+		/*!
+		@brief 用锚点推算tick对应的时间，tick早于锚点(跨核TSC微小偏差)时取锚点时间
+		*/
+		static long long extrapolate(unsigned long long tick, unsigned long long anchorTick, long long anchorUs, double usPerTick)
+		{
+			const long long dt = (long long)(tick - anchorTick);
+			return dt > 0 ? anchorUs + (long long)((double)dt * usPerTick) : anchorUs;
+		}
+
+		long long resync(unsigned long long tick, unsigned long long anchorTick, long long anchorUs, double usPerTick)
+		{
+			const long long us = get_tick_us();
+			if (!_mutex.try_lock())
+			{
+				//其它线程正在校准，不能返回比已发布锚点推算值更小的时间
+				if (usPerTick > 0)
+				{
+					const long long cont = extrapolate(tick, anchorTick, anchorUs, usPerTick);
+					return cont > us ? cont : us;
+				}
+				return us;
+			}
+			anchorTick = _anchorTick.load(std::memory_order_relaxed);
+			anchorUs = _anchorUs.load(std::memory_order_relaxed);
+			usPerTick = _usPerTick.load(std::memory_order_relaxed);
+			if (usPerTick > 0 && (long long)(tick - anchorTick) < 0)
+			{
+				//tick早于当前锚点，不做校准
+				_mutex.unlock();
+				return anchorUs;
+			}
+			if (tick < _nextTick.load(std::memory_order_relaxed))
+			{
+				//其它线程已完成校准
+				_mutex.unlock();
+				return usPerTick > 0 ? extrapolate(tick, anchorTick, anchorUs, usPerTick) : us;
+			}
+			if (us - _baseUs < TSC_CALIBRATE_US || (long long)(tick - _baseTick) <= 0)
+			{
+				_mutex.unlock();
+				return us;
+			}
+			//比例取自启动以来的全部区间，越往后越准确
+			const double newUsPerTick = (double)(us - _baseUs) / (double)(long long)(tick - _baseTick);
+			long long newAnchorUs = us;
+			if (usPerTick > 0)
+			{
+				//保证单调，TSC快于系统时钟时不回退
+				const long long cont = extrapolate(tick, anchorTick, anchorUs, usPerTick);
+				newAnchorUs = cont > us ? cont : us;
+			}
+			_seq.fetch_add(1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			_anchorTick.store(tick, std::memory_order_relaxed);
+			_anchorUs.store(newAnchorUs, std::memory_order_relaxed);
+			_usPerTick.store(newUsPerTick, std::memory_order_relaxed);
+			_nextTick.store(tick + (unsigned long long)((double)TSC_RESYNC_US / newUsPerTick), std::memory_order_relaxed);
+			_seq.fetch_add(1, std::memory_order_release);
+			_mutex.unlock();
+			return newAnchorUs;
+		}
+
+		const bool _invariant;
+		std::atomic<size_t> _seq;
+		std::atomic<unsigned long long> _anchorTick;
+		std::atomic<long long> _anchorUs;
+		std::atomic<double> _usPerTick;
+		std::atomic<unsigned long long> _nextTick;
+		unsigned long long _baseTick;
+		long long _baseUs;
+		std::mutex _mutex;
+	};
+
+	static TscClock_& tsc_clock()
+	{
+		static TscClock_ s_clock;
+		return s_clock;
+	}
+
+	static long long* coarse_slot()
+	{
+		void** const tls = io_engine::getTlsValueBuff();
+		return tls ? (long long*)tls[TIME_COARSE_TLS_INDEX] : NULL;
+	}
+
+	long long tsc_us()
+	{
+		return tsc_clock().now();
+	}
+
+	long long coarse_us()
+	{
+		long long* const slot = coarse_slot();
+		if (slot)
+		{
+			return *slot;
+		}
+		return tsc_us();
+	}
+
+	long long refresh_coarse()
+	{
+		const long long us = tsc_us();
+		long long* const slot = coarse_slot();
+		if (slot)
+		{
+			*slot = us;
+		}
+		return us;
+	}
+
+	void refresh_coarse(long long us)
+	{
+		long long* const slot = coarse_slot();
+		if (slot && us > *slot)
+		{
+			*slot = us;
+		}
+	}
+
+	bool tsc_invariant()
+	{
+		return tsc_clock()._invariant;
+	}
+
+	double tsc_per_us()
+	{
+		const double usPerTick = tsc_clock()._usPerTick.load(std::memory_order_relaxed);
+		return usPerTick > 0 ? 1.0 / usPerTick : 0;
+	}
+}
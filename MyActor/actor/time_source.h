@@ -0,0 +1,58 @@
+#ifndef __TIME_SOURCE_H
+#define __TIME_SOURCE_H
+
+//TSC启动校准时长(us)，校准完成前tsc_us直接使用get_tick_us
+#ifndef TSC_CALIBRATE_US
+#define TSC_CALIBRATE_US 10000
+#endif
+
+//TSC重新对齐CLOCK_MONOTONIC的周期(us)
+#ifndef TSC_RESYNC_US
+#define TSC_RESYNC_US 1000000
+#endif
+
+//strand同一轮中每执行多少个任务刷新一次粗粒度时钟
+#ifndef TIME_COARSE_BATCH
+#define TIME_COARSE_BATCH 32
+#endif
+
+/*!
+@brief 时间源，与get_tick_us处于同一时间轴(微秒)；
+tsc_us 用invariant TSC(cpu_tick)按CLOCK_MONOTONIC校准得到的精确时间，CPU不支持invariant TSC时等同get_tick_us；
+coarse_us 每个io线程缓存的粗粒度时间，strand每轮(及每TIME_COARSE_BATCH个任务)开始时刷新，
+可能滞后于当前时间一个任务批次的执行时长，只适用于统计等能容忍这种误差的场合，定时器的起始时间要用tsc_us
+*/
+namespace time_source
+{
+	/*!
+	@brief 精确时间戳(us)
+	*/
+	long long tsc_us();
+
+	/*!
+	@brief 当前io线程缓存的粗粒度时间(us)，非io线程或未启用ENABLE_NEXT_TICK时返回tsc_us()
+	*/
+	long long coarse_us();
+
+	/*!
+	@brief 刷新当前io线程的粗粒度时间，返回刷新后的值
+	*/
+	long long refresh_coarse();
+
+	/*!
+	@brief 用一个已取得的精确时间刷新当前io线程的粗粒度时间
+	*/
+	void refresh_coarse(long long us);
+
+	/*!
+	@brief CPU是否支持invariant TSC(tsc_us是否真正使用TSC)
+	*/
+	bool tsc_invariant();
+
+	/*!
+	@brief 每微秒TSC计数，未完成校准时返回0
+	*/
+	double tsc_per_us();
+}
+
+#endif
@@ -49,8 +49,8 @@ struct stack_line_info
 };
 
 /*!
-@brief ȡǰöջϢ
-@param maxDepth ȡǰջ߲Σ32
+@brief 获取当前调用堆栈信息
+@param maxDepth 获取当前堆栈向下最高层次，最大32层
 */
 std::list<stack_line_info> get_stack_list(size_t maxDepth = 32, size_t offset = 0, bool module = false, bool symbolName = false);
 std::list<stack_line_info> get_stack_list(void* bp, void* sp, void* ip, size_t maxDepth = 32, size_t offset = 0, bool module = false, bool symbolName = false);
@@ -58,7 +58,7 @@ std::list<stack_line_info> get_stack_list(void* bp, void* sp, void* ip, size_t m
 
 #ifdef PRINT_ACTOR_STACK
 
-//¼ǰActorϢ
+//记录当前Actor入口信息
 #define ACTOR_POSITION(__host__) \
 {\
 	__host__->_checkStackFree = true; \
@@ -69,18 +69,18 @@ std::list<stack_line_info> get_stack_list(void* bp, void* sp, void* ip, size_t m
 	__host__->_createStack->push_front(__line); \
 }
 
-//¼ǰActorϢ
+//记录当前Actor入口信息
 #define SELF_POSITION ACTOR_POSITION(self)
 
 /*!
-@brief ջϢ
+@brief 堆栈溢出弹出消息
 */
 void stack_overflow_format(int size, const std::list<stack_line_info>& createStack);
 void stack_overflow_format(int size, std::list<stack_line_info>&& createStack);
 
 #else
 
-//¼ǰActorϢ
+//记录当前Actor入口信息
 #define ACTOR_POSITION(__host__)
 #define SELF_POSITION
 
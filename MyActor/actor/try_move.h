@@ -7,7 +7,7 @@
 template <typename T>
 struct try_move
 {
-	//ȷ޷Ƿƶ
+	//不正确参数，无法检测是否可移动
 
 	static inline T& move(T& p)
 	{
@@ -64,37 +64,37 @@ struct try_move<T&&>
 	}
 };
 
-//Ƴ
+//移除引用属性
 #define RM_REF(__T__) typename std::remove_reference<__T__>::type
 #define RM_REF_(__T__) std::remove_reference<__T__>::type
-//Ƴͱ const 
+//移除类型本身的 const 属性
 #define RM_CONST(__T__) typename std::remove_const<__T__>::type
 #define RM_CONST_(__T__) std::remove_const<__T__>::type
-//ƳͱԣȻƳ const
+//移除类型本身的引用属性，然后移除 const
 #define RM_CREF(__T__) RM_CONST(RM_REF(__T__))
 #define RM_CREF_(__T__) RM_CONST_(RM_REF_(__T__))
 
-//Ƴָ
+//移除指针
 #define RM_PTR(__T__) typename std::remove_pointer<__T__>::type
 #define RM_PTR_(__T__) std::remove_pointer<__T__>::type
-//Ƴͱָ룬ȻƳ const
+//移除类型本身的指针，然后移除 const
 #define RM_CPTR(__T__) RM_CONST(RM_PTR(__T__))
 #define RM_CPTR_(__T__) RM_CONST_(RM_PTR_(__T__))
-//ƳͱԣƳָ룬ȻƳ const
+//移除类型本身的引用属性，再移除指针，然后移除 const
 #define RM_CPTR_REF(__T__) RM_CONST(RM_PTR(RM_REF(__T__)))
 #define RM_CPTR_REF_(__T__) RM_CONST_(RM_PTR_(RM_REF_(__T__)))
 
 
-//һǷֵݣǾͼֵ
+//检测一个参数是否是右值传递，是就继续进行右值传递
 #define TRY_MOVE(__P__) (decltype(__P__))(__P__)
-//һǷֵ
+//检测一个参数是否是右值传递
 #define CAN_MOVE(__P__) try_move<decltype(__P__)>::can_move
-//constǿתΪֵ
+//const属性强制转换为右值
 #define FORCE_MOVE(__P__) (RM_CREF(decltype(__P__))&&)__P__
 //////////////////////////////////////////////////////////////////////////
 
 /*!
-@brief  һǷΪãǾתΪðװֵ
+@brief  检测一个参数是否是为引用，是就转为引用包装，否则尝试右值传递
 */
 template <typename ARG>
 struct try_ref_move
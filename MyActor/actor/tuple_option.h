@@ -39,7 +39,7 @@ struct SingleElement_<0, FIRST, TYPES...>
 };
 
 /*!
-@brief ȡI
+@brief 取第I个类型
 */
 template <size_t I, typename FIRST, typename... TYPES>
 struct single_element : public SingleElement_<I, FIRST, TYPES...> {};
@@ -97,7 +97,7 @@ struct CheckRef0_<T&&>
 };
 
 /*!
-@brief ƶtupleеĵI
+@brief 尝试移动tuple中的第I个参数
 */
 template <size_t I, typename TUPLE>
 struct tuple_move
@@ -316,7 +316,7 @@ struct CheckClassFunc_<R(C::*)(Types...) const>
 };
 
 /*!
-@brief tupleȡĳ
+@brief 从tuple中取参数调用某个函数
 */
 template <typename R = void, typename Handler, typename Unknown, typename... Tuple>
 inline R tuple_invoke(Handler&& h, Unknown&& unkown, Tuple&&... tups)
@@ -388,7 +388,7 @@ struct RvalInvoke_<R, true>
 };
 
 /*!
-@brief ̬뵱ǰǷֵ
+@brief 动态传入当前调用是否是右值
 */
 template <typename R = void, typename Handler, typename Unknown, typename... Args>
 inline R try_rval_invoke(Handler&& h, Unknown&& unkown, Args&&... args)
@@ -1,6 +1,7 @@
 #ifdef DISABLE_BOOST_TIMER
 #include "waitable_timer.h"
 #include "scattered.h"
+#include "time_source.h"
 #ifdef WIN32
 #include <Windows.h>
 
@@ -57,7 +58,7 @@ void WaitableTimer_::timerThread()
 	{
 		if (WAIT_OBJECT_0 == WaitForSingleObject(_timerHandle, INFINITE) && !_exited)
 		{
-			long long ct = get_tick_us();
+			long long ct = time_source::tsc_us();
 			std::lock_guard<std::mutex> lg(_ctrlMutex);
 			_extFinishTime = -1;
 			while (!_eventsQueue.empty())
@@ -147,7 +148,7 @@ void WaitableTimer_::timerThread()
 	{
 		if (sizeof(exp) == read(_timerFd, &exp, sizeof(exp)) && !_exited)
 		{
-			long long ct = get_tick_us();
+			long long ct = time_source::tsc_us();
 			std::lock_guard<std::mutex> lg(_ctrlMutex);
 			_extFinishTime = -1;
 			while (!_eventsQueue.empty())